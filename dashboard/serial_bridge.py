@@ -5,7 +5,9 @@ Connects web dashboard to ESP32 via Serial port using WebSocket
 """
 
 import asyncio
+import binascii
 import json
+import struct
 import serial
 import serial.tools.list_ports
 from websockets.server import serve
@@ -16,11 +18,187 @@ SERIAL_PORT = "COM5"  # Updated to COM5
 SERIAL_BAUD = 115200
 WEBSOCKET_HOST = "localhost"
 WEBSOCKET_PORT = 8765
+BINARY_COMMANDS = False  # 7-byte binary frames instead of JSON lines
+BINARY_TELEMETRY = False  # COBS frames from a TELEMETRY_BINARY build instead of text
+
+# Channel order of the binary frame (RemoteChannel in CommandParser.h)
+REMOTE_CHANNELS = [
+    "soilMoisture", "soilTemp", "soilPH", "leafTemp", "leafWetness",
+    "airTemp", "humidity", "light", "rainfall", "windSpeed",
+    "windDirection", "gas", "co2", "co", "waterLevel", "weight",
+]
+COMMAND_SYNC = 0xA5
+
+def crc8(data):
+    """CRC-8, polynomial 0x07 (commandCrc8 on the ESP32)"""
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+# Binary telemetry (Telemetry.h): snapshot values, status bytes and flag bits
+TELEMETRY_VALUES = REMOTE_CHANNELS + [
+    "rainRate", "rainfall1h", "windGust", "windMean10Min",
+    "windDirectionMean10Min", "waterVolume",
+]
+TELEMETRY_STATUS = [
+    "moisture", "soilTemp", "ph", "leafTemp", "wetness", "airTemp",
+    "humidity", "light", "wind", "rain", "rainIntensity", "tank", "gas",
+    "airQuality", "co", "motion", "weight",
+]
+TELEMETRY_FLAGS = [
+    "dhtValid", "motion", "lowWater", "gasDanger", "co2Danger", "coDanger",
+    "overloaded",
+]
+FRAME_SNAPSHOT = 0x01
+FRAME_LOG = 0x02
+FRAME_TRACE = 0x03
+TRACE_FILE_HEADER = b"STRC" + bytes([1])  # SensorTrace.h, version 1
+FRAME_HEADER = struct.Struct("<BHI")
+SNAPSHOT_BODY = struct.Struct("<HH%df%dB" % (len(TELEMETRY_VALUES), len(TELEMETRY_STATUS)))
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE (telemetryCrc16 on the ESP32)"""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+def cobs_decode(frame):
+    """One COBS frame without its 0x00 delimiter, or None if malformed"""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame):
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+def decode_frame(frame):
+    """Dashboard message of one telemetry frame, or None if it does not
+    decode. Snapshot values are top-level keys like the JSON the dashboard
+    already takes; log frames become serial lines; trace frames carry a
+    SensorTrace chunk for the trace file (never sent to the dashboard)."""
+    payload = cobs_decode(frame)
+    if payload is None or len(payload) < FRAME_HEADER.size + 2:
+        return None
+    body, crc = payload[:-2], struct.unpack_from("<H", payload, len(payload) - 2)[0]
+    if crc16(body) != crc:
+        return None
+
+    frame_type, seq, uptime = FRAME_HEADER.unpack_from(body)
+    if frame_type == FRAME_LOG:
+        text = body[FRAME_HEADER.size:].decode("utf-8", errors="replace").rstrip()
+        return {"type": "serial", "seq": seq, "uptime": uptime, "data": text}
+    if frame_type == FRAME_TRACE:
+        return {"type": "trace", "seq": seq, "uptime": uptime, "chunk": body[FRAME_HEADER.size:]}
+    if frame_type != FRAME_SNAPSHOT or len(body) != FRAME_HEADER.size + SNAPSHOT_BODY.size:
+        return None
+
+    fields = SNAPSHOT_BODY.unpack_from(body, FRAME_HEADER.size)
+    flags, remote_mask = fields[0], fields[1]
+    values = fields[2:2 + len(TELEMETRY_VALUES)]
+    status = fields[2 + len(TELEMETRY_VALUES):]
+    message = {"type": "telemetry", "seq": seq, "uptime": uptime}
+    message.update({name: round(value, 2) for name, value in zip(TELEMETRY_VALUES, values)})
+    message.update({name: bool(flags & (1 << bit)) for bit, name in enumerate(TELEMETRY_FLAGS)})
+    message["status"] = dict(zip(TELEMETRY_STATUS, status))
+    message["remote"] = [name for bit, name in enumerate(REMOTE_CHANNELS) if remote_mask & (1 << bit)]
+    return message
+
+class TelemetryDecoder:
+    """Splits the byte stream on 0x00 and decodes each frame. Text that is
+    not a frame (boot ROM output before the first delimiter) is passed on as
+    serial lines; damaged frames and sequence gaps are counted."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.expected_seq = None
+        self.frames = 0
+        self.bad_frames = 0
+        self.gaps = 0
+
+    def feed(self, data):
+        """Messages of every frame completed by data"""
+        self.buffer += data
+        messages = []
+        while True:
+            end = self.buffer.find(0)
+            if end < 0:
+                return messages
+            frame = bytes(self.buffer[:end])
+            del self.buffer[:end + 1]
+            if frame:
+                messages.extend(self.decode(frame))
+
+    def decode(self, frame):
+        message = decode_frame(frame)
+        if message is None:
+            text = frame.decode("utf-8", errors="ignore")
+            if text.isprintable() or "\n" in text:
+                return [{"type": "serial", "data": line.strip()}
+                        for line in text.splitlines() if line.strip()]
+            self.bad_frames += 1
+            return []
+
+        self.frames += 1
+        if self.expected_seq is not None and message["seq"] != self.expected_seq:
+            self.gaps += 1
+        self.expected_seq = (message["seq"] + 1) & 0xFFFF
+        return [message]
+
+class TraceWriter:
+    """Trace file of the SensorTrace chunks, for host_replay"""
+
+    def __init__(self, path):
+        self.file = open(path, "wb")
+        self.file.write(TRACE_FILE_HEADER)
+        self.chunks = 0
+
+    def write(self, chunk):
+        self.file.write(struct.pack("<H", len(chunk)) + chunk)
+        self.file.flush()
+        self.chunks += 1
+
+    def close(self):
+        self.file.close()
+
+def decode_capture(path, trace_path=None):
+    """Print every frame of a recorded byte stream (test_telemetry capture);
+    trace chunks go to trace_path if given"""
+    decoder = TelemetryDecoder()
+    trace = TraceWriter(trace_path) if trace_path else None
+    with open(path, "rb") as capture:
+        for message in decoder.feed(capture.read()):
+            if message["type"] == "trace":
+                if trace:
+                    trace.write(message["chunk"])
+                message = {"type": "trace", "seq": message["seq"], "bytes": len(message["chunk"])}
+            print(json.dumps(message))
+    print(f"{decoder.frames} frames, {decoder.bad_frames} bad, {decoder.gaps} sequence gaps",
+          file=sys.stderr)
+    if trace:
+        trace.close()
+        print(f"{trace.chunks} trace chunks written to {trace_path}", file=sys.stderr)
+    return decoder.bad_frames == 0
+
+def encode_command(sensor, value):
+    """Serial bytes of one override: a binary frame for known channels
+    when BINARY_COMMANDS is set, otherwise a JSON line"""
+    if BINARY_COMMANDS and sensor in REMOTE_CHANNELS:
+        payload = struct.pack("<Bf", REMOTE_CHANNELS.index(sensor), float(value))
+        return bytes([COMMAND_SYNC]) + payload + bytes([crc8(payload)])
+    return (json.dumps({"sensor": sensor, "value": value}) + "\n").encode()
 
 class SerialBridge:
     def __init__(self):
         self.serial_conn = None
         self.websocket_clients = set()
+        self.telemetry = TelemetryDecoder()
+        self.trace = None  # TraceWriter when recording (--record)
         
     def find_serial_port(self):
         """Auto-detect ESP32 serial port"""
@@ -82,9 +260,8 @@ class SerialBridge:
                     value = data.get('value', 0)
                     
                     # Send to ESP32 via Serial
-                    json_cmd = json.dumps({"sensor": sensor, "value": value})
                     if self.serial_conn and self.serial_conn.is_open:
-                        self.serial_conn.write((json_cmd + "\n").encode())
+                        self.serial_conn.write(encode_command(sensor, value))
                         print(f"📤 Sent to ESP32: {sensor} = {value}")
                     else:
                         print("⚠️  Serial not connected - command not sent")
@@ -100,11 +277,34 @@ class SerialBridge:
             self.websocket_clients.remove(websocket)
             print(f"🔌 Dashboard disconnected: {client_addr}")
     
+    async def broadcast(self, message):
+        """Forward one message to all connected dashboards"""
+        if self.websocket_clients:
+            message = json.dumps(message)
+            await asyncio.gather(
+                *[client.send(message) for client in self.websocket_clients],
+                return_exceptions=True
+            )
+
+    async def read_telemetry(self):
+        """Decode whatever frames have arrived and forward them"""
+        data = self.serial_conn.read(self.serial_conn.in_waiting)
+        for message in self.telemetry.feed(data):
+            if message["type"] == "trace":
+                if self.trace:
+                    self.trace.write(message["chunk"])
+                continue
+            if message["type"] == "serial":
+                print(f"📥 ESP32: {message['data']}")
+            await self.broadcast(message)
+
     async def read_serial(self):
         """Read from ESP32 and send to dashboard"""
         while True:
             try:
-                if self.serial_conn and self.serial_conn.is_open and self.serial_conn.in_waiting:
+                if self.serial_conn and self.serial_conn.is_open and self.serial_conn.in_waiting and BINARY_TELEMETRY:
+                    await self.read_telemetry()
+                elif self.serial_conn and self.serial_conn.is_open and self.serial_conn.in_waiting:
                     line = self.serial_conn.readline().decode('utf-8', errors='ignore').strip()
                     if line:
                         print(f"📥 ESP32: {line}")
@@ -150,12 +350,21 @@ class SerialBridge:
 
 def main():
     """Main entry point"""
+    global BINARY_TELEMETRY
+    if len(sys.argv) in (3, 4) and sys.argv[1] == "--decode":
+        sys.exit(0 if decode_capture(*sys.argv[2:]) else 1)
+
     print("=" * 60)
     print("  🌾 Smart Farm IoT - Serial Bridge")
     print("  Dashboard ↔ WebSocket ↔ Serial ↔ ESP32")
     print("=" * 60)
     
     bridge = SerialBridge()
+    if len(sys.argv) == 3 and sys.argv[1] == "--record":
+        # Sensor trace from a SENSOR_TRACE build, for host_replay
+        BINARY_TELEMETRY = True
+        bridge.trace = TraceWriter(sys.argv[2])
+        print(f"⏺️  Recording sensor trace to {sys.argv[2]}")
     
     try:
         asyncio.run(bridge.start_server())
@@ -0,0 +1,148 @@
+#ifndef CLOUD_UPLOAD_H
+#define CLOUD_UPLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "data_structures.h"
+#include "flash_log.h"
+#include "node_registry.h"
+
+// ==================== UPLOAD CONFIGURATION ====================
+#define UPLOAD_DOC_MAX 2048            // Largest serialized document (bytes)
+#define UPLOAD_QUEUE_SLOTS 4           // Live snapshots kept in RAM
+#define UPLOAD_RETRY_BASE_MS 2000      // First retry delay, doubled per failure
+#define UPLOAD_RETRY_MAX_MS 60000      // Retry delay ceiling
+#define UPLOAD_BACKLOG_BATCH 6         // Logged records per backlog request
+#define UPLOAD_BACKLOG_INTERVAL_MS 1000  // Minimum gap between backlog requests
+
+// Alert flags published next to the readings
+struct UploadAlerts {
+    bool soilMoistureLow;
+    bool soilDrying;         // Moisture falling fast over the last hour
+    bool gasHigh;
+    bool co2High;
+    bool coHigh;
+    bool waterLow;
+    bool motionDetected;
+};
+
+// Backlog metrics published with every live snapshot
+struct UploadMetrics {
+    uint32_t backlogDepth;   // Logged records waiting for upload
+    float drainRate;         // Records per second of the current/last drain
+};
+
+// Serialize one snapshot as a Firebase multi-path update document
+// ({"sensors/soil/moisture":65.00,...}). Node sections are only included
+// when that node has reported and carry the age of the readings in seconds
+// ("sensors/soil/age"), as nodes only send on change; trends are left out
+// while NaN and metrics are optional. Returns the document length, or 0 if
+// it did not fit into `capacity` bytes.
+size_t buildSensorUpdate(const AllSensorData& data, const UploadAlerts& alerts,
+                         uint32_t timestamp, char* out, size_t capacity,
+                         const UploadMetrics* metrics = nullptr);
+
+// Serialize registered nodes from index `first` on as
+// {"nodes/<mac>":{"type":"soil","age":12,...},
+//  "system/nodes/<mac>":{"lost":3,"rssi":-67,"jitter":4.2,...},...}.
+// Stops at the first node that does not fit; returns the index after the
+// last node written and the document length through `length` (0 when not
+// even one node fit).
+uint16_t buildNodeUpdate(const NodeRegistry& registry, uint16_t first, uint32_t now_ms,
+                         char* out, size_t capacity, size_t& length);
+
+// Serialize logged records as {"history/<id>":{...},...}. Stops at the
+// first record that does not fit; returns how many were written and the
+// document length through `length`.
+size_t buildHistoryUpdate(const LogRecord* records, const uint32_t* ids, size_t count,
+                          char* out, size_t capacity, size_t& length);
+
+// Sends one update document to the cloud. Implemented with the Firebase
+// client on the gateway and with a plain HTTP client on the host.
+class UploadTransport {
+public:
+    virtual ~UploadTransport() {}
+
+    // PATCH `json` at `path`; true when the server accepted it
+    virtual bool update(const char* path, const char* json, size_t length) = 0;
+};
+
+// Upload counters
+struct UploadStats {
+    uint32_t requests;       // Update requests issued
+    uint32_t failures;       // Requests that failed
+    uint32_t dropped;        // Snapshots lost (queue full and no backlog)
+    uint32_t spilled;        // Snapshots moved to the flash backlog
+    uint32_t bytesSent;      // Payload bytes of all requests
+    uint32_t lastBytes;      // Payload bytes of the latest request
+    uint32_t backlogRequests;
+    uint32_t backlogRecords; // Logged records uploaded
+    uint32_t nodeRequests;   // Requests carrying per-node documents
+};
+
+// FIFO of live snapshots with exponential retry backoff, plus an optional
+// flash backlog that is drained oldest first whenever no live snapshot is
+// waiting. With a node registry attached, every snapshot is followed by a
+// sweep over the registered nodes, one page per request. Each call to
+// service() issues at most one request, so a dead link never blocks the
+// caller for more than one request timeout.
+class CloudUploader {
+private:
+    struct Slot {
+        AllSensorData data;
+        UploadAlerts alerts;
+        uint32_t timestamp;
+    };
+
+    UploadTransport* transport;
+    const char* path;
+    FlashRingLog* backlog;
+    const NodeRegistry* registry;
+    uint16_t nodeCursor;     // Next node of the current sweep
+    bool nodeSweep;          // A sweep is due or in progress
+    Slot queue[UPLOAD_QUEUE_SLOTS];
+    uint8_t head;            // Oldest pending snapshot
+    uint8_t count;
+    uint32_t retryDelay_ms;
+    uint32_t nextAttempt_ms;
+    uint32_t nextBacklog_ms;
+    uint32_t drainStart_ms;  // First request of the current drain
+    uint32_t drainEnd_ms;    // Latest successful backlog request
+    uint32_t drainRecords;   // Records uploaded in the current drain
+    bool draining;
+    UploadStats stats;
+    char buffer[UPLOAD_DOC_MAX];  // Document being sent
+
+    bool send(const char* json, size_t length, uint32_t now_ms);
+    bool serviceBacklog(uint32_t now_ms);
+    bool serviceNodes(uint32_t now_ms);
+
+public:
+    // Constructor
+    CloudUploader(UploadTransport* transport, const char* path = "/");
+
+    // Store-and-forward log for snapshots that cannot be sent
+    void attachBacklog(FlashRingLog* backlog);
+
+    // Nodes uploaded under nodes/<mac> after each snapshot
+    void attachRegistry(const NodeRegistry* registry);
+
+    // Queue a live snapshot; the oldest one moves to the backlog when full
+    bool enqueue(const AllSensorData& data, const UploadAlerts& alerts, uint32_t timestamp);
+
+    // Write a snapshot straight to the backlog (link known to be down)
+    bool archive(const AllSensorData& data, uint32_t timestamp);
+
+    // Send the next live snapshot, node page or backlog batch if due (call from loop)
+    void service(uint32_t now_ms);
+
+    // Number of live snapshots waiting to be sent
+    uint8_t getPending() const;
+
+    // Backlog depth and drain throughput
+    UploadMetrics getMetrics() const;
+
+    const UploadStats& getStats() const;
+};
+
+#endif // CLOUD_UPLOAD_H
@@ -0,0 +1,148 @@
+#ifndef DATA_STRUCTURES_H
+#define DATA_STRUCTURES_H
+
+#include <stdint.h>
+
+// ==================== PACKET HEADER ====================
+// Wire format shared by every node (see protocol.h). All multi-byte fields
+// are little-endian, which is the native order of the ESP32.
+struct PacketHeader {
+    uint8_t version;         // PROTOCOL_VERSION of the sender
+    uint8_t nodeId;          // Node identifier (1=Soil, 2=Weather, 3=Gateway)
+    uint8_t packetType;      // Type of data packet (PacketType)
+    uint32_t timestamp;      // Sender uptime in ms (RTC ms on duty-cycled nodes)
+    uint16_t sequence;       // Packet sequence number
+    uint16_t skipped;        // Readings suppressed since the previous packet
+    uint8_t flags;           // PACKET_FLAG_* (see protocol.h)
+    uint8_t checksum;        // CRC-8 over the whole packet, this byte as 0
+} __attribute__((packed));
+
+// ==================== SOIL NODE DATA ====================
+// Fixed-point payload, see the scale of each field
+struct SoilNodeData {
+    PacketHeader header;
+    uint16_t soilMoisture;   // 0-100% in 0.01 %
+    int16_t soilTemp;        // Celsius in 0.01 °C
+    uint16_t soilPH;         // 0-14 in 0.01 pH
+} __attribute__((packed));
+
+// ==================== WEATHER NODE DATA ====================
+struct WeatherNodeData {
+    PacketHeader header;
+    int16_t airTemp;         // Celsius in 0.01 °C
+    uint16_t humidity;       // 0-100% in 0.01 %
+    uint16_t light;          // Lux
+    uint16_t rainfall;       // mm in 0.1 mm
+    uint16_t windSpeed;      // m/s in 0.01 m/s
+    uint16_t windDirection;  // 0-360 degrees
+    int16_t leafTemp;        // Celsius in 0.01 °C
+    uint16_t leafWetness;    // 0-100% in 0.01 %
+    uint16_t windDirection10; // 0-360 degrees, 10-minute vector mean
+    uint16_t windDirStdDev;  // Yamartino sigma over 2 minutes in 0.1 degrees
+    uint16_t rainfall1h;     // mm in 0.1 mm, rolling hour
+    uint16_t rainEvent;      // mm in 0.1 mm, current rain event
+    uint16_t rainRate;       // mm/h in 0.1 mm/h
+} __attribute__((packed));
+
+// ==================== GATEWAY LOCAL DATA ====================
+struct GatewayLocalData {
+    float waterLevel;        // 0-100%
+    bool motion;             // true/false
+    float weight;            // kg
+    uint32_t lastMotionTime; // Timestamp of last motion detection
+} __attribute__((packed));
+
+// ==================== AGGREGATED SENSOR DATA ====================
+struct AllSensorData {
+    // Soil Node Data
+    float soilMoisture;
+    float soilTemp;
+    float soilPH;
+    
+    // Weather Node Data
+    float leafTemp;
+    float leafWetness;
+    float airTemp;
+    float humidity;
+    uint16_t light;
+    float rainfall;          // Rolling 24 h
+    float rainfall1h;        // Rolling hour
+    float rainEvent;         // Current rain event
+    float rainRate;          // mm/h
+    float windSpeed;
+    uint16_t windDirection;   // 2-minute vector mean
+    uint16_t windDirection10; // 10-minute vector mean
+    float windDirStdDev;      // Degrees over 2 minutes
+    
+    // Gateway Local Data
+    uint16_t gas;
+    uint16_t co2;
+    uint16_t co;
+    float waterLevel;
+    bool motion;
+    float weight;
+    
+    // Trends from the gateway's history, NaN until there is one
+    float soilMoisture1h;        // Mean over the last hour
+    float soilMoistureChange1h;  // Change over the last hour
+    float waterLevelChange1h;    // cm
+    
+    // Metadata
+    uint32_t timestamp;
+    bool soilNodeConnected;
+    bool weatherNodeConnected;
+    uint32_t soilUpdated;    // Gateway ms of the latest soil packet
+    uint32_t weatherUpdated; // Gateway ms of the latest weather packet
+};
+
+// ==================== OFFLINE LOG RECORD ====================
+// One AllSensorData snapshot as stored in the gateway's flash log
+// (fixed-point, same scales as the node packets)
+#define LOG_FLAG_SOIL_NODE 0x01
+#define LOG_FLAG_WEATHER_NODE 0x02
+#define LOG_FLAG_MOTION 0x04
+
+struct LogRecord {
+    uint32_t timestamp;      // Gateway uptime in ms when taken
+    uint16_t soilMoisture;   // 0.01 %
+    int16_t soilTemp;        // 0.01 °C
+    uint16_t soilPH;         // 0.01 pH
+    int16_t airTemp;         // 0.01 °C
+    uint16_t humidity;       // 0.01 %
+    uint16_t light;          // Lux
+    uint16_t rainfall;       // 0.1 mm
+    uint16_t windSpeed;      // 0.01 m/s
+    uint16_t windDirection;  // 0-360 degrees
+    int16_t leafTemp;        // 0.01 °C
+    uint16_t leafWetness;    // 0.01 %
+    uint16_t gas;            // PPM
+    uint16_t co2;            // PPM
+    uint16_t co;             // PPM
+    uint16_t waterLevel;     // 0.1 cm
+    int32_t weight;          // Grams
+    uint8_t flags;           // LOG_FLAG_*
+    uint8_t checksum;        // CRC-8 over the preceding bytes
+} __attribute__((packed));  // 40 bytes
+
+// ==================== ALERT STRUCTURE ====================
+struct Alert {
+    char message[64];
+    uint8_t severity;  // 0=Info, 1=Warning, 2=Critical
+    uint32_t timestamp;
+};
+
+// ==================== STATISTICS ====================
+// Link quality of one node as seen by the gateway (see link_stats.h)
+struct NodeStatistics {
+    uint32_t packetsReceived;
+    uint32_t packetsLost;    // Sequence gaps, less packets that arrived late
+    int32_t lastRSSI;        // dBm of the latest packet, 0 = not measured
+    uint32_t uptimeSeconds;
+    uint32_t duplicates;     // Packets received more than once
+    uint32_t restarts;       // Sequence resets (node rebooted)
+    float averageRSSI;       // dBm, exponentially weighted
+    float jitter_ms;         // RFC 3550 inter-arrival jitter
+    float interval_ms;       // Mean time between packets
+};
+
+#endif // DATA_STRUCTURES_H
@@ -0,0 +1,135 @@
+#ifndef DUTY_CYCLE_H
+#define DUTY_CYCLE_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ==================== POWER STATES ====================
+enum PowerState : uint8_t {
+    POWER_SLEEP = 0,        // Deep sleep: RTC timer and RTC memory only
+    POWER_ACTIVE,           // CPU running, radio off (boot, sensor reads)
+    POWER_RADIO,            // WiFi/ESP-NOW up (bring-up, send, waiting for ACK)
+    POWER_STATE_COUNT
+};
+
+// Supply current drawn in each power state
+struct PowerProfile {
+    const char* name;
+    float current_mA[POWER_STATE_COUNT];
+};
+
+// Bare ESP32-WROOM-32 module, datasheet figures
+extern const PowerProfile POWER_PROFILE_WROOM32;
+
+// ESP32 DevKit board: the LDO and USB-UART bridge stay powered in deep sleep
+extern const PowerProfile POWER_PROFILE_DEVKIT;
+
+// ==================== ENERGY LEDGER ====================
+#define ENERGY_LEDGER_MAGIC 0x454E5247  // "ENRG"
+
+// Time spent in each power state. Plain data, so a duty-cycled node can
+// keep it in RTC memory and account every wake; the host model fills the
+// same struct from estimated phase durations.
+struct EnergyLedger {
+    uint32_t magic;
+    uint32_t wakes;
+    uint32_t transmissions;             // Radio sessions
+    uint32_t packets;                   // Packets handed to the radio
+    uint64_t time_us[POWER_STATE_COUNT];
+};
+
+// Clear all counters
+void energyReset(EnergyLedger* ledger);
+
+// Keep a ledger with a valid magic, reset it otherwise; true if kept
+bool energyRestore(EnergyLedger* ledger);
+
+// Add time spent in one state
+void energyAccount(EnergyLedger* ledger, PowerState state, uint64_t duration_us);
+
+// Time covered by the ledger
+uint64_t energyTotalTime_us(const EnergyLedger* ledger);
+
+// Charge drawn over the ledger's time under a power profile
+float energyCharge_mAh(const EnergyLedger* ledger, const PowerProfile* profile);
+
+// Time-weighted average current (0 for an empty ledger)
+float energyAverageCurrent_mA(const EnergyLedger* ledger, const PowerProfile* profile);
+
+// Battery life at the ledger's average current (0 for an empty ledger)
+float energyBatteryLife_days(const EnergyLedger* ledger, const PowerProfile* profile, float capacity_mAh);
+
+// ==================== READING BATCH ====================
+// Sealed packets held between wakes until the next radio session, oldest
+// first. A plain aggregate on purpose: in RTC_DATA_ATTR memory a
+// constructor would run on every wake and empty the batch, while the
+// zero-initialised storage of a cold boot is already an empty batch.
+template <typename Packet, uint8_t Capacity>
+struct ReadingBatch {
+    uint8_t count;
+    Packet packets[Capacity];
+
+    bool full() const {
+        return count >= Capacity;
+    }
+
+    // Append a packet; a full batch drops its oldest one (returns false)
+    bool push(const Packet& packet) {
+        bool kept = true;
+        if (count >= Capacity) {
+            memmove(&packets[0], &packets[1], sizeof(Packet) * (Capacity - 1));
+            count = Capacity - 1;
+            kept = false;
+        }
+        packets[count++] = packet;
+        return kept;
+    }
+
+    // Drop the oldest n packets (the ones delivered)
+    void consume(uint8_t n) {
+        if (n >= count) {
+            count = 0;
+            return;
+        }
+        memmove(&packets[0], &packets[n], sizeof(Packet) * (count - n));
+        count -= n;
+    }
+
+    void clear() {
+        count = 0;
+    }
+};
+
+// ==================== SEND POLICY ====================
+// Band of a value against an alert range: -1 below low, 0 inside, 1 above high
+inline int8_t thresholdBand(float value, float low, float high) {
+    if (value < low) return -1;
+    if (value > high) return 1;
+    return 0;
+}
+
+// Store the band of a new reading; true if it left the previous band,
+// which sends the batch right away instead of waiting for it to fill
+inline bool thresholdCrossed(int8_t* band, float value, float low, float high) {
+    int8_t now = thresholdBand(value, low, high);
+    bool crossed = now != *band;
+    *band = now;
+    return crossed;
+}
+
+// Longest the gateway goes without a radio session: one full batch of
+// wakes, and never less than `minSilence_ms`. Also the report filter's
+// max silence, so a heartbeat reading is due about when the session is.
+constexpr uint32_t batchMaxSilence_ms(uint32_t sleep_ms, uint8_t batchSize, uint32_t minSilence_ms) {
+    return sleep_ms * batchSize > minSilence_ms ? sleep_ms * batchSize : minSilence_ms;
+}
+
+// True when the batched readings go out this wake: the batch is full, a
+// threshold was crossed, or the last radio session is `maxSilence_ms`
+// old. Heartbeat readings are batched like any other.
+inline bool batchSendDue(uint8_t count, uint8_t batchSize, bool crossed, uint32_t sinceSession_ms,
+                         uint32_t maxSilence_ms) {
+    return count > 0 && (count >= batchSize || crossed || sinceSession_ms >= maxSilence_ms);
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "data_structures.h"
+
+// ==================== FLASH LAYOUT ====================
+// The log area is a ring of erase sectors. Each sector starts with a
+// header carrying a sequence number, followed by fixed-size record slots.
+// Sectors are filled in physical order and erased once every record in
+// them has been uploaded, so every sector sees the same number of erase
+// cycles (wear levelling by construction). Slot states only ever clear
+// bits, so no erase is needed to append or to mark a record uploaded:
+//
+//   0xFF  free
+//   0x7F  being written (power loss here leaves a slot that is skipped)
+//   0x3F  valid, waiting for upload
+//   0x1F  uploaded
+#define FLASH_LOG_MAGIC 0x474F4C46UL   // "FLOG"
+#define FLASH_LOG_SECTOR_HEADER 16
+#define FLASH_LOG_SLOT_SIZE 44         // Status byte + LogRecord, 4-byte aligned
+
+// Raw flash area backing the log (a partition on the ESP32, RAM on the host).
+// Writes may only clear bits; erase() sets a whole sector back to 0xFF.
+class LogStorage {
+public:
+    virtual ~LogStorage() {}
+
+    virtual uint32_t sectorSize() = 0;
+    virtual uint32_t sectorCount() = 0;
+    virtual bool read(uint32_t address, void* data, size_t length) = 0;
+    virtual bool write(uint32_t address, const void* data, size_t length) = 0;
+    virtual bool erase(uint32_t sector) = 0;
+};
+
+// Log counters
+struct FlashLogStats {
+    uint32_t appended;       // Records written
+    uint32_t consumed;       // Records marked uploaded
+    uint32_t dropped;        // Unsent records lost because the log was full
+    uint32_t erases;         // Sector erases
+    uint32_t corrupt;        // Slots skipped for a bad state or checksum
+};
+
+// Append-only ring log of LogRecords in flash
+class FlashRingLog {
+private:
+    LogStorage* storage;
+    uint32_t sectors;
+    uint32_t slotsPerSector;
+
+    uint32_t headSector;     // Sector being appended to
+    uint32_t headSlot;       // Next free slot in headSector
+    uint32_t headSequence;   // Sequence number of headSector
+    uint32_t tailSector;     // Sector holding the oldest unsent record
+    uint32_t tailSlot;
+    uint32_t depth;          // Records waiting for upload
+    bool ready;
+    FlashLogStats stats;
+
+    uint32_t slotAddress(uint32_t sector, uint32_t slot);
+    uint8_t readStatus(uint32_t sector, uint32_t slot);
+    bool readSequence(uint32_t sector, uint32_t& sequence);
+    uint32_t sectorSequence(uint32_t sector);
+    bool startSector(uint32_t sector, uint32_t sequence);
+    void advanceTail();
+    void releaseSector(uint32_t sector);
+
+public:
+    // Constructor
+    FlashRingLog(LogStorage* storage);
+
+    // Scan the flash and recover head, tail and depth
+    bool begin();
+
+    // Append a snapshot; overwrites the oldest sector when full
+    bool append(const LogRecord& record);
+
+    // Copy up to `max` of the oldest unsent records, without consuming them.
+    // `ids` (optional) receives a per-record id that increases across reboots.
+    size_t peek(LogRecord* records, uint32_t* ids, size_t max);
+
+    // Mark the `count` oldest unsent records as uploaded
+    void consume(size_t count);
+
+    // Records waiting for upload
+    uint32_t getDepth() const;
+
+    // Records the log can hold
+    uint32_t getCapacity() const;
+
+    const FlashLogStats& getStats() const;
+};
+
+// Convert between a snapshot and its compact flash form
+LogRecord toLogRecord(const AllSensorData& data, uint32_t timestamp);
+void fromLogRecord(const LogRecord& record, AllSensorData& data);
+
+#endif // FLASH_LOG_H
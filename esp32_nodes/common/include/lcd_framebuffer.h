@@ -0,0 +1,71 @@
+#ifndef LCD_FRAMEBUFFER_H
+#define LCD_FRAMEBUFFER_H
+
+#include <stdint.h>
+
+// ==================== LCD FRAMEBUFFER ====================
+#define LCD_FB_COLUMNS 20
+#define LCD_FB_ROWS 4
+#define LCD_FB_CELLS (LCD_FB_COLUMNS * LCD_FB_ROWS)
+#define LCD_FB_MERGE_GAP 1              // Clean cells rewritten to join two runs
+
+// Where a framebuffer sends its changes: HD44780 set-DDRAM-address and
+// character writes. The display driver provides it.
+class LcdSink {
+public:
+    virtual ~LcdSink() {}
+    virtual void setAddress(uint8_t address) = 0;
+    virtual void write(uint8_t c) = 0;
+};
+
+struct LcdFramebufferStats {
+    uint32_t flushes;
+    uint32_t cellsSent;                 // Characters written to the panel
+    uint32_t cursorMoves;               // Set-address commands
+    uint32_t lastCells;                 // Characters of the latest flush
+};
+
+// Shadow copy of a 20x4 character LCD. Drawing only touches RAM; flush()
+// sends the cells that differ from what the panel shows, as runs in DDRAM
+// order (rows 0, 2, 1, 3), so a run that ends a row continues into the
+// next and the cursor is only moved when a run starts elsewhere. Text is
+// clipped at the row end.
+class LcdFramebuffer {
+private:
+    char frame[LCD_FB_CELLS];           // Wanted content, DDRAM order
+    char shown[LCD_FB_CELLS];           // What the panel shows
+    bool shownValid;                    // False until the panel content is known
+    uint8_t cursor;                     // Cell the panel's address counter points at
+    uint8_t drawCell;                   // Next cell print() writes
+    uint8_t drawEnd;                    // End of the row being printed
+    LcdFramebufferStats stats;
+
+    static uint8_t cellIndex(uint8_t column, uint8_t row);
+    static uint8_t cellAddress(uint8_t cell);
+
+public:
+    // Constructor; the panel content is unknown until panelCleared()
+    LcdFramebuffer();
+
+    // Drawing (no bus traffic)
+    void clear();
+    void setCursor(uint8_t column, uint8_t row);
+    void print(const char* text);
+    void printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    // Send the cells that changed since the last flush; returns their count
+    uint8_t flush(LcdSink& sink);
+
+    // The driver blanked the panel and homed the cursor (init, clear)
+    void panelCleared();
+
+    // Resend every cell on the next flush (panel content unknown)
+    void invalidate();
+
+    // Character the framebuffer holds at a position
+    char getCell(uint8_t column, uint8_t row) const;
+
+    const LcdFramebufferStats& getStats() const;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef LINK_STATS_H
+#define LINK_STATS_H
+
+#include <stdint.h>
+#include "data_structures.h"
+
+// ==================== LINK TRACKING ====================
+#define LINK_WINDOW 32                  // Sequence numbers remembered behind the newest
+#define LINK_JITTER_GAIN 16.0f          // RFC 3550 jitter smoothing (1/16)
+#define LINK_AVERAGE_GAIN 8.0f          // Smoothing of RSSI and interval (1/8)
+
+// What a received sequence number turned out to be
+enum LinkEvent : uint8_t {
+    LINK_FIRST = 0,                     // First packet of the node
+    LINK_NEXT,                          // Newer than any so far (gaps count as lost)
+    LINK_LATE,                          // Missing one arriving late; no longer lost
+    LINK_DUPLICATE,                     // Already received (a retransmission)
+    LINK_RESTART                        // Sequence started over: the node rebooted
+};
+
+// Short name of an event for logs
+const char* linkEventName(LinkEvent event);
+
+// Per-node sequence window and timing reference. Zero-initialised state
+// has seen nothing.
+struct LinkTracker {
+    uint16_t newest;                    // Highest sequence number received
+    uint8_t primed;
+    uint8_t lastEvent;                  // LinkEvent of the latest packet
+    uint32_t window;                    // Bit n: sequence newest - n received
+    uint32_t lastArrival_ms;            // Receiver clock of `newest`
+    uint32_t lastSent_ms;               // Sender timestamp of `newest`
+};
+
+// Account one validated packet in `stats`: received, lost (sequence gaps,
+// reduced again by late arrivals), duplicates, restarts, RSSI (0 = not
+// measured), mean interval and the RFC 3550 inter-arrival jitter between
+// sender timestamps and arrival times. Duplicates only bump their counter.
+LinkEvent linkRecord(LinkTracker& link, NodeStatistics& stats, uint16_t sequence,
+                     uint32_t sent_ms, uint32_t arrival_ms, int8_t rssi);
+
+// Share of sent packets that never arrived, 0..1
+float linkLossRate(const NodeStatistics& stats);
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef NODE_REGISTRY_H
+#define NODE_REGISTRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "data_structures.h"
+#include "link_stats.h"
+
+// ==================== REGISTRY SIZING ====================
+#define REGISTRY_MAX_NODES 64
+#define REGISTRY_SLOTS 128              // Power of two; load factor stays at or below 1/2
+#define REGISTRY_KEY_LENGTH 13          // "AABBCCDDEEFF" plus terminator
+
+// Latest validated packet of a node, kept as received
+union NodePacket {
+    PacketHeader header;
+    SoilNodeData soil;
+    WeatherNodeData weather;
+};
+
+// Everything the gateway knows about one sender
+struct NodeEntry {
+    uint8_t mac[6];
+    bool used;
+    uint8_t nodeType;                   // NODE_ID_* of the latest packet
+    uint32_t firstHeard_ms;
+    uint32_t lastHeard_ms;
+    uint32_t readings;                  // Packets plus the readings the node suppressed
+    uint32_t heartbeats;                // Packets sent only because of max silence
+    NodeStatistics stats;
+    LinkTracker link;
+    NodePacket packet;
+};
+
+// ==================== NODE REGISTRY ====================
+// Senders keyed by MAC address in an open-addressing table with linear
+// probing, so a packet finds its node in O(1) on average. The caller owns
+// the storage: `slots` must hold `slotCount` entries (a power of two) and
+// `order` maxNodes indices. Nodes are never removed; once maxNodes are
+// registered, packets from new senders are counted and refused.
+class NodeRegistry {
+private:
+    NodeEntry* slots;
+    uint16_t* order;                    // Slot of each node in registration order
+    uint16_t mask;
+    uint16_t maxNodes;
+    uint16_t count;
+    uint32_t rejected;
+    uint32_t lookups;
+    uint32_t probes;
+
+    static uint32_t hashMac(const uint8_t* mac);
+
+public:
+    // Constructor; clears the storage
+    NodeRegistry(NodeEntry* slots, uint16_t slotCount, uint16_t* order, uint16_t maxNodes);
+
+    // Forget every node
+    void clear();
+
+    // Take over every node and counter of `other`, e.g. to work on a copy
+    // while the original keeps receiving. False (nothing copied) when the
+    // slot counts differ.
+    bool copyFrom(const NodeRegistry& other);
+
+    // Entry of a known sender, or nullptr
+    NodeEntry* find(const uint8_t* mac);
+
+    // Entry of a sender, registered on first contact; nullptr when full
+    NodeEntry* findOrAdd(const uint8_t* mac, uint32_t now_ms);
+
+    // Account a validated packet in the node's link statistics and keep it
+    // as the latest unless it is a duplicate or arrived late (see
+    // link.lastEvent). `rssi` is 0 when not measured. nullptr when the
+    // registry is full.
+    NodeEntry* record(const uint8_t* mac, const uint8_t* packet, size_t length, uint32_t now_ms,
+                      int8_t rssi = 0);
+
+    // Registered nodes, in registration order
+    uint16_t size() const;
+    NodeEntry& at(uint16_t index);
+    const NodeEntry& at(uint16_t index) const;
+
+    // Packets refused because the registry was full
+    uint32_t getRejected() const;
+
+    // Mean slots inspected per lookup since the last clear()
+    float getAverageProbes() const;
+};
+
+// MAC as 12 upper-case hex digits, used as the node key in the cloud
+void formatNodeKey(const uint8_t* mac, char* out);
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "data_structures.h"
+
+// ==================== PROTOCOL VERSION ====================
+// Bump when the layout of PacketHeader or any payload changes
+#define PROTOCOL_VERSION 5
+
+// ESP-NOW frame payload limit
+#define PROTOCOL_MAX_PACKET 250
+
+// ==================== NODE IDS ====================
+#define NODE_ID_SOIL 1
+#define NODE_ID_WEATHER 2
+#define NODE_ID_GATEWAY 3
+
+// ==================== PACKET TYPES ====================
+enum PacketType {
+    PACKET_INVALID = 0,
+    PACKET_SOIL_DATA = 1,
+    PACKET_WEATHER_DATA = 2,
+    PACKET_PAIR = 3,               // Gateway -> nodes, header only: "unicast to me"
+    PACKET_TYPE_COUNT
+};
+
+// ==================== HEADER FLAGS ====================
+#define PACKET_FLAG_HEARTBEAT 0x01 // Sent because of max silence, nothing changed
+#define PACKET_FLAG_PAIRING 0x02   // Broadcast by a node without a gateway address
+
+// ==================== VALIDATION RESULT ====================
+// protocolValidate() returns 0 or a combination of these flags
+#define PACKET_OK 0x00
+#define PACKET_ERR_SHORT 0x01      // Shorter than a header
+#define PACKET_ERR_VERSION 0x02    // Unknown protocol version
+#define PACKET_ERR_TYPE 0x04       // Unknown packet type
+#define PACKET_ERR_LENGTH 0x08     // Length does not match the packet type
+#define PACKET_ERR_CHECKSUM 0x10   // CRC mismatch
+
+// ==================== FIXED-POINT SCALES ====================
+#define FIXED_CENTI 100.0f         // 0.01 resolution
+#define FIXED_DECI 10.0f           // 0.1 resolution
+
+// Encode a float into a saturated fixed-point integer
+int16_t toFixedS16(float value, float scale);
+uint16_t toFixedU16(float value, float scale);
+
+// Decode a fixed-point integer
+inline float fromFixed(int32_t value, float scale) {
+    return value / scale;
+}
+
+// Expected total size of a packet type, 0 for unknown types
+uint8_t protocolPacketSize(uint8_t packetType);
+
+// CRC-8 (poly 0x07) over a buffer
+uint8_t crc8(const uint8_t* data, size_t length);
+
+// CRC-8 (poly 0x07) over a packet, treating the checksum byte as 0
+uint8_t protocolChecksum(const uint8_t* packet, size_t length);
+
+// Fill in the header of an outgoing packet and seal it with the checksum.
+// `length` is the full packet size including the header. `skipped` and
+// `flags` are kept as the caller set them.
+void protocolSeal(PacketHeader* header, size_t length, uint8_t nodeId,
+                  uint8_t packetType, uint16_t sequence, uint32_t timestamp);
+
+// Validate a received packet. Every check is evaluated and folded into the
+// result without early exits, so the cost does not depend on where a
+// corrupted packet fails.
+uint8_t protocolValidate(const uint8_t* packet, int length);
+
+#endif // PROTOCOL_H
@@ -0,0 +1,61 @@
+#ifndef RAIN_GAUGE_H
+#define RAIN_GAUGE_H
+
+#include <stdint.h>
+
+// ==================== GAUGE CONSTANTS ====================
+#define RAIN_STATE_MAGIC 0x5241494E     // "RAIN"
+#define RAIN_RECENT_TIPS 16             // Tip times kept for intensity
+#define RAIN_INTENSITY_WINDOW_S 600     // Intensity looks back 10 minutes
+#define RAIN_EVENT_GAP_S 21600          // 6 h without tips ends an event
+
+// Persisted tipping-bucket counters, all times in RTC seconds. Meant to
+// live in RTC_NOINIT_ATTR memory: it survives deep sleep and resets and
+// is validated by magic and checksum on boot.
+struct RainGaugeState {
+    uint32_t magic;
+    uint32_t totalTips;
+    uint32_t eventTips;
+    uint32_t eventStart;
+    uint32_t lastTip;
+    uint32_t minute;                    // Minute of the newest minute bucket
+    uint32_t hour;                      // Hour of the newest hour bucket
+    uint16_t minuteTips[60];
+    uint16_t hourTips[24];
+    uint32_t recentTips[RAIN_RECENT_TIPS];
+    uint16_t recentHead;                // Next recent entry to overwrite
+    uint16_t recentCount;
+    uint32_t checksum;
+};
+
+// Rainfall totals derived from timestamped bucket tips: rolling 1 h
+// (minute buckets), rolling 24 h (hour buckets), the current event and
+// a sliding-window intensity. Buckets advance lazily with elapsed time.
+class RainGauge {
+private:
+    RainGaugeState* state;
+    float mmPerTip;
+
+    void advance(uint32_t now);
+    uint32_t checksum() const;
+    void seal();
+
+public:
+    RainGauge(RainGaugeState* state, float mmPerTip);
+
+    // Keep valid retained state, clear it otherwise; true if restored
+    bool restore();
+    void clear();
+
+    // Record one tip at RTC time `time` (seconds)
+    void addTip(uint32_t time);
+
+    // Totals (mm) and intensity (mm/h) at RTC time `now`
+    float lastHour(uint32_t now);
+    float last24h(uint32_t now);
+    float event(uint32_t now) const;     // 0 once the event has ended
+    float intensity(uint32_t now) const;
+    uint32_t totalTips() const;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef REPORT_FILTER_H
+#define REPORT_FILTER_H
+
+#include <stdint.h>
+
+// ==================== SEND-ON-CHANGE ====================
+#define REPORT_MAX_CHANNELS 8
+#define REPORT_MAX_SILENCE_MS 600000    // Default heartbeat: 10 minutes
+
+// One reported channel. A reading is news once it is more than `deadband`
+// away from the value last sent; circular channels (degrees) compare the
+// shorter way round.
+struct ReportChannel {
+    const char* name;
+    float deadband;
+    bool circular;
+};
+
+// Why a reading was sent (or not)
+enum ReportDecision : uint8_t {
+    REPORT_SUPPRESS = 0,                // Every channel inside its deadband
+    REPORT_FIRST,                       // Nothing sent yet
+    REPORT_CHANGE,                      // A channel moved past its deadband
+    REPORT_HEARTBEAT,                   // Max silence reached
+    REPORT_FORCED                       // Caller asked for it (e.g. an alert)
+};
+
+// Short name of a decision for logs
+const char* reportDecisionName(ReportDecision decision);
+
+// Filter state. Plain data so a duty-cycled node can keep it in RTC
+// memory; zero-initialised state has sent nothing, so the first reading
+// always goes out.
+struct ReportFilterState {
+    float lastSent[REPORT_MAX_CHANNELS];
+    uint32_t lastSendTime;              // ms, caller's clock
+    uint32_t samples;                   // Readings evaluated
+    uint32_t sent;                      // Readings sent (any reason)
+    uint32_t heartbeats;                // Sent only because of max silence
+    uint16_t skipped;                   // Suppressed since the last send
+    uint16_t skippedBeforeSend;         // `skipped` as it was at the last send
+    uint8_t primed;
+    int8_t trigger;                     // Channel that caused the last change send
+};
+
+// Per-channel deadband filter with a heartbeat. Values are passed in
+// channel order.
+class ReportFilter {
+private:
+    ReportFilterState* state;
+    const ReportChannel* channels;
+    uint8_t count;
+    uint32_t maxSilence_ms;
+
+public:
+    // Constructor; count is clamped to REPORT_MAX_CHANNELS
+    ReportFilter(ReportFilterState* state, const ReportChannel* channels, uint8_t count,
+                 uint32_t maxSilence_ms = REPORT_MAX_SILENCE_MS);
+
+    // Judge one reading. Anything but REPORT_SUPPRESS means send it; its
+    // values then become the reference for the deadbands. `force` sends a
+    // reading the deadbands would have suppressed.
+    ReportDecision evaluate(const float* values, uint32_t now_ms, bool force = false);
+
+    // Readings suppressed before the one last sent (goes into the packet)
+    uint16_t getSkipped() const;
+
+    // Name of the channel behind the last REPORT_CHANGE
+    const char* getTriggerName() const;
+
+    uint32_t getSamples() const;
+    uint32_t getSent() const;
+    uint32_t getHeartbeats() const;
+
+    // Share of readings that were not sent
+    float getSuppressionRatio() const;
+};
+
+#endif
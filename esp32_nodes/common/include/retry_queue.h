@@ -0,0 +1,86 @@
+#ifndef RETRY_QUEUE_H
+#define RETRY_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "protocol.h"
+
+// ==================== RETRY CONFIGURATION ====================
+#define RETRY_QUEUE_SLOTS 4
+#define RETRY_BASE_DELAY_MS 200         // Backoff before the first retry
+#define RETRY_MAX_DELAY_MS 5000         // Backoff cap
+
+struct RetryStats {
+    uint32_t queued;                    // Packets pushed
+    uint32_t attempts;                  // Transmissions, first tries included
+    uint32_t retries;                   // Transmissions after a failed one
+    uint32_t delivered;                 // Acknowledged by the receiver
+    uint32_t superseded;                // Replaced by a newer reading while waiting
+    uint32_t expired;                   // Given up after maxRetry retries
+    uint32_t overflow;                  // Oldest dropped because the queue was full
+};
+
+// ==================== RETRY QUEUE ====================
+// FIFO of sealed packets waiting for a link-layer acknowledgement. One
+// packet is on the air at a time; a failed one is retried after an
+// exponential backoff with jitter, so nodes that failed together do not
+// retry in lockstep, and dropped after maxRetry retries.
+//
+// A newer reading supersedes a waiting packet of the same type: it takes
+// the old packet's place and retry schedule. If the old packet never went
+// out, the new one is resealed with the old sequence number and the old
+// readings added to its `skipped`, so the gateway sees no sequence gap
+// (it would count one as lost); push() returns true and the caller hands
+// the new packet's own number out again. A packet that went out keeps
+// its number: the gateway either has it or lost it on the air.
+class RetryQueue {
+private:
+    struct Slot {
+        uint8_t data[PROTOCOL_MAX_PACKET];
+        uint8_t length;
+        uint8_t attempts;               // Transmissions so far
+        uint32_t due_ms;
+    };
+
+    Slot slots[RETRY_QUEUE_SLOTS];
+    uint8_t head;
+    uint8_t count;
+    bool inFlight;                      // Head handed out by next(), no result yet
+    uint8_t maxRetry;
+    uint32_t baseDelay_ms;
+    uint32_t maxDelay_ms;
+    uint32_t random;                    // xorshift32 state for the jitter
+    RetryStats stats;
+
+    void pop();
+
+public:
+    // Constructor; seed the jitter differently on every node
+    RetryQueue(uint8_t maxRetry, uint32_t baseDelay_ms = RETRY_BASE_DELAY_MS,
+               uint32_t maxDelay_ms = RETRY_MAX_DELAY_MS, uint32_t seed = 1);
+
+    // Queue a sealed packet, due at once unless it supersedes one. True if
+    // it took the sequence number of a packet that never went out, so its
+    // own number is unused.
+    bool push(const uint8_t* packet, size_t length, uint32_t now_ms);
+
+    // Packet to transmit now, or nullptr (nothing due, or one on the air)
+    const uint8_t* next(uint32_t now_ms, size_t& length);
+
+    // Result of the transmission handed out by next()
+    void complete(bool delivered, uint32_t now_ms);
+
+    // Jittered delay before retry number `attempt` (1 = first retry):
+    // uniform in [d/2, d] with d = base * 2^(attempt-1), capped
+    uint32_t backoff(uint8_t attempt);
+
+    // Packets waiting, the one on the air included
+    uint8_t size() const;
+
+    // A transmission is waiting for its result
+    bool busy() const;
+
+    const RetryStats& getStats() const;
+};
+
+#endif
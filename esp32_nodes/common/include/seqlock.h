@@ -0,0 +1,62 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// ==================== SEQLOCK ====================
+// Snapshot of a plain-data value with one writer and any number of
+// readers, none of which ever blocks the writer.
+//
+// The writer makes the sequence odd, copies the value in and makes it
+// even again; a reader copies the value out and retries if the sequence
+// was odd or changed meanwhile. A reader therefore only spins while a
+// write is in progress, so it must not preempt the writer on the same
+// core (run readers at a lower priority there, or on the other core).
+template <typename T>
+class Seqlock {
+private:
+    T value;
+    std::atomic<uint32_t> sequence;  // Odd while a write is in progress
+    mutable std::atomic<uint32_t> retries;
+
+public:
+    Seqlock() : value(), sequence(0), retries(0) {}
+
+    // Publish a new value (writer only)
+    void write(const T& next) {
+        uint32_t s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy((void*)&value, &next, sizeof(T));
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+    // Consistent copy of the latest value
+    void read(T& out) const {
+        while (true) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                memcpy((void*)&out, &value, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) {
+                    return;
+                }
+            }
+            retries.store(retries.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+    // Number of values published so far
+    uint32_t getVersion() const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+    // Reads that had to start over because of a concurrent write
+    uint32_t getRetries() const {
+        return retries.load(std::memory_order_relaxed);
+    }
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// ==================== SPSC RING BUFFER ====================
+// Lock-free ring of fixed-size slots for exactly one producer (e.g. the
+// ESP-NOW receive callback on the WiFi task) and one consumer (the task that decodes).
+//
+// The producer fills a slot in place between acquireWrite() and
+// commitWrite(); the consumer reads it in place between peek() and
+// release(). Head and tail are free-running counters, so a full ring
+// keeps all N slots in use. Each index is written by one side only and
+// published with release ordering, which makes the slot contents visible
+// before the index that hands them over.
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> head;      // Next slot to write (producer)
+    std::atomic<uint32_t> tail;      // Next slot to read (consumer)
+    std::atomic<uint32_t> dropped;   // Writes refused because the ring was full
+
+public:
+    SpscRing() : head(0), tail(0), dropped(0) {}
+
+    // ---------- Producer side ----------
+
+    // Slot to fill, or nullptr (and the drop is counted) when full
+    T* acquireWrite() {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &slots[h & (N - 1)];
+    }
+
+    // Publish the slot returned by acquireWrite()
+    void commitWrite() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // ---------- Consumer side ----------
+
+    // Oldest unread slot, or nullptr when empty
+    const T* peek() const {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) {
+            return nullptr;
+        }
+        return &slots[t & (N - 1)];
+    }
+
+    // Hand the slot returned by peek() back to the producer
+    void release() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // ---------- Either side ----------
+
+    // Number of unread slots (a snapshot)
+    size_t size() const {
+        // Tail first: head only moves forward, so the difference never underflows
+        uint32_t t = tail.load(std::memory_order_acquire);
+        return head.load(std::memory_order_acquire) - t;
+    }
+
+    size_t capacity() const {
+        return N;
+    }
+
+    uint32_t getDropped() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,209 @@
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "data_structures.h"
+
+// ==================== STORE SIZING ====================
+// Raw samples per channel: TS_BLOCKS_PER_CHANNEL compressed blocks of
+// TS_BLOCK_BYTES each; the oldest block is recycled when all are full.
+// Slowly changing readings compress to a few bits per sample, so 1 KB
+// holds several hundred samples. This full layout (~63 KB for all
+// channels) is used in PSRAM; without PSRAM the compact layout below
+// (~25 KB) goes into internal RAM next to WiFi and TLS.
+#ifndef TS_BLOCK_BYTES
+#define TS_BLOCK_BYTES 256
+#endif
+#ifndef TS_BLOCKS_PER_CHANNEL
+#define TS_BLOCKS_PER_CHANNEL 4
+#endif
+
+// Rollup buckets kept per channel and resolution
+#ifndef TS_MINUTE_BUCKETS
+#define TS_MINUTE_BUCKETS 60           // 1 hour of 1-minute rollups
+#endif
+#ifndef TS_QUARTER_BUCKETS
+#define TS_QUARTER_BUCKETS 32          // 8 hours of 15-minute rollups
+#endif
+#ifndef TS_HOUR_BUCKETS
+#define TS_HOUR_BUCKETS 48             // 2 days of 1-hour rollups
+#endif
+
+// Compact layout for boards without PSRAM
+#ifndef TS_COMPACT_BLOCKS_PER_CHANNEL
+#define TS_COMPACT_BLOCKS_PER_CHANNEL 2
+#endif
+#ifndef TS_COMPACT_MINUTE_BUCKETS
+#define TS_COMPACT_MINUTE_BUCKETS 15   // 15 minutes of 1-minute rollups
+#endif
+#ifndef TS_COMPACT_QUARTER_BUCKETS
+#define TS_COMPACT_QUARTER_BUCKETS 8   // 2 hours of 15-minute rollups
+#endif
+#ifndef TS_COMPACT_HOUR_BUCKETS
+#define TS_COMPACT_HOUR_BUCKETS 24     // 1 day of 1-hour rollups
+#endif
+
+// ==================== CHANNELS ====================
+enum TsChannel {
+    TS_SOIL_MOISTURE = 0,
+    TS_SOIL_TEMP,
+    TS_SOIL_PH,
+    TS_AIR_TEMP,
+    TS_HUMIDITY,
+    TS_LIGHT,
+    TS_RAINFALL,
+    TS_WIND_SPEED,
+    TS_WIND_DIRECTION,
+    TS_LEAF_TEMP,
+    TS_LEAF_WETNESS,
+    TS_WATER_LEVEL,
+    TS_GAS,
+    TS_CO2,
+    TS_CO,
+    TS_WEIGHT,
+    TS_CHANNEL_COUNT
+};
+
+enum TsResolution {
+    TS_MINUTE = 0,
+    TS_QUARTER_HOUR,
+    TS_HOUR,
+    TS_RESOLUTION_COUNT
+};
+
+// One raw sample
+struct TsPoint {
+    uint32_t time;           // ms (gateway uptime)
+    float value;
+};
+
+// Aggregate over a time range
+struct TsRollup {
+    uint32_t start;          // Bucket start (ms)
+    float min;
+    float max;
+    float mean;
+    uint32_t count;
+};
+
+// Memory use and compression
+struct TsStats {
+    uint32_t samples;        // Samples currently held in raw blocks
+    uint32_t bytesUsed;      // Compressed bytes holding them
+    uint32_t blocksRecycled; // Raw blocks overwritten with older history
+    uint32_t bytesAllocated; // Whole store, 0 before begin()
+};
+
+// Raw blocks and rollup buckets kept per channel
+struct TsLayout {
+    uint8_t blocksPerChannel;
+    uint16_t buckets[TS_RESOLUTION_COUNT];  // Per TsResolution
+};
+
+extern const TsLayout TS_FULL_LAYOUT;
+extern const TsLayout TS_COMPACT_LAYOUT;
+
+// Columnar in-memory time-series store with one compressed raw series and
+// three rollup levels per channel. Timestamps are delta-of-delta encoded
+// and values XOR-encoded against the previous sample (Gorilla style).
+// Samples must arrive in time order per channel; late samples are dropped.
+class TimeSeriesStore {
+private:
+    // Compressed run of samples; the header keeps the encoder state so
+    // the newest block can keep growing
+    struct Block {
+        uint32_t firstTime;
+        uint32_t lastTime;
+        int32_t lastDelta;
+        uint32_t lastBits;       // Previous value as IEEE-754 bits
+        uint16_t count;
+        uint16_t bitLength;
+        uint8_t leading;         // XOR window of the previous value
+        uint8_t trailing;
+        uint8_t data[TS_BLOCK_BYTES];
+    };
+
+    struct Bucket {
+        uint32_t start;
+        float min;
+        float max;
+        float sum;
+        uint32_t count;
+    };
+
+    struct RollupRing {
+        Bucket* buckets;
+        uint16_t capacity;
+        uint16_t head;           // Newest bucket
+        uint16_t count;
+    };
+
+    // Blocks and buckets point into the same allocation as the channels
+    struct Channel {
+        Block* blocks;
+        uint8_t newest;
+        uint8_t used;
+        bool hasLatest;
+        TsPoint latest;
+        RollupRing rollups[TS_RESOLUTION_COUNT];
+    };
+
+    Channel* channels;
+    TsLayout layout;
+    size_t allocated;
+    uint32_t recycled;
+
+    static size_t layoutSize(const TsLayout& layout);
+    void carve(void* memory, const TsLayout& layout);
+
+    bool appendToBlock(Block& block, uint32_t time, float value);
+    void addToRollup(RollupRing& ring, uint32_t width, uint32_t time, float value);
+    size_t decodeBlock(const Block& block, uint32_t from, uint32_t to, TsPoint* out, size_t max);
+    void clearChannel(Channel& channel);
+
+public:
+    // Constructor
+    TimeSeriesStore();
+    ~TimeSeriesStore();
+
+    // Allocate the channel storage: the full layout in PSRAM when present,
+    // the compact one in internal RAM otherwise. False if out of memory.
+    bool begin();
+
+    // Allocate the channel storage with the given layout
+    bool begin(const TsLayout& layout);
+
+    // Layout chosen by begin()
+    const TsLayout& getLayout() const { return layout; }
+
+    // Record a sample
+    void record(TsChannel channel, uint32_t time, float value);
+
+    // Record every channel of a snapshot that the snapshot carries
+    void recordSnapshot(const AllSensorData& data, uint32_t time);
+
+    // Most recent sample
+    bool latest(TsChannel channel, TsPoint& out);
+
+    // Raw samples with from <= time <= to, oldest first
+    size_t samples(TsChannel channel, uint32_t from, uint32_t to, TsPoint* out, size_t max);
+
+    // Rollup buckets starting within [from, to], oldest first
+    size_t rollups(TsChannel channel, TsResolution resolution, uint32_t from, uint32_t to,
+                   TsRollup* out, size_t max);
+
+    // Combine the rollup buckets starting within [from, to] into one
+    bool aggregate(TsChannel channel, TsResolution resolution, uint32_t from, uint32_t to,
+                   TsRollup& out);
+
+    // Change of the latest value against the value `window_ms` earlier
+    bool change(TsChannel channel, uint32_t window_ms, float& out);
+
+    // Width of a rollup bucket in ms
+    static uint32_t resolutionWidth(TsResolution resolution);
+
+    TsStats getStats();
+};
+
+#endif // TIMESERIES_H
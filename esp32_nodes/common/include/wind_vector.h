@@ -0,0 +1,62 @@
+#ifndef WIND_VECTOR_H
+#define WIND_VECTOR_H
+
+#include <stdint.h>
+
+// ==================== SIZING ====================
+// Samples kept for the longest window (10 minutes at 1 Hz)
+#ifndef WIND_VECTOR_HISTORY
+#define WIND_VECTOR_HISTORY 600
+#endif
+#define WIND_VECTOR_MAX_WINDOWS 3
+#define WIND_VECTOR_SCALE 32767        // Fixed-point unit length
+
+// Direction statistics of one window
+struct WindVectorStats {
+    float direction;         // Vector mean, 0-360 degrees
+    float stdDev;            // Yamartino standard deviation (degrees)
+    float steadiness;        // Resultant length 0-1 (1 = constant direction)
+    uint16_t samples;
+};
+
+// Rolling unit-vector average of wind direction. Each sample is stored
+// as a fixed-point (sin, cos) pair; every window keeps integer running
+// sums over the shared history, so a sample costs O(1) per window and
+// the sums never drift.
+class WindVectorAverage {
+private:
+    struct Window {
+        uint16_t length;
+        int32_t sumSin;
+        int32_t sumCos;
+    };
+
+    int16_t sinRing[WIND_VECTOR_HISTORY];
+    int16_t cosRing[WIND_VECTOR_HISTORY];
+    uint16_t head;           // Next entry to overwrite
+    uint16_t filled;
+    Window windows[WIND_VECTOR_MAX_WINDOWS];
+    uint8_t windowCount;
+
+public:
+    // Constructor
+    WindVectorAverage();
+
+    // Add a window over the newest `samples` samples; returns its index or -1
+    int addWindow(uint16_t samples);
+
+    // Forget all samples (windows are kept)
+    void reset();
+
+    // Add one direction sample in degrees
+    void add(float degrees);
+
+    // Statistics of a window (all zero while it is empty)
+    WindVectorStats stats(uint8_t window) const;
+};
+
+// Compass point names, table lookup
+const char* windCardinal16(float degrees);
+const char* windCardinal8(float degrees);
+
+#endif
@@ -0,0 +1,483 @@
+#include "cloud_upload.h"
+#include "protocol.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+// Appends formatted text to a bounded buffer and remembers overflow
+struct JsonWriter {
+    char* out;
+    size_t capacity;
+    size_t length;
+    bool overflow;
+    bool first;              // No member written yet in the current object
+
+    void append(const char* format, ...) {
+        if (overflow) return;
+
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(out + length, capacity - length, format, args);
+        va_end(args);
+
+        if (written < 0 || (size_t)written >= capacity - length) {
+            overflow = true;
+            return;
+        }
+        length += written;
+    }
+
+    void open() {
+        append("{");
+        first = true;
+    }
+
+    void close() {
+        append("}");
+        first = false;
+    }
+
+    void key(const char* path) {
+        append(first ? "\"%s\":" : ",\"%s\":", path);
+        first = false;
+    }
+
+    void number(const char* path, float value, int decimals) {
+        key(path);
+        append("%.*f", decimals, value);
+    }
+
+    void integer(const char* path, long value) {
+        key(path);
+        append("%ld", value);
+    }
+
+    void boolean(const char* path, bool value) {
+        key(path);
+        append(value ? "true" : "false");
+    }
+};
+
+size_t buildSensorUpdate(const AllSensorData& data, const UploadAlerts& alerts,
+                         uint32_t timestamp, char* out, size_t capacity,
+                         const UploadMetrics* metrics) {
+    if (out == nullptr || capacity < 3) return 0;
+
+    JsonWriter json = { out, capacity, 0, false, false };
+    json.open();
+
+    // Soil Node data
+    if (data.soilNodeConnected) {
+        json.number("sensors/soil/moisture", data.soilMoisture, 2);
+        json.number("sensors/soil/ph", data.soilPH, 2);
+        json.number("sensors/soil/temperature", data.soilTemp, 2);
+        json.integer("sensors/soil/age", (timestamp - data.soilUpdated) / 1000);
+    }
+
+    // Weather Node data
+    if (data.weatherNodeConnected) {
+        json.number("sensors/weather/airTemp", data.airTemp, 2);
+        json.number("sensors/weather/humidity", data.humidity, 2);
+        json.number("sensors/weather/leafWetness", data.leafWetness, 2);
+        json.integer("sensors/weather/light", data.light);
+        json.number("sensors/weather/windSpeed", data.windSpeed, 2);
+        json.integer("sensors/weather/windDirection", data.windDirection);
+        json.integer("sensors/weather/windDirection10", data.windDirection10);
+        json.number("sensors/weather/windDirStdDev", data.windDirStdDev, 1);
+        json.number("sensors/weather/rainfall", data.rainfall, 1);
+        json.number("sensors/weather/rainfall1h", data.rainfall1h, 1);
+        json.number("sensors/weather/rainEvent", data.rainEvent, 1);
+        json.number("sensors/weather/rainRate", data.rainRate, 1);
+        json.integer("sensors/weather/age", (timestamp - data.weatherUpdated) / 1000);
+    }
+
+    // Gateway sensor data
+    json.number("sensors/gateway/waterLevel", data.waterLevel, 1);
+    json.integer("sensors/gateway/gas", data.gas);
+    json.integer("sensors/gateway/co2", data.co2);
+    json.integer("sensors/gateway/co", data.co);
+    json.boolean("sensors/gateway/motion", data.motion);
+    json.number("sensors/gateway/weight", data.weight, 2);
+
+    // Trends, once the history holds them
+    if (data.soilMoisture1h == data.soilMoisture1h) {
+        json.number("trends/soilMoisture1h", data.soilMoisture1h, 2);
+    }
+    if (data.soilMoistureChange1h == data.soilMoistureChange1h) {
+        json.number("trends/soilMoistureChange1h", data.soilMoistureChange1h, 2);
+    }
+    if (data.waterLevelChange1h == data.waterLevelChange1h) {
+        json.number("trends/waterLevelChange1h", data.waterLevelChange1h, 1);
+    }
+
+    // Alert status
+    json.boolean("alerts/soilMoistureLow", alerts.soilMoistureLow);
+    json.boolean("alerts/soilDrying", alerts.soilDrying);
+    json.boolean("alerts/gasHigh", alerts.gasHigh);
+    json.boolean("alerts/co2High", alerts.co2High);
+    json.boolean("alerts/coHigh", alerts.coHigh);
+    json.boolean("alerts/waterLow", alerts.waterLow);
+    json.boolean("alerts/motionDetected", alerts.motionDetected);
+
+    // Timestamp (kept as a string, as the dashboard expects)
+    json.key("system/lastUpdate");
+    json.append("\"%lu\"", (unsigned long)timestamp);
+
+    // Store-and-forward backlog
+    if (metrics != nullptr) {
+        json.integer("system/backlogDepth", metrics->backlogDepth);
+        json.number("system/backlogDrainRate", metrics->drainRate, 2);
+    }
+
+    json.close();
+    return json.overflow ? 0 : json.length;
+}
+
+// One logged record as a JSON object
+static void writeHistoryRecord(JsonWriter& json, const LogRecord& record) {
+    AllSensorData data;
+    fromLogRecord(record, data);
+
+    json.open();
+    json.integer("uptime", record.timestamp);
+    if (data.soilNodeConnected) {
+        json.number("soilMoisture", data.soilMoisture, 2);
+        json.number("soilPH", data.soilPH, 2);
+        json.number("soilTemp", data.soilTemp, 2);
+    }
+    if (data.weatherNodeConnected) {
+        json.number("airTemp", data.airTemp, 2);
+        json.number("humidity", data.humidity, 2);
+        json.number("leafTemp", data.leafTemp, 2);
+        json.number("leafWetness", data.leafWetness, 2);
+        json.integer("light", data.light);
+        json.number("windSpeed", data.windSpeed, 2);
+        json.integer("windDirection", data.windDirection);
+        json.number("rainfall", data.rainfall, 1);
+    }
+    json.number("waterLevel", data.waterLevel, 1);
+    json.integer("gas", data.gas);
+    json.integer("co2", data.co2);
+    json.integer("co", data.co);
+    json.boolean("motion", data.motion);
+    json.number("weight", data.weight, 2);
+    json.close();
+}
+
+// One registered node as a JSON object
+static void writeNodeRecord(JsonWriter& json, const NodeEntry& node, uint32_t now_ms) {
+    json.open();
+    json.integer("age", (now_ms - node.lastHeard_ms) / 1000);
+    json.integer("packets", node.stats.packetsReceived);
+    json.integer("readings", node.readings);
+    json.integer("uptime", node.stats.uptimeSeconds);
+
+    if (node.nodeType == NODE_ID_SOIL) {
+        const SoilNodeData& soil = node.packet.soil;
+        json.key("type");
+        json.append("\"soil\"");
+        json.number("moisture", fromFixed(soil.soilMoisture, FIXED_CENTI), 2);
+        json.number("ph", fromFixed(soil.soilPH, FIXED_CENTI), 2);
+        json.number("temperature", fromFixed(soil.soilTemp, FIXED_CENTI), 2);
+    } else if (node.nodeType == NODE_ID_WEATHER) {
+        const WeatherNodeData& weather = node.packet.weather;
+        json.key("type");
+        json.append("\"weather\"");
+        json.number("airTemp", fromFixed(weather.airTemp, FIXED_CENTI), 2);
+        json.number("humidity", fromFixed(weather.humidity, FIXED_CENTI), 2);
+        json.number("leafTemp", fromFixed(weather.leafTemp, FIXED_CENTI), 2);
+        json.number("leafWetness", fromFixed(weather.leafWetness, FIXED_CENTI), 2);
+        json.integer("light", weather.light);
+        json.number("windSpeed", fromFixed(weather.windSpeed, FIXED_CENTI), 2);
+        json.integer("windDirection", weather.windDirection);
+        json.integer("windDirection10", weather.windDirection10);
+        json.number("windDirStdDev", fromFixed(weather.windDirStdDev, FIXED_DECI), 1);
+        json.number("rainfall", fromFixed(weather.rainfall, FIXED_DECI), 1);
+        json.number("rainfall1h", fromFixed(weather.rainfall1h, FIXED_DECI), 1);
+        json.number("rainEvent", fromFixed(weather.rainEvent, FIXED_DECI), 1);
+        json.number("rainRate", fromFixed(weather.rainRate, FIXED_DECI), 1);
+    }
+    json.close();
+}
+
+// Link quality of one node as a JSON object
+static void writeLinkRecord(JsonWriter& json, const NodeStatistics& stats) {
+    json.open();
+    json.integer("received", stats.packetsReceived);
+    json.integer("lost", stats.packetsLost);
+    json.integer("duplicates", stats.duplicates);
+    json.integer("restarts", stats.restarts);
+    json.number("lossRate", linkLossRate(stats) * 100.0f, 2);
+    if (stats.lastRSSI != 0) {
+        json.integer("rssi", stats.lastRSSI);
+        json.number("rssiAverage", stats.averageRSSI, 1);
+    }
+    json.number("jitter", stats.jitter_ms, 1);
+    json.number("interval", stats.interval_ms / 1000.0f, 1);
+    json.close();
+}
+
+uint16_t buildNodeUpdate(const NodeRegistry& registry, uint16_t first, uint32_t now_ms,
+                         char* out, size_t capacity, size_t& length) {
+    length = 0;
+    if (out == nullptr || capacity < 3) return first;
+
+    JsonWriter json = { out, capacity, 0, false, false };
+    json.open();
+
+    uint16_t next = first;
+    for (; next < registry.size(); next++) {
+        // Keep the document valid up to the last node that fit
+        size_t mark = json.length;
+        bool wasFirst = json.first;
+
+        const NodeEntry& node = registry.at(next);
+        char key[16 + REGISTRY_KEY_LENGTH];
+        memcpy(key, "system/nodes/", 13);
+        formatNodeKey(node.mac, key + 13);
+        json.key(key + 7);
+        writeNodeRecord(json, node, now_ms);
+        json.key(key);
+        writeLinkRecord(json, node.stats);
+
+        // Leave room for the closing brace
+        if (json.overflow || json.length + 1 >= capacity) {
+            json.length = mark;
+            json.first = wasFirst;
+            json.overflow = false;
+            break;
+        }
+    }
+
+    json.close();
+    if (json.overflow || next == first) return first;
+
+    length = json.length;
+    return next;
+}
+
+size_t buildHistoryUpdate(const LogRecord* records, const uint32_t* ids, size_t count,
+                          char* out, size_t capacity, size_t& length) {
+    length = 0;
+    if (out == nullptr || capacity < 3) return 0;
+
+    JsonWriter json = { out, capacity, 0, false, false };
+    json.open();
+
+    size_t written = 0;
+    for (; written < count; written++) {
+        // Keep the document valid up to the last record that fit
+        size_t mark = json.length;
+        bool wasFirst = json.first;
+
+        char key[24];
+        snprintf(key, sizeof(key), "history/%lu", (unsigned long)ids[written]);
+        json.key(key);
+        writeHistoryRecord(json, records[written]);
+
+        // Leave room for the closing brace
+        if (json.overflow || json.length + 1 >= capacity) {
+            json.length = mark;
+            json.first = wasFirst;
+            json.overflow = false;
+            break;
+        }
+    }
+
+    json.close();
+    if (json.overflow || written == 0) return 0;
+
+    length = json.length;
+    return written;
+}
+
+// Constructor
+CloudUploader::CloudUploader(UploadTransport* transport, const char* path) {
+    this->transport = transport;
+    this->path = path;
+    this->backlog = nullptr;
+    this->registry = nullptr;
+    this->nodeCursor = 0;
+    this->nodeSweep = false;
+    this->head = 0;
+    this->count = 0;
+    this->retryDelay_ms = 0;
+    this->nextAttempt_ms = 0;
+    this->nextBacklog_ms = 0;
+    this->drainStart_ms = 0;
+    this->drainEnd_ms = 0;
+    this->drainRecords = 0;
+    this->draining = false;
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Store-and-forward log for snapshots that cannot be sent
+void CloudUploader::attachBacklog(FlashRingLog* backlog) {
+    this->backlog = backlog;
+}
+
+// Nodes uploaded after each snapshot
+void CloudUploader::attachRegistry(const NodeRegistry* registry) {
+    this->registry = registry;
+}
+
+// Queue a live snapshot
+bool CloudUploader::enqueue(const AllSensorData& data, const UploadAlerts& alerts, uint32_t timestamp) {
+    // Full: the oldest snapshot goes to flash (or is lost without a backlog)
+    if (count == UPLOAD_QUEUE_SLOTS) {
+        const Slot& oldest = queue[head];
+        if (!archive(oldest.data, oldest.timestamp)) {
+            stats.dropped++;
+        }
+        head = (head + 1) % UPLOAD_QUEUE_SLOTS;
+        count--;
+    }
+
+    Slot& slot = queue[(head + count) % UPLOAD_QUEUE_SLOTS];
+    slot.data = data;
+    slot.alerts = alerts;
+    slot.timestamp = timestamp;
+    count++;
+
+    // A sweep already running carries on from where it is
+    if (!nodeSweep) {
+        nodeSweep = true;
+        nodeCursor = 0;
+    }
+    return true;
+}
+
+// Write a snapshot straight to the backlog
+bool CloudUploader::archive(const AllSensorData& data, uint32_t timestamp) {
+    if (backlog == nullptr || !backlog->append(toLogRecord(data, timestamp))) {
+        return false;
+    }
+    stats.spilled++;
+    return true;
+}
+
+// Issue one request and update the retry state
+bool CloudUploader::send(const char* json, size_t length, uint32_t now_ms) {
+    stats.requests++;
+    stats.bytesSent += length;
+    stats.lastBytes = length;
+
+    if (transport->update(path, json, length)) {
+        retryDelay_ms = 0;
+        return true;
+    }
+
+    // Back off before trying again
+    stats.failures++;
+    retryDelay_ms = retryDelay_ms == 0 ? UPLOAD_RETRY_BASE_MS : retryDelay_ms * 2;
+    if (retryDelay_ms > UPLOAD_RETRY_MAX_MS) {
+        retryDelay_ms = UPLOAD_RETRY_MAX_MS;
+    }
+    nextAttempt_ms = now_ms + retryDelay_ms;
+    return false;
+}
+
+// Upload one batch of logged records, oldest first
+bool CloudUploader::serviceBacklog(uint32_t now_ms) {
+    if (backlog == nullptr || backlog->getDepth() == 0) {
+        draining = false;
+        return false;
+    }
+    if ((int32_t)(now_ms - nextBacklog_ms) < 0) return false;
+
+    LogRecord records[UPLOAD_BACKLOG_BATCH];
+    uint32_t ids[UPLOAD_BACKLOG_BATCH];
+    size_t available = backlog->peek(records, ids, UPLOAD_BACKLOG_BATCH);
+    if (available == 0) return false;
+
+    size_t length;
+    size_t batch = buildHistoryUpdate(records, ids, available, buffer, sizeof(buffer), length);
+    if (batch == 0) return false;
+
+    if (!draining) {
+        draining = true;
+        drainStart_ms = now_ms;
+        drainEnd_ms = now_ms;
+        drainRecords = 0;
+    }
+
+    nextBacklog_ms = now_ms + UPLOAD_BACKLOG_INTERVAL_MS;
+    stats.backlogRequests++;
+    if (!send(buffer, length, now_ms)) return true;
+
+    backlog->consume(batch);
+    stats.backlogRecords += batch;
+    drainRecords += batch;
+    drainEnd_ms = now_ms;
+    return true;
+}
+
+// Upload the next page of registered nodes
+bool CloudUploader::serviceNodes(uint32_t now_ms) {
+    if (registry == nullptr || !nodeSweep) return false;
+    if (nodeCursor >= registry->size()) {
+        nodeSweep = false;
+        return false;
+    }
+
+    size_t length;
+    uint16_t next = buildNodeUpdate(*registry, nodeCursor, now_ms, buffer, sizeof(buffer), length);
+    if (next == nodeCursor) {
+        // A node too large for a document would stall the sweep
+        nodeCursor++;
+        return false;
+    }
+
+    stats.nodeRequests++;
+    if (send(buffer, length, now_ms)) {
+        nodeCursor = next;
+    }
+    return true;
+}
+
+// Send the next live snapshot, node page or backlog batch
+void CloudUploader::service(uint32_t now_ms) {
+    if (transport == nullptr) return;
+    if (retryDelay_ms > 0 && (int32_t)(now_ms - nextAttempt_ms) < 0) return;
+
+    // Live data always goes first, then the nodes, then the backlog
+    if (count == 0) {
+        if (!serviceNodes(now_ms)) {
+            serviceBacklog(now_ms);
+        }
+        return;
+    }
+
+    const Slot& slot = queue[head];
+    UploadMetrics metrics = getMetrics();
+    size_t length = buildSensorUpdate(slot.data, slot.alerts, slot.timestamp, buffer, sizeof(buffer),
+                                      backlog != nullptr ? &metrics : nullptr);
+
+    // A snapshot that cannot be serialized would block the queue forever
+    if (length == 0 || send(buffer, length, now_ms)) {
+        if (length == 0) stats.dropped++;
+        head = (head + 1) % UPLOAD_QUEUE_SLOTS;
+        count--;
+    }
+}
+
+// Number of live snapshots waiting to be sent
+uint8_t CloudUploader::getPending() const {
+    return count;
+}
+
+// Backlog depth and drain throughput
+UploadMetrics CloudUploader::getMetrics() const {
+    UploadMetrics metrics;
+    metrics.backlogDepth = backlog != nullptr ? backlog->getDepth() : 0;
+
+    // Records per second from the first request to the latest success
+    uint32_t elapsed = drainEnd_ms - drainStart_ms + UPLOAD_BACKLOG_INTERVAL_MS;
+    metrics.drainRate = drainRecords > 0 ? drainRecords * 1000.0f / elapsed : 0.0f;
+    return metrics;
+}
+
+// Upload counters
+const UploadStats& CloudUploader::getStats() const {
+    return stats;
+}
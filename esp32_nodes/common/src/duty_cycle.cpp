@@ -0,0 +1,60 @@
+#include "duty_cycle.h"
+
+// ==================== POWER PROFILES ====================
+// Deep sleep with RTC timer and RTC memory, CPU at 240 MHz with the
+// radio off, and the average over WiFi bring-up and ESP-NOW exchanges
+const PowerProfile POWER_PROFILE_WROOM32 = {
+    "ESP32-WROOM-32", { 0.01f, 50.0f, 120.0f }
+};
+
+const PowerProfile POWER_PROFILE_DEVKIT = {
+    "ESP32 DevKit", { 6.0f, 55.0f, 125.0f }
+};
+
+// ==================== ENERGY LEDGER ====================
+void energyReset(EnergyLedger* ledger) {
+    memset(ledger, 0, sizeof(EnergyLedger));
+    ledger->magic = ENERGY_LEDGER_MAGIC;
+}
+
+bool energyRestore(EnergyLedger* ledger) {
+    if (ledger->magic == ENERGY_LEDGER_MAGIC) {
+        return true;
+    }
+    energyReset(ledger);
+    return false;
+}
+
+void energyAccount(EnergyLedger* ledger, PowerState state, uint64_t duration_us) {
+    if (state < POWER_STATE_COUNT) {
+        ledger->time_us[state] += duration_us;
+    }
+}
+
+uint64_t energyTotalTime_us(const EnergyLedger* ledger) {
+    uint64_t total = 0;
+    for (int i = 0; i < POWER_STATE_COUNT; i++) {
+        total += ledger->time_us[i];
+    }
+    return total;
+}
+
+float energyCharge_mAh(const EnergyLedger* ledger, const PowerProfile* profile) {
+    double charge = 0.0;
+    for (int i = 0; i < POWER_STATE_COUNT; i++) {
+        charge += profile->current_mA[i] * (ledger->time_us[i] / 3600e6);
+    }
+    return (float)charge;
+}
+
+float energyAverageCurrent_mA(const EnergyLedger* ledger, const PowerProfile* profile) {
+    uint64_t total = energyTotalTime_us(ledger);
+    if (total == 0) return 0.0f;
+    return (float)(energyCharge_mAh(ledger, profile) / (total / 3600e6));
+}
+
+float energyBatteryLife_days(const EnergyLedger* ledger, const PowerProfile* profile, float capacity_mAh) {
+    float current = energyAverageCurrent_mA(ledger, profile);
+    if (current <= 0.0f) return 0.0f;
+    return capacity_mAh / current / 24.0f;
+}
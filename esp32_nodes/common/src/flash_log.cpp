@@ -0,0 +1,373 @@
+#include "flash_log.h"
+#include "protocol.h"
+#include <string.h>
+
+static_assert(sizeof(LogRecord) == 40, "LogRecord size changed, logs written by older firmware become unreadable");
+static_assert(sizeof(LogRecord) + 4 <= FLASH_LOG_SLOT_SIZE, "LogRecord does not fit into a slot");
+
+// Slot states (bits are only ever cleared)
+#define SLOT_FREE 0xFF
+#define SLOT_WRITING 0x7F
+#define SLOT_VALID 0x3F
+#define SLOT_CONSUMED 0x1F
+
+// Record data follows the status byte at this offset
+#define SLOT_RECORD_OFFSET 4
+
+struct SectorHeader {
+    uint32_t magic;
+    uint32_t sequence;
+    uint8_t reserved[FLASH_LOG_SECTOR_HEADER - 8];
+};
+
+// Read a slot and check that it holds an intact, unsent record
+static bool readValid(LogStorage* storage, uint32_t address, LogRecord* record) {
+    uint8_t status;
+    if (!storage->read(address, &status, 1) || status != SLOT_VALID) return false;
+    if (!storage->read(address + SLOT_RECORD_OFFSET, record, sizeof(LogRecord))) return false;
+    return crc8((const uint8_t*)record, sizeof(LogRecord) - 1) == record->checksum;
+}
+
+// Constructor
+FlashRingLog::FlashRingLog(LogStorage* storage) {
+    this->storage = storage;
+    this->sectors = 0;
+    this->slotsPerSector = 0;
+    this->headSector = 0;
+    this->headSlot = 0;
+    this->headSequence = 0;
+    this->tailSector = 0;
+    this->tailSlot = 0;
+    this->depth = 0;
+    this->ready = false;
+    memset(&stats, 0, sizeof(stats));
+}
+
+uint32_t FlashRingLog::slotAddress(uint32_t sector, uint32_t slot) {
+    return sector * storage->sectorSize() + FLASH_LOG_SECTOR_HEADER + slot * FLASH_LOG_SLOT_SIZE;
+}
+
+uint8_t FlashRingLog::readStatus(uint32_t sector, uint32_t slot) {
+    uint8_t status = SLOT_FREE;
+    storage->read(slotAddress(sector, slot), &status, 1);
+    return status;
+}
+
+// Sequence number of a sector in use, false for an erased sector
+bool FlashRingLog::readSequence(uint32_t sector, uint32_t& sequence) {
+    SectorHeader header;
+    if (!storage->read(sector * storage->sectorSize(), &header, sizeof(header))) return false;
+    if (header.magic != FLASH_LOG_MAGIC) return false;
+    sequence = header.sequence;
+    return true;
+}
+
+// Sequence number of a sector known to be in use
+uint32_t FlashRingLog::sectorSequence(uint32_t sector) {
+    uint32_t sequence = 0;
+    readSequence(sector, sequence);
+    return sequence;
+}
+
+// Check whether a sector is still fully erased
+static bool isBlank(LogStorage* storage, uint32_t sector) {
+    uint8_t chunk[64];
+    uint32_t base = sector * storage->sectorSize();
+
+    for (uint32_t offset = 0; offset < storage->sectorSize(); offset += sizeof(chunk)) {
+        if (!storage->read(base + offset, chunk, sizeof(chunk))) return false;
+        for (size_t i = 0; i < sizeof(chunk); i++) {
+            if (chunk[i] != 0xFF) return false;
+        }
+    }
+    return true;
+}
+
+// Make a sector the new head, erasing it unless released sectors already were
+bool FlashRingLog::startSector(uint32_t sector, uint32_t sequence) {
+    if (!isBlank(storage, sector)) {
+        if (!storage->erase(sector)) return false;
+        stats.erases++;
+    }
+
+    SectorHeader header;
+    memset(&header, 0xFF, sizeof(header));
+    header.magic = FLASH_LOG_MAGIC;
+    header.sequence = sequence;
+    if (!storage->write(sector * storage->sectorSize(), &header, sizeof(header))) return false;
+
+    headSector = sector;
+    headSlot = 0;
+    headSequence = sequence;
+    return true;
+}
+
+// Give back a sector whose records have all been uploaded
+void FlashRingLog::releaseSector(uint32_t sector) {
+    if (storage->erase(sector)) {
+        stats.erases++;
+    }
+}
+
+// Move the tail to the oldest intact unsent record (or to the head)
+void FlashRingLog::advanceTail() {
+    LogRecord record;
+
+    while (!(tailSector == headSector && tailSlot >= headSlot)) {
+        if (tailSlot >= slotsPerSector) {
+            // Everything in this sector is done, recycle it
+            releaseSector(tailSector);
+            tailSector = (tailSector + 1) % sectors;
+            tailSlot = 0;
+            continue;
+        }
+
+        uint32_t address = slotAddress(tailSector, tailSlot);
+        uint8_t status = readStatus(tailSector, tailSlot);
+        if (status == SLOT_VALID) {
+            if (readValid(storage, address, &record)) return;
+
+            // Damaged record: retire it so it is not retried forever
+            uint8_t consumed = SLOT_CONSUMED;
+            storage->write(address, &consumed, 1);
+            stats.corrupt++;
+            if (depth > 0) depth--;
+        } else if (status == SLOT_WRITING) {
+            stats.corrupt++;
+        }
+        tailSlot++;
+    }
+}
+
+// Scan the flash and recover head, tail and depth
+bool FlashRingLog::begin() {
+    ready = false;
+    if (storage == nullptr) return false;
+
+    sectors = storage->sectorCount();
+    slotsPerSector = (storage->sectorSize() - FLASH_LOG_SECTOR_HEADER) / FLASH_LOG_SLOT_SIZE;
+    if (sectors < 2 || slotsPerSector == 0) return false;
+
+    // The head is the sector with the highest sequence number
+    bool found = false;
+    for (uint32_t sector = 0; sector < sectors; sector++) {
+        uint32_t sequence;
+        if (readSequence(sector, sequence) && (!found || sequence > headSequence)) {
+            found = true;
+            headSector = sector;
+            headSequence = sequence;
+        }
+    }
+
+    depth = 0;
+    if (!found) {
+        if (!startSector(0, 1)) return false;
+        tailSector = headSector;
+        tailSlot = 0;
+        ready = true;
+        return true;
+    }
+
+    headSlot = 0;
+    while (headSlot < slotsPerSector && readStatus(headSector, headSlot) != SLOT_FREE) {
+        headSlot++;
+    }
+
+    // Sectors in use run contiguously up to the head; the oldest is the
+    // first one in use after the head
+    tailSector = headSector;
+    for (uint32_t i = 1; i < sectors; i++) {
+        uint32_t sector = (headSector + i) % sectors;
+        uint32_t sequence;
+        if (readSequence(sector, sequence)) {
+            tailSector = sector;
+            break;
+        }
+    }
+    tailSlot = 0;
+
+    // Count unsent records
+    for (uint32_t sector = tailSector; ; sector = (sector + 1) % sectors) {
+        uint32_t sequence;
+        if (readSequence(sector, sequence)) {
+            uint32_t used = sector == headSector ? headSlot : slotsPerSector;
+            for (uint32_t slot = 0; slot < used; slot++) {
+                if (readStatus(sector, slot) == SLOT_VALID) depth++;
+            }
+        }
+        if (sector == headSector) break;
+    }
+
+    advanceTail();
+    ready = true;
+    return true;
+}
+
+// Append a snapshot
+bool FlashRingLog::append(const LogRecord& record) {
+    if (!ready) return false;
+
+    if (headSlot >= slotsPerSector) {
+        uint32_t next = (headSector + 1) % sectors;
+
+        // Full: the oldest sector gives way, losing what was not uploaded
+        if (tailSector == next) {
+            uint32_t lost = 0;
+            for (uint32_t slot = 0; slot < slotsPerSector; slot++) {
+                if (readStatus(next, slot) == SLOT_VALID) lost++;
+            }
+            stats.dropped += lost;
+            depth -= lost < depth ? lost : depth;
+            tailSector = (next + 1) % sectors;
+            tailSlot = 0;
+        }
+
+        if (!startSector(next, headSequence + 1)) return false;
+        if (depth == 0) {
+            tailSector = headSector;
+            tailSlot = 0;
+        }
+    }
+
+    LogRecord stored = record;
+    stored.checksum = crc8((const uint8_t*)&stored, sizeof(stored) - 1);
+
+    uint32_t address = slotAddress(headSector, headSlot);
+    uint8_t status = SLOT_WRITING;
+    bool ok = storage->write(address, &status, 1);
+    ok = ok && storage->write(address + SLOT_RECORD_OFFSET, &stored, sizeof(stored));
+    status = SLOT_VALID;
+    ok = ok && storage->write(address, &status, 1);
+    headSlot++;
+
+    if (!ok) {
+        stats.corrupt++;
+        return false;
+    }
+
+    depth++;
+    stats.appended++;
+    if (depth == 1) {
+        advanceTail();
+    }
+    return true;
+}
+
+// Copy the oldest unsent records
+size_t FlashRingLog::peek(LogRecord* records, uint32_t* ids, size_t max) {
+    if (!ready) return 0;
+
+    size_t count = 0;
+    uint32_t sector = tailSector;
+    uint32_t slot = tailSlot;
+
+    while (count < max && !(sector == headSector && slot >= headSlot)) {
+        if (slot >= slotsPerSector) {
+            sector = (sector + 1) % sectors;
+            slot = 0;
+            continue;
+        }
+        if (readValid(storage, slotAddress(sector, slot), &records[count])) {
+            if (ids != nullptr) {
+                ids[count] = sectorSequence(sector) * slotsPerSector + slot;
+            }
+            count++;
+        }
+        slot++;
+    }
+    return count;
+}
+
+// Mark the oldest unsent records as uploaded
+void FlashRingLog::consume(size_t count) {
+    if (!ready) return;
+
+    LogRecord record;
+    uint32_t sector = tailSector;
+    uint32_t slot = tailSlot;
+
+    while (count > 0 && !(sector == headSector && slot >= headSlot)) {
+        if (slot >= slotsPerSector) {
+            sector = (sector + 1) % sectors;
+            slot = 0;
+            continue;
+        }
+        uint32_t address = slotAddress(sector, slot);
+        if (readValid(storage, address, &record)) {
+            uint8_t consumed = SLOT_CONSUMED;
+            storage->write(address, &consumed, 1);
+            depth--;
+            stats.consumed++;
+            count--;
+        }
+        slot++;
+    }
+
+    advanceTail();
+}
+
+// Records waiting for upload
+uint32_t FlashRingLog::getDepth() const {
+    return depth;
+}
+
+// Records the log can hold before the oldest sector is overwritten
+uint32_t FlashRingLog::getCapacity() const {
+    return sectors * slotsPerSector;
+}
+
+const FlashLogStats& FlashRingLog::getStats() const {
+    return stats;
+}
+
+LogRecord toLogRecord(const AllSensorData& data, uint32_t timestamp) {
+    LogRecord record;
+    memset(&record, 0, sizeof(record));
+
+    record.timestamp = timestamp;
+    record.soilMoisture = toFixedU16(data.soilMoisture, FIXED_CENTI);
+    record.soilTemp = toFixedS16(data.soilTemp, FIXED_CENTI);
+    record.soilPH = toFixedU16(data.soilPH, FIXED_CENTI);
+    record.airTemp = toFixedS16(data.airTemp, FIXED_CENTI);
+    record.humidity = toFixedU16(data.humidity, FIXED_CENTI);
+    record.light = data.light;
+    record.rainfall = toFixedU16(data.rainfall, FIXED_DECI);
+    record.windSpeed = toFixedU16(data.windSpeed, FIXED_CENTI);
+    record.windDirection = data.windDirection;
+    record.leafTemp = toFixedS16(data.leafTemp, FIXED_CENTI);
+    record.leafWetness = toFixedU16(data.leafWetness, FIXED_CENTI);
+    record.gas = data.gas;
+    record.co2 = data.co2;
+    record.co = data.co;
+    record.waterLevel = toFixedU16(data.waterLevel, FIXED_DECI);
+    record.weight = (int32_t)(data.weight * 1000.0f + (data.weight >= 0 ? 0.5f : -0.5f));
+    record.flags = (data.soilNodeConnected ? LOG_FLAG_SOIL_NODE : 0) |
+                   (data.weatherNodeConnected ? LOG_FLAG_WEATHER_NODE : 0) |
+                   (data.motion ? LOG_FLAG_MOTION : 0);
+    return record;
+}
+
+void fromLogRecord(const LogRecord& record, AllSensorData& data) {
+    memset(&data, 0, sizeof(data));
+
+    data.timestamp = record.timestamp;
+    data.soilMoisture = fromFixed(record.soilMoisture, FIXED_CENTI);
+    data.soilTemp = fromFixed(record.soilTemp, FIXED_CENTI);
+    data.soilPH = fromFixed(record.soilPH, FIXED_CENTI);
+    data.airTemp = fromFixed(record.airTemp, FIXED_CENTI);
+    data.humidity = fromFixed(record.humidity, FIXED_CENTI);
+    data.light = record.light;
+    data.rainfall = fromFixed(record.rainfall, FIXED_DECI);
+    data.windSpeed = fromFixed(record.windSpeed, FIXED_CENTI);
+    data.windDirection = record.windDirection;
+    data.leafTemp = fromFixed(record.leafTemp, FIXED_CENTI);
+    data.leafWetness = fromFixed(record.leafWetness, FIXED_CENTI);
+    data.gas = record.gas;
+    data.co2 = record.co2;
+    data.co = record.co;
+    data.waterLevel = fromFixed(record.waterLevel, FIXED_DECI);
+    data.weight = record.weight / 1000.0f;
+    data.soilNodeConnected = (record.flags & LOG_FLAG_SOIL_NODE) != 0;
+    data.weatherNodeConnected = (record.flags & LOG_FLAG_WEATHER_NODE) != 0;
+    data.motion = (record.flags & LOG_FLAG_MOTION) != 0;
+}
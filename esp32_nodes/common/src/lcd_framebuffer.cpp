@@ -0,0 +1,114 @@
+#include "lcd_framebuffer.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// Constructor
+LcdFramebuffer::LcdFramebuffer() {
+    memset(shown, 0, sizeof(shown));
+    memset(&stats, 0, sizeof(stats));
+    invalidate();
+    clear();
+}
+
+// Rows are interleaved in DDRAM: row 0 is followed by row 2, row 1 by row 3
+uint8_t LcdFramebuffer::cellIndex(uint8_t column, uint8_t row) {
+    return (row & 1) * 2 * LCD_FB_COLUMNS + (row >> 1) * LCD_FB_COLUMNS + column;
+}
+
+// The first line holds 0x00-0x27, the second starts at 0x40
+uint8_t LcdFramebuffer::cellAddress(uint8_t cell) {
+    return cell < 2 * LCD_FB_COLUMNS ? cell : 0x40 + cell - 2 * LCD_FB_COLUMNS;
+}
+
+// ==================== DRAWING ====================
+
+void LcdFramebuffer::clear() {
+    memset(frame, ' ', sizeof(frame));
+    setCursor(0, 0);
+}
+
+void LcdFramebuffer::setCursor(uint8_t column, uint8_t row) {
+    if (row >= LCD_FB_ROWS) row = LCD_FB_ROWS - 1;
+    if (column > LCD_FB_COLUMNS) column = LCD_FB_COLUMNS;
+    drawCell = cellIndex(column, row);
+    drawEnd = cellIndex(0, row) + LCD_FB_COLUMNS;
+}
+
+void LcdFramebuffer::print(const char* text) {
+    while (*text && drawCell < drawEnd) {
+        frame[drawCell++] = *text++;
+    }
+}
+
+void LcdFramebuffer::printf(const char* format, ...) {
+    char text[LCD_FB_COLUMNS + 1];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    print(text);
+}
+
+char LcdFramebuffer::getCell(uint8_t column, uint8_t row) const {
+    if (column >= LCD_FB_COLUMNS || row >= LCD_FB_ROWS) return 0;
+    return frame[cellIndex(column, row)];
+}
+
+// ==================== FLUSH ====================
+
+uint8_t LcdFramebuffer::flush(LcdSink& sink) {
+    if (!shownValid) {
+        memset(shown, 0, sizeof(shown));
+        shownValid = true;
+    }
+
+    uint8_t sent = 0;
+    uint8_t cell = 0;
+    while (cell < LCD_FB_CELLS) {
+        if (frame[cell] == shown[cell]) {
+            cell++;
+            continue;
+        }
+
+        // Extend the run over gaps of up to LCD_FB_MERGE_GAP clean cells
+        uint8_t end = cell + 1;
+        for (uint8_t scan = end; scan < LCD_FB_CELLS && scan - end <= LCD_FB_MERGE_GAP; scan++) {
+            if (frame[scan] != shown[scan]) end = scan + 1;
+        }
+
+        if (cursor != cell) {
+            sink.setAddress(cellAddress(cell));
+            stats.cursorMoves++;
+        }
+        for (uint8_t i = cell; i < end; i++) {
+            sink.write((uint8_t)frame[i]);
+            shown[i] = frame[i];
+        }
+        sent += end - cell;
+
+        // The address counter steps on, from the end of DDRAM back to 0
+        cursor = end % LCD_FB_CELLS;
+        cell = end;
+    }
+
+    stats.flushes++;
+    stats.cellsSent += sent;
+    stats.lastCells = sent;
+    return sent;
+}
+
+void LcdFramebuffer::panelCleared() {
+    memset(shown, ' ', sizeof(shown));
+    shownValid = true;
+    cursor = 0;
+}
+
+void LcdFramebuffer::invalidate() {
+    shownValid = false;
+    cursor = LCD_FB_CELLS;              // Unknown
+}
+
+const LcdFramebufferStats& LcdFramebuffer::getStats() const {
+    return stats;
+}
@@ -0,0 +1,79 @@
+#include "link_stats.h"
+#include <stdlib.h>
+
+const char* linkEventName(LinkEvent event) {
+    switch (event) {
+        case LINK_FIRST: return "first";
+        case LINK_NEXT: return "next";
+        case LINK_LATE: return "late";
+        case LINK_DUPLICATE: return "duplicate";
+        case LINK_RESTART: return "restart";
+    }
+    return "?";
+}
+
+// Make `sequence` the newest packet of a fresh window
+static void linkStart(LinkTracker& link, uint16_t sequence, uint32_t sent_ms, uint32_t arrival_ms) {
+    link.newest = sequence;
+    link.primed = 1;
+    link.window = 1;
+    link.lastArrival_ms = arrival_ms;
+    link.lastSent_ms = sent_ms;
+}
+
+LinkEvent linkRecord(LinkTracker& link, NodeStatistics& stats, uint16_t sequence,
+                     uint32_t sent_ms, uint32_t arrival_ms, int8_t rssi) {
+    LinkEvent event;
+    int16_t ahead = (int16_t)(sequence - link.newest);
+
+    if (!link.primed) {
+        event = LINK_FIRST;
+        linkStart(link, sequence, sent_ms, arrival_ms);
+    } else if (ahead > 0 && (int32_t)(sent_ms - link.lastSent_ms) >= 0) {
+        event = LINK_NEXT;
+        stats.packetsLost += ahead - 1;
+        link.window = ahead >= LINK_WINDOW ? 1 : (link.window << ahead) | 1;
+
+        // Difference in transit time of consecutive packets (RFC 3550 6.4.1)
+        int32_t arrivalGap = (int32_t)(arrival_ms - link.lastArrival_ms);
+        int32_t sentGap = (int32_t)(sent_ms - link.lastSent_ms);
+        float transit = (float)abs(arrivalGap - sentGap);
+        stats.jitter_ms += (transit - stats.jitter_ms) / LINK_JITTER_GAIN;
+        float interval = (float)arrivalGap / ahead;
+        stats.interval_ms = stats.interval_ms == 0.0f
+            ? interval : stats.interval_ms + (interval - stats.interval_ms) / LINK_AVERAGE_GAIN;
+
+        link.newest = sequence;
+        link.lastArrival_ms = arrival_ms;
+        link.lastSent_ms = sent_ms;
+    } else if (ahead <= 0 && -ahead < LINK_WINDOW) {
+        uint32_t bit = 1UL << -ahead;
+        if (link.window & bit) {
+            stats.duplicates++;
+            link.lastEvent = LINK_DUPLICATE;
+            return LINK_DUPLICATE;
+        }
+        event = LINK_LATE;
+        link.window |= bit;
+        if (stats.packetsLost > 0) stats.packetsLost--;
+    } else {
+        // Far behind, or ahead while the sender clock went back
+        event = LINK_RESTART;
+        stats.restarts++;
+        linkStart(link, sequence, sent_ms, arrival_ms);
+    }
+
+    stats.packetsReceived++;
+    if (rssi != 0) {
+        stats.lastRSSI = rssi;
+        stats.averageRSSI = stats.averageRSSI == 0.0f
+            ? rssi : stats.averageRSSI + (rssi - stats.averageRSSI) / LINK_AVERAGE_GAIN;
+    }
+    link.lastEvent = event;
+    return event;
+}
+
+float linkLossRate(const NodeStatistics& stats) {
+    uint32_t sent = stats.packetsReceived + stats.packetsLost;
+    return sent ? (float)stats.packetsLost / sent : 0.0f;
+}
@@ -0,0 +1,132 @@
+#include "node_registry.h"
+#include "protocol.h"
+#include <string.h>
+
+// Constructor
+NodeRegistry::NodeRegistry(NodeEntry* slots, uint16_t slotCount, uint16_t* order, uint16_t maxNodes) {
+    this->slots = slots;
+    this->order = order;
+    this->mask = slotCount - 1;
+    // Never fill the table completely, so probing always meets a free slot
+    this->maxNodes = maxNodes < slotCount ? maxNodes : slotCount - 1;
+    clear();
+}
+
+void NodeRegistry::clear() {
+    memset(slots, 0, sizeof(NodeEntry) * (mask + 1));
+    count = 0;
+    rejected = 0;
+    lookups = 0;
+    probes = 0;
+}
+
+bool NodeRegistry::copyFrom(const NodeRegistry& other) {
+    if (other.mask != mask || other.count > maxNodes) return false;
+    memcpy(slots, other.slots, sizeof(NodeEntry) * (mask + 1));
+    memcpy(order, other.order, sizeof(uint16_t) * other.count);
+    count = other.count;
+    rejected = other.rejected;
+    lookups = other.lookups;
+    probes = other.probes;
+    return true;
+}
+
+// Vendor bytes (the first three) are shared by most senders, so all six
+// are folded in and mixed with a multiplicative hash
+uint32_t NodeRegistry::hashMac(const uint8_t* mac) {
+    uint64_t key = 0;
+    for (int i = 0; i < 6; i++) {
+        key = (key << 8) | mac[i];
+    }
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(key >> 32);
+}
+
+NodeEntry* NodeRegistry::find(const uint8_t* mac) {
+    lookups++;
+    uint32_t index = hashMac(mac) & mask;
+    while (true) {
+        probes++;
+        NodeEntry& entry = slots[index];
+        if (!entry.used) return nullptr;
+        if (memcmp(entry.mac, mac, 6) == 0) return &entry;
+        index = (index + 1) & mask;
+    }
+}
+
+NodeEntry* NodeRegistry::findOrAdd(const uint8_t* mac, uint32_t now_ms) {
+    lookups++;
+    uint32_t index = hashMac(mac) & mask;
+    while (true) {
+        probes++;
+        NodeEntry& entry = slots[index];
+        if (entry.used) {
+            if (memcmp(entry.mac, mac, 6) == 0) return &entry;
+            index = (index + 1) & mask;
+            continue;
+        }
+
+        // First free slot of the probe sequence: the sender is new
+        if (count >= maxNodes) {
+            rejected++;
+            return nullptr;
+        }
+        memcpy(entry.mac, mac, 6);
+        entry.used = true;
+        entry.firstHeard_ms = now_ms;
+        entry.lastHeard_ms = now_ms;
+        order[count++] = (uint16_t)index;
+        return &entry;
+    }
+}
+
+NodeEntry* NodeRegistry::record(const uint8_t* mac, const uint8_t* packet, size_t length, uint32_t now_ms,
+                                int8_t rssi) {
+    NodeEntry* entry = findOrAdd(mac, now_ms);
+    if (entry == nullptr) return nullptr;
+
+    PacketHeader header;
+    memcpy(&header, packet, sizeof(header));
+    LinkEvent event = linkRecord(entry->link, entry->stats, header.sequence, header.timestamp, now_ms, rssi);
+    if (event == LINK_DUPLICATE) return entry;
+
+    entry->lastHeard_ms = now_ms;
+    entry->readings += 1 + header.skipped;
+    if (header.flags & PACKET_FLAG_HEARTBEAT) entry->heartbeats++;
+    if (event == LINK_LATE) return entry;  // Older than the packet kept
+
+    if (length > sizeof(NodePacket)) length = sizeof(NodePacket);
+    memcpy(&entry->packet, packet, length);
+    entry->nodeType = header.nodeId;
+    entry->stats.uptimeSeconds = header.timestamp / 1000;
+    return entry;
+}
+
+uint16_t NodeRegistry::size() const {
+    return count;
+}
+
+NodeEntry& NodeRegistry::at(uint16_t index) {
+    return slots[order[index]];
+}
+
+const NodeEntry& NodeRegistry::at(uint16_t index) const {
+    return slots[order[index]];
+}
+
+uint32_t NodeRegistry::getRejected() const {
+    return rejected;
+}
+
+float NodeRegistry::getAverageProbes() const {
+    return lookups ? (float)probes / lookups : 0.0f;
+}
+
+void formatNodeKey(const uint8_t* mac, char* out) {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    for (int i = 0; i < 6; i++) {
+        out[i * 2] = HEX_DIGITS[mac[i] >> 4];
+        out[i * 2 + 1] = HEX_DIGITS[mac[i] & 0x0F];
+    }
+    out[12] = '\0';
+}
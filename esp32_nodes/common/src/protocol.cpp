@@ -0,0 +1,92 @@
+#include "protocol.h"
+
+// Total packet size per PacketType (index 0 = invalid)
+static const uint8_t PACKET_SIZES[PACKET_TYPE_COUNT] = {
+    0,
+    sizeof(SoilNodeData),
+    sizeof(WeatherNodeData),
+    sizeof(PacketHeader)
+};
+
+static_assert(sizeof(PacketHeader) == 13, "PacketHeader wire size changed, bump PROTOCOL_VERSION");
+static_assert(sizeof(SoilNodeData) == 19, "SoilNodeData wire size changed, bump PROTOCOL_VERSION");
+static_assert(sizeof(WeatherNodeData) == 39, "WeatherNodeData wire size changed, bump PROTOCOL_VERSION");
+
+// Offset of the checksum byte inside PacketHeader
+#define CHECKSUM_OFFSET (sizeof(PacketHeader) - 1)
+
+int16_t toFixedS16(float value, float scale) {
+    float scaled = value * scale;
+    if (scaled >= 32767.0f) return 32767;
+    if (scaled <= -32768.0f) return -32768;
+    return (int16_t)(scaled + (scaled >= 0 ? 0.5f : -0.5f));
+}
+
+uint16_t toFixedU16(float value, float scale) {
+    float scaled = value * scale;
+    if (scaled >= 65535.0f) return 65535;
+    if (scaled <= 0.0f) return 0;
+    return (uint16_t)(scaled + 0.5f);
+}
+
+uint8_t protocolPacketSize(uint8_t packetType) {
+    return packetType < PACKET_TYPE_COUNT ? PACKET_SIZES[packetType] : 0;
+}
+
+// Shift one byte into the CRC
+static inline uint8_t crc8Step(uint8_t crc, uint8_t byte) {
+    crc ^= byte;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (uint8_t)((crc << 1) ^ (0x07 & -(crc >> 7)));
+    }
+    return crc;
+}
+
+uint8_t crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc = crc8Step(crc, data[i]);
+    }
+    return crc;
+}
+
+uint8_t protocolChecksum(const uint8_t* packet, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        // Mask the checksum byte to 0 without branching on the position
+        uint8_t keep = (uint8_t)-(uint8_t)(i != CHECKSUM_OFFSET);
+        crc = crc8Step(crc, packet[i] & keep);
+    }
+    return crc;
+}
+
+void protocolSeal(PacketHeader* header, size_t length, uint8_t nodeId,
+                  uint8_t packetType, uint16_t sequence, uint32_t timestamp) {
+    header->version = PROTOCOL_VERSION;
+    header->nodeId = nodeId;
+    header->packetType = packetType;
+    header->timestamp = timestamp;
+    header->sequence = sequence;
+    header->checksum = protocolChecksum((const uint8_t*)header, length);
+}
+
+uint8_t protocolValidate(const uint8_t* packet, int length) {
+    // Nothing else can be read from a runt frame
+    if (packet == nullptr || length < (int)sizeof(PacketHeader) || length > PROTOCOL_MAX_PACKET) {
+        return PACKET_ERR_SHORT;
+    }
+
+    const PacketHeader* header = (const PacketHeader*)packet;
+    uint8_t type = header->packetType;
+
+    // Unknown types index slot 0 (size 0), so the length check fails too
+    uint8_t known = (uint8_t)(type < PACKET_TYPE_COUNT);
+    uint8_t expected = PACKET_SIZES[type * known];
+
+    uint8_t result = PACKET_OK;
+    result |= (uint8_t)(header->version != PROTOCOL_VERSION) * PACKET_ERR_VERSION;
+    result |= (uint8_t)(known == 0 || type == PACKET_INVALID) * PACKET_ERR_TYPE;
+    result |= (uint8_t)(expected != length) * PACKET_ERR_LENGTH;
+    result |= (uint8_t)(protocolChecksum(packet, length) != header->checksum) * PACKET_ERR_CHECKSUM;
+    return result;
+}
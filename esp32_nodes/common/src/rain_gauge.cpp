@@ -0,0 +1,130 @@
+#include "rain_gauge.h"
+#include <stddef.h>
+#include <string.h>
+
+RainGauge::RainGauge(RainGaugeState* state, float mmPerTip) : state(state), mmPerTip(mmPerTip) {
+}
+
+// FNV-style hash over every word before the checksum field
+uint32_t RainGauge::checksum() const {
+    const uint32_t* words = (const uint32_t*)state;
+    uint32_t sum = 0x9E3779B9;
+    for (size_t i = 0; i < offsetof(RainGaugeState, checksum) / sizeof(uint32_t); i++) {
+        sum = (sum ^ words[i]) * 16777619u;
+    }
+    return sum;
+}
+
+void RainGauge::seal() {
+    state->checksum = checksum();
+}
+
+bool RainGauge::restore() {
+    if (state->magic == RAIN_STATE_MAGIC && state->checksum == checksum()) {
+        return true;
+    }
+    clear();
+    return false;
+}
+
+void RainGauge::clear() {
+    memset(state, 0, sizeof(RainGaugeState));
+    state->magic = RAIN_STATE_MAGIC;
+    seal();
+}
+
+// Empty the buckets of every minute and hour that passed; a clock that
+// went backwards leaves them alone
+void RainGauge::advance(uint32_t now) {
+    uint32_t minute = now / 60;
+    if (minute > state->minute) {
+        uint32_t passed = minute - state->minute;
+        if (passed > 60) passed = 60;
+        for (uint32_t i = 1; i <= passed; i++) {
+            state->minuteTips[(state->minute + i) % 60] = 0;
+        }
+        state->minute = minute;
+    }
+
+    uint32_t hour = now / 3600;
+    if (hour > state->hour) {
+        uint32_t passed = hour - state->hour;
+        if (passed > 24) passed = 24;
+        for (uint32_t i = 1; i <= passed; i++) {
+            state->hourTips[(state->hour + i) % 24] = 0;
+        }
+        state->hour = hour;
+    }
+}
+
+void RainGauge::addTip(uint32_t time) {
+    advance(time);
+
+    // Late tips still count when their bucket is inside the window
+    uint32_t minute = time / 60;
+    if (minute + 60 > state->minute) state->minuteTips[minute % 60]++;
+    uint32_t hour = time / 3600;
+    if (hour + 24 > state->hour) state->hourTips[hour % 24]++;
+
+    if (state->totalTips == 0 || time - state->lastTip > RAIN_EVENT_GAP_S) {
+        state->eventTips = 0;
+        state->eventStart = time;
+    }
+    state->eventTips++;
+    state->totalTips++;
+    state->lastTip = time;
+
+    state->recentTips[state->recentHead] = time;
+    state->recentHead = (uint16_t)((state->recentHead + 1) % RAIN_RECENT_TIPS);
+    if (state->recentCount < RAIN_RECENT_TIPS) state->recentCount++;
+
+    seal();
+}
+
+float RainGauge::lastHour(uint32_t now) {
+    advance(now);
+    seal();
+    uint32_t tips = 0;
+    for (int i = 0; i < 60; i++) tips += state->minuteTips[i];
+    return tips * mmPerTip;
+}
+
+float RainGauge::last24h(uint32_t now) {
+    advance(now);
+    seal();
+    uint32_t tips = 0;
+    for (int i = 0; i < 24; i++) tips += state->hourTips[i];
+    return tips * mmPerTip;
+}
+
+float RainGauge::event(uint32_t now) const {
+    if (state->totalTips == 0 || now - state->lastTip > RAIN_EVENT_GAP_S) return 0.0f;
+    return state->eventTips * mmPerTip;
+}
+
+// Tips in the window over their span; the span is at least the time
+// since the newest tip, so the rate decays once rain stops
+float RainGauge::intensity(uint32_t now) const {
+    uint32_t count = 0;
+    uint32_t newest = 0;
+    uint32_t oldest = 0;
+    for (uint16_t k = 0; k < state->recentCount; k++) {
+        uint32_t t = state->recentTips[(state->recentHead + RAIN_RECENT_TIPS - 1 - k) % RAIN_RECENT_TIPS];
+        if (now - t > RAIN_INTENSITY_WINDOW_S) break;
+        if (count == 0) newest = t;
+        oldest = t;
+        count++;
+    }
+
+    if (count == 0) return 0.0f;
+    if (count == 1) return mmPerTip * 3600.0f / RAIN_INTENSITY_WINDOW_S;
+
+    uint32_t span = newest - oldest;
+    if (now - newest > span) span = now - newest;
+    if (span == 0) span = 1;
+    return (count - 1) * mmPerTip * 3600.0f / span;
+}
+
+uint32_t RainGauge::totalTips() const {
+    return state->totalTips;
+}
@@ -0,0 +1,96 @@
+#include "report_filter.h"
+#include <math.h>
+
+ReportFilter::ReportFilter(ReportFilterState* state, const ReportChannel* channels, uint8_t count,
+                           uint32_t maxSilence_ms) {
+    this->state = state;
+    this->channels = channels;
+    this->count = count > REPORT_MAX_CHANNELS ? REPORT_MAX_CHANNELS : count;
+    this->maxSilence_ms = maxSilence_ms;
+}
+
+const char* reportDecisionName(ReportDecision decision) {
+    switch (decision) {
+        case REPORT_SUPPRESS: return "suppressed";
+        case REPORT_FIRST: return "first";
+        case REPORT_CHANGE: return "change";
+        case REPORT_HEARTBEAT: return "heartbeat";
+        case REPORT_FORCED: return "forced";
+    }
+    return "?";
+}
+
+// Distance from the last sent value; NaN compares as changed
+static float channelDelta(const ReportChannel& channel, float value, float last) {
+    float delta = fabsf(value - last);
+    if (channel.circular) {
+        delta = fmodf(delta, 360.0f);
+        if (delta > 180.0f) delta = 360.0f - delta;
+    }
+    return delta;
+}
+
+ReportDecision ReportFilter::evaluate(const float* values, uint32_t now_ms, bool force) {
+    state->samples++;
+
+    ReportDecision decision = REPORT_SUPPRESS;
+    if (!state->primed) {
+        decision = REPORT_FIRST;
+    } else {
+        for (uint8_t i = 0; i < count; i++) {
+            float delta = channelDelta(channels[i], values[i], state->lastSent[i]);
+            if (!(delta <= channels[i].deadband)) {
+                decision = REPORT_CHANGE;
+                state->trigger = i;
+                break;
+            }
+        }
+        if (decision == REPORT_SUPPRESS && now_ms - state->lastSendTime >= maxSilence_ms) {
+            decision = REPORT_HEARTBEAT;
+        }
+        if (decision == REPORT_SUPPRESS && force) {
+            decision = REPORT_FORCED;
+        }
+    }
+
+    if (decision == REPORT_SUPPRESS) {
+        if (state->skipped < UINT16_MAX) state->skipped++;
+        return decision;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        state->lastSent[i] = values[i];
+    }
+    state->lastSendTime = now_ms;
+    state->primed = 1;
+    state->sent++;
+    if (decision == REPORT_HEARTBEAT) state->heartbeats++;
+    state->skippedBeforeSend = state->skipped;
+    state->skipped = 0;
+    return decision;
+}
+
+uint16_t ReportFilter::getSkipped() const {
+    return state->skippedBeforeSend;
+}
+
+const char* ReportFilter::getTriggerName() const {
+    return state->trigger >= 0 && state->trigger < count ? channels[state->trigger].name : "";
+}
+
+uint32_t ReportFilter::getSamples() const {
+    return state->samples;
+}
+
+uint32_t ReportFilter::getSent() const {
+    return state->sent;
+}
+
+uint32_t ReportFilter::getHeartbeats() const {
+    return state->heartbeats;
+}
+
+float ReportFilter::getSuppressionRatio() const {
+    if (state->samples == 0) return 0.0f;
+    return 1.0f - (float)state->sent / state->samples;
+}
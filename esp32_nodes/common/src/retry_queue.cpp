@@ -0,0 +1,126 @@
+#include "retry_queue.h"
+#include <string.h>
+
+// Constructor
+RetryQueue::RetryQueue(uint8_t maxRetry, uint32_t baseDelay_ms, uint32_t maxDelay_ms, uint32_t seed) {
+    this->maxRetry = maxRetry;
+    this->baseDelay_ms = baseDelay_ms;
+    this->maxDelay_ms = maxDelay_ms;
+    this->random = seed ? seed : 1;
+    this->head = 0;
+    this->count = 0;
+    this->inFlight = false;
+    memset(&stats, 0, sizeof(stats));
+}
+
+void RetryQueue::pop() {
+    head = (head + 1) % RETRY_QUEUE_SLOTS;
+    count--;
+}
+
+bool RetryQueue::push(const uint8_t* packet, size_t length, uint32_t now_ms) {
+    if (length > PROTOCOL_MAX_PACKET) return false;
+    stats.queued++;
+
+    PacketHeader header;
+    memcpy(&header, packet, sizeof(header));
+
+    // Supersede a waiting packet of the same type (never the one on the air)
+    for (uint8_t i = inFlight ? 1 : 0; i < count; i++) {
+        Slot& slot = slots[(head + i) % RETRY_QUEUE_SLOTS];
+        PacketHeader* old = (PacketHeader*)slot.data;
+        if (old->packetType != header.packetType) continue;
+
+        // A packet that was never on the air cannot have arrived: its
+        // readings and sequence number pass to the new one. One that was
+        // may have (only its ACK lost), so it is not counted twice.
+        bool unsent = slot.attempts == 0;
+        uint32_t skipped = header.skipped;
+        uint16_t sequence = header.sequence;
+        if (unsent) {
+            skipped += old->skipped + 1;
+            sequence = old->sequence;
+        }
+
+        memcpy(slot.data, packet, length);
+        slot.length = (uint8_t)length;
+        PacketHeader* replaced = (PacketHeader*)slot.data;
+        replaced->skipped = skipped > UINT16_MAX ? UINT16_MAX : (uint16_t)skipped;
+        protocolSeal(replaced, length, replaced->nodeId, replaced->packetType,
+                     sequence, replaced->timestamp);
+        stats.superseded++;
+        return unsent;
+    }
+
+    // Full: the oldest packet that is not on the air makes room
+    if (count == RETRY_QUEUE_SLOTS) {
+        for (uint8_t i = inFlight ? 1 : 0; i + 1 < count; i++) {
+            slots[(head + i) % RETRY_QUEUE_SLOTS] = slots[(head + i + 1) % RETRY_QUEUE_SLOTS];
+        }
+        count--;
+        stats.overflow++;
+    }
+
+    Slot& slot = slots[(head + count) % RETRY_QUEUE_SLOTS];
+    memcpy(slot.data, packet, length);
+    slot.length = (uint8_t)length;
+    slot.attempts = 0;
+    slot.due_ms = now_ms;
+    count++;
+    return false;
+}
+
+const uint8_t* RetryQueue::next(uint32_t now_ms, size_t& length) {
+    if (count == 0 || inFlight) return nullptr;
+
+    Slot& slot = slots[head];
+    if ((int32_t)(now_ms - slot.due_ms) < 0) return nullptr;
+
+    if (slot.attempts > 0) stats.retries++;
+    stats.attempts++;
+    slot.attempts++;
+    inFlight = true;
+    length = slot.length;
+    return slot.data;
+}
+
+void RetryQueue::complete(bool delivered, uint32_t now_ms) {
+    if (!inFlight) return;
+    inFlight = false;
+
+    Slot& slot = slots[head];
+    if (delivered) {
+        stats.delivered++;
+        pop();
+    } else if (slot.attempts > maxRetry) {
+        stats.expired++;
+        pop();
+    } else {
+        slot.due_ms = now_ms + backoff(slot.attempts);
+    }
+}
+
+uint32_t RetryQueue::backoff(uint8_t attempt) {
+    uint32_t delay = maxDelay_ms;
+    if (attempt > 0 && attempt <= 16) {
+        uint32_t exponential = baseDelay_ms << (attempt - 1);
+        if (exponential < delay) delay = exponential;
+    }
+
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return delay / 2 + random % (delay / 2 + 1);
+}
+
+uint8_t RetryQueue::size() const {
+    return count;
+}
+
+bool RetryQueue::busy() const {
+    return inFlight;
+}
+
+const RetryStats& RetryQueue::getStats() const {
+    return stats;
+}
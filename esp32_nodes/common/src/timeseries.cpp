@@ -0,0 +1,499 @@
+#include "timeseries.h"
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#endif
+
+// Worst-case bits of one sample (4 + 32 timestamp, 2 + 5 + 5 + 32 value)
+#define TS_MAX_SAMPLE_BITS 80
+
+// Rollup widths per TsResolution
+static const uint32_t RESOLUTION_WIDTH[TS_RESOLUTION_COUNT] = {
+    60UL * 1000UL,
+    15UL * 60UL * 1000UL,
+    60UL * 60UL * 1000UL
+};
+
+const TsLayout TS_FULL_LAYOUT = {
+    TS_BLOCKS_PER_CHANNEL, { TS_MINUTE_BUCKETS, TS_QUARTER_BUCKETS, TS_HOUR_BUCKETS }
+};
+
+const TsLayout TS_COMPACT_LAYOUT = {
+    TS_COMPACT_BLOCKS_PER_CHANNEL,
+    { TS_COMPACT_MINUTE_BUCKETS, TS_COMPACT_QUARTER_BUCKETS, TS_COMPACT_HOUR_BUCKETS }
+};
+
+// ==================== BIT STREAM ====================
+static void writeBits(uint8_t* data, uint16_t& bitLength, uint32_t value, uint8_t bits) {
+    for (int i = bits - 1; i >= 0; i--) {
+        uint16_t byte = bitLength >> 3;
+        uint8_t mask = 0x80 >> (bitLength & 7);
+        if ((value >> i) & 1) {
+            data[byte] |= mask;
+        } else {
+            data[byte] &= ~mask;
+        }
+        bitLength++;
+    }
+}
+
+static uint32_t readBits(const uint8_t* data, uint16_t& position, uint8_t bits) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < bits; i++) {
+        value = (value << 1) | ((data[position >> 3] >> (7 - (position & 7))) & 1);
+        position++;
+    }
+    return value;
+}
+
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static uint8_t leadingZeros(uint32_t value) {
+    uint8_t count = 0;
+    for (uint32_t mask = 0x80000000UL; mask != 0 && !(value & mask); mask >>= 1) count++;
+    return count;
+}
+
+static uint8_t trailingZeros(uint32_t value) {
+    uint8_t count = 0;
+    for (uint32_t mask = 1; mask != 0 && !(value & mask); mask <<= 1) count++;
+    return count;
+}
+
+// Sign-extend the low `bits` bits
+static int32_t signExtend(uint32_t value, uint8_t bits) {
+    uint32_t sign = 1UL << (bits - 1);
+    return (int32_t)((value ^ sign) - sign);
+}
+
+// ==================== DELTA-OF-DELTA TIMESTAMPS ====================
+// '0' same interval, '10' + 8 bits, '110' + 14 bits, '1110' + 20 bits,
+// '1111' + 32 bits
+static void writeTimestamp(uint8_t* data, uint16_t& bitLength, int32_t dod) {
+    if (dod == 0) {
+        writeBits(data, bitLength, 0x0, 1);
+    } else if (dod >= -128 && dod < 128) {
+        writeBits(data, bitLength, 0x2, 2);
+        writeBits(data, bitLength, (uint32_t)dod & 0xFF, 8);
+    } else if (dod >= -8192 && dod < 8192) {
+        writeBits(data, bitLength, 0x6, 3);
+        writeBits(data, bitLength, (uint32_t)dod & 0x3FFF, 14);
+    } else if (dod >= -524288 && dod < 524288) {
+        writeBits(data, bitLength, 0xE, 4);
+        writeBits(data, bitLength, (uint32_t)dod & 0xFFFFF, 20);
+    } else {
+        writeBits(data, bitLength, 0xF, 4);
+        writeBits(data, bitLength, (uint32_t)dod, 32);
+    }
+}
+
+static int32_t readTimestamp(const uint8_t* data, uint16_t& position) {
+    if (readBits(data, position, 1) == 0) return 0;
+    if (readBits(data, position, 1) == 0) return signExtend(readBits(data, position, 8), 8);
+    if (readBits(data, position, 1) == 0) return signExtend(readBits(data, position, 14), 14);
+    if (readBits(data, position, 1) == 0) return signExtend(readBits(data, position, 20), 20);
+    return (int32_t)readBits(data, position, 32);
+}
+
+// ==================== STORE ====================
+// Constructor
+TimeSeriesStore::TimeSeriesStore() {
+    this->channels = nullptr;
+    memset(&this->layout, 0, sizeof(this->layout));
+    this->allocated = 0;
+    this->recycled = 0;
+}
+
+TimeSeriesStore::~TimeSeriesStore() {
+    free(channels);
+}
+
+// Bytes of one allocation holding every channel with this layout
+size_t TimeSeriesStore::layoutSize(const TsLayout& layout) {
+    size_t buckets = 0;
+    for (int level = 0; level < TS_RESOLUTION_COUNT; level++) {
+        buckets += layout.buckets[level];
+    }
+    return TS_CHANNEL_COUNT * (sizeof(Channel) + layout.blocksPerChannel * sizeof(Block) +
+                               buckets * sizeof(Bucket));
+}
+
+// Lay the channels, then all blocks, then all buckets out in `memory`
+void TimeSeriesStore::carve(void* memory, const TsLayout& layout) {
+    channels = (Channel*)memory;
+    Block* blocks = (Block*)(channels + TS_CHANNEL_COUNT);
+    Bucket* buckets = (Bucket*)(blocks + TS_CHANNEL_COUNT * layout.blocksPerChannel);
+
+    for (int i = 0; i < TS_CHANNEL_COUNT; i++) {
+        Channel& channel = channels[i];
+        channel.blocks = blocks;
+        blocks += layout.blocksPerChannel;
+        for (int level = 0; level < TS_RESOLUTION_COUNT; level++) {
+            channel.rollups[level].buckets = buckets;
+            channel.rollups[level].capacity = layout.buckets[level];
+            buckets += layout.buckets[level];
+        }
+    }
+    this->layout = layout;
+}
+
+// Allocate the channel storage
+bool TimeSeriesStore::begin() {
+    if (channels != nullptr) return true;
+
+#ifdef ESP_PLATFORM
+    // Prefer PSRAM, keep internal RAM for WiFi and TLS
+    size_t size = layoutSize(TS_FULL_LAYOUT);
+    void* memory = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (memory != nullptr) {
+        memset(memory, 0, size);
+        carve(memory, TS_FULL_LAYOUT);
+        allocated = size;
+        return true;
+    }
+    return begin(TS_COMPACT_LAYOUT);
+#else
+    return begin(TS_FULL_LAYOUT);
+#endif
+}
+
+// Allocate the channel storage with a given layout
+bool TimeSeriesStore::begin(const TsLayout& layout) {
+    if (channels != nullptr) return true;
+    if (layout.blocksPerChannel == 0) return false;
+    for (int level = 0; level < TS_RESOLUTION_COUNT; level++) {
+        if (layout.buckets[level] == 0) return false;
+    }
+
+    size_t size = layoutSize(layout);
+    void* memory = malloc(size);
+    if (memory == nullptr) return false;
+
+    memset(memory, 0, size);
+    carve(memory, layout);
+    allocated = size;
+    return true;
+}
+
+// Encode one sample into a block; false when the block is full
+bool TimeSeriesStore::appendToBlock(Block& block, uint32_t time, float value) {
+    uint32_t bits = floatBits(value);
+
+    if (block.count == 0) {
+        block.bitLength = 0;
+        block.firstTime = time;
+        block.lastTime = time;
+        block.lastDelta = 0;
+        block.lastBits = bits;
+        block.leading = 0xFF;  // No XOR window yet
+        block.trailing = 0;
+        writeBits(block.data, block.bitLength, bits, 32);
+        block.count = 1;
+        return true;
+    }
+
+    if (block.bitLength + TS_MAX_SAMPLE_BITS > TS_BLOCK_BYTES * 8 || block.count == 0xFFFF) {
+        return false;
+    }
+
+    // Timestamp
+    int32_t delta = (int32_t)(time - block.lastTime);
+    writeTimestamp(block.data, block.bitLength, delta - block.lastDelta);
+    block.lastDelta = delta;
+    block.lastTime = time;
+
+    // Value
+    uint32_t x = bits ^ block.lastBits;
+    block.lastBits = bits;
+    if (x == 0) {
+        writeBits(block.data, block.bitLength, 0, 1);
+    } else {
+        uint8_t leading = leadingZeros(x);
+        uint8_t trailing = trailingZeros(x);
+        if (leading > 31) leading = 31;
+
+        if (block.leading != 0xFF && leading >= block.leading && trailing >= block.trailing) {
+            // Fits the previous window
+            writeBits(block.data, block.bitLength, 0x2, 2);
+            uint8_t length = 32 - block.leading - block.trailing;
+            writeBits(block.data, block.bitLength, x >> block.trailing, length);
+        } else {
+            uint8_t length = 32 - leading - trailing;
+            writeBits(block.data, block.bitLength, 0x3, 2);
+            writeBits(block.data, block.bitLength, leading, 5);
+            writeBits(block.data, block.bitLength, length - 1, 5);
+            writeBits(block.data, block.bitLength, x >> trailing, length);
+            block.leading = leading;
+            block.trailing = trailing;
+        }
+    }
+
+    block.count++;
+    return true;
+}
+
+// Decode the samples of a block within [from, to]
+size_t TimeSeriesStore::decodeBlock(const Block& block, uint32_t from, uint32_t to,
+                                    TsPoint* out, size_t max) {
+    if (block.count == 0 || max == 0) return 0;
+    if (block.lastTime < from || block.firstTime > to) return 0;
+
+    size_t found = 0;
+    uint16_t position = 0;
+    uint32_t bits = readBits(block.data, position, 32);
+    uint32_t time = block.firstTime;
+    int32_t delta = 0;
+    uint8_t leading = 0;
+    uint8_t trailing = 0;
+
+    for (uint16_t i = 0; i < block.count; i++) {
+        if (i > 0) {
+            delta += readTimestamp(block.data, position);
+            time += delta;
+
+            if (readBits(block.data, position, 1) == 1) {
+                if (readBits(block.data, position, 1) == 1) {
+                    leading = readBits(block.data, position, 5);
+                    uint8_t length = readBits(block.data, position, 5) + 1;
+                    trailing = 32 - leading - length;
+                }
+                uint8_t length = 32 - leading - trailing;
+                bits ^= readBits(block.data, position, length) << trailing;
+            }
+        }
+
+        if (time > to) break;
+        if (time >= from) {
+            out[found].time = time;
+            out[found].value = bitsFloat(bits);
+            if (++found == max) break;
+        }
+    }
+    return found;
+}
+
+// Fold a sample into the open bucket of a rollup level
+void TimeSeriesStore::addToRollup(RollupRing& ring, uint32_t width, uint32_t time, float value) {
+    uint32_t start = time - time % width;
+    Bucket* bucket = ring.count > 0 ? &ring.buckets[ring.head] : nullptr;
+
+    if (bucket == nullptr || bucket->start != start) {
+        // Out-of-order samples only update the raw series
+        if (bucket != nullptr && start < bucket->start) return;
+
+        ring.head = ring.count > 0 ? (ring.head + 1) % ring.capacity : 0;
+        if (ring.count < ring.capacity) ring.count++;
+
+        bucket = &ring.buckets[ring.head];
+        bucket->start = start;
+        bucket->min = value;
+        bucket->max = value;
+        bucket->sum = 0;
+        bucket->count = 0;
+    }
+
+    if (value < bucket->min) bucket->min = value;
+    if (value > bucket->max) bucket->max = value;
+    bucket->sum += value;
+    bucket->count++;
+}
+
+// Forget the history of a channel
+void TimeSeriesStore::clearChannel(Channel& channel) {
+    channel.newest = 0;
+    channel.used = 0;
+    channel.hasLatest = false;
+    channel.blocks[0].count = 0;
+    for (int level = 0; level < TS_RESOLUTION_COUNT; level++) {
+        channel.rollups[level].head = 0;
+        channel.rollups[level].count = 0;
+    }
+}
+
+// Record a sample
+void TimeSeriesStore::record(TsChannel channel, uint32_t time, float value) {
+    if (channels == nullptr || channel < 0 || channel >= TS_CHANNEL_COUNT) return;
+    if (value != value) return;  // NaN marks a failed reading
+
+    Channel& c = channels[channel];
+    if (c.hasLatest && time < c.latest.time) {
+        // A small step back is a late sample; a large one is the millis()
+        // wrap (~49 days), after which the old history no longer sorts
+        if (c.latest.time - time < RESOLUTION_WIDTH[TS_HOUR]) return;
+        clearChannel(c);
+    }
+
+    if (c.used == 0) {
+        c.used = 1;
+        c.newest = 0;
+    }
+
+    if (!appendToBlock(c.blocks[c.newest], time, value)) {
+        // Start a new block, recycling the oldest when all are in use
+        c.newest = (c.newest + 1) % layout.blocksPerChannel;
+        if (c.used < layout.blocksPerChannel) {
+            c.used++;
+        } else {
+            recycled++;
+        }
+        c.blocks[c.newest].count = 0;
+        appendToBlock(c.blocks[c.newest], time, value);
+    }
+
+    c.latest.time = time;
+    c.latest.value = value;
+    c.hasLatest = true;
+
+    for (int level = 0; level < TS_RESOLUTION_COUNT; level++) {
+        addToRollup(c.rollups[level], RESOLUTION_WIDTH[level], time, value);
+    }
+}
+
+// Record every channel of a snapshot
+void TimeSeriesStore::recordSnapshot(const AllSensorData& data, uint32_t time) {
+    if (data.soilNodeConnected) {
+        record(TS_SOIL_MOISTURE, time, data.soilMoisture);
+        record(TS_SOIL_TEMP, time, data.soilTemp);
+        record(TS_SOIL_PH, time, data.soilPH);
+    }
+    if (data.weatherNodeConnected) {
+        record(TS_AIR_TEMP, time, data.airTemp);
+        record(TS_HUMIDITY, time, data.humidity);
+        record(TS_LIGHT, time, data.light);
+        record(TS_RAINFALL, time, data.rainfall);
+        record(TS_WIND_SPEED, time, data.windSpeed);
+        record(TS_WIND_DIRECTION, time, data.windDirection);
+        record(TS_LEAF_TEMP, time, data.leafTemp);
+        record(TS_LEAF_WETNESS, time, data.leafWetness);
+    }
+    record(TS_WATER_LEVEL, time, data.waterLevel);
+    record(TS_GAS, time, data.gas);
+    record(TS_CO2, time, data.co2);
+    record(TS_CO, time, data.co);
+    record(TS_WEIGHT, time, data.weight);
+}
+
+// Most recent sample
+bool TimeSeriesStore::latest(TsChannel channel, TsPoint& out) {
+    if (channels == nullptr || channel < 0 || channel >= TS_CHANNEL_COUNT) return false;
+    if (!channels[channel].hasLatest) return false;
+
+    out = channels[channel].latest;
+    return true;
+}
+
+// Raw samples within [from, to]
+size_t TimeSeriesStore::samples(TsChannel channel, uint32_t from, uint32_t to, TsPoint* out, size_t max) {
+    if (channels == nullptr || channel < 0 || channel >= TS_CHANNEL_COUNT) return 0;
+
+    Channel& c = channels[channel];
+    size_t found = 0;
+    for (uint8_t i = 0; i < c.used && found < max; i++) {
+        // Oldest block first
+        uint8_t index = (c.newest + layout.blocksPerChannel - c.used + 1 + i) % layout.blocksPerChannel;
+        found += decodeBlock(c.blocks[index], from, to, out + found, max - found);
+    }
+    return found;
+}
+
+// Rollup buckets starting within [from, to]
+size_t TimeSeriesStore::rollups(TsChannel channel, TsResolution resolution, uint32_t from, uint32_t to,
+                                TsRollup* out, size_t max) {
+    if (channels == nullptr || channel < 0 || channel >= TS_CHANNEL_COUNT) return 0;
+    if (resolution < 0 || resolution >= TS_RESOLUTION_COUNT) return 0;
+
+    RollupRing& ring = channels[channel].rollups[resolution];
+    size_t found = 0;
+    for (uint16_t i = 0; i < ring.count && found < max; i++) {
+        const Bucket& bucket = ring.buckets[(ring.head + ring.capacity - ring.count + 1 + i) % ring.capacity];
+        if (bucket.start < from || bucket.start > to) continue;
+
+        out[found].start = bucket.start;
+        out[found].min = bucket.min;
+        out[found].max = bucket.max;
+        out[found].mean = bucket.sum / bucket.count;
+        out[found].count = bucket.count;
+        found++;
+    }
+    return found;
+}
+
+// Combine rollup buckets into one
+bool TimeSeriesStore::aggregate(TsChannel channel, TsResolution resolution, uint32_t from, uint32_t to,
+                                TsRollup& out) {
+    if (channels == nullptr || channel < 0 || channel >= TS_CHANNEL_COUNT) return false;
+    if (resolution < 0 || resolution >= TS_RESOLUTION_COUNT) return false;
+
+    RollupRing& ring = channels[channel].rollups[resolution];
+    float sum = 0;
+    out.count = 0;
+
+    for (uint16_t i = 0; i < ring.count; i++) {
+        const Bucket& bucket = ring.buckets[(ring.head + ring.capacity - ring.count + 1 + i) % ring.capacity];
+        if (bucket.start < from || bucket.start > to) continue;
+
+        if (out.count == 0) {
+            out.start = bucket.start;
+            out.min = bucket.min;
+            out.max = bucket.max;
+        }
+        if (bucket.min < out.min) out.min = bucket.min;
+        if (bucket.max > out.max) out.max = bucket.max;
+        sum += bucket.sum;
+        out.count += bucket.count;
+    }
+
+    if (out.count == 0) return false;
+    out.mean = sum / out.count;
+    return true;
+}
+
+// Change of the latest value over a window
+bool TimeSeriesStore::change(TsChannel channel, uint32_t window_ms, float& out) {
+    TsPoint last;
+    if (!latest(channel, last)) return false;
+
+    // Earliest raw sample inside the window
+    TsPoint first;
+    uint32_t from = last.time >= window_ms ? last.time - window_ms : 0;
+    if (samples(channel, from, last.time, &first, 1) == 0 || first.time == last.time) return false;
+
+    out = last.value - first.value;
+    return true;
+}
+
+// Width of a rollup bucket
+uint32_t TimeSeriesStore::resolutionWidth(TsResolution resolution) {
+    return resolution >= 0 && resolution < TS_RESOLUTION_COUNT ? RESOLUTION_WIDTH[resolution] : 0;
+}
+
+// Memory use and compression
+TsStats TimeSeriesStore::getStats() {
+    TsStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.blocksRecycled = recycled;
+    stats.bytesAllocated = allocated;
+    if (channels == nullptr) return stats;
+
+    for (int i = 0; i < TS_CHANNEL_COUNT; i++) {
+        Channel& c = channels[i];
+        for (uint8_t b = 0; b < c.used; b++) {
+            stats.samples += c.blocks[b].count;
+            stats.bytesUsed += (c.blocks[b].bitLength + 7) / 8;
+        }
+    }
+    return stats;
+}
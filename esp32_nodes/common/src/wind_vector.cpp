@@ -0,0 +1,106 @@
+#include "wind_vector.h"
+#include <math.h>
+
+#define WIND_DEG_TO_RAD 0.017453292519943295f
+#define WIND_RAD_TO_DEG 57.29577951308232f
+
+// 2/sqrt(3) - 1, Yamartino correction factor
+#define YAMARTINO_B 0.1547005f
+
+static const char* const CARDINAL_16[16] = {
+    "N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
+    "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"
+};
+
+static const char* const CARDINAL_8[8] = {
+    "N", "NE", "E", "SE", "S", "SW", "W", "NW"
+};
+
+// Normalize to [0, 360)
+static float normalizeDegrees(float degrees) {
+    degrees = fmodf(degrees, 360.0f);
+    return degrees < 0 ? degrees + 360.0f : degrees;
+}
+
+const char* windCardinal16(float degrees) {
+    return CARDINAL_16[(int)((normalizeDegrees(degrees) + 11.25f) / 22.5f) & 15];
+}
+
+const char* windCardinal8(float degrees) {
+    return CARDINAL_8[(int)((normalizeDegrees(degrees) + 22.5f) / 45.0f) & 7];
+}
+
+// ==================== ACCUMULATOR ====================
+WindVectorAverage::WindVectorAverage() : windowCount(0) {
+    reset();
+}
+
+int WindVectorAverage::addWindow(uint16_t samples) {
+    if (windowCount >= WIND_VECTOR_MAX_WINDOWS || samples == 0 || samples > WIND_VECTOR_HISTORY) {
+        return -1;
+    }
+    Window& window = windows[windowCount];
+    window.length = samples;
+    window.sumSin = 0;
+    window.sumCos = 0;
+
+    // Cover samples already in the ring
+    uint16_t count = filled < samples ? filled : samples;
+    for (uint16_t i = 1; i <= count; i++) {
+        uint16_t index = (uint16_t)((head + WIND_VECTOR_HISTORY - i) % WIND_VECTOR_HISTORY);
+        window.sumSin += sinRing[index];
+        window.sumCos += cosRing[index];
+    }
+    return windowCount++;
+}
+
+void WindVectorAverage::reset() {
+    head = 0;
+    filled = 0;
+    for (uint8_t i = 0; i < windowCount; i++) {
+        windows[i].sumSin = 0;
+        windows[i].sumCos = 0;
+    }
+}
+
+void WindVectorAverage::add(float degrees) {
+    float radians = degrees * WIND_DEG_TO_RAD;
+    int16_t s = (int16_t)lroundf(sinf(radians) * WIND_VECTOR_SCALE);
+    int16_t c = (int16_t)lroundf(cosf(radians) * WIND_VECTOR_SCALE);
+
+    // Each window drops the sample that falls out of it
+    for (uint8_t i = 0; i < windowCount; i++) {
+        Window& window = windows[i];
+        if (filled >= window.length) {
+            uint16_t leaving = (uint16_t)((head + WIND_VECTOR_HISTORY - window.length) % WIND_VECTOR_HISTORY);
+            window.sumSin -= sinRing[leaving];
+            window.sumCos -= cosRing[leaving];
+        }
+        window.sumSin += s;
+        window.sumCos += c;
+    }
+
+    sinRing[head] = s;
+    cosRing[head] = c;
+    head = (uint16_t)((head + 1) % WIND_VECTOR_HISTORY);
+    if (filled < WIND_VECTOR_HISTORY) filled++;
+}
+
+WindVectorStats WindVectorAverage::stats(uint8_t window) const {
+    WindVectorStats result = { 0.0f, 0.0f, 0.0f, 0 };
+    if (window >= windowCount || filled == 0) return result;
+
+    const Window& w = windows[window];
+    uint16_t count = filled < w.length ? filled : w.length;
+    float sa = (float)w.sumSin / count / WIND_VECTOR_SCALE;
+    float ca = (float)w.sumCos / count / WIND_VECTOR_SCALE;
+    float r2 = sa * sa + ca * ca;
+
+    // sigma = asin(e) * (1 + b * e^3), e = sqrt(1 - R^2)
+    float epsilon = r2 < 1.0f ? sqrtf(1.0f - r2) : 0.0f;
+    result.direction = normalizeDegrees(atan2f(sa, ca) * WIND_RAD_TO_DEG);
+    result.stdDev = asinf(epsilon) * (1.0f + YAMARTINO_B * epsilon * epsilon * epsilon) * WIND_RAD_TO_DEG;
+    result.steadiness = r2 < 1.0f ? sqrtf(r2) : 1.0f;
+    result.samples = count;
+    return result;
+}
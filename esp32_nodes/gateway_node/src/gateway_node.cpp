@@ -13,10 +13,15 @@
  * * Communication: 
  * - ESP-NOW (Receive from Slaves)
  * - WiFi/Firebase (Send to Cloud)
+ * * Tasks:
+ * - Sensing & alerts (core 1): packets, gateway sensors, LEDs, buzzer
+ * - Network (core 0): snapshots, Firebase upload, reports
+ * - Display (core 1, lowest priority): LCD pages
  */
 
 #include <esp_now.h>
 #include <WiFi.h>
+#include <esp_wifi.h>
 #include <FirebaseESP32.h>
 #include <addons/TokenHelper.h>
 #include <addons/RTDBHelper.h>
@@ -24,6 +29,21 @@
 #include <LiquidCrystal_I2C.h>
 #include <HX711.h>
 #include <Arduino.h>
+#include "data_structures.h"
+#include "protocol.h"
+#include "spsc_ring.h"
+#include "cloud_upload.h"
+#include "flash_log.h"
+#include "timeseries.h"
+#include "node_registry.h"
+#include "seqlock.h"
+#include "lcd_framebuffer.h"
+#include <esp_partition.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
 
 // ============================================
 // FIREBASE CONFIGURATION
@@ -71,63 +91,196 @@ FirebaseConfig config;
 // ============================================
 // DATA STRUCTURES
 // ============================================
-typedef struct soil_data {
-  char nodeId[20];
-  float soilMoisture;
-  float soilPH;
-  float soilTemp;
-  unsigned long timestamp;
-} soil_data;
-
-typedef struct weather_data {
-  char nodeId[20];
-  float leafWetness;
-  float leafTemp;
-  float airTemp;
-  float humidity;
-  float lightIntensity;
-  float windSpeed;
-  float windDirection;
-  float rainfall;
-  unsigned long timestamp;
-} weather_data;
-
-soil_data receivedSoilData;
-weather_data receivedWeatherData;
-
-bool soilDataReceived = false;
-bool weatherDataReceived = false;
+// Latest decoded readings from every node
+AllSensorData sensorData;
+
+// Rejected packets by cause
+struct PacketErrorCounts {
+  uint32_t length;
+  uint32_t version;
+  uint32_t type;
+  uint32_t checksum;
+};
+
+PacketErrorCounts packetErrors;
+
+// Every sender, keyed by MAC address: latest packet, send-on-change
+// counts and NodeStatistics. sensorData keeps the latest soil and weather
+// reading of any node (carried forward while nodes stay silent).
+NodeEntry registrySlots[REGISTRY_SLOTS];
+uint16_t registryOrder[REGISTRY_MAX_NODES];
+NodeRegistry nodeRegistry(registrySlots, REGISTRY_SLOTS, registryOrder, REGISTRY_MAX_NODES);
+uint32_t registryRejectedReported = 0;
+
+// Raw frame as captured by the ESP-NOW receive callback
+struct ReceivedPacket {
+  uint32_t arrival_ms;          // millis() when the frame arrived
+  uint32_t arrival_us;          // esp_timer, for the alert latency
+  uint8_t mac[6];               // Sender address
+  int16_t length;               // Length reported by ESP-NOW
+  int8_t rssi;                  // dBm from the promiscuous capture, 0 = unknown
+  uint8_t data[PROTOCOL_MAX_PACKET];
+};
+
+// Receive callback (WiFi task) -> sensing task. Must be a power of two.
+#define RX_RING_SLOTS 16
+
+SpscRing<ReceivedPacket, RX_RING_SLOTS> rxRing;
+uint32_t rxDroppedReported = 0;
+
+// RSSI of the latest ESP-NOW frame. The promiscuous callback sees each
+// frame on the WiFi task just before OnDataRecv does, so OnDataRecv can
+// take it over when the sender matches.
+int8_t promiscuousRssi = 0;
+uint8_t promiscuousMac[6];
+
+// Pairing: nodes broadcast with PACKET_FLAG_PAIRING until they hear a
+// PACKET_PAIR, which gives them this MAC for acknowledged unicast. One
+// broadcast reply serves every node waiting at the time.
+const uint8_t BROADCAST_ADDRESS[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+const unsigned long PAIR_REPLY_INTERVAL = 50;
+unsigned long lastPairReply = 0;
+uint16_t pairSequence = 0;
+
+// Recent history of every channel, shared by the LCD, alerts and upload
+TimeSeriesStore history;
+
+// Gateway sensor readings of one sampling period. Only the sensing task
+// touches the hardware; the LCD, alerts and upload read this cache.
+struct SensorSnapshot {
+  uint32_t sequence;            // Incremented every sampling period
+  uint32_t taken_ms;            // millis() of the sampling period
+  float waterLevel;             // cm, -1 when the ultrasonic read failed
+  float gas;                    // ppm
+  float co2;                    // ppm
+  float co;                     // ppm
+  bool motion;
+  float weight;                 // kg, refreshed every WEIGHT_SAMPLE_INTERVAL
+};
+
+SensorSnapshot gatewaySnapshot;
+
+// ============================================
+// TASKS
+// ============================================
+// The sensing task owns sensorData, the registry and the history. A
+// multi-second TLS request only blocks the network task, which runs on
+// core 0 next to the WiFi stack, so alerts keep their latency.
+#define SENSING_CORE 1
+#define NETWORK_CORE 0
+#define DISPLAY_CORE 1
+#define SENSING_PRIORITY 3
+#define NETWORK_PRIORITY 2
+#define DISPLAY_PRIORITY 1    // Below the sensing task: it may spin on the seqlock
+#define SENSING_STACK 4096
+#define NETWORK_STACK 12288   // Firebase client and TLS
+#define DISPLAY_STACK 4096
+#define ALERT_QUEUE_DEPTH 8
+
+// What the other tasks see of the sensing task, published after every
+// change and copied out without ever blocking it
+struct GatewayState {
+  AllSensorData data;
+  UploadAlerts alerts;
+  SensorSnapshot snapshot;
+};
+
+Seqlock<GatewayState> publishedState;
+
+// Raised alerts, sensing -> network: uploaded without waiting for the
+// next FIREBASE_INTERVAL
+struct AlertEvent {
+  uint32_t raised_ms;
+  UploadAlerts alerts;
+};
+
+QueueHandle_t alertQueue;
+uint32_t alertEventsDropped = 0;
+
+// The registry and the history are too large to publish: the sensing task
+// holds this mutex while changing them, the other tasks while reading them
+SemaphoreHandle_t stateMutex;
+
+// Registry as of the latest snapshot, for the node upload pages and the
+// reports of the network task
+NodeEntry uploadSlots[REGISTRY_SLOTS];
+uint16_t uploadOrder[REGISTRY_MAX_NODES];
+NodeRegistry uploadRegistry(uploadSlots, REGISTRY_SLOTS, uploadOrder, REGISTRY_MAX_NODES);
+
+// Work and scheduling of one task, written only by the task itself
+struct TaskLoad {
+  const char *name;
+  int core;
+  TaskHandle_t handle;
+  uint32_t busy_us;                 // Free running, diffed by reportTasks()
+  uint32_t loops;
+  uint32_t lastStart_us;
+  uint32_t worstPeriod_us;          // Longest gap between two iterations
+  uint32_t worstPeriodUpload_us;    // ... with an upload in flight
+};
+
+TaskLoad sensingLoad = { "sensing", SENSING_CORE };
+TaskLoad networkLoad = { "network", NETWORK_CORE };
+TaskLoad displayLoad = { "display", DISPLAY_CORE };
+
+// Alert path: new input (sample taken, packet received) to LEDs driven
+struct AlertLatency {
+  uint32_t checks;
+  uint32_t worst_us;
+  uint32_t checksUpload;            // Input or check during an upload
+  uint32_t worstUpload_us;
+};
+
+AlertLatency alertLatency;
+volatile bool uploadInFlight = false;
+
+// Earliest input the alerts have not been evaluated on yet
+bool alertInputPending = false;
+bool alertInputDuringUpload = false;
+uint32_t alertInput_us = 0;
+UploadAlerts currentAlerts;
 
 // ============================================
 // SIMULATION MODE - Initialize with test data
 // ============================================
 void initializeTestData() {
   // Initialize Soil Node data (for testing without ESP-NOW)
-  strcpy(receivedSoilData.nodeId, "SOIL_NODE_SIM");
-  receivedSoilData.soilMoisture = 65.0;  // Good moisture level
-  receivedSoilData.soilPH = 6.5;          // Neutral pH
-  receivedSoilData.soilTemp = 22.0;       // Room temperature
-  receivedSoilData.timestamp = millis();
-  soilDataReceived = true;
+  sensorData.soilMoisture = 65.0;  // Good moisture level
+  sensorData.soilPH = 6.5;         // Neutral pH
+  sensorData.soilTemp = 22.0;      // Room temperature
+  sensorData.soilNodeConnected = true;
   
   // Initialize Weather Node data (for testing without ESP-NOW)
-  strcpy(receivedWeatherData.nodeId, "WEATHER_NODE_SIM");
-  receivedWeatherData.leafWetness = 45.0;
-  receivedWeatherData.leafTemp = 21.0;
-  receivedWeatherData.airTemp = 25.0;
-  receivedWeatherData.humidity = 60.0;
-  receivedWeatherData.lightIntensity = 500.0;
-  receivedWeatherData.windSpeed = 3.5;
-  receivedWeatherData.windDirection = 180.0;
-  receivedWeatherData.rainfall = 2.5;
-  receivedWeatherData.timestamp = millis();
-  weatherDataReceived = true;
+  sensorData.leafWetness = 45.0;
+  sensorData.leafTemp = 21.0;
+  sensorData.airTemp = 25.0;
+  sensorData.humidity = 60.0;
+  sensorData.light = 500;
+  sensorData.windSpeed = 3.5;
+  sensorData.windDirection = 180;
+  sensorData.windDirection10 = 175;
+  sensorData.windDirStdDev = 12.0;
+  sensorData.rainfall = 2.5;
+  sensorData.rainfall1h = 0.6;
+  sensorData.rainEvent = 2.5;
+  sensorData.rainRate = 1.2;
+  sensorData.weatherNodeConnected = true;
+  
+  // No history yet
+  sensorData.soilMoisture1h = NAN;
+  sensorData.soilMoistureChange1h = NAN;
+  sensorData.waterLevelChange1h = NAN;
+  
+  sensorData.timestamp = millis();
+  sensorData.soilUpdated = sensorData.timestamp;
+  sensorData.weatherUpdated = sensorData.timestamp;
 }
 
 // ============================================
 // ALERT THRESHOLDS
 // ============================================
 const float MOISTURE_LOW = 30.0;
+const float MOISTURE_DROP_1H = 5.0;  // % per hour
 const float GAS_HIGH = 500.0;
 const float CO2_HIGH = 1000.0;
 const float CO_HIGH = 50.0;
@@ -139,258 +292,775 @@ const int TANK_HEIGHT = 200;   // cm (total tank height)
 // ============================================
 unsigned long lastFirebaseUpdate = 0;
 const unsigned long FIREBASE_INTERVAL = 30000;  // Upload every 30 seconds (30000ms)
-unsigned long lastLCDUpdate = 0;
-const unsigned long LCD_INTERVAL = 2000;  // Update LCD every 2 seconds
-int lcdPage = 0;
+const unsigned long ALERT_UPLOAD_GAP = 5000;  // At most one early upload per 5 s of alerts
+const unsigned long LCD_INTERVAL = 2000;  // Next LCD page every 2 seconds
+const unsigned long LCD_REFRESH_INTERVAL = 500;  // Redraw the page with fresh values
+int lcdPage = -1;
+unsigned long lastGatewaySample = 0;
+const unsigned long GATEWAY_SAMPLE_INTERVAL = 1000;  // Gateway sensors into history every second
+unsigned long lastWeightSample = 0;
+const unsigned long WEIGHT_SAMPLE_INTERVAL = 30000;
+unsigned long lastTrendUpdate = 0;
+const unsigned long TREND_INTERVAL = 60000;  // Trends from the history every minute
+unsigned long lastHistoryReport = 0;
+const unsigned long HISTORY_REPORT_INTERVAL = 300000;  // Store stats every 5 minutes
+unsigned long lastTaskReport = 0;
+const unsigned long TASK_REPORT_INTERVAL = 60000;  // CPU and alert latency every minute
+const unsigned long SENSING_PERIOD = 10;  // ms
+const unsigned long NETWORK_POLL = 100;   // ms, or sooner on an alert
+
+// Registry and history (see stateMutex)
+void lockState() {
+  xSemaphoreTake(stateMutex, portMAX_DELAY);
+}
+
+void unlockState() {
+  xSemaphoreGive(stateMutex);
+}
+
+// New input for the alerts, ready at `ready_us`
+void noteAlertInput(uint32_t ready_us) {
+  if (!alertInputPending || (int32_t)(ready_us - alertInput_us) < 0) {
+    alertInput_us = ready_us;
+  }
+  alertInputPending = true;
+  alertInputDuringUpload |= uploadInFlight;
+}
 
 // ============================================
-// ESP-NOW CALLBACK - RECEIVE DATA
+// PACKET DECODING (runs in the sensing task)
 // ============================================
-void OnDataRecv(const uint8_t *mac, const uint8_t *incomingData, int len) {
-  char nodeId[20];
-  memcpy(nodeId, incomingData, 20);
+// Packet handlers receive a packet already checked by protocolValidate(),
+// so the length always matches the struct of its type.
+typedef void (*PacketHandler)(const ReceivedPacket &received);
+
+void handleSoilPacket(const ReceivedPacket &received) {
+  SoilNodeData packet;
+  memcpy(&packet, received.data, sizeof(packet));
   
-  if (strcmp(nodeId, "SOIL_NODE") == 0) {
-    memcpy(&receivedSoilData, incomingData, sizeof(receivedSoilData));
-    soilDataReceived = true;
-    
-    Serial.println("\r\n┌──────────────────────────────────────┐");
-    Serial.println("│   RECEIVED: Soil Node Data          │");
-    Serial.println("├──────────────────────────────────────┤");
-    Serial.printf("│ Moisture: %6.2f %%                  │\r\n", receivedSoilData.soilMoisture);
-    Serial.printf("│ pH:       %6.2f                     │\r\n", receivedSoilData.soilPH);
-    Serial.printf("│ Temp:     %6.2f °C                  │\r\n", receivedSoilData.soilTemp);
-    Serial.println("└──────────────────────────────────────┘");
+  sensorData.soilMoisture = fromFixed(packet.soilMoisture, FIXED_CENTI);
+  sensorData.soilTemp = fromFixed(packet.soilTemp, FIXED_CENTI);
+  sensorData.soilPH = fromFixed(packet.soilPH, FIXED_CENTI);
+  sensorData.soilNodeConnected = true;
+  sensorData.timestamp = received.arrival_ms;
+  sensorData.soilUpdated = received.arrival_ms;
+  
+  history.record(TS_SOIL_MOISTURE, received.arrival_ms, sensorData.soilMoisture);
+  history.record(TS_SOIL_TEMP, received.arrival_ms, sensorData.soilTemp);
+  history.record(TS_SOIL_PH, received.arrival_ms, sensorData.soilPH);
+}
+
+void handleWeatherPacket(const ReceivedPacket &received) {
+  WeatherNodeData packet;
+  memcpy(&packet, received.data, sizeof(packet));
+  
+  sensorData.airTemp = fromFixed(packet.airTemp, FIXED_CENTI);
+  sensorData.humidity = fromFixed(packet.humidity, FIXED_CENTI);
+  sensorData.light = packet.light;
+  sensorData.rainfall = fromFixed(packet.rainfall, FIXED_DECI);
+  sensorData.rainfall1h = fromFixed(packet.rainfall1h, FIXED_DECI);
+  sensorData.rainEvent = fromFixed(packet.rainEvent, FIXED_DECI);
+  sensorData.rainRate = fromFixed(packet.rainRate, FIXED_DECI);
+  sensorData.windSpeed = fromFixed(packet.windSpeed, FIXED_CENTI);
+  sensorData.windDirection = packet.windDirection;
+  sensorData.windDirection10 = packet.windDirection10;
+  sensorData.windDirStdDev = fromFixed(packet.windDirStdDev, FIXED_DECI);
+  sensorData.leafTemp = fromFixed(packet.leafTemp, FIXED_CENTI);
+  sensorData.leafWetness = fromFixed(packet.leafWetness, FIXED_CENTI);
+  sensorData.weatherNodeConnected = true;
+  sensorData.timestamp = received.arrival_ms;
+  sensorData.weatherUpdated = received.arrival_ms;
+  
+  history.record(TS_AIR_TEMP, received.arrival_ms, sensorData.airTemp);
+  history.record(TS_HUMIDITY, received.arrival_ms, sensorData.humidity);
+  history.record(TS_LIGHT, received.arrival_ms, sensorData.light);
+  history.record(TS_RAINFALL, received.arrival_ms, sensorData.rainfall);
+  history.record(TS_WIND_SPEED, received.arrival_ms, sensorData.windSpeed);
+  history.record(TS_WIND_DIRECTION, received.arrival_ms, sensorData.windDirection);
+  history.record(TS_LEAF_TEMP, received.arrival_ms, sensorData.leafTemp);
+  history.record(TS_LEAF_WETNESS, received.arrival_ms, sensorData.leafWetness);
+}
+
+// Pairing reply of another gateway in range
+void handlePairPacket(const ReceivedPacket &received) {
+  (void)received;
+}
+
+// Indexed by PacketType
+static const PacketHandler packetHandlers[PACKET_TYPE_COUNT] = {
+  nullptr,              // PACKET_INVALID
+  handleSoilPacket,     // PACKET_SOIL_DATA
+  handleWeatherPacket,  // PACKET_WEATHER_DATA
+  handlePairPacket      // PACKET_PAIR
+};
+
+// Answer a node that has no Gateway address yet
+void sendPairReply(unsigned long now) {
+  if (now - lastPairReply < PAIR_REPLY_INTERVAL) {
+    return;  // The last reply is still fresh for every waiting node
+  }
+  lastPairReply = now;
+  
+  PacketHeader reply = {};
+  protocolSeal(&reply, sizeof(reply), NODE_ID_GATEWAY, PACKET_PAIR, pairSequence++, now);
+  if (esp_now_send(BROADCAST_ADDRESS, (uint8_t *) &reply, sizeof(reply)) != ESP_OK) {
+    Serial.println("[ESP-NOW] ✗ Pairing reply failed");
+  }
+}
+
+// Validate and decode every queued frame; true when any was decoded
+bool processReceivedPackets() {
+  const ReceivedPacket *received;
+  bool decoded = false;
+  
+  while ((received = rxRing.peek()) != nullptr) {
+    uint8_t result = protocolValidate(received->data, received->length);
+    lockState();
     
-    // Check soil alerts
-    if (receivedSoilData.soilMoisture < MOISTURE_LOW) {
-      digitalWrite(LED_SOIL, HIGH);
-      Serial.println("[ALERT] ⚠ Low soil moisture!");
+    if (result == PACKET_OK) {
+      const PacketHeader *header = (const PacketHeader *)received->data;
+      NodeEntry *node = nullptr;
+      if (header->nodeId != NODE_ID_GATEWAY) {
+        node = nodeRegistry.record(received->mac, received->data, received->length,
+                                   received->arrival_ms, received->rssi);
+      }
+      if (header->flags & PACKET_FLAG_PAIRING) {
+        sendPairReply(millis());
+      }
+      if (node != nullptr && node->link.lastEvent == LINK_RESTART) {
+        char key[REGISTRY_KEY_LENGTH];
+        formatNodeKey(received->mac, key);
+        Serial.printf("[Link] Node %s restarted at sequence %u\r\n", key, header->sequence);
+      }
+      
+      // Packets of nodes the full registry refused are dropped, and so are
+      // retransmissions the node sent because an ACK got lost and packets
+      // older than the node's latest (they would roll its readings back)
+      bool decode = header->nodeId == NODE_ID_GATEWAY ||
+                    (node != nullptr && node->link.lastEvent != LINK_DUPLICATE &&
+                     node->link.lastEvent != LINK_LATE);
+      if (decode) {
+        packetHandlers[header->packetType](*received);
+        decoded = true;
+        if (header->packetType == PACKET_SOIL_DATA) {
+          noteAlertInput(received->arrival_us);
+        }
+      }
     } else {
-      digitalWrite(LED_SOIL, LOW);
+      if (result & (PACKET_ERR_SHORT | PACKET_ERR_LENGTH)) packetErrors.length++;
+      if (result & PACKET_ERR_VERSION) packetErrors.version++;
+      if (result & PACKET_ERR_TYPE) packetErrors.type++;
+      if (result & PACKET_ERR_CHECKSUM) packetErrors.checksum++;
+      Serial.printf("[ESP-NOW] Rejected %d byte packet (error 0x%02X)\r\n", received->length, result);
     }
-  }
-  else if (strcmp(nodeId, "WEATHER_NODE") == 0) {
-    memcpy(&receivedWeatherData, incomingData, sizeof(receivedWeatherData));
-    weatherDataReceived = true;
     
-    Serial.println("\r\n┌──────────────────────────────────────┐");
-    Serial.println("│   RECEIVED: Weather Node Data       │");
-    Serial.println("├──────────────────────────────────────┤");
-    Serial.printf("│ Air Temp: %6.2f °C                  │\r\n", receivedWeatherData.airTemp);
-    Serial.printf("│ Humidity: %6.2f %%                  │\r\n", receivedWeatherData.humidity);
-    Serial.printf("│ Light:    %6.0f lux                 │\r\n", receivedWeatherData.lightIntensity);
-    Serial.printf("│ Wind:     %6.2f m/s                 │\r\n", receivedWeatherData.windSpeed);
-    Serial.println("└──────────────────────────────────────┘");
+    unlockState();
+    rxRing.release();
   }
+  
+  uint32_t dropped = rxRing.getDropped();
+  if (dropped != rxDroppedReported) {
+    Serial.printf("[ESP-NOW] ⚠ Receive queue full, %lu packets dropped\r\n", (unsigned long)(dropped - rxDroppedReported));
+    rxDroppedReported = dropped;
+  }
+  
+  uint32_t rejected = nodeRegistry.getRejected();
+  if (rejected != registryRejectedReported) {
+    Serial.printf("[Registry] ⚠ Full (%u nodes), %lu packets from new nodes refused\r\n",
+                  nodeRegistry.size(), (unsigned long)(rejected - registryRejectedReported));
+    registryRejectedReported = rejected;
+  }
+  return decoded;
 }
 
+// True when the latest reading of any soil node is below MOISTURE_LOW
+bool soilMoistureLow() {
+  if (nodeRegistry.size() == 0) {
+    return sensorData.soilMoisture < MOISTURE_LOW;  // Test data only
+  }
+  for (uint16_t i = 0; i < nodeRegistry.size(); i++) {
+    const NodeEntry &node = nodeRegistry.at(i);
+    if (node.nodeType == NODE_ID_SOIL && fromFixed(node.packet.soil.soilMoisture, FIXED_CENTI) < MOISTURE_LOW) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ============================================
+// ESP-NOW CALLBACK - RECEIVE DATA
+// ============================================
+// Promiscuous capture of management frames: keeps the rx_ctrl RSSI of
+// ESP-NOW frames (vendor-specific action frames with the Espressif OUI)
+void OnPromiscuousRx(void *buf, wifi_promiscuous_pkt_type_t type) {
+  if (type != WIFI_PKT_MGMT) {
+    return;
+  }
+  
+  const wifi_promiscuous_pkt_t *pkt = (const wifi_promiscuous_pkt_t *)buf;
+  const uint8_t *frame = pkt->payload;
+  if (pkt->rx_ctrl.sig_len < 28 || frame[0] != 0xD0 || frame[24] != 0x7F ||
+      frame[25] != 0x18 || frame[26] != 0xFE || frame[27] != 0x34) {
+    return;
+  }
+  
+  memcpy(promiscuousMac, frame + 10, sizeof(promiscuousMac));  // Transmitter address
+  promiscuousRssi = pkt->rx_ctrl.rssi;
+}
+
+// Runs on the WiFi task: only copy the frame into the ring, decoding
+// happens in processReceivedPackets().
+void OnDataRecv(const uint8_t *mac, const uint8_t *incomingData, int len) {
+  ReceivedPacket *slot = rxRing.acquireWrite();
+  if (slot == nullptr) {
+    return;  // Counted by the ring
+  }
+  
+  slot->arrival_ms = millis();
+  slot->arrival_us = (uint32_t)esp_timer_get_time();
+  memcpy(slot->mac, mac, sizeof(slot->mac));
+  slot->rssi = memcmp(promiscuousMac, mac, sizeof(promiscuousMac)) == 0 ? promiscuousRssi : 0;
+  slot->length = (len < 0 || len > PROTOCOL_MAX_PACKET) ? -1 : len;
+  if (slot->length > 0) {
+    memcpy(slot->data, incomingData, slot->length);
+  }
+  
+  rxRing.commitWrite();
+}
 
 // ============================================
 // GATEWAY SENSOR FUNCTIONS
 // ============================================
 
-float readWaterLevel() {
+// The echo is timed by an edge interrupt instead of pulseIn(), which would
+// hold the sensing task for up to 30 ms: startWaterLevelRead() pings, and
+// the sensing task collects the level with pollWaterLevel() on later ticks
+#define ECHO_TIMEOUT_US 30000  // No echo within 30 ms = out of range
+
+volatile uint32_t echoRise_us = 0;
+volatile uint32_t echoWidth_us = 0;
+volatile bool echoStarted = false;
+volatile bool echoDone = false;
+uint32_t pingStart_us = 0;
+bool pingPending = false;
+
+void IRAM_ATTR onEchoEdge() {
+  uint32_t now = micros();
+  if (digitalRead(ECHO_PIN) == HIGH) {
+    echoRise_us = now;
+    echoStarted = true;
+  } else if (echoStarted && !echoDone) {
+    echoWidth_us = now - echoRise_us;
+    echoDone = true;
+  }
+}
+
+void startWaterLevelRead() {
+  echoStarted = false;
+  echoDone = false;
+  
   digitalWrite(TRIG_PIN, LOW);
   delayMicroseconds(2);
   digitalWrite(TRIG_PIN, HIGH);
   delayMicroseconds(10);
   digitalWrite(TRIG_PIN, LOW);
   
-  long duration = pulseIn(ECHO_PIN, HIGH, 30000);
+  pingStart_us = micros();
+  pingPending = true;
+}
+
+// Water level (cm) from an echo width, -1 when out of range
+float waterLevelFromEcho(uint32_t duration) {
   float distance = duration * 0.034 / 2;  // cm
   
   if (distance == 0 || distance > 400) {
-    Serial.println("[DEBUG] Water Level: ERROR - Out of range\r\n");
-    return -1;  // Error
+    return -1;  // Out of range
   }
   
   // Calculate water level (tank height - distance from sensor)
   float waterLevel = TANK_HEIGHT - distance;
   waterLevel = max(0.0f, waterLevel);
-  Serial.printf("[DEBUG] Water Level: %.1f cm (distance: %.1f cm)\r\n", waterLevel, distance);
   return waterLevel;
 }
 
+// True once the pending ping's echo has been captured or timed out
+bool pollWaterLevel(float &level) {
+  if (!pingPending) {
+    return false;
+  }
+  uint32_t width = 0;
+  if (echoDone) {
+    width = echoWidth_us;
+  } else if (micros() - pingStart_us < ECHO_TIMEOUT_US) {
+    return false;
+  }
+  pingPending = false;
+  level = waterLevelFromEcho(width);
+  return true;
+}
+
 float readGasSensor() {
   int rawValue = analogRead(GAS_PIN);
   float gasLevel = map(rawValue, 0, 4095, 0, 1000);
-  Serial.printf("[DEBUG] Gas Sensor: %.0f (raw: %d)\r\n", gasLevel, rawValue);
   return gasLevel;
 }
 
 float readCO2() {
   int rawValue = analogRead(CO2_PIN);
   float co2Level = map(rawValue, 0, 4095, 400, 5000);  // ppm
-  Serial.printf("[DEBUG] CO2 Level: %.0f ppm (raw: %d)\r\n", co2Level, rawValue);
   return co2Level;
 }
 
 float readCO() {
   int rawValue = analogRead(CO_PIN);
   float coLevel = map(rawValue, 0, 4095, 0, 200);  // ppm
-  Serial.printf("[DEBUG] CO Level: %.0f ppm (raw: %d)\r\n", coLevel, rawValue);
   return coLevel;
 }
 
 bool readMotion() {
   bool motion = digitalRead(PIR_PIN);
-  Serial.printf("[DEBUG] Motion Sensor: %s\r\n", motion ? "DETECTED" : "None");
   return motion;
 }
 
-float readWeight() {
-  if (scale.is_ready()) {
-    float weight = scale.get_units(5);  // Average of 5 readings
-    Serial.printf("[DEBUG] Weight: %.2f kg\r\n", weight);
-    return weight;
+// The HX711 converts at 10 Hz: average WEIGHT_READINGS conversions one at
+// a time as they become ready, instead of blocking the sensing task in
+// get_units() for half a second
+#define WEIGHT_READINGS 5
+float weightSum = 0;
+uint8_t weightReadings = 0;
+
+// Take the pending HX711 conversion, if any; true once `weight` holds a
+// new average
+bool pollWeight(float &weight) {
+  if (!scale.is_ready()) {
+    return false;
+  }
+  weightSum += scale.get_units(1);
+  if (++weightReadings < WEIGHT_READINGS) {
+    return false;
+  }
+  weight = weightSum / WEIGHT_READINGS;
+  weightSum = 0;
+  weightReadings = 0;
+  return true;
+}
+
+// Refresh the weight every WEIGHT_SAMPLE_INTERVAL; true when it changed
+bool sampleWeight(unsigned long now) {
+  static bool due = true;
+  if (!due && now - lastWeightSample < WEIGHT_SAMPLE_INTERVAL) {
+    return false;
+  }
+  due = true;
+  
+  float weight;
+  if (!pollWeight(weight)) {
+    return false;
+  }
+  due = false;
+  lastWeightSample = now;
+  gatewaySnapshot.weight = weight;
+  sensorData.weight = weight;
+  
+  lockState();
+  history.record(TS_WEIGHT, now, weight);
+  unlockState();
+  return true;
+}
+
+// Take one snapshot of the gateway's own sensors: the level from this
+// period's ultrasonic ping and one conversion per ADC channel, copied into
+// sensorData and the history.
+void sampleGatewaySensors(unsigned long now, float waterLevel) {
+  SensorSnapshot &snapshot = gatewaySnapshot;
+  snapshot.waterLevel = waterLevel;
+  snapshot.gas = readGasSensor();
+  snapshot.co2 = readCO2();
+  snapshot.co = readCO();
+  snapshot.motion = readMotion();
+  noteAlertInput((uint32_t)esp_timer_get_time());
+  
+  snapshot.taken_ms = now;
+  snapshot.sequence++;
+  
+  sensorData.waterLevel = snapshot.waterLevel;
+  sensorData.gas = snapshot.gas;
+  sensorData.co2 = snapshot.co2;
+  sensorData.co = snapshot.co;
+  sensorData.motion = snapshot.motion;
+  
+  lockState();
+  // A failed ultrasonic read (-1) is not a water level
+  if (snapshot.waterLevel >= 0) {
+    history.record(TS_WATER_LEVEL, now, snapshot.waterLevel);
+  }
+  history.record(TS_GAS, now, snapshot.gas);
+  history.record(TS_CO2, now, snapshot.co2);
+  history.record(TS_CO, now, snapshot.co);
+  unlockState();
+}
+
+// Refresh the hourly trends of sensorData from the history every
+// TREND_INTERVAL; true when they were refreshed. The sensing task owns the
+// history, so reading it needs no lock.
+bool updateTrends(unsigned long now) {
+  if (now - lastTrendUpdate < TREND_INTERVAL) {
+    return false;
+  }
+  lastTrendUpdate = now;
+  
+  // Mean of the quarter-hour rollups of the last hour
+  TsRollup hour;
+  uint32_t from = now > 3600000UL ? now - 3600000UL : 0;
+  sensorData.soilMoisture1h = history.aggregate(TS_SOIL_MOISTURE, TS_QUARTER_HOUR, from, now, hour) ? hour.mean : NAN;
+  
+  float change;
+  sensorData.soilMoistureChange1h = history.change(TS_SOIL_MOISTURE, 3600000UL, change) ? change : NAN;
+  sensorData.waterLevelChange1h = history.change(TS_WATER_LEVEL, 3600000UL, change) ? change : NAN;
+  noteAlertInput((uint32_t)esp_timer_get_time());
+  return true;
+}
+
+// Print how much history the store holds
+void reportHistory() {
+  lockState();
+  TsStats stats = history.getStats();
+  unlockState();
+  Serial.printf("[History] %lu samples in %lu bytes (%.1f bits/sample, %lu blocks recycled, %lu bytes allocated)\r\n",
+                (unsigned long)stats.samples, (unsigned long)stats.bytesUsed,
+                stats.samples ? stats.bytesUsed * 8.0f / stats.samples : 0.0f,
+                (unsigned long)stats.blocksRecycled, (unsigned long)stats.bytesAllocated);
+}
+
+// Print every registered node: how many readings it kept to itself, how
+// old its data is and the quality of its link
+void reportNodes(const NodeRegistry &registry, uint32_t now) {
+  Serial.printf("[Registry] %u nodes (%.2f probes/lookup)\r\n",
+                registry.size(), registry.getAverageProbes());
+  for (uint16_t i = 0; i < registry.size(); i++) {
+    const NodeEntry &node = registry.at(i);
+    char key[REGISTRY_KEY_LENGTH];
+    formatNodeKey(node.mac, key);
+    Serial.printf("[Report] %s %-7s %lu packets for %lu readings (%.1f%% suppressed, %lu heartbeats), data %lu s old\r\n",
+                  key, node.nodeType == NODE_ID_SOIL ? "soil" : "weather",
+                  (unsigned long)node.stats.packetsReceived, (unsigned long)node.readings,
+                  100.0f * (node.readings - node.stats.packetsReceived) / node.readings,
+                  (unsigned long)node.heartbeats, (unsigned long)((now - node.lastHeard_ms) / 1000));
+    Serial.printf("[Link]   %s lost %lu (%.2f%%), %lu duplicates, %lu restarts, RSSI %ld dBm (avg %.1f), jitter %.1f ms, every %.1f s\r\n",
+                  key, (unsigned long)node.stats.packetsLost, linkLossRate(node.stats) * 100.0f,
+                  (unsigned long)node.stats.duplicates, (unsigned long)node.stats.restarts,
+                  (long)node.stats.lastRSSI, node.stats.averageRSSI, node.stats.jitter_ms,
+                  node.stats.interval_ms / 1000.0f);
   }
-  Serial.println("[DEBUG] Weight: Scale not ready\r\n");
-  return 0;
 }
 
 // ============================================
 // LCD DISPLAY FUNCTIONS
 // ============================================
-void updateLCD() {
-  lcd.clear();
-  lcd.setCursor(0, 0);
-  
-  switch (lcdPage) {
-    case 0:  // Soil Data
-      lcd.print("=== SOIL DATA ===");
-      lcd.setCursor(0, 1);
-      lcd.printf("Moist: %.1f%%", receivedSoilData.soilMoisture);
-      lcd.setCursor(0, 2);
-      lcd.printf("pH: %.2f", receivedSoilData.soilPH);
-      lcd.setCursor(0, 3);
-      lcd.printf("Temp: %.1fC", receivedSoilData.soilTemp);
-      break;
-      
-    case 1:  // Weather Data
-      lcd.print("== WEATHER DATA ==");
-      lcd.setCursor(0, 1);
-      lcd.printf("Air: %.1fC H:%.0f%%", receivedWeatherData.airTemp, receivedWeatherData.humidity);
-      lcd.setCursor(0, 2);
-      lcd.printf("Light: %.0f lux", receivedWeatherData.lightIntensity);
-      lcd.setCursor(0, 3);
-      lcd.printf("Wind: %.1f m/s", receivedWeatherData.windSpeed);
-      break;
-      
-    case 2:  // Gateway Sensors
-      lcd.print("== SAFETY DATA ==");
-      lcd.setCursor(0, 1);
-      lcd.printf("Water: %.1f cm", readWaterLevel());
-      lcd.setCursor(0, 2);
-      lcd.printf("Gas: %.0f", readGasSensor());
-      lcd.setCursor(0, 3);
-      lcd.printf("CO2: %.0f CO: %.0f", readCO2(), readCO());
-      break;
+#define LCD_FIXED_PAGES 3
+#define LCD_NODES_PER_PAGE 3
+#define LCD_HD44780_SET_DDRAM 0x80
+
+// Framebuffer changes go out through the library's command()/write()
+class LiquidCrystalSink : public LcdSink {
+public:
+  void setAddress(uint8_t address) override {
+    lcd.command(LCD_HD44780_SET_DDRAM | address);
+  }
+  void write(uint8_t c) override {
+    lcd.write(c);
   }
+};
+
+LcdFramebuffer lcdFrame;
+LiquidCrystalSink lcdSink;
+
+// One LCD row of a fixed page: printf format and up to two readings
+struct LcdLine {
+  const char *format;
+  float (*first)(const GatewayState &state);
+  float (*second)(const GatewayState &state);
+};
+
+static const LcdLine LCD_FIXED[LCD_FIXED_PAGES][LCD_FB_ROWS] = {
+  {  // Soil data
+    { "=== SOIL DATA ===", nullptr, nullptr },
+    { "Moist: %.1f%%", [](const GatewayState &s) { return s.data.soilMoisture; }, nullptr },
+    { "pH: %.2f", [](const GatewayState &s) { return s.data.soilPH; }, nullptr },
+    { "Temp: %.1fC", [](const GatewayState &s) { return s.data.soilTemp; }, nullptr },
+  },
+  {  // Weather data
+    { "== WEATHER DATA ==", nullptr, nullptr },
+    { "Air: %.1fC H:%.0f%%", [](const GatewayState &s) { return s.data.airTemp; },
+      [](const GatewayState &s) { return s.data.humidity; } },
+    { "Light: %.0f lux", [](const GatewayState &s) { return (float)s.data.light; }, nullptr },
+    { "Wind: %.1f m/s", [](const GatewayState &s) { return s.data.windSpeed; }, nullptr },
+  },
+  {  // Gateway sensors
+    { "== SAFETY DATA ==", nullptr, nullptr },
+    { "Water: %.1f cm", [](const GatewayState &s) { return s.snapshot.waterLevel; }, nullptr },
+    { "Gas: %.0f", [](const GatewayState &s) { return s.snapshot.gas; }, nullptr },
+    { "CO2: %.0f CO: %.0f", [](const GatewayState &s) { return s.snapshot.co2; },
+      [](const GatewayState &s) { return s.snapshot.co; } },
+  },
+};
+
+// One registry node per row: type, last MAC bytes, key value, age
+void formatNodeRow(const NodeEntry &node, uint32_t now, char *row, size_t size) {
+  uint32_t age = (now - node.lastHeard_ms) / 1000;
+  if (node.nodeType == NODE_ID_SOIL) {
+    snprintf(row, size, "S %02X%02X M%.1f%% %lus", node.mac[4], node.mac[5],
+             fromFixed(node.packet.soil.soilMoisture, FIXED_CENTI), (unsigned long)age);
+  } else {
+    snprintf(row, size, "W %02X%02X T%.1fC %lus", node.mac[4], node.mac[5],
+             fromFixed(node.packet.weather.airTemp, FIXED_CENTI), (unsigned long)age);
+  }
+}
+
+void drawFixedPage(int page, const GatewayState &state) {
+  for (uint8_t row = 0; row < LCD_FB_ROWS; row++) {
+    const LcdLine &line = LCD_FIXED[page][row];
+    lcdFrame.setCursor(0, row);
+    if (line.first == nullptr) {
+      lcdFrame.print(line.format);
+    } else if (line.second == nullptr) {
+      lcdFrame.printf(line.format, line.first(state));
+    } else {
+      lcdFrame.printf(line.format, line.first(state), line.second(state));
+    }
+  }
+}
+
+// Runs in the display task: readings come from the published state, the
+// registry and history are only locked to copy out what the page shows.
+// The page is drawn into the framebuffer and only changed characters are
+// sent, so redrawing the same page with fresh values is cheap.
+void updateLCD(bool nextPage) {
+  GatewayState state;
+  publishedState.read(state);
   
-  lcdPage = (lcdPage + 1) % 3;
+  lockState();
+  uint16_t nodes = nodeRegistry.size();
+  unlockState();
+  uint16_t nodePages = (nodes + LCD_NODES_PER_PAGE - 1) / LCD_NODES_PER_PAGE;
+  if (nextPage) {
+    lcdPage++;
+  }
+  if (lcdPage >= LCD_FIXED_PAGES + nodePages) {
+    lcdPage = 0;
+  }
+  
+  lcdFrame.clear();
+  if (lcdPage < LCD_FIXED_PAGES) {
+    drawFixedPage(lcdPage, state);
+  }
+  
+  if (lcdPage == 0) {
+    // Hourly mean, from the history by the sensing task
+    if (!isnan(state.data.soilMoisture1h)) {
+      lcdFrame.setCursor(11, 1);
+      lcdFrame.printf("1h:%.1f", state.data.soilMoisture1h);
+    }
+  } else if (lcdPage >= LCD_FIXED_PAGES) {
+    // Registered nodes
+    uint16_t first = (lcdPage - LCD_FIXED_PAGES) * LCD_NODES_PER_PAGE;
+    lcdFrame.printf("== NODES %u/%u ==", lcdPage - LCD_FIXED_PAGES + 1, nodePages);
+    uint32_t now = millis();
+    char rows[LCD_NODES_PER_PAGE][LCD_FB_COLUMNS + 1];
+    uint16_t shown = 0;
+    lockState();
+    for (; shown < LCD_NODES_PER_PAGE && first + shown < nodeRegistry.size(); shown++) {
+      formatNodeRow(nodeRegistry.at(first + shown), now, rows[shown], sizeof(rows[shown]));
+    }
+    unlockState();
+    for (uint16_t row = 0; row < shown; row++) {
+      lcdFrame.setCursor(0, row + 1);
+      lcdFrame.print(rows[row]);
+    }
+  }
+  
+  lcdFrame.flush(lcdSink);
 }
 
 // ============================================
 // FIREBASE FUNCTIONS
 // ============================================
-void uploadToFirebase() {
-  if (!Firebase.ready()) {
-    Serial.println("[Firebase] Not ready yet...");
+// Writes a whole snapshot with one multi-path update request
+class FirebaseTransport : public UploadTransport {
+public:
+  bool update(const char *path, const char *json, size_t length) override {
+    if (!Firebase.ready()) {
+      Serial.println("[Firebase] Not ready yet...");
+      return false;
+    }
+    
+    FirebaseJson document;
+    document.setJsonData(json);
+    if (!Firebase.updateNode(fbdo, path, document)) {
+      Serial.printf("[Firebase] ✗ Update failed: %s\r\n", fbdo.errorReason().c_str());
+      return false;
+    }
+    return true;
+  }
+};
+
+// Offline log in the data partition the default partition table reserves
+// for SPIFFS (unused by the gateway). esp_partition handles the raw flash.
+#define OFFLINE_LOG_LABEL "spiffs"
+
+class PartitionStorage : public LogStorage {
+private:
+  const esp_partition_t *partition = nullptr;
+  
+public:
+  bool begin() {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, OFFLINE_LOG_LABEL);
+    return partition != nullptr;
+  }
+  
+  uint32_t sectorSize() override { return SPI_FLASH_SEC_SIZE; }
+  uint32_t sectorCount() override { return partition ? partition->size / SPI_FLASH_SEC_SIZE : 0; }
+  
+  bool read(uint32_t address, void *data, size_t length) override {
+    return esp_partition_read(partition, address, data, length) == ESP_OK;
+  }
+  
+  bool write(uint32_t address, const void *data, size_t length) override {
+    return esp_partition_write(partition, address, data, length) == ESP_OK;
+  }
+  
+  bool erase(uint32_t sector) override {
+    return esp_partition_erase_range(partition, sector * SPI_FLASH_SEC_SIZE, SPI_FLASH_SEC_SIZE) == ESP_OK;
+  }
+};
+
+FirebaseTransport firebaseTransport;
+CloudUploader cloudUploader(&firebaseTransport, "/");
+PartitionStorage offlineStorage;
+FlashRingLog offlineLog(&offlineStorage);
+
+// Mount the store-and-forward log
+void initializeOfflineLog() {
+  if (!offlineStorage.begin() || !offlineLog.begin()) {
+    Serial.println("[Backlog] ✗ No log partition, offline readings will be lost");
     return;
   }
   
-  // Read Gateway sensor data first
-  float waterLevel = readWaterLevel();
-  float gasLevel = readGasSensor();
-  float co2Level = readCO2();
-  float coLevel = readCO();
-  bool motion = readMotion();
-  float weight = readWeight();
+  cloudUploader.attachBacklog(&offlineLog);
+  Serial.printf("[Backlog] ✓ %lu of %lu records waiting for upload\r\n",
+                (unsigned long)offlineLog.getDepth(), (unsigned long)offlineLog.getCapacity());
+}
+
+// Runs in the network task, on the published state and a copy of the
+// registry taken under the lock (the node pages upload from the copy)
+void uploadToFirebase() {
+  GatewayState state;
+  publishedState.read(state);
+  const AllSensorData &sensorData = state.data;
+  
+  lockState();
+  uploadRegistry.copyFrom(nodeRegistry);
+  unlockState();
   
-  // Print formatted sensor data
+  // Gateway readings come from the latest snapshot, not from the sensors
   Serial.println("\r\n┌────────────────────────────────────────┐");
   Serial.println("│    GATEWAY NODE - Sensor Data         │");
   Serial.println("├──────────────────────────────────────┤");
-  Serial.printf("│ Water Level:      %6.1f cm           │\r\n", waterLevel);
-  Serial.printf("│ Gas Sensor:       %6.0f ppm          │\r\n", gasLevel);
-  Serial.printf("│ CO2 Level:        %6.0f ppm          │\r\n", co2Level);
-  Serial.printf("│ CO Level:         %6.0f ppm          │\r\n", coLevel);
-  Serial.printf("│ Motion:           %s                 │\r\n", motion ? "DETECTED" : "None    ");
-  Serial.printf("│ Weight:           %6.2f kg           │\r\n", weight);
+  Serial.printf("│ Snapshot:         #%-6lu             │\r\n", (unsigned long)state.snapshot.sequence);
+  Serial.printf("│ Water Level:      %6.1f cm           │\r\n", sensorData.waterLevel);
+  Serial.printf("│ Gas Sensor:       %6u ppm          │\r\n", sensorData.gas);
+  Serial.printf("│ CO2 Level:        %6u ppm          │\r\n", sensorData.co2);
+  Serial.printf("│ CO Level:         %6u ppm          │\r\n", sensorData.co);
+  Serial.printf("│ Motion:           %s                 │\r\n", sensorData.motion ? "DETECTED" : "None    ");
+  Serial.printf("│ Weight:           %6.2f kg           │\r\n", sensorData.weight);
   Serial.println("└──────────────────────────────────────┘");
   
-  Serial.println("\r\n[Firebase] Uploading aggregated data...");
-  
-  // Create timestamp
-  String timestamp = String(millis());
-  
-  // Upload Soil Node data
-  if (soilDataReceived) {
-    Firebase.setFloat(fbdo, "/sensors/soil/moisture", receivedSoilData.soilMoisture);
-    Firebase.setFloat(fbdo, "/sensors/soil/ph", receivedSoilData.soilPH);
-    Firebase.setFloat(fbdo, "/sensors/soil/temperature", receivedSoilData.soilTemp);
-  }
-  
-  // Upload Weather Node data
-  if (weatherDataReceived) {
-    Firebase.setFloat(fbdo, "/sensors/weather/airTemp", receivedWeatherData.airTemp);
-    Firebase.setFloat(fbdo, "/sensors/weather/humidity", receivedWeatherData.humidity);
-    Firebase.setFloat(fbdo, "/sensors/weather/leafWetness", receivedWeatherData.leafWetness);
-    Firebase.setFloat(fbdo, "/sensors/weather/light", receivedWeatherData.lightIntensity);
-    Firebase.setFloat(fbdo, "/sensors/weather/windSpeed", receivedWeatherData.windSpeed);
-    Firebase.setFloat(fbdo, "/sensors/weather/windDirection", receivedWeatherData.windDirection);
-    Firebase.setFloat(fbdo, "/sensors/weather/rainfall", receivedWeatherData.rainfall);
+  // Offline: keep the reading in flash until the link is back
+  if (WiFi.status() != WL_CONNECTED) {
+    if (cloudUploader.archive(sensorData, millis())) {
+      Serial.printf("[Backlog] Offline, snapshot logged (%lu waiting)\r\n",
+                    (unsigned long)cloudUploader.getMetrics().backlogDepth);
+    } else {
+      Serial.println("[Backlog] ✗ Offline, snapshot lost");
+    }
+    return;
   }
   
-  // Upload Gateway sensor data (already read above)
-  Firebase.setFloat(fbdo, "/sensors/gateway/waterLevel", waterLevel);
-  Firebase.setFloat(fbdo, "/sensors/gateway/gas", gasLevel);
-  Firebase.setFloat(fbdo, "/sensors/gateway/co2", co2Level);
-  Firebase.setFloat(fbdo, "/sensors/gateway/co", coLevel);
-  Firebase.setBool(fbdo, "/sensors/gateway/motion", motion);
-  Firebase.setFloat(fbdo, "/sensors/gateway/weight", weight);
+  // The uploader serializes and sends it (and retries) from the network task
+  cloudUploader.enqueue(sensorData, state.alerts, millis());
+  Serial.printf("[Firebase] Snapshot queued (%u pending)\r\n", cloudUploader.getPending());
+}
+
+// Send queued snapshots and report the result of each request
+void serviceFirebaseUpload() {
+  uint32_t requestsBefore = cloudUploader.getStats().requests;
+  uint32_t failuresBefore = cloudUploader.getStats().failures;
+  uint32_t backlogRequestsBefore = cloudUploader.getStats().backlogRequests;
+  uint32_t backlogRecordsBefore = cloudUploader.getStats().backlogRecords;
+  uint32_t nodeRequestsBefore = cloudUploader.getStats().nodeRequests;
   
-  // Upload alert status
-  Firebase.setBool(fbdo, "/alerts/soilMoistureLow", receivedSoilData.soilMoisture < MOISTURE_LOW);
-  Firebase.setBool(fbdo, "/alerts/gasHigh", gasLevel > GAS_HIGH);
-  Firebase.setBool(fbdo, "/alerts/co2High", co2Level > CO2_HIGH);
-  Firebase.setBool(fbdo, "/alerts/coHigh", coLevel > CO_HIGH);
-  Firebase.setBool(fbdo, "/alerts/waterLow", waterLevel < WATER_LOW);
-  Firebase.setBool(fbdo, "/alerts/motionDetected", motion);
+  cloudUploader.service(millis());
   
-  // Update timestamp
-  Firebase.setString(fbdo, "/system/lastUpdate", timestamp);
+  const UploadStats &stats = cloudUploader.getStats();
+  if (stats.requests == requestsBefore || stats.failures != failuresBefore) return;
   
-  Serial.println("[Firebase] ✓ Data uploaded successfully");
+  if (stats.backlogRequests != backlogRequestsBefore) {
+    UploadMetrics metrics = cloudUploader.getMetrics();
+    Serial.printf("[Backlog] Drained %lu records, %lu waiting (%.1f records/s)\r\n",
+                  (unsigned long)(stats.backlogRecords - backlogRecordsBefore),
+                  (unsigned long)metrics.backlogDepth, metrics.drainRate);
+  } else if (stats.nodeRequests != nodeRequestsBefore) {
+    Serial.printf("[Firebase] ✓ Node page uploaded (%lu bytes, %u nodes registered)\r\n",
+                  (unsigned long)stats.lastBytes, uploadRegistry.size());
+  } else {
+    Serial.printf("[Firebase] ✓ Data uploaded successfully (%lu bytes, 1 request)\r\n", (unsigned long)stats.lastBytes);
+  }
 }
 
 // ============================================
 // ALERT SYSTEM
 // ============================================
-void checkAlerts() {
+// Alert conditions on the current readings
+UploadAlerts evaluateAlerts() {
+  UploadAlerts alerts;
+  alerts.soilMoistureLow = soilMoistureLow();
+  alerts.soilDrying = sensorData.soilMoistureChange1h < -MOISTURE_DROP_1H;  // NaN: no history
+  alerts.gasHigh = gatewaySnapshot.gas > GAS_HIGH;
+  alerts.co2High = gatewaySnapshot.co2 > CO2_HIGH;
+  alerts.coHigh = gatewaySnapshot.co > CO_HIGH;
+  alerts.waterLow = gatewaySnapshot.waterLevel >= 0 && gatewaySnapshot.waterLevel < WATER_LOW;  // -1: no echo
+  alerts.motionDetected = gatewaySnapshot.motion;
+  return alerts;
+}
+
+// True when a condition of `now` was clear in `before`
+bool alertRaised(const UploadAlerts &before, const UploadAlerts &now) {
+  return (now.soilMoistureLow && !before.soilMoistureLow) || (now.soilDrying && !before.soilDrying) ||
+         (now.gasHigh && !before.gasHigh) || (now.co2High && !before.co2High) || (now.coHigh && !before.coHigh) ||
+         (now.waterLow && !before.waterLow) || (now.motionDetected && !before.motionDetected);
+}
+
+// Drive the alert LEDs; true while a gas alarm is on
+bool updateAlertLeds(const UploadAlerts &alerts) {
   bool alertActive = false;
   
   // Check all alert conditions
-  if (receivedSoilData.soilMoisture < MOISTURE_LOW) {
+  if (alerts.soilMoistureLow || alerts.soilDrying) {
     digitalWrite(LED_SOIL, HIGH);
     alertActive = true;
   } else {
     digitalWrite(LED_SOIL, LOW);
   }
   
-  float gasLevel = readGasSensor();
-  float co2Level = readCO2();
-  float coLevel = readCO();
-  
-  if (gasLevel > GAS_HIGH || co2Level > CO2_HIGH || coLevel > CO_HIGH) {
+  bool gasAlarm = alerts.gasHigh || alerts.co2High || alerts.coHigh;
+  if (gasAlarm) {
     digitalWrite(LED_GAS, HIGH);
     alertActive = true;
   } else {
     digitalWrite(LED_GAS, LOW);
   }
   
-  if (readMotion()) {
+  if (alerts.motionDetected) {
     digitalWrite(LED_MOTION, HIGH);
   } else {
     digitalWrite(LED_MOTION, LOW);
@@ -399,11 +1069,44 @@ void checkAlerts() {
   // System OK LED (inverse of alert)
   digitalWrite(LED_OK, !alertActive ? HIGH : LOW);
   
+  return gasAlarm;
+}
+
+// Time from the oldest unevaluated input to the LEDs being driven
+void recordAlertLatency() {
+  uint32_t latency = (uint32_t)esp_timer_get_time() - alertInput_us;
+  alertLatency.checks++;
+  if (latency > alertLatency.worst_us) alertLatency.worst_us = latency;
+  
+  if (alertInputDuringUpload || uploadInFlight) {
+    alertLatency.checksUpload++;
+    if (latency > alertLatency.worstUpload_us) alertLatency.worstUpload_us = latency;
+  }
+  alertInputPending = false;
+  alertInputDuringUpload = false;
+}
+
+// Re-evaluate the alerts on new input and run the buzzer; true when an
+// alert was raised
+bool checkAlerts() {
+  static bool gasAlarm = false;
+  bool raised = false;
+  
+  // Conditions only change with a new snapshot or a soil packet from any
+  // node; the buzzer below still runs on every call
+  if (alertInputPending) {
+    UploadAlerts alerts = evaluateAlerts();
+    gasAlarm = updateAlertLeds(alerts);
+    recordAlertLatency();
+    raised = alertRaised(currentAlerts, alerts);
+    currentAlerts = alerts;
+  }
+  
   // Buzzer for critical alerts
   static unsigned long buzzerStartTime = 0;
   static bool buzzerOn = false;
   
-  if (gasLevel > GAS_HIGH || co2Level > CO2_HIGH || coLevel > CO_HIGH) {
+  if (gasAlarm) {
     unsigned long currentTime = millis();
     
     if (!buzzerOn && (currentTime - buzzerStartTime > 1000)) {
@@ -421,12 +1124,222 @@ void checkAlerts() {
     ledcWriteTone(0, 0);  // Ensure buzzer is off when no alert
     buzzerOn = false;
   }
+  return raised;
+}
+
+// ============================================
+// TASK FUNCTIONS
+// ============================================
+// Start of one iteration of a task loop; returns the start time
+uint32_t taskBegin(TaskLoad &load) {
+  uint32_t now = (uint32_t)esp_timer_get_time();
+  if (load.loops > 0) {
+    uint32_t period = now - load.lastStart_us;
+    if (period > load.worstPeriod_us) load.worstPeriod_us = period;
+    if (uploadInFlight && period > load.worstPeriodUpload_us) load.worstPeriodUpload_us = period;
+  }
+  load.lastStart_us = now;
+  return now;
+}
+
+// End of the iteration started at `start`
+void taskEnd(TaskLoad &load, uint32_t start) {
+  load.busy_us += (uint32_t)esp_timer_get_time() - start;
+  load.loops++;
+}
+
+// Copy the sensing task's readings and alerts out for the other tasks
+void publishState() {
+  GatewayState state;
+  state.data = sensorData;
+  state.alerts = currentAlerts;
+  state.snapshot = gatewaySnapshot;
+  publishedState.write(state);
+}
+
+// Share of the CPU each task used since the last report, its worst
+// scheduling gap and the alert latency, both overall and with an upload
+// in flight
+void reportTasks() {
+  static TaskLoad *const loads[] = { &sensingLoad, &networkLoad, &displayLoad };
+  static uint32_t lastBusy[3] = {};
+  static uint32_t lastReport_us = 0;
+  
+  uint32_t now = (uint32_t)esp_timer_get_time();
+  uint32_t elapsed = now - lastReport_us;
+  lastReport_us = now;
+  
+  for (int i = 0; i < 3; i++) {
+    TaskLoad &load = *loads[i];
+    uint32_t busy = load.busy_us;
+    Serial.printf("[Tasks] %-7s core %d: %5.2f%% CPU, %lu loops, worst period %.1f ms (%.1f ms during upload), %u bytes stack free\r\n",
+                  load.name, load.core, 100.0f * (busy - lastBusy[i]) / elapsed,
+                  (unsigned long)load.loops, load.worstPeriod_us / 1000.0f, load.worstPeriodUpload_us / 1000.0f,
+                  (unsigned)uxTaskGetStackHighWaterMark(load.handle));
+    lastBusy[i] = busy;
+  }
+  Serial.printf("[Alerts] Latency worst %.2f ms over %lu checks, %.2f ms over %lu checks during upload\r\n",
+                alertLatency.worst_us / 1000.0f, (unsigned long)alertLatency.checks,
+                alertLatency.worstUpload_us / 1000.0f, (unsigned long)alertLatency.checksUpload);
+  Serial.printf("[Tasks] %lu states published, %lu seqlock retries, %lu alert events dropped\r\n",
+                (unsigned long)publishedState.getVersion(), (unsigned long)publishedState.getRetries(),
+                (unsigned long)alertEventsDropped);
+  const LcdFramebufferStats &lcdStats = lcdFrame.getStats();
+  Serial.printf("[LCD] %lu flushes, %lu characters, %lu cursor moves (%.1f characters per flush)\r\n",
+                (unsigned long)lcdStats.flushes, (unsigned long)lcdStats.cellsSent,
+                (unsigned long)lcdStats.cursorMoves,
+                lcdStats.flushes ? (float)lcdStats.cellsSent / lcdStats.flushes : 0.0f);
+}
+
+// Core 1, highest priority: packets, gateway sensors, LEDs and buzzer
+void sensingTask(void *parameter) {
+  TickType_t wake = xTaskGetTickCount();
+  
+  for (;;) {
+    uint32_t start = taskBegin(sensingLoad);
+    unsigned long now = millis();
+    
+    // Decode packets queued by the ESP-NOW callback
+    bool changed = processReceivedPackets();
+    
+    // Ping the tank each period; the rest of the gateway sensors are
+    // sampled into the history once its echo is in
+    if (lastGatewaySample == 0 || now - lastGatewaySample >= GATEWAY_SAMPLE_INTERVAL) {
+      lastGatewaySample = now;
+      startWaterLevelRead();
+    }
+    float waterLevel;
+    if (pollWaterLevel(waterLevel)) {
+      sampleGatewaySensors(now, waterLevel);
+      changed = true;
+    }
+    changed |= sampleWeight(now);
+    changed |= updateTrends(now);
+    
+    bool raised = checkAlerts();
+    if (changed) {
+      publishState();
+    }
+    if (raised) {
+      AlertEvent event = { (uint32_t)now, currentAlerts };
+      if (xQueueSend(alertQueue, &event, 0) != pdTRUE) {
+        alertEventsDropped++;
+      }
+    }
+    
+    taskEnd(sensingLoad, start);
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(SENSING_PERIOD));
+  }
+}
+
+// Core 0: snapshots, uploads and reports. Blocks in Firebase requests for
+// as long as they take without holding up the other tasks.
+void networkTask(void *parameter) {
+  bool alertPending = false;
+  uint32_t alertRaised_ms = 0;
+  
+  for (;;) {
+    AlertEvent event;
+    if (xQueueReceive(alertQueue, &event, pdMS_TO_TICKS(NETWORK_POLL)) == pdTRUE && !alertPending) {
+      alertPending = true;
+      alertRaised_ms = event.raised_ms;
+    }
+    uint32_t start = taskBegin(networkLoad);
+    unsigned long now = millis();
+    
+    // Snapshot sensor data for Firebase periodically, and soon after an alert
+    bool alertDue = alertPending && now - lastFirebaseUpdate >= ALERT_UPLOAD_GAP;
+    if (alertDue || now - lastFirebaseUpdate >= FIREBASE_INTERVAL) {
+      if (alertDue) {
+        Serial.printf("[Alert] Uploading raised alert (%lu ms old)\r\n", (unsigned long)(now - alertRaised_ms));
+      }
+      lastFirebaseUpdate = now;
+      alertPending = false;
+      uploadToFirebase();
+    }
+    
+    if (now - lastHistoryReport >= HISTORY_REPORT_INTERVAL) {
+      lastHistoryReport = now;
+      reportHistory();
+      reportNodes(uploadRegistry, now);
+    }
+    
+    if (now - lastTaskReport >= TASK_REPORT_INTERVAL) {
+      lastTaskReport = now;
+      reportTasks();
+    }
+    
+    // Send or retry queued uploads
+    if (WiFi.status() == WL_CONNECTED) {
+      uploadInFlight = true;
+      serviceFirebaseUpload();
+      uploadInFlight = false;
+    }
+    
+    taskEnd(networkLoad, start);
+  }
+}
+
+// Core 1, lowest priority: LCD pages
+void displayTask(void *parameter) {
+  uint32_t refreshes = 0;
+  for (;;) {
+    uint32_t start = taskBegin(displayLoad);
+    updateLCD(refreshes++ % (LCD_INTERVAL / LCD_REFRESH_INTERVAL) == 0);
+    taskEnd(displayLoad, start);
+    vTaskDelay(pdMS_TO_TICKS(LCD_REFRESH_INTERVAL));
+  }
+}
+
+// Receive callback, broadcast peer for pairing replies and RSSI capture
+void initializeEspNow() {
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("[ERROR] ESP-NOW initialization failed!");
+    return;
+  }
+  Serial.println("[ESP-NOW] ✓ Initialized successfully");
+  
+  // Register receive callback
+  esp_now_register_recv_cb(OnDataRecv);
+  
+  // Broadcast peer for pairing replies
+  esp_now_peer_info_t broadcastPeer = {};
+  memcpy(broadcastPeer.peer_addr, BROADCAST_ADDRESS, 6);
+  if (esp_now_add_peer(&broadcastPeer) != ESP_OK) {
+    Serial.println("[ERROR] Failed to add broadcast peer!");
+  }
+  
+  // Management frames only, for the RSSI of ESP-NOW packets
+  wifi_promiscuous_filter_t promiscuousFilter = { .filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT };
+  esp_wifi_set_promiscuous_filter(&promiscuousFilter);
+  esp_wifi_set_promiscuous_rx_cb(OnPromiscuousRx);
+  esp_wifi_set_promiscuous(true);
+  
+  Serial.println("[ESP-NOW] Skipped for simulation mode");
+}
+
+// Start the tasks; from here on only they touch the sensors, LCD and cloud
+void startTasks() {
+  stateMutex = xSemaphoreCreateMutex();
+  alertQueue = xQueueCreate(ALERT_QUEUE_DEPTH, sizeof(AlertEvent));
+  publishState();
+  
+  xTaskCreatePinnedToCore(sensingTask, "sensing", SENSING_STACK, nullptr, SENSING_PRIORITY,
+                          &sensingLoad.handle, SENSING_CORE);
+  xTaskCreatePinnedToCore(networkTask, "network", NETWORK_STACK, nullptr, NETWORK_PRIORITY,
+                          &networkLoad.handle, NETWORK_CORE);
+  xTaskCreatePinnedToCore(displayTask, "display", DISPLAY_STACK, nullptr, DISPLAY_PRIORITY,
+                          &displayLoad.handle, DISPLAY_CORE);
+  Serial.printf("[Tasks] ✓ Sensing on core %d, network on core %d, display on core %d\r\n",
+                SENSING_CORE, NETWORK_CORE, DISPLAY_CORE);
 }
 
 // ============================================
 // SETUP
 // ============================================
 void setup() {
+  // Printing from the tasks only copies into this buffer
+  Serial.setTxBufferSize(4096);
   Serial.begin(115200);
   delay(1000);
   
@@ -437,6 +1350,7 @@ void setup() {
   // Pin setup
   pinMode(TRIG_PIN, OUTPUT);
   pinMode(ECHO_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(ECHO_PIN), onEchoEdge, CHANGE);
   pinMode(PIR_PIN, INPUT);
   pinMode(BUZZER_PIN, OUTPUT);
   pinMode(LED_SOIL, OUTPUT);
@@ -456,13 +1370,22 @@ void setup() {
   
   // Initialize test data for simulation (since ESP-NOW is disabled)
   initializeTestData();
+  initializeOfflineLog();
+  cloudUploader.attachRegistry(&uploadRegistry);
+  if (!history.begin()) {
+    Serial.println("[History] ✗ Out of memory, running without history");
+  } else {
+    Serial.printf("[History] %lu bytes, %u blocks per channel\r\n",
+                  (unsigned long)history.getStats().bytesAllocated, history.getLayout().blocksPerChannel);
+  }
   Serial.println("[SIMULATION] Test data initialized for soil and weather nodes");
   
   // Initialize LCD
   lcd.init();
   lcd.backlight();
-  lcd.setCursor(0, 0);
-  lcd.print("Gateway Booting...");
+  lcdFrame.panelCleared();
+  lcdFrame.print("Gateway Booting...");
+  lcdFrame.flush(lcdSink);
   
   // Initialize HX711
   scale.begin(HX711_DT, HX711_SCK);
@@ -478,17 +1401,7 @@ void setup() {
   // Set device as a Wi-Fi Station
   WiFi.mode(WIFI_STA);
   
-  // Initialize ESP-NOW
-  if (esp_now_init() != ESP_OK) {
-    Serial.println("[ERROR] ESP-NOW initialization failed!");
-    return;
-  }
-  Serial.println("[ESP-NOW] ✓ Initialized successfully");
-  
-  // Register receive callback
-  esp_now_register_recv_cb(OnDataRecv);
-  
-  Serial.println("[ESP-NOW] Skipped for simulation mode");
+  initializeEspNow();
   
   // Connect to WiFi
   Serial.print("[WiFi] Connecting to ");
@@ -524,9 +1437,11 @@ void setup() {
     Serial.println("[INFO] Continuing without cloud connectivity...");
   }
   
-  lcd.clear();
-  lcd.setCursor(0, 0);
-  lcd.print("GATEWAY READY");
+  lcdFrame.clear();
+  lcdFrame.print("GATEWAY READY");
+  lcdFrame.flush(lcdSink);
+  
+  startTasks();
   
   Serial.println("\r\n╔════════════════════════════════════════╗");
   Serial.println("║     GATEWAY NODE Ready - Listening     ║");
@@ -536,23 +1451,7 @@ void setup() {
 // ============================================
 // MAIN LOOP
 // ============================================
+// Everything runs in the tasks started by setup()
 void loop() {
-  unsigned long currentTime = millis();
-  
-  // Update LCD periodically
-  if (currentTime - lastLCDUpdate >= LCD_INTERVAL) {
-    lastLCDUpdate = currentTime;
-    updateLCD();
-  }
-  
-  // Check alerts
-  checkAlerts();
-  
-  // Upload to Firebase periodically
-  if (WiFi.status() == WL_CONNECTED && currentTime - lastFirebaseUpdate >= FIREBASE_INTERVAL) {
-    lastFirebaseUpdate = currentTime;
-    uploadToFirebase();
-  }
-  
-  delay(100);
-}
\ No newline at end of file
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,229 @@
+/*
+ * Host node registry benchmark (PlatformIO `native_registry` environment)
+ *
+ * Registers simulated soil and weather nodes with random MAC addresses
+ * (a few shared vendor prefixes, as with real ESP32 boards), then times
+ * packet lookups in the NodeRegistry against a linear scan over the same
+ * MACs, the way a plain node array would be searched. A second table size
+ * shows the probe count at the same load factor for 256 nodes.
+ *
+ * The nodes are then paged into nodes/<mac> and system/nodes/<mac> upload
+ * documents to check that every node fits in a request and how many
+ * requests a sweep takes.
+ *
+ * Finally one node sends over a simulated link that drops, duplicates,
+ * reorders and delays packets and reboots halfway; the link statistics the
+ * registry derives are printed next to the true counts.
+ *
+ * Build and run: pio run -e native_registry && .pio/build/native_registry/program [lookups] [loss%]
+ */
+
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "node_registry.h"
+#include "cloud_upload.h"
+#include "protocol.h"
+#include "link_stats.h"
+
+#define MAX_NODES 256
+#define MAX_SLOTS 512
+
+static NodeEntry slots[MAX_SLOTS];
+static uint16_t order[MAX_NODES];
+static uint8_t macs[MAX_NODES][6];
+static uint16_t lookupOrder[1 << 16];
+
+static const uint8_t VENDORS[][3] = {
+  { 0x24, 0x0A, 0xC4 }, { 0x30, 0xAE, 0xA4 }, { 0xA4, 0xCF, 0x12 },
+};
+
+static double nowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// A soil or weather packet as a node would seal it
+static size_t makePacket(uint16_t node, uint16_t sequence, uint8_t *out) {
+  if (node % 4 == 0) {
+    WeatherNodeData packet = {};
+    packet.header.nodeId = NODE_ID_WEATHER;
+    packet.header.sequence = sequence;
+    packet.header.timestamp = sequence * 5000UL;
+    packet.airTemp = toFixedS16(15.0f + node % 20, FIXED_CENTI);
+    packet.humidity = toFixedU16(60.0f, FIXED_CENTI);
+    memcpy(out, &packet, sizeof(packet));
+    return sizeof(packet);
+  }
+  SoilNodeData packet = {};
+  packet.header.nodeId = NODE_ID_SOIL;
+  packet.header.sequence = sequence;
+  packet.header.timestamp = sequence * 5000UL;
+  packet.soilMoisture = toFixedU16(20.0f + node % 60, FIXED_CENTI);
+  packet.soilPH = toFixedU16(6.5f, FIXED_CENTI);
+  memcpy(out, &packet, sizeof(packet));
+  return sizeof(packet);
+}
+
+// Linear search, as over an array of nodes without an index
+static int linearFind(const uint8_t *mac, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    if (memcmp(macs[i], mac, 6) == 0) return i;
+  }
+  return -1;
+}
+
+static void benchmark(uint16_t nodes, uint16_t slotCount, uint32_t lookups) {
+  NodeRegistry registry(slots, slotCount, order, nodes);
+
+  // Register every node with its first packet
+  uint8_t packet[sizeof(NodePacket)];
+  for (uint16_t i = 0; i < nodes; i++) {
+    size_t length = makePacket(i, 1, packet);
+    if (registry.record(macs[i], packet, length, 0) == nullptr) {
+      printf("  node %u refused\n", i);
+    }
+  }
+  // One more sender than fits must be refused, not overwrite a node
+  uint8_t stranger[6] = { 0x02, 0, 0, 0, 0, 0x01 };
+  size_t length = makePacket(1, 1, packet);
+  bool refused = registry.record(stranger, packet, length, 0) == nullptr;
+
+  for (uint32_t i = 0; i < lookups; i++) {
+    lookupOrder[i % (1 << 16)] = rand() % nodes;
+  }
+
+  // Hash lookups (find() also counts probes, as the gateway's does)
+  double start = nowNs();
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < lookups; i++) {
+    found += registry.find(macs[lookupOrder[i % (1 << 16)]]) != nullptr;
+  }
+  double hashNs = (nowNs() - start) / lookups;
+  float probes = registry.getAverageProbes();
+
+  // The same lookups by linear scan
+  start = nowNs();
+  long scanned = 0;
+  for (uint32_t i = 0; i < lookups; i++) {
+    scanned += linearFind(macs[lookupOrder[i % (1 << 16)]], nodes);
+  }
+  double linearNs = (nowNs() - start) / lookups;
+
+  // Full packet path: lookup, copy and counters
+  start = nowNs();
+  for (uint32_t i = 0; i < lookups; i++) {
+    uint16_t node = lookupOrder[i % (1 << 16)];
+    size_t size = makePacket(node, i + 2, packet);
+    registry.record(macs[node], packet, size, i);
+  }
+  double recordNs = (nowNs() - start) / lookups;
+
+  printf("%5u nodes %4u slots  found %lu/%lu  probes %.2f  hash %6.1f ns  linear %7.1f ns  record %6.1f ns  full %s\n",
+         nodes, slotCount, (unsigned long)found, (unsigned long)lookups, probes, hashNs, linearNs, recordNs,
+         refused ? "ok" : "FAILED");
+  if (scanned < 0) printf("  linear scan missed a node\n");
+
+  // Page every node into upload documents
+  static char document[UPLOAD_DOC_MAX];
+  uint16_t first = 0;
+  unsigned requests = 0;
+  size_t largest = 0;
+  while (first < registry.size()) {
+    size_t bytes;
+    uint16_t next = buildNodeUpdate(registry, first, lookups, document, sizeof(document), bytes);
+    if (next == first) {
+      printf("  node %u does not fit a document\n", first);
+      break;
+    }
+    requests++;
+    if (bytes > largest) largest = bytes;
+    first = next;
+  }
+  printf("%5s upload sweep: %u requests of up to %lu bytes (%.1f nodes/request)\n", "",
+         requests, (unsigned long)largest, requests ? (float)registry.size() / requests : 0.0f);
+}
+
+// One node sending every 5 s over a lossy link with 0..jitter ms delay
+static void simulateLink(float lossPercent) {
+  const uint32_t PACKETS = 20000;
+  const uint32_t INTERVAL_MS = 5000;
+  const uint32_t JITTER_MS = 40;
+  NodeRegistry registry(slots, REGISTRY_SLOTS, order, REGISTRY_MAX_NODES);
+  uint8_t packet[sizeof(NodePacket)];
+  uint8_t held[sizeof(NodePacket)];
+  size_t heldLength = 0;
+  uint32_t lost = 0, duplicated = 0, reordered = 0;
+  uint16_t sequence = 0;
+  uint32_t uptime = 0;
+
+  for (uint32_t i = 0; i < PACKETS; i++) {
+    // Reboot halfway: sequence and uptime start over
+    if (i == PACKETS / 2) {
+      sequence = 0;
+      uptime = 0;
+    }
+    size_t length = makePacket(1, sequence++, packet);
+    ((PacketHeader *)packet)->timestamp = uptime;
+    uint32_t arrival = i * INTERVAL_MS + rand() % (JITTER_MS + 1);
+    uptime += INTERVAL_MS;
+
+    if (rand() % 10000 < lossPercent * 100) {
+      lost++;
+      continue;
+    }
+    // Hold every 50th packet back until after the next one
+    if (i % 50 == 7 && heldLength == 0) {
+      memcpy(held, packet, length);
+      heldLength = length;
+      reordered++;
+      continue;
+    }
+    registry.record(macs[0], packet, length, arrival, -60 - rand() % 20);
+    if (heldLength) {
+      registry.record(macs[0], held, heldLength, arrival + 1, -70);
+      heldLength = 0;
+    }
+    // Lost ACK: the node sends the same packet again
+    if (rand() % 100 < 2) {
+      registry.record(macs[0], packet, length, arrival + 3, -65);
+      duplicated++;
+    }
+  }
+
+  const NodeStatistics &stats = registry.at(0).stats;
+  printf("Link at %.0f%% loss: true lost %lu dup %lu reordered %lu | measured lost %lu (%.2f%%) dup %lu restarts %lu\n",
+         lossPercent, (unsigned long)lost, (unsigned long)duplicated, (unsigned long)reordered,
+         (unsigned long)stats.packetsLost, linkLossRate(stats) * 100.0f, (unsigned long)stats.duplicates,
+         (unsigned long)stats.restarts);
+  printf("%5s received %lu, RSSI %ld dBm (avg %.1f), jitter %.1f ms, interval %.2f s\n", "",
+         (unsigned long)stats.packetsReceived, (long)stats.lastRSSI, stats.averageRSSI, stats.jitter_ms,
+         stats.interval_ms / 1000.0f);
+}
+
+int main(int argc, char **argv) {
+  uint32_t lookups = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+  float lossPercent = argc > 2 ? atof(argv[2]) : 10.0f;
+  srand(1);
+
+  // Unique MACs under a few vendor prefixes
+  for (uint16_t i = 0; i < MAX_NODES; i++) {
+    do {
+      memcpy(macs[i], VENDORS[rand() % 3], 3);
+      for (int b = 3; b < 6; b++) macs[i][b] = rand() & 0xFF;
+    } while (linearFind(macs[i], i) >= 0);
+  }
+
+  printf("Node registry: %lu bytes per entry, %lu lookups per run\n",
+         (unsigned long)sizeof(NodeEntry), (unsigned long)lookups);
+  benchmark(REGISTRY_MAX_NODES, REGISTRY_SLOTS, lookups);
+  benchmark(MAX_NODES, MAX_SLOTS, lookups);
+  simulateLink(lossPercent);
+  return 0;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,397 @@
+/*
+ * Host upload check for the gateway (PlatformIO `native` environment)
+ *
+ * Runs the CloudUploader against a local HTTP stand-in on 127.0.0.1 that
+ * counts requests and bytes, then replays the same snapshots the old way
+ * (one request per value) for comparison. The first `failFirst` requests
+ * are answered with 503 to exercise the retry queue.
+ *
+ * A second run takes the link down for `outage` snapshot intervals. The
+ * snapshots go to a FlashRingLog on an emulated NOR flash, the gateway
+ * "reboots" halfway through the outage (the log is re-mounted from flash),
+ * and after reconnecting the backlog is drained while live uploads go on.
+ *
+ * Build and run: pio run -e native && .pio/build/native/program [cycles] [failFirst] [outage]
+ */
+
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "cloud_upload.h"
+#include "flash_log.h"
+
+// Same cadence as gateway_node.cpp
+#define FIREBASE_INTERVAL 30000
+#define LOOP_INTERVAL 100
+
+// ============================================
+// LOCAL HTTP STAND-IN
+// ============================================
+struct ServerStats {
+  unsigned long requests;
+  unsigned long bytesIn;      // Request line, headers and body
+  unsigned long bodyBytes;
+  int failFirst;              // Answer this many requests with 503
+};
+
+static ServerStats server;
+static pthread_mutex_t serverLock = PTHREAD_MUTEX_INITIALIZER;
+static int listenSocket = -1;
+static int serverPort = 0;
+
+// Read one request and answer it
+static void serveClient(int client) {
+  char buffer[2048];
+  size_t received = 0;
+  long contentLength = -1;
+  size_t headerEnd = 0;
+
+  while (received < sizeof(buffer) - 1) {
+    ssize_t n = recv(client, buffer + received, sizeof(buffer) - 1 - received, 0);
+    if (n <= 0) break;
+    received += n;
+    buffer[received] = '\0';
+
+    if (headerEnd == 0) {
+      char *end = strstr(buffer, "\r\n\r\n");
+      if (end == nullptr) continue;
+      headerEnd = end - buffer + 4;
+      char *length = strstr(buffer, "Content-Length:");
+      contentLength = length ? strtol(length + 15, nullptr, 10) : 0;
+    }
+    if (received >= headerEnd + contentLength) break;
+  }
+
+  pthread_mutex_lock(&serverLock);
+  server.requests++;
+  server.bytesIn += received;
+  server.bodyBytes += contentLength > 0 ? contentLength : 0;
+  bool fail = server.failFirst > 0;
+  if (fail) server.failFirst--;
+  pthread_mutex_unlock(&serverLock);
+
+  const char *response = fail
+    ? "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n"
+    : "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\n{}";
+  send(client, response, strlen(response), 0);
+  close(client);
+}
+
+static void *serverThread(void *) {
+  while (true) {
+    int client = accept(listenSocket, nullptr, nullptr);
+    if (client < 0) break;
+    serveClient(client);
+  }
+  return nullptr;
+}
+
+static bool startServer() {
+  listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+  if (listenSocket < 0) return false;
+
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;  // Any free port
+
+  socklen_t length = sizeof(address);
+  if (bind(listenSocket, (sockaddr *)&address, sizeof(address)) < 0 ||
+      listen(listenSocket, 8) < 0 ||
+      getsockname(listenSocket, (sockaddr *)&address, &length) < 0) {
+    return false;
+  }
+  serverPort = ntohs(address.sin_port);
+
+  pthread_t thread;
+  return pthread_create(&thread, nullptr, serverThread, nullptr) == 0;
+}
+
+// ============================================
+// HTTP TRANSPORT
+// ============================================
+// One request per connection, like the Firebase client without keep-alive
+static bool httpRequest(const char *method, const char *path, const char *body, size_t length) {
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0) return false;
+
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(serverPort);
+  if (connect(sock, (sockaddr *)&address, sizeof(address)) < 0) {
+    close(sock);
+    return false;
+  }
+
+  char header[256];
+  int headerLength = snprintf(header, sizeof(header),
+    "%s %s.json HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\n"
+    "Content-Length: %zu\r\nConnection: close\r\n\r\n", method, path, length);
+  send(sock, header, headerLength, 0);
+  send(sock, body, length, 0);
+
+  char response[128] = {0};
+  recv(sock, response, sizeof(response) - 1, 0);
+  close(sock);
+
+  return strncmp(response, "HTTP/1.1 200", 12) == 0;
+}
+
+class HttpTransport : public UploadTransport {
+public:
+  bool update(const char *path, const char *json, size_t length) override {
+    return httpRequest("PATCH", path, json, length);
+  }
+};
+
+// Old behaviour: one PUT per value of the update document
+static void uploadPerValue(const char *json) {
+  char document[UPLOAD_DOC_MAX];
+  strncpy(document, json, sizeof(document) - 1);
+  document[sizeof(document) - 1] = '\0';
+
+  char *entry = strtok(document + 1, ",}");  // Skip '{'
+  while (entry != nullptr) {
+    char *colon = strstr(entry, "\":");
+    if (colon != nullptr) {
+      *colon = '\0';
+      char path[64];
+      snprintf(path, sizeof(path), "/%s", entry + 1);  // Skip opening quote
+      const char *value = colon + 2;
+      httpRequest("PUT", path, value, strlen(value));
+    }
+    entry = strtok(nullptr, ",}");
+  }
+}
+
+// ============================================
+// SNAPSHOT
+// ============================================
+static void fillSnapshot(AllSensorData &data, int cycle) {
+  memset(&data, 0, sizeof(data));
+  data.soilMoisture = 65.0f - cycle * 0.5f;
+  data.soilPH = 6.5f;
+  data.soilTemp = 22.0f;
+  data.soilNodeConnected = true;
+  data.leafWetness = 45.0f;
+  data.leafTemp = 21.0f;
+  data.airTemp = 25.0f + cycle * 0.1f;
+  data.humidity = 60.0f;
+  data.light = 500;
+  data.windSpeed = 3.5f;
+  data.windDirection = 180;
+  data.windDirection10 = 175;
+  data.windDirStdDev = 12.0f;
+  data.rainfall = 2.5f;
+  data.rainfall1h = 0.6f;
+  data.rainEvent = 2.5f;
+  data.rainRate = 1.2f;
+  data.weatherNodeConnected = true;
+  data.waterLevel = 150.0f;
+  data.gas = 120;
+  data.co2 = 450;
+  data.co = 5;
+  data.weight = 12.3f;
+}
+
+// ============================================
+// EMULATED NOR FLASH
+// ============================================
+#define HOST_FLASH_SECTOR 4096
+#define HOST_FLASH_SECTORS 8
+
+// Writes can only clear bits, like the ESP32's SPI flash
+class RamFlash : public LogStorage {
+private:
+  uint8_t memory[HOST_FLASH_SECTOR * HOST_FLASH_SECTORS];
+
+public:
+  unsigned long erases = 0;
+
+  RamFlash() { memset(memory, 0xFF, sizeof(memory)); }
+
+  uint32_t sectorSize() override { return HOST_FLASH_SECTOR; }
+  uint32_t sectorCount() override { return HOST_FLASH_SECTORS; }
+
+  bool read(uint32_t address, void *data, size_t length) override {
+    if (address + length > sizeof(memory)) return false;
+    memcpy(data, memory + address, length);
+    return true;
+  }
+
+  bool write(uint32_t address, const void *data, size_t length) override {
+    if (address + length > sizeof(memory)) return false;
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < length; i++) {
+      memory[address + i] &= bytes[i];
+    }
+    return true;
+  }
+
+  bool erase(uint32_t sector) override {
+    if (sector >= HOST_FLASH_SECTORS) return false;
+    memset(memory + sector * HOST_FLASH_SECTOR, 0xFF, HOST_FLASH_SECTOR);
+    erases++;
+    return true;
+  }
+};
+
+// ============================================
+// STORE-AND-FORWARD RUN
+// ============================================
+static void runOutage(int cycles, int outage) {
+  static RamFlash flash;
+  FlashRingLog *log = new FlashRingLog(&flash);
+  log->begin();
+
+  HttpTransport transport;
+  CloudUploader *uploader = new CloudUploader(&transport, "/");
+  uploader->attachBacklog(log);
+
+  unsigned long requestsBefore = server.requests;
+  int outageStart = 2;
+  int outageEnd = outageStart + outage;
+  uint32_t now = 0;
+  uint32_t lastSnapshot = 0;
+  uint32_t reconnectTime = 0;
+  uint32_t drainedAt = 0;
+  uint32_t peakDepth = 0;
+  int taken = 0;
+  AllSensorData data;
+  UploadAlerts alerts;
+  memset(&alerts, 0, sizeof(alerts));
+
+  while (taken < cycles || uploader->getPending() > 0 || log->getDepth() > 0) {
+    bool online = taken <= outageStart || taken > outageEnd;
+
+    if (taken < cycles && (taken == 0 || now - lastSnapshot >= FIREBASE_INTERVAL)) {
+      lastSnapshot = now;
+      fillSnapshot(data, taken);
+      if (online) {
+        uploader->enqueue(data, alerts, now);
+      } else {
+        uploader->archive(data, now);
+      }
+      taken++;
+
+      // Power cycle halfway through the outage: re-mount the log from flash
+      if (taken == outageStart + outage / 2) {
+        delete uploader;
+        delete log;
+        log = new FlashRingLog(&flash);
+        log->begin();
+        uploader = new CloudUploader(&transport, "/");
+        uploader->attachBacklog(log);
+        printf("[Host] Reboot: log recovered with %lu records\n", (unsigned long)log->getDepth());
+      }
+      if (taken == outageEnd + 1) {
+        reconnectTime = now;
+      }
+    }
+
+    if (log->getDepth() > peakDepth) peakDepth = log->getDepth();
+    if (online) {
+      uploader->service(now);
+    }
+    if (reconnectTime > 0 && drainedAt == 0 && log->getDepth() == 0) {
+      drainedAt = now;
+    }
+    now += LOOP_INTERVAL;
+  }
+
+  const UploadStats &stats = uploader->getStats();
+  UploadMetrics metrics = uploader->getMetrics();
+  printf("[Host] Outage:    %d snapshots logged, peak backlog %lu of %lu records\n",
+         outage, (unsigned long)peakDepth, (unsigned long)log->getCapacity());
+  printf("[Host] Drain:     %lu records in %lu requests, %.1f records/s, backlog empty %lu ms after reconnect\n",
+         (unsigned long)stats.backlogRecords, (unsigned long)stats.backlogRequests, metrics.drainRate,
+         (unsigned long)(drainedAt - reconnectTime));
+  printf("[Host] Log:       since reboot %lu appended, %lu consumed, %lu dropped, %lu corrupt, %lu sector erases\n",
+         (unsigned long)log->getStats().appended, (unsigned long)log->getStats().consumed,
+         (unsigned long)log->getStats().dropped, (unsigned long)log->getStats().corrupt, flash.erases);
+  printf("[Host] Requests:  %lu (%lu live, %lu backlog)\n", server.requests - requestsBefore,
+         (unsigned long)(stats.requests - stats.backlogRequests), (unsigned long)stats.backlogRequests);
+
+  delete uploader;
+  delete log;
+}
+
+// ============================================
+// MAIN
+// ============================================
+int main(int argc, char **argv) {
+  int cycles = argc > 1 ? atoi(argv[1]) : 10;
+  int failFirst = argc > 2 ? atoi(argv[2]) : 3;
+  int outage = argc > 3 ? atoi(argv[3]) : 240;
+
+  if (!startServer()) {
+    printf("[Host] Cannot start local HTTP server\n");
+    return 1;
+  }
+  printf("[Host] HTTP stand-in on 127.0.0.1:%d, %d cycles, first %d requests fail\n",
+         serverPort, cycles, failFirst);
+
+  HttpTransport transport;
+  CloudUploader uploader(&transport, "/");
+  server.failFirst = failFirst;
+
+  // Virtual clock: snapshot every FIREBASE_INTERVAL, service every loop pass
+  uint32_t now = 0;
+  int queued = 0;
+  uint32_t lastSnapshot = 0;
+  AllSensorData data;
+  UploadAlerts alerts;
+  memset(&alerts, 0, sizeof(alerts));
+
+  while (queued < cycles || uploader.getPending() > 0) {
+    if (queued < cycles && (queued == 0 || now - lastSnapshot >= FIREBASE_INTERVAL)) {
+      lastSnapshot = now;
+      fillSnapshot(data, queued);
+      uploader.enqueue(data, alerts, now);
+      queued++;
+    }
+    uploader.service(now);
+    now += LOOP_INTERVAL;
+  }
+
+  const UploadStats &stats = uploader.getStats();
+  unsigned long batchedRequests = server.requests;
+  unsigned long batchedBytes = server.bytesIn;
+
+  printf("[Host] Batched:   %lu requests (%lu failed, %lu dropped), %lu bytes on the wire, "
+         "%lu payload bytes/cycle\n",
+         batchedRequests, (unsigned long)stats.failures, (unsigned long)stats.dropped,
+         batchedBytes, (unsigned long)stats.lastBytes);
+
+  // Same snapshots, one request per value
+  for (int cycle = 0; cycle < cycles; cycle++) {
+    char json[UPLOAD_DOC_MAX];
+    fillSnapshot(data, cycle);
+    buildSensorUpdate(data, alerts, cycle * FIREBASE_INTERVAL, json, sizeof(json));
+    uploadPerValue(json);
+  }
+
+  unsigned long legacyRequests = server.requests - batchedRequests;
+  unsigned long legacyBytes = server.bytesIn - batchedBytes;
+  printf("[Host] Per-value: %lu requests, %lu bytes on the wire\n", legacyRequests, legacyBytes);
+  printf("[Host] Per cycle: %.1f -> %.1f requests, %lu -> %lu bytes\n",
+         (double)legacyRequests / cycles, (double)(batchedRequests - stats.failures) / cycles,
+         legacyBytes / cycles, (batchedBytes / batchedRequests));
+
+  runOutage(outage + 10, outage);
+
+  close(listenSocket);
+  return 0;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,106 @@
+/*
+ * Link statistics: sequence classification, loss and jitter
+ *
+ * Feeds scripted sequence numbers of one node through linkRecord():
+ * - gaps count as lost, a late arrival takes one back, a repeat is a
+ *   duplicate that changes nothing else
+ * - the sequence wrapping at 65535 is the next packet, not a restart
+ * - a far step back is a restart (the node rebooted)
+ * - packets on a fixed schedule have no jitter, a delayed one adds
+ *   1/16 of its transit difference
+ *
+ * Run: pio test -e native
+ */
+
+#ifndef ARDUINO
+
+#include <unity.h>
+#include <string.h>
+#include "link_stats.h"
+
+#define TEST_INTERVAL_MS 5000
+
+static LinkTracker tracker;
+static NodeStatistics stats;
+
+// Packet `sequence`, sent on schedule and arriving `delay_ms` later
+static LinkEvent receive(uint16_t sequence, uint32_t delay_ms = 10) {
+    uint32_t sent = sequence * TEST_INTERVAL_MS;
+    return linkRecord(tracker, stats, sequence, sent, sent + delay_ms, -60);
+}
+
+void setUp() {
+    memset(&tracker, 0, sizeof(tracker));
+    memset(&stats, 0, sizeof(stats));
+}
+
+void tearDown() {
+}
+
+void test_loss_late_duplicate() {
+    TEST_ASSERT_EQUAL(LINK_FIRST, receive(1));
+    TEST_ASSERT_EQUAL(LINK_NEXT, receive(2));
+    TEST_ASSERT_EQUAL(LINK_NEXT, receive(5));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.packetsLost);
+
+    // 3 was only delayed: no longer lost
+    TEST_ASSERT_EQUAL(LINK_LATE, receive(3, 12000));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.packetsLost);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.packetsReceived);
+
+    // Retransmissions of packets already counted
+    TEST_ASSERT_EQUAL(LINK_DUPLICATE, receive(3));
+    TEST_ASSERT_EQUAL(LINK_DUPLICATE, receive(5));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.packetsReceived);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.packetsLost);
+    TEST_ASSERT_EQUAL(LINK_DUPLICATE, tracker.lastEvent);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f / 5.0f, linkLossRate(stats));
+}
+
+void test_sequence_wrap() {
+    receive(65534);
+    TEST_ASSERT_EQUAL(LINK_NEXT, receive(65535));
+    TEST_ASSERT_EQUAL(LINK_NEXT, linkRecord(tracker, stats, 0, 65536UL * TEST_INTERVAL_MS,
+                                            65536UL * TEST_INTERVAL_MS + 10, -60));
+    TEST_ASSERT_EQUAL(LINK_NEXT, linkRecord(tracker, stats, 2, 65538UL * TEST_INTERVAL_MS,
+                                            65538UL * TEST_INTERVAL_MS + 10, -60));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.packetsLost);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.restarts);
+}
+
+void test_restart() {
+    for (uint16_t sequence = 100; sequence < 110; sequence++) {
+        receive(sequence);
+    }
+    TEST_ASSERT_EQUAL(LINK_RESTART, linkRecord(tracker, stats, 1, 1000, 600000, -60));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.restarts);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.packetsLost);
+    TEST_ASSERT_EQUAL(LINK_NEXT, linkRecord(tracker, stats, 2, 1000 + TEST_INTERVAL_MS,
+                                            600000 + TEST_INTERVAL_MS, -60));
+}
+
+void test_jitter() {
+    for (uint16_t sequence = 1; sequence <= 20; sequence++) {
+        receive(sequence);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, stats.jitter_ms);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, (float)TEST_INTERVAL_MS, stats.interval_ms);
+    TEST_ASSERT_EQUAL_INT32(-60, stats.lastRSSI);
+
+    // 160 ms late: the transit difference is 160 ms
+    receive(21, 170);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 160.0f / LINK_JITTER_GAIN, stats.jitter_ms);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_loss_late_duplicate);
+    RUN_TEST(test_sequence_wrap);
+    RUN_TEST(test_restart);
+    RUN_TEST(test_jitter);
+    return UNITY_END();
+}
+
+#endif // ARDUINO
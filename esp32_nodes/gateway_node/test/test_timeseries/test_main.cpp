@@ -0,0 +1,184 @@
+/*
+ * Round-trip test of the Gorilla-style time-series blocks
+ *
+ * Records series into a TimeSeriesStore and reads them back with
+ * samples(); every value must come back with the same IEEE-754 bits and
+ * every timestamp unchanged:
+ * - a constant series (value '0' path, ~2 bits per sample)
+ * - sign changes, signed zeros, denormals and infinities (full XOR windows)
+ * - timestamp jumps on both sides of every delta-of-delta bucket boundary
+ * - random values at irregular times until blocks fill and the oldest
+ *   one is recycled
+ * - the compact layout for boards without PSRAM: smaller rollup rings and
+ *   fewer blocks, with the same encoding
+ *
+ * Run: pio test -e native
+ */
+
+#ifndef ARDUINO
+
+#include <unity.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include "timeseries.h"
+
+#define MAX_POINTS 4096
+
+static TimeSeriesStore* store;
+static TsPoint recorded[MAX_POINTS];
+static TsPoint decoded[MAX_POINTS];
+static size_t recordedCount;
+
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void add(TsChannel channel, uint32_t time, float value) {
+    store->record(channel, time, value);
+    recorded[recordedCount].time = time;
+    recorded[recordedCount].value = value;
+    recordedCount++;
+}
+
+// Decoded samples must equal the last `held` recorded ones, bit for bit
+static void assertRoundTrip(TsChannel channel, size_t held) {
+    size_t found = store->samples(channel, 0, UINT32_MAX, decoded, MAX_POINTS);
+    TEST_ASSERT_EQUAL_UINT32(held, found);
+    TEST_ASSERT_EQUAL_UINT32(held, store->getStats().samples);
+
+    const TsPoint* expected = recorded + (recordedCount - held);
+    for (size_t i = 0; i < found; i++) {
+        TEST_ASSERT_EQUAL_HEX32(expected[i].time, decoded[i].time);
+        TEST_ASSERT_EQUAL_HEX32(floatBits(expected[i].value), floatBits(decoded[i].value));
+    }
+}
+
+void setUp() {
+    store = new TimeSeriesStore();
+    TEST_ASSERT_TRUE(store->begin());
+    recordedCount = 0;
+}
+
+void tearDown() {
+    delete store;
+}
+
+void test_constant_series() {
+    for (int i = 0; i < 500; i++) {
+        add(TS_SOIL_MOISTURE, 1000 + i * 5000, 42.5f);
+    }
+    assertRoundTrip(TS_SOIL_MOISTURE, 500);
+
+    // 32 bits for the first value, '110' + 14 bits for the first delta,
+    // then '0' for each unchanged delta and value
+    TEST_ASSERT_EQUAL_UINT32((32 + 17 + 1 + 498 * 2 + 7) / 8, store->getStats().bytesUsed);
+}
+
+void test_sign_changes() {
+    const float values[] = {
+        1.5f, -1.5f, 0.0f, -0.0f, 0.0f, 21.3f, -21.3f, 1e-40f, -1e-40f,
+        FLT_MIN, -FLT_MIN, FLT_MAX, -FLT_MAX, bitsFloat(0x7f800000), bitsFloat(0xff800000),
+        -0.0f, 1e30f, -1e-30f, 3.0f, -3.0f, 3.0f, -3.0f
+    };
+    const size_t count = sizeof(values) / sizeof(values[0]);
+
+    for (size_t i = 0; i < count; i++) {
+        add(TS_AIR_TEMP, 60000 + i * 1000, values[i]);
+    }
+    assertRoundTrip(TS_AIR_TEMP, count);
+}
+
+void test_timestamp_jumps() {
+    // Delta-of-delta on both sides of each bucket edge, then 32-bit jumps
+    // and a repeated timestamp
+    const int32_t dods[] = {
+        0, 127, -128, 128, -129, 0,
+        8191, -8192, 8192, -8193, 0,
+        524287, -524288, 524288, -524289, 0,
+        100000000, -100000000, 0
+    };
+    const size_t count = sizeof(dods) / sizeof(dods[0]);
+
+    uint32_t time = 1000;
+    int32_t delta = 150000000;
+    add(TS_WATER_LEVEL, time, 10.0f);
+    for (size_t i = 0; i < count; i++) {
+        delta += dods[i];
+        time += delta;
+        add(TS_WATER_LEVEL, time, 10.0f + i);
+    }
+    add(TS_WATER_LEVEL, time, 99.0f);
+    assertRoundTrip(TS_WATER_LEVEL, count + 2);
+}
+
+void test_block_filled_to_capacity() {
+    // Incompressible values at irregular times: every block fills to the
+    // worst-case sample size, then the oldest is overwritten
+    srand(8);
+    uint32_t time = 0;
+    while (store->getStats().blocksRecycled == 0) {
+        TEST_ASSERT_TRUE(recordedCount < MAX_POINTS);
+
+        uint32_t bits;
+        float value;
+        do {
+            bits = ((uint32_t)rand() << 16) ^ (uint32_t)rand() ^ ((uint32_t)rand() << 31);
+            value = bitsFloat(bits);
+        } while (value != value);  // NaN is dropped by record()
+
+        time += rand() % 4 == 0 ? (uint32_t)rand() % 1000000 : 5000 + rand() % 200;
+        add(TS_WEIGHT, time, value);
+    }
+
+    size_t held = store->getStats().samples;
+    TEST_ASSERT_TRUE(held < recordedCount);
+    TEST_ASSERT_TRUE(held > (size_t)(store->getLayout().blocksPerChannel - 1) * (TS_BLOCK_BYTES * 8 / 80));
+    assertRoundTrip(TS_WEIGHT, held);
+}
+
+void test_compact_layout() {
+    TimeSeriesStore compact;
+    TEST_ASSERT_TRUE(compact.begin(TS_COMPACT_LAYOUT));
+    TEST_ASSERT_TRUE(compact.getStats().bytesAllocated < store->getStats().bytesAllocated / 2);
+
+    // Half an hour of one sample per minute: the minute ring keeps the
+    // newest TS_COMPACT_MINUTE_BUCKETS, the quarter ring all of it
+    for (uint32_t minute = 0; minute < 30; minute++) {
+        compact.record(TS_SOIL_MOISTURE, minute * 60000UL, (float)minute);
+    }
+    TsRollup rollups[64];
+    size_t count = compact.rollups(TS_SOIL_MOISTURE, TS_MINUTE, 0, UINT32_MAX, rollups, 64);
+    TEST_ASSERT_EQUAL_UINT32(TS_COMPACT_MINUTE_BUCKETS, count);
+    TEST_ASSERT_EQUAL_UINT32((30 - TS_COMPACT_MINUTE_BUCKETS) * 60000UL, rollups[0].start);
+    TEST_ASSERT_EQUAL_UINT32(2, compact.rollups(TS_SOIL_MOISTURE, TS_QUARTER_HOUR, 0, UINT32_MAX, rollups, 64));
+
+    TsRollup hour;
+    TEST_ASSERT_TRUE(compact.aggregate(TS_SOIL_MOISTURE, TS_QUARTER_HOUR, 0, UINT32_MAX, hour));
+    TEST_ASSERT_EQUAL_UINT32(30, hour.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 14.5f, hour.mean);
+
+    float change;
+    TEST_ASSERT_TRUE(compact.change(TS_SOIL_MOISTURE, 10 * 60000UL, change));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, change);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_constant_series);
+    RUN_TEST(test_sign_changes);
+    RUN_TEST(test_timestamp_jumps);
+    RUN_TEST(test_block_filled_to_capacity);
+    RUN_TEST(test_compact_layout);
+    return UNITY_END();
+}
+
+#endif // ARDUINO
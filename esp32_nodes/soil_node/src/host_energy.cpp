@@ -0,0 +1,281 @@
+/*
+ * Host energy model for duty-cycled nodes (PlatformIO `native` environment)
+ *
+ * Replays `days` of wakes for each node and configuration (sleep interval
+ * x batch size) with the same ReportFilter, ReadingBatch and send policy
+ * the nodes run, feeds estimated phase durations into an EnergyLedger and
+ * prints the average current and battery life per power profile. A
+ * synthetic signal per node (soil drying and irrigation, daily air
+ * temperature) goes through its channel's deadband, so only changes and
+ * heartbeats are batched, and its threshold crossings send a batch early.
+ * The other channels are taken as steady.
+ *
+ * The first row of each node is the always-on firmware (radio listening
+ * the whole time, a sample every 5 s). Rain-tip wakes of the weather node
+ * are not modelled.
+ *
+ * `night` mode runs a stable night, noise inside the deadbands, through
+ * the soil node's ReportFilter. Sampling every 5 s, only the first reading
+ * and the heartbeats may go out (72 packets in 12 h). Duty-cycled at 300 s
+ * x 6, the radio may come up once per batch of wakes (24 sessions in
+ * 12 h). The program fails otherwise.
+ *
+ * Build and run: pio run -e native && .pio/build/native/program [days] [capacity_mAh]
+ *                .pio/build/native/program night
+ */
+
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "duty_cycle.h"
+#include "data_structures.h"
+#include "report_filter.h"
+
+// ============================================
+// PHASE DURATION ESTIMATES
+// ============================================
+#define BOOT_US 250000            // Deep-sleep wake to setup()
+#define SOIL_SAMPLE_US 760000     // DS18B20 12-bit conversion and two ADC reads
+#define WEATHER_SAMPLE_US 560000  // DHT22 read and a 10-sample vane burst
+#define RADIO_START_US 120000     // WiFi station start, ESP-NOW init, peer
+#define PACKET_US 2000            // One send and its callback
+#define MAX_BATCH 8
+#define SAMPLE_INTERVAL_MS 5000   // Always-on firmware, as in soil_node.cpp
+
+// ============================================
+// NODE MODELS
+// ============================================
+// Moisture dries from 75 % to 15 % over 2.5 days, then irrigation refills it
+static float soilMoisture(double t) {
+  double phase = fmod(t, 3 * 86400.0);
+  if (phase < 2.5 * 86400.0) {
+    return 75.0 - 60.0 * phase / (2.5 * 86400.0);
+  }
+  return 15.0 + 60.0 * (phase - 2.5 * 86400.0) / (0.5 * 86400.0);
+}
+
+// Daily air temperature swing between 8 and 36 °C, peak mid-afternoon
+static float airTemperature(double t) {
+  return 22.0 + 14.0 * sin(2.0 * M_PI * (t / 86400.0 - 0.375));
+}
+
+struct NodeModel {
+  const char *name;
+  uint32_t sample_us;             // Awake time after boot, radio off
+  float (*signal)(double t);
+  float low;                      // Alert band of the signal
+  float high;
+  ReportChannel channel;          // Its send-on-change deadband
+};
+
+static const NodeModel NODES[] = {
+  { "soil",    SOIL_SAMPLE_US,    soilMoisture,   20.0, 80.0, { "moisture", 1.0, false } },
+  { "weather", WEATHER_SAMPLE_US, airTemperature,  5.0, 35.0, { "airTemp", 0.3, false } },
+};
+
+struct DutyConfig {
+  uint32_t sleep_s;               // 0 = always-on firmware
+  uint8_t batchSize;
+};
+
+static const DutyConfig CONFIGS[] = {
+  { 0, 1 },
+  { 60, 1 }, { 60, 5 },
+  { 300, 1 }, { 300, 6 },
+  { 900, 1 }, { 900, 4 },
+};
+
+struct RunResult {
+  EnergyLedger ledger;
+  uint32_t earlySends;            // Batches sent before filling up
+  uint32_t worstLatency_s;        // Oldest reading at send time
+  uint32_t heartbeats;            // Packets sent only because of max silence
+};
+
+// ============================================
+// SIMULATION
+// ============================================
+static RunResult simulate(const NodeModel &node, const DutyConfig &config, double days) {
+  RunResult result = {};
+  energyReset(&result.ledger);
+  double duration = days * 86400.0;
+  ReportFilterState filterState = {};
+
+  // Always-on: WiFi up and the loop polling for the whole run, every
+  // sample through the filter with the default heartbeat
+  if (config.sleep_s == 0) {
+    ReportFilter filter(&filterState, &node.channel, 1);
+    energyAccount(&result.ledger, POWER_RADIO, (uint64_t)(duration * 1e6));
+    result.ledger.wakes = 1;
+    result.ledger.transmissions = 1;
+    for (double t = 0.0; t < duration; t += SAMPLE_INTERVAL_MS / 1000.0) {
+      float value = node.signal(t);
+      if (filter.evaluate(&value, (uint32_t)(t * 1000.0)) != REPORT_SUPPRESS) result.ledger.packets++;
+    }
+    result.heartbeats = filter.getHeartbeats();
+    return result;
+  }
+
+  // Duty-cycled, as runDutyCycle(): heartbeats are batched, and the radio
+  // comes up when the batch is full, on a crossing, or after max silence
+  uint32_t maxSilence_ms = batchMaxSilence_ms(config.sleep_s * 1000UL, config.batchSize, REPORT_MAX_SILENCE_MS);
+  ReportFilter filter(&filterState, &node.channel, 1, maxSilence_ms);
+  ReadingBatch<SoilNodeData, MAX_BATCH> batch = {};
+  int8_t band = 0;
+  uint32_t lastSession_ms = 0;
+  double t = 0.0;
+
+  while (t < duration) {
+    result.ledger.wakes++;
+    uint32_t now_ms = (uint32_t)(t * 1000.0);
+    float value = node.signal(t);
+    bool crossed = thresholdCrossed(&band, value, node.low, node.high);
+    if (filter.evaluate(&value, now_ms, crossed) != REPORT_SUPPRESS) {
+      SoilNodeData packet = {};
+      packet.header.timestamp = (uint32_t)t;   // Seconds, for the latency figure
+      batch.push(packet);
+    }
+
+    uint64_t active = BOOT_US + node.sample_us;
+    uint64_t radio = 0;
+    if (batchSendDue(batch.count, config.batchSize, crossed, now_ms - lastSession_ms, maxSilence_ms)) {
+      lastSession_ms = now_ms;
+      radio = RADIO_START_US + (uint64_t)batch.count * PACKET_US;
+      uint32_t latency = (uint32_t)t - batch.packets[0].header.timestamp;
+      if (latency > result.worstLatency_s) result.worstLatency_s = latency;
+      if (batch.count < config.batchSize) result.earlySends++;
+      result.ledger.transmissions++;
+      result.ledger.packets += batch.count;
+      batch.clear();
+    }
+
+    energyAccount(&result.ledger, POWER_ACTIVE, active);
+    energyAccount(&result.ledger, POWER_RADIO, radio);
+    energyAccount(&result.ledger, POWER_SLEEP, config.sleep_s * 1000000ULL);
+    t += config.sleep_s + (active + radio) / 1e6;
+  }
+  result.heartbeats = filter.getHeartbeats();
+  return result;
+}
+
+// ============================================
+// STABLE NIGHT (SEND-ON-CHANGE)
+// ============================================
+#define NIGHT_HOURS 12
+
+// Same deadbands as soil_node.cpp
+static const ReportChannel SOIL_CHANNELS[] = {
+  { "moisture", 1.0, false },      // %
+  { "pH", 0.1, false },
+  { "temperature", 0.25, false },  // °C
+};
+
+// Uniform noise in [-amplitude, amplitude]
+static float noise(float amplitude) {
+  return amplitude * (2.0f * rand() / (float)RAND_MAX - 1.0f);
+}
+
+static bool runStableNight() {
+  ReportFilterState state = {};
+  ReportFilter filter(&state, SOIL_CHANNELS, 3);
+  uint32_t duration_ms = NIGHT_HOURS * 3600000UL;
+  uint32_t readings = 0;
+  uint32_t packets = 0;
+  uint32_t heartbeats = 0;
+
+  // Each channel wanders by less than half its deadband
+  for (uint32_t now = 0; now < duration_ms; now += SAMPLE_INTERVAL_MS) {
+    float values[] = { 42.0f + noise(0.4f), 6.8f + noise(0.04f), 17.5f + noise(0.1f) };
+    ReportDecision decision = filter.evaluate(values, now);
+    readings++;
+    if (decision != REPORT_SUPPRESS) packets++;
+    if (decision == REPORT_HEARTBEAT) heartbeats++;
+  }
+
+  // The first reading, then a heartbeat every REPORT_MAX_SILENCE_MS
+  uint32_t expected = duration_ms / REPORT_MAX_SILENCE_MS;
+  bool ok = packets == expected && heartbeats == expected - 1;
+  printf("Stable night: %d h of %d ms samples, %lu readings, %lu packets (%lu heartbeats), "
+         "%.1f%% suppressed, expected %lu packets: %s\n",
+         NIGHT_HOURS, SAMPLE_INTERVAL_MS, (unsigned long)readings, (unsigned long)packets,
+         (unsigned long)heartbeats, 100.0f * filter.getSuppressionRatio(), (unsigned long)expected,
+         ok ? "OK" : "FAIL");
+  return ok;
+}
+
+// Soil moisture wandering inside its deadband, far from the alert band
+static float stableMoisture(double t) {
+  (void)t;
+  return 42.0f + noise(0.4f);
+}
+
+// The same night duty-cycled: heartbeats wait for the batch, so the radio
+// comes up once per BATCH_SIZE wakes and not once per heartbeat
+static bool runStableNightDutyCycled() {
+  const NodeModel node = { "soil", SOIL_SAMPLE_US, stableMoisture, 20.0, 80.0, SOIL_CHANNELS[0] };
+  const DutyConfig config = { 300, 6 };
+  RunResult run = simulate(node, config, NIGHT_HOURS / 24.0);
+
+  uint32_t expected = NIGHT_HOURS * 3600UL / (config.sleep_s * config.batchSize);
+  bool ok = run.ledger.transmissions <= expected && run.ledger.transmissions + 1 >= expected;
+  printf("Stable night, %lus x %u: %lu wakes, %lu radio sessions for %lu packets (%lu heartbeats), "
+         "expected %lu sessions: %s\n",
+         (unsigned long)config.sleep_s, config.batchSize, (unsigned long)run.ledger.wakes,
+         (unsigned long)run.ledger.transmissions, (unsigned long)run.ledger.packets,
+         (unsigned long)run.heartbeats, (unsigned long)expected, ok ? "OK" : "FAIL");
+  return ok;
+}
+
+static void printPercent(const EnergyLedger &ledger, PowerState state) {
+  printf(" %6.2f", 100.0 * ledger.time_us[state] / energyTotalTime_us(&ledger));
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "night") == 0) {
+    srand(1);
+    bool ok = runStableNight();
+    ok &= runStableNightDutyCycled();
+    return ok ? 0 : 1;
+  }
+
+  double days = argc > 1 ? atof(argv[1]) : 7.0;
+  float capacity = argc > 2 ? atof(argv[2]) : 2000.0f;
+  const PowerProfile *profiles[] = { &POWER_PROFILE_WROOM32, &POWER_PROFILE_DEVKIT };
+
+  printf("Energy model: %.1f days, %.0f mAh battery\n", days, capacity);
+  printf("Awake per wake: boot %.0f ms, soil %.0f ms, weather %.0f ms; radio %.0f ms + %.0f ms/packet\n",
+         BOOT_US / 1e3, SOIL_SAMPLE_US / 1e3, WEATHER_SAMPLE_US / 1e3, RADIO_START_US / 1e3, PACKET_US / 1e3);
+
+  for (const PowerProfile *profile : profiles) {
+    printf("\n%s: sleep %.3f mA, active %.1f mA, radio %.1f mA\n", profile->name,
+           profile->current_mA[POWER_SLEEP], profile->current_mA[POWER_ACTIVE],
+           profile->current_mA[POWER_RADIO]);
+    printf("node     sleep  batch  wakes  radio  packets  beats  early  latency   sleep%% active%%  radio%%   avg mA     days\n");
+
+    for (const NodeModel &node : NODES) {
+      for (const DutyConfig &config : CONFIGS) {
+        RunResult run = simulate(node, config, days);
+        if (config.sleep_s == 0) {
+          printf("%-8s %5s  %5s  %5s  %5s  %7lu  %5lu  %5s  %7s", node.name, "on", "-", "-", "-",
+                 (unsigned long)run.ledger.packets, (unsigned long)run.heartbeats, "-", "-");
+        } else {
+          printf("%-8s %4lus  %5u  %5lu  %5lu  %7lu  %5lu  %5lu  %6lus", node.name, (unsigned long)config.sleep_s,
+                 config.batchSize, (unsigned long)run.ledger.wakes, (unsigned long)run.ledger.transmissions,
+                 (unsigned long)run.ledger.packets, (unsigned long)run.heartbeats,
+                 (unsigned long)run.earlySends, (unsigned long)run.worstLatency_s);
+        }
+        printPercent(run.ledger, POWER_SLEEP);
+        printPercent(run.ledger, POWER_ACTIVE);
+        printPercent(run.ledger, POWER_RADIO);
+        printf(" %8.3f %8.1f\n", energyAverageCurrent_mA(&run.ledger, profile),
+               energyBatteryLife_days(&run.ledger, profile, capacity));
+      }
+    }
+  }
+  return 0;
+}
+
+#endif // ARDUINO
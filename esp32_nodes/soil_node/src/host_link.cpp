@@ -0,0 +1,168 @@
+/*
+ * Host delivery check for node packets (PlatformIO `native_link` environment)
+ *
+ * Sends a reading every SAMPLE_INTERVAL for `hours` over an in-process
+ * link model that loses each data frame, and each link-layer ACK, with
+ * probability `loss` (after the radio's own retries). The node side is the
+ * RetryQueue the nodes run; the gateway side is the NodeRegistry, so
+ * duplicates from lost ACKs are detected exactly as on the gateway.
+ *
+ * Schemes per loss rate:
+ * - broadcast: no ACK, the send callback always reports success
+ * - unicast:   ACK, but no retries
+ * - retry:     ACK, MAX_RETRY retries with backoff (the nodes' setting)
+ * - retry x6:  six retries; the backoff then outlasts SAMPLE_INTERVAL and
+ *              newer readings supersede the waiting one
+ *
+ * "delivered" counts distinct packets that reached the gateway, "counted"
+ * the readings the gateway can account for (superseded readings travel
+ * in `skipped` of the packet that replaced them). "expired" packets may
+ * still have arrived, with only their ACKs lost.
+ *
+ * Then a lossless link whose send callbacks take longer than two sample
+ * intervals, so readings supersede packets that never went out. The
+ * gateway must count no loss there: the replacement goes out under the
+ * replaced packet's sequence number. The program fails if it does.
+ *
+ * Build and run: pio run -e native_link && .pio/build/native_link/program [hours]
+ */
+
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "retry_queue.h"
+#include "node_registry.h"
+#include "protocol.h"
+
+// Same settings as soil_node.cpp
+#define SAMPLE_INTERVAL 5000
+#define LOOP_INTERVAL 10
+#define MAX_RETRY 3
+
+struct Scheme {
+  const char *name;
+  bool acknowledged;
+  uint8_t maxRetry;
+};
+
+static const Scheme SCHEMES[] = {
+  { "broadcast", false, 0 },
+  { "unicast",   true,  0 },
+  { "retry",     true,  MAX_RETRY },
+  { "retry x6",  true,  6 },
+};
+
+static const float LOSS_RATES[] = { 0.10f, 0.30f, 0.50f };
+
+// Superseding on a lossless link: readings every 100 ms, send callbacks
+// after 250 ms
+#define BUSY_SAMPLE_INTERVAL 100
+#define BUSY_CALLBACK_DELAY 250
+
+struct LinkResult {
+  uint32_t readings;
+  uint32_t delivered;           // Distinct packets at the gateway
+  uint32_t lost;                // Sequence gaps the gateway counted as lost
+  uint32_t counted;             // Readings the gateway accounts for
+  uint32_t duplicates;
+  RetryStats retry;
+  double latencySum_ms;
+  uint32_t latencyMax_ms;
+};
+
+static NodeEntry slots[REGISTRY_SLOTS];
+static uint16_t order[REGISTRY_MAX_NODES];
+
+static bool chance(float probability) {
+  return rand() < probability * ((float)RAND_MAX + 1.0f);
+}
+
+static LinkResult simulate(const Scheme &scheme, float loss, double hours,
+                           uint32_t sampleInterval = SAMPLE_INTERVAL, uint32_t callbackDelay = LOOP_INTERVAL) {
+  LinkResult result = {};
+  RetryQueue queue(scheme.maxRetry, RETRY_BASE_DELAY_MS, RETRY_MAX_DELAY_MS, 12345);
+  NodeRegistry gateway(slots, REGISTRY_SLOTS, order, REGISTRY_MAX_NODES);
+  const uint8_t mac[6] = { 0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01 };
+  uint32_t duration = (uint32_t)(hours * 3600000.0);
+  uint16_t sequence = 0;
+  bool acknowledged = false;
+  uint32_t sent = 0;
+
+  // Sample for `hours`, then let the queue drain
+  for (uint32_t now = 0; now < duration || queue.size() > 0; now += LOOP_INTERVAL) {
+    if (now < duration && now % sampleInterval == 0) {
+      SoilNodeData packet = {};
+      packet.soilMoisture = toFixedU16(40.0f + (now / SAMPLE_INTERVAL) % 20, FIXED_CENTI);
+      protocolSeal(&packet.header, sizeof(packet), NODE_ID_SOIL, PACKET_SOIL_DATA, sequence++, now);
+      if (queue.push((const uint8_t *)&packet, sizeof(packet), now)) {
+        sequence--;
+      }
+      result.readings++;
+    }
+
+    // The send callback of the last transmission
+    if (queue.busy() && now - sent >= callbackDelay) {
+      queue.complete(acknowledged, now);
+    }
+
+    size_t length;
+    const uint8_t *packet = queue.next(now, length);
+    if (packet == nullptr) continue;
+    sent = now;
+
+    bool arrived = !chance(loss);
+    if (arrived) {
+      NodeEntry *node = gateway.record(mac, packet, length, now);
+      if (node->link.lastEvent != LINK_DUPLICATE) {
+        uint32_t latency = now - ((const PacketHeader *)packet)->timestamp;
+        result.latencySum_ms += latency;
+        if (latency > result.latencyMax_ms) result.latencyMax_ms = latency;
+      }
+    }
+    acknowledged = scheme.acknowledged ? arrived && !chance(loss) : true;
+  }
+
+  if (gateway.size() > 0) {
+    const NodeEntry &node = gateway.at(0);
+    result.delivered = node.stats.packetsReceived;
+    result.counted = node.readings;
+    result.lost = node.stats.packetsLost;
+    result.duplicates = node.stats.duplicates;
+  }
+  result.retry = queue.getStats();
+  return result;
+}
+
+int main(int argc, char **argv) {
+  double hours = argc > 1 ? atof(argv[1]) : 24.0;
+  srand(1);
+
+  printf("Delivery over a lossy link: %.1f h, a reading every %d ms, MAX_RETRY %d, backoff %d..%d ms\n",
+         hours, SAMPLE_INTERVAL, MAX_RETRY, RETRY_BASE_DELAY_MS, RETRY_MAX_DELAY_MS);
+  printf("loss  scheme     readings  delivered  counted  tx/reading  superseded  expired  dups  latency avg/max ms\n");
+
+  for (float loss : LOSS_RATES) {
+    for (const Scheme &scheme : SCHEMES) {
+      LinkResult run = simulate(scheme, loss, hours);
+      printf("%3.0f%%  %-9s  %8lu  %8.2f%%  %6.2f%%  %10.2f  %10lu  %7lu  %4lu  %7.0f / %lu\n",
+             loss * 100.0f, scheme.name, (unsigned long)run.readings,
+             100.0 * run.delivered / run.readings, 100.0 * run.counted / run.readings,
+             (double)run.retry.attempts / run.readings, (unsigned long)run.retry.superseded,
+             (unsigned long)run.retry.expired, (unsigned long)run.duplicates,
+             run.delivered ? run.latencySum_ms / run.delivered : 0.0, (unsigned long)run.latencyMax_ms);
+    }
+  }
+
+  Scheme retry = { "retry", true, MAX_RETRY };
+  LinkResult busy = simulate(retry, 0.0f, hours, BUSY_SAMPLE_INTERVAL, BUSY_CALLBACK_DELAY);
+  bool ok = busy.retry.superseded > 0 && busy.lost == 0 && busy.counted == busy.readings;
+  printf("\nLossless, callbacks after %d ms, a reading every %d ms: %lu readings, %lu superseded, "
+         "%lu delivered, %lu counted, %lu lost: %s\n",
+         BUSY_CALLBACK_DELAY, BUSY_SAMPLE_INTERVAL, (unsigned long)busy.readings,
+         (unsigned long)busy.retry.superseded, (unsigned long)busy.delivered, (unsigned long)busy.counted,
+         (unsigned long)busy.lost, ok ? "OK" : "FAIL");
+  return ok ? 0 : 1;
+}
+
+#endif // ARDUINO
@@ -7,7 +7,15 @@
  * - Soil Thermal Monitoring
  * - Soil Nutrient Availability (pH) Monitoring
  * 
- * Communication: ESP-NOW (Send to Gateway)
+ * Communication: ESP-NOW (Send to Gateway), send-on-change: a reading
+ * goes out only when a channel leaves its deadband, or as a heartbeat.
+ * Broadcasts until the Gateway answers, then unicasts with ACK and
+ * retries with exponential backoff.
+ *
+ * Power: always-on, or duty-cycled with deep sleep (SLEEP_ENABLED).
+ * Each wake appends the reading to a batch in RTC memory; the radio
+ * comes up only when the batch is full or a reading crosses an alert
+ * threshold.
  */
 
 #include <Arduino.h>
@@ -15,13 +23,23 @@
 #include <WiFi.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <sys/time.h>
+#include "protocol.h"
+#include "duty_cycle.h"
+#include "report_filter.h"
+#include "retry_queue.h"
 
 // ============================================
-// CONFIGURATION - REPLACE WITH YOUR GATEWAY MAC ADDRESS
+// CONFIGURATION - GATEWAY MAC ADDRESS
 // ============================================
-// To get MAC address: Upload this sketch to Gateway ESP32 first,
-// then check Serial Monitor for MAC address on boot
-uint8_t gatewayAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+// Learned by pairing: the node broadcasts with PACKET_FLAG_PAIRING until
+// the Gateway answers with a PACKET_PAIR. To skip pairing, enter the MAC
+// the Gateway prints on boot and set gatewayPaired to true.
+const uint8_t BROADCAST_ADDRESS[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+RTC_DATA_ATTR uint8_t gatewayAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+RTC_DATA_ATTR bool gatewayPaired = false;
 
 // ============================================
 // PIN DEFINITIONS
@@ -39,16 +57,20 @@ DallasTemperature soilTempSensor(&oneWire);
 // ============================================
 // DATA STRUCTURE FOR ESP-NOW
 // ============================================
-typedef struct struct_soil_message {
-  char nodeId[20];
+// Wire format lives in common/include/data_structures.h (SoilNodeData)
+SoilNodeData soilPacket;
+RTC_DATA_ATTR uint16_t packetSequence = 0;  // Kept across deep sleep
+esp_now_peer_info_t peerInfo;
+
+// Latest readings in engineering units
+struct SoilReadings {
   float soilMoisture;      // Percentage (0-100%)
   float soilPH;            // pH value (0-14)
   float soilTemp;          // Temperature in Celsius
-  unsigned long timestamp; // Milliseconds since boot
-} struct_soil_message;
+  unsigned long timestamp; // Uptime ms, or RTC ms when duty-cycled
+};
 
-struct_soil_message soilData;
-esp_now_peer_info_t peerInfo;
+SoilReadings soilData;
 
 // ============================================
 // SENSOR CALIBRATION VALUES
@@ -62,8 +84,59 @@ const float PH_MAX = 9.0;        // Maximum pH value
 // ============================================
 // TIMING CONFIGURATION
 // ============================================
-const unsigned long SEND_INTERVAL = 5000;  // Send data every 5 seconds
-unsigned long lastSendTime = 0;
+const unsigned long SAMPLE_INTERVAL = 5000;  // Sample every 5 seconds
+unsigned long lastSampleTime = 0;
+
+// Send-on-change: a reading is sent when a channel moves past its
+// deadband, or as a heartbeat after the max silence without one
+const ReportChannel REPORT_CHANNELS[] = {
+  { "moisture", 1.0, false },      // %
+  { "pH", 0.1, false },
+  { "temperature", 0.25, false },  // °C
+};
+
+// Duty cycling: wake every SLEEP_DURATION_MS, batch the reading in RTC
+// memory and send every BATCH_SIZE wakes or on a threshold crossing.
+// false keeps the radio on and samples every SAMPLE_INTERVAL.
+const bool SLEEP_ENABLED = false;
+const unsigned long SLEEP_DURATION_MS = 300000;  // Wake every 5 minutes
+#define BATCH_SIZE 6                             // Readings per radio session
+const unsigned long SEND_ACK_TIMEOUT_MS = 50;    // Wait for each send callback
+const unsigned long PAIR_WAIT_MS = 100;          // Listen for a pairing reply
+const float BATTERY_CAPACITY_MAH = 2000.0;       // For the battery-life estimate
+
+// Duty-cycled, heartbeats wait in the batch like other readings: the radio
+// comes up at least every SESSION_MAX_SILENCE_MS (one batch of wakes, 30
+// min), and the heartbeat is due as often, not every REPORT_MAX_SILENCE_MS
+const uint32_t SESSION_MAX_SILENCE_MS = batchMaxSilence_ms(SLEEP_DURATION_MS, BATCH_SIZE, REPORT_MAX_SILENCE_MS);
+RTC_DATA_ATTR ReportFilterState reportState;
+ReportFilter reportFilter(&reportState, REPORT_CHANNELS, 3,
+                          SLEEP_ENABLED ? SESSION_MAX_SILENCE_MS : REPORT_MAX_SILENCE_MS);
+
+// ============================================
+// DEEP-SLEEP STATE (RTC memory)
+// ============================================
+RTC_DATA_ATTR ReadingBatch<SoilNodeData, BATCH_SIZE> pendingPackets;
+RTC_DATA_ATTR EnergyLedger energyLedger;
+RTC_DATA_ATTR uint32_t lastSessionMs = 0;  // RTC ms of the last radio session
+RTC_DATA_ATTR uint32_t sleepStartMs = 0;  // RTC ms when the last sleep began
+RTC_DATA_ATTR int8_t moistureBand = 0;   // Alert band of the last reading
+RTC_DATA_ATTR int8_t phBand = 0;
+RTC_DATA_ATTR int8_t tempBand = 0;
+
+// Delivery: unicast packets wait in a retry queue until ESP-NOW reports
+// the ACK; after MAX_RETRY retries a packet is dropped, and after
+// PAIR_LOST_AFTER dropped packets in a row the node pairs again
+#define MAX_RETRY 3
+#define PAIR_LOST_AFTER 3
+RetryQueue retryQueue(MAX_RETRY, RETRY_BASE_DELAY_MS, RETRY_MAX_DELAY_MS, esp_random());
+RTC_DATA_ATTR uint8_t expiredInRow = 0;
+unsigned long sendStartTime = 0;
+
+volatile bool sendDone = false;
+volatile bool sendDelivered = false;
+volatile bool pairReceived = false;
+uint8_t pairAddress[6];
 
 // ============================================
 // ESP-NOW CALLBACKS
@@ -71,6 +144,25 @@ unsigned long lastSendTime = 0;
 void OnDataSent(const uint8_t *mac_addr, esp_now_send_status_t status) {
   Serial.print("\r\n[ESP-NOW] Last Packet Send Status: ");
   Serial.println(status == ESP_NOW_SEND_SUCCESS ? "✓ Success" : "✗ Failed");
+  sendDelivered = status == ESP_NOW_SEND_SUCCESS;
+  sendDone = true;
+}
+
+// Only a Gateway's pairing reply is expected
+void OnDataRecv(const uint8_t *mac, const uint8_t *incomingData, int len) {
+  if (protocolValidate(incomingData, len) != PACKET_OK ||
+      ((const PacketHeader *)incomingData)->packetType != PACKET_PAIR) {
+    return;
+  }
+  memcpy(pairAddress, mac, sizeof(pairAddress));
+  pairReceived = true;
+}
+
+// Milliseconds on the RTC clock, which keeps running through deep sleep
+uint32_t rtcMillis() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (uint32_t)(now.tv_sec * 1000ULL + now.tv_usec / 1000);
 }
 
 // ============================================
@@ -115,51 +207,323 @@ float readSoilTemp() {
 }
 
 // ============================================
-// SETUP
+// SAMPLING AND TRANSMISSION
 // ============================================
-void setup() {
-  Serial.begin(115200);
-  delay(1000);
+
+// Read all sensors and report them
+void sampleSoil(uint32_t timestamp) {
+  soilData.soilMoisture = readSoilMoisture();
+  soilData.soilPH = readSoilPH();
+  soilData.soilTemp = readSoilTemp();
+  soilData.timestamp = timestamp;
   
-  Serial.println("\r\n\r\n╔════════════════════════════════════════╗");
-  Serial.println("║   ESP32 SOIL NODE - Initializing...   ║");
-  Serial.println("╚════════════════════════════════════════╝\r\n");
+  // Print data to Serial Monitor
+  Serial.println("\r\n┌──────────────────────────────────────┐");
+  Serial.println("│       SOIL NODE - Sensor Data       │");
+  Serial.println("├──────────────────────────────────────┤");
+  Serial.printf("│ Soil Moisture:    %6.2f %%         │\r\n", soilData.soilMoisture);
+  Serial.printf("│ Soil pH:          %6.2f            │\r\n", soilData.soilPH);
+  Serial.printf("│ Soil Temperature: %6.2f °C         │\r\n", soilData.soilTemp);
+  Serial.printf("│ Timestamp:        %lu ms          │\r\n", soilData.timestamp);
+  Serial.println("└──────────────────────────────────────┘");
   
-  // Set device as a Wi-Fi Station
-  WiFi.mode(WIFI_STA);
+  // Interpret soil conditions
+  Serial.println("\r\n[Analysis]");
   
-  // Print MAC Address
-  Serial.print("[WiFi] This Device MAC Address: ");
-  Serial.println(WiFi.macAddress());
+  // Moisture analysis
+  if (soilData.soilMoisture < 20) {
+    Serial.println("  ⚠ Soil is DRY - Irrigation recommended");
+  } else if (soilData.soilMoisture > 80) {
+    Serial.println("  ⚠ Soil is TOO WET - Check drainage");
+  } else {
+    Serial.println("  ✓ Soil moisture is optimal");
+  }
+  
+  // pH analysis
+  if (soilData.soilPH < 6.0) {
+    Serial.println("  ⚠ Soil is ACIDIC - Consider adding lime");
+  } else if (soilData.soilPH > 7.5) {
+    Serial.println("  ⚠ Soil is ALKALINE - Consider adding sulfur");
+  } else {
+    Serial.println("  ✓ Soil pH is optimal for most crops");
+  }
+  
+  // Temperature analysis
+  if (soilData.soilTemp < 10) {
+    Serial.println("  ⚠ Soil is COLD - Plant growth may be slow");
+  } else if (soilData.soilTemp > 30) {
+    Serial.println("  ⚠ Soil is HOT - Monitor moisture closely");
+  } else {
+    Serial.println("  ✓ Soil temperature is optimal");
+  }
+  
+}
+
+// Run the reading through the send-on-change filter and, unless it is
+// suppressed, encode and seal soilPacket. `force` sends it regardless.
+ReportDecision filterSoilReading(uint32_t now, bool force) {
+  float values[] = { soilData.soilMoisture, soilData.soilPH, soilData.soilTemp };
+  ReportDecision decision = reportFilter.evaluate(values, now, force);
+  
+  if (decision != REPORT_SUPPRESS) {
+    // Encode fixed-point packet and seal header
+    soilPacket.soilMoisture = toFixedU16(soilData.soilMoisture, FIXED_CENTI);
+    soilPacket.soilTemp = toFixedS16(soilData.soilTemp, FIXED_CENTI);
+    soilPacket.soilPH = toFixedU16(soilData.soilPH, FIXED_CENTI);
+    soilPacket.header.skipped = reportFilter.getSkipped();
+    soilPacket.header.flags = (decision == REPORT_HEARTBEAT ? PACKET_FLAG_HEARTBEAT : 0) |
+                              (gatewayPaired ? 0 : PACKET_FLAG_PAIRING);
+    protocolSeal(&soilPacket.header, sizeof(soilPacket), NODE_ID_SOIL,
+                 PACKET_SOIL_DATA, packetSequence++, soilData.timestamp);
+  }
+  
+  Serial.printf("[Report] %s%s%s | %lu of %lu readings suppressed (%.1f%%)\r\n",
+                reportDecisionName(decision),
+                decision == REPORT_CHANGE ? ": " : "",
+                decision == REPORT_CHANGE ? reportFilter.getTriggerName() : "",
+                (unsigned long)(reportFilter.getSamples() - reportFilter.getSent()),
+                (unsigned long)reportFilter.getSamples(),
+                reportFilter.getSuppressionRatio() * 100.0f);
+  return decision;
+}
+
+// Bring up WiFi in station mode, ESP-NOW and the Gateway peer
+bool startEspNow() {
+  WiFi.mode(WIFI_STA);
   
-  // Initialize ESP-NOW
   if (esp_now_init() != ESP_OK) {
     Serial.println("[ERROR] ESP-NOW initialization failed!");
-    return;
+    return false;
   }
-  Serial.println("[ESP-NOW] ✓ Initialized successfully");
-  
-  // Register send callback
   esp_now_register_send_cb(OnDataSent);
+  esp_now_register_recv_cb(OnDataRecv);
   
-  // Register Gateway peer
-  memcpy(peerInfo.peer_addr, gatewayAddress, 6);
+  // Broadcast peer for pairing, and the Gateway once known
   peerInfo.channel = 0;  
   peerInfo.encrypt = false;
-  
+  memcpy(peerInfo.peer_addr, BROADCAST_ADDRESS, 6);
   if (esp_now_add_peer(&peerInfo) != ESP_OK) {
+    Serial.println("[ERROR] Failed to add broadcast peer!");
+    return false;
+  }
+  if (gatewayPaired) {
+    memcpy(peerInfo.peer_addr, gatewayAddress, 6);
+    if (esp_now_add_peer(&peerInfo) != ESP_OK) {
+      Serial.println("[ERROR] Failed to add Gateway peer!");
+      return false;
+    }
+  }
+  return true;
+}
+
+// Switch to unicast once the Gateway has answered
+void applyPairing() {
+  if (!pairReceived) {
+    return;
+  }
+  pairReceived = false;
+  if (gatewayPaired && memcmp(gatewayAddress, pairAddress, 6) == 0) {
+    return;
+  }
+  
+  memcpy(peerInfo.peer_addr, pairAddress, 6);
+  if (!esp_now_is_peer_exist(pairAddress) && esp_now_add_peer(&peerInfo) != ESP_OK) {
     Serial.println("[ERROR] Failed to add Gateway peer!");
     return;
   }
-  Serial.println("[ESP-NOW] ✓ Gateway peer registered");
+  memcpy(gatewayAddress, pairAddress, 6);
+  gatewayPaired = true;
+  expiredInRow = 0;
+  Serial.printf("[ESP-NOW] ✓ Paired with Gateway %02X:%02X:%02X:%02X:%02X:%02X, sending unicast\r\n",
+                gatewayAddress[0], gatewayAddress[1], gatewayAddress[2],
+                gatewayAddress[3], gatewayAddress[4], gatewayAddress[5]);
+}
+
+// Count a packet given up on; too many in a row and the Gateway is
+// presumed gone (replaced, or moved channel), so pair again
+void countExpired() {
+  Serial.printf("[ESP-NOW] ✗ Packet dropped after %d retries\r\n", MAX_RETRY);
+  if (gatewayPaired && ++expiredInRow >= PAIR_LOST_AFTER) {
+    Serial.println("[ESP-NOW] ⚠ Gateway not answering, pairing again");
+    esp_now_del_peer(gatewayAddress);
+    memcpy(gatewayAddress, BROADCAST_ADDRESS, 6);
+    gatewayPaired = false;
+    expiredInRow = 0;
+  }
+}
+
+// Finish the transmission on the air, then start the next one that is due
+void serviceRetryQueue(unsigned long now) {
+  if (retryQueue.busy()) {
+    if (!sendDone && now - sendStartTime < SEND_ACK_TIMEOUT_MS) {
+      return;
+    }
+    uint32_t expired = retryQueue.getStats().expired;
+    bool delivered = sendDone && sendDelivered;
+    retryQueue.complete(delivered, now);
+    if (delivered) {
+      expiredInRow = 0;
+    } else if (retryQueue.getStats().expired != expired) {
+      countExpired();
+    }
+  }
+  
+  size_t length;
+  const uint8_t *packet = retryQueue.next(now, length);
+  if (packet == nullptr) {
+    return;
+  }
+  sendDone = false;
+  sendStartTime = now;
+  if (esp_now_send(gatewayAddress, (uint8_t *) packet, length) != ESP_OK) {
+    Serial.println("[ERROR] Failed to send data packet!");
+    sendDone = true;
+    sendDelivered = false;
+  }
+}
+
+// Send the batch oldest first, retrying each packet up to MAX_RETRY times
+// with backoff. Packets from the first one that fails for good on stay
+// batched for the next radio session.
+uint8_t sendPendingPackets() {
+  uint8_t delivered = 0;
+  
+  while (delivered < pendingPackets.count) {
+    bool acknowledged = false;
+    for (uint8_t attempt = 0; attempt <= MAX_RETRY && !acknowledged; attempt++) {
+      if (attempt > 0) {
+        delay(retryQueue.backoff(attempt));
+      }
+      sendDone = false;
+      esp_err_t result = esp_now_send(gatewayAddress, (uint8_t *) &pendingPackets.packets[delivered],
+                                      sizeof(SoilNodeData));
+      if (result != ESP_OK) {
+        Serial.println("[ERROR] Failed to send data packet!");
+        continue;
+      }
+      energyLedger.packets++;
+      
+      unsigned long start = millis();
+      while (!sendDone && millis() - start < SEND_ACK_TIMEOUT_MS) {
+        delay(1);
+      }
+      acknowledged = sendDone && sendDelivered;
+    }
+    if (!acknowledged) {
+      countExpired();
+      break;
+    }
+    expiredInRow = 0;
+    delivered++;
+  }
+  
+  // Unpaired: the Gateway answers the broadcast with its address
+  if (!gatewayPaired) {
+    unsigned long start = millis();
+    while (!pairReceived && millis() - start < PAIR_WAIT_MS) {
+      delay(1);
+    }
+    applyPairing();
+  }
+  
+  pendingPackets.consume(delivered);
+  return delivered;
+}
+
+// One wake of the duty cycle: sample, batch, send if due, deep sleep.
+// Never returns; the next wake starts over in setup().
+void runDutyCycle() {
+  if (!energyRestore(&energyLedger)) {
+    pendingPackets.clear();
+    lastSessionMs = rtcMillis();
+    Serial.println("[Sleep] Cold boot - energy ledger reset");
+  } else if (sleepStartMs != 0) {
+    // RTC time since going to sleep, less the time awake so far
+    uint32_t elapsed = rtcMillis() - sleepStartMs;
+    uint32_t awake = millis();
+    if (elapsed > awake) {
+      energyAccount(&energyLedger, POWER_SLEEP, (elapsed - awake) * 1000ULL);
+    }
+  }
+  energyLedger.wakes++;
+  
+  soilTempSensor.begin();
+  sampleSoil(rtcMillis());
+  
+  // Update every band, then decide
+  bool crossed = thresholdCrossed(&moistureBand, soilData.soilMoisture, 20, 80);
+  crossed |= thresholdCrossed(&phBand, soilData.soilPH, 6.0, 7.5);
+  crossed |= thresholdCrossed(&tempBand, soilData.soilTemp, 10, 30);
+  
+  // Unchanged readings are not batched
+  if (filterSoilReading(rtcMillis(), crossed) != REPORT_SUPPRESS && !pendingPackets.push(soilPacket)) {
+    Serial.println("[Sleep] Batch full - oldest reading dropped");
+  }
+  
+  uint64_t radioTime = 0;
+  if (batchSendDue(pendingPackets.count, BATCH_SIZE, crossed, rtcMillis() - lastSessionMs,
+                   SESSION_MAX_SILENCE_MS)) {
+    lastSessionMs = rtcMillis();
+    uint64_t radioStart = esp_timer_get_time();
+    uint8_t queued = pendingPackets.count;
+    Serial.printf("\r\n[ESP-NOW] Transmitting %u batched reading(s)%s...\r\n",
+                  queued, crossed ? " (threshold crossed)" : "");
+    uint8_t delivered = startEspNow() ? sendPendingPackets() : 0;
+    esp_now_deinit();
+    WiFi.mode(WIFI_OFF);
+    
+    radioTime = esp_timer_get_time() - radioStart;
+    energyAccount(&energyLedger, POWER_RADIO, radioTime);
+    energyLedger.transmissions++;
+    Serial.printf("[ESP-NOW] %u/%u delivered\r\n", delivered, queued);
+  } else {
+    Serial.printf("\r\n[Sleep] Batched %u/%u readings\r\n", pendingPackets.count, BATCH_SIZE);
+  }
+  
+  energyAccount(&energyLedger, POWER_ACTIVE, esp_timer_get_time() - radioTime);
+  
+  Serial.printf("[Energy] %lu wakes, %lu radio sessions | avg %.3f mA | ~%.0f days on %.0f mAh\r\n",
+                (unsigned long)energyLedger.wakes, (unsigned long)energyLedger.transmissions,
+                energyAverageCurrent_mA(&energyLedger, &POWER_PROFILE_WROOM32),
+                energyBatteryLife_days(&energyLedger, &POWER_PROFILE_WROOM32, BATTERY_CAPACITY_MAH),
+                BATTERY_CAPACITY_MAH);
+  Serial.flush();
+  
+  sleepStartMs = rtcMillis();
+  esp_sleep_enable_timer_wakeup(SLEEP_DURATION_MS * 1000ULL);
+  esp_deep_sleep_start();
+}
+
+// ============================================
+// SETUP
+// ============================================
+void setup() {
+  Serial.begin(115200);
+  
+  // Duty-cycled: skip the banner and never reach loop()
+  if (SLEEP_ENABLED) {
+    runDutyCycle();
+  }
+  delay(1000);
+  
+  Serial.println("\r\n\r\n╔════════════════════════════════════════╗");
+  Serial.println("║   ESP32 SOIL NODE - Initializing...   ║");
+  Serial.println("╚════════════════════════════════════════╝\r\n");
+  
+  // Set device as a Wi-Fi Station, initialize ESP-NOW and register the Gateway peer
+  if (!startEspNow()) {
+    return;
+  }
+  
+  // Print MAC Address
+  Serial.print("[WiFi] This Device MAC Address: ");
+  Serial.println(WiFi.macAddress());
+  Serial.println("[ESP-NOW] ✓ Initialized, Gateway peer registered");
   
   // Initialize sensors
   soilTempSensor.begin();
   Serial.println("[Sensors] ✓ DS18B20 initialized");
   
-  // Set node ID
-  strcpy(soilData.nodeId, "SOIL_NODE");
-  
   Serial.println("\r\n╔════════════════════════════════════════╗");
   Serial.println("║      SOIL NODE Ready - Monitoring     ║");
   Serial.println("╚════════════════════════════════════════╝\r\n");
@@ -171,63 +535,27 @@ void setup() {
 void loop() {
   unsigned long currentTime = millis();
   
-  if (currentTime - lastSendTime >= SEND_INTERVAL) {
-    lastSendTime = currentTime;
+  if (currentTime - lastSampleTime >= SAMPLE_INTERVAL) {
+    lastSampleTime = currentTime;
     
     // Read all sensor data
-    soilData.soilMoisture = readSoilMoisture();
-    soilData.soilPH = readSoilPH();
-    soilData.soilTemp = readSoilTemp();
-    soilData.timestamp = currentTime;
-    
-    // Print data to Serial Monitor
-    Serial.println("\r\n┌──────────────────────────────────────┐");
-    Serial.println("│       SOIL NODE - Sensor Data       │");
-    Serial.println("├──────────────────────────────────────┤");
-    Serial.printf("│ Soil Moisture:    %6.2f %%         │\r\n", soilData.soilMoisture);
-    Serial.printf("│ Soil pH:          %6.2f            │\r\n", soilData.soilPH);
-    Serial.printf("│ Soil Temperature: %6.2f °C         │\r\n", soilData.soilTemp);
-    Serial.printf("│ Timestamp:        %lu ms          │\r\n", soilData.timestamp);
-    Serial.println("└──────────────────────────────────────┘");
+    sampleSoil(currentTime);
     
-    // Interpret soil conditions
-    Serial.println("\r\n[Analysis]");
-    
-    // Moisture analysis
-    if (soilData.soilMoisture < 20) {
-      Serial.println("  ⚠ Soil is DRY - Irrigation recommended");
-    } else if (soilData.soilMoisture > 80) {
-      Serial.println("  ⚠ Soil is TOO WET - Check drainage");
-    } else {
-      Serial.println("  ✓ Soil moisture is optimal");
-    }
-    
-    // pH analysis
-    if (soilData.soilPH < 6.0) {
-      Serial.println("  ⚠ Soil is ACIDIC - Consider adding lime");
-    } else if (soilData.soilPH > 7.5) {
-      Serial.println("  ⚠ Soil is ALKALINE - Consider adding sulfur");
-    } else {
-      Serial.println("  ✓ Soil pH is optimal for most crops");
-    }
-    
-    // Temperature analysis
-    if (soilData.soilTemp < 10) {
-      Serial.println("  ⚠ Soil is COLD - Plant growth may be slow");
-    } else if (soilData.soilTemp > 30) {
-      Serial.println("  ⚠ Soil is HOT - Monitor moisture closely");
-    } else {
-      Serial.println("  ✓ Soil temperature is optimal");
-    }
-    
-    // Send message via ESP-NOW to Gateway
-    Serial.println("\r\n[ESP-NOW] Transmitting to Gateway...");
-    esp_err_t result = esp_now_send(gatewayAddress, (uint8_t *) &soilData, sizeof(soilData));
-    
-    if (result != ESP_OK) {
-      Serial.println("[ERROR] Failed to send data packet!");
+    // Queue it for the Gateway, unless nothing changed; a reading still
+    // waiting for a retry is replaced by this one
+    if (filterSoilReading(currentTime, false) != REPORT_SUPPRESS) {
+      uint32_t superseded = retryQueue.getStats().superseded;
+      if (retryQueue.push((const uint8_t *) &soilPacket, sizeof(soilPacket), currentTime)) {
+        packetSequence--;  // It took the replaced packet's number
+      }
+      Serial.printf("\r\n[ESP-NOW] Queued for Gateway (%s)%s\r\n",
+                    gatewayPaired ? "unicast" : "broadcast, pairing",
+                    retryQueue.getStats().superseded != superseded ? ", replaces an undelivered reading" : "");
     }
   }
   
-  delay(100); // Small delay to prevent watchdog issues
+  applyPairing();
+  serviceRetryQueue(currentTime);
+  
+  delay(10); // Small delay to prevent watchdog issues
 }
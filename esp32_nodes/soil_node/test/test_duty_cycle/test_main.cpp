@@ -0,0 +1,128 @@
+/*
+ * Duty cycle: energy ledger, reading batch and send policy
+ *
+ * - the ledger's charge, average current and battery life against hand
+ *   computed figures
+ * - a full batch drops its oldest packet, consume() keeps the newest
+ * - threshold bands and crossings
+ * - batched readings go out when the batch is full, a threshold was
+ *   crossed or the session silence reached batchMaxSilence_ms(), never
+ *   from an empty batch
+ *
+ * Run: pio test -e native
+ */
+
+#ifndef ARDUINO
+
+#include <unity.h>
+#include "duty_cycle.h"
+
+#define TEST_SLEEP_MS 300000UL
+#define TEST_BATCH 4
+#define TEST_MIN_SILENCE_MS 600000UL
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_energy_ledger() {
+    EnergyLedger ledger;
+    ledger.magic = 0;
+    TEST_ASSERT_FALSE(energyRestore(&ledger));
+    TEST_ASSERT_TRUE(energyRestore(&ledger));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, energyAverageCurrent_mA(&ledger, &POWER_PROFILE_WROOM32));
+
+    // One hour: 59 min asleep, 50 s active, 10 s with the radio up
+    energyAccount(&ledger, POWER_SLEEP, 3540000000ULL);
+    energyAccount(&ledger, POWER_ACTIVE, 50000000ULL);
+    energyAccount(&ledger, POWER_RADIO, 10000000ULL);
+    TEST_ASSERT_TRUE(energyTotalTime_us(&ledger) == 3600000000ULL);
+
+    float charge = 0.01f * 3540.0f / 3600.0f + 50.0f * 50.0f / 3600.0f + 120.0f * 10.0f / 3600.0f;
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, charge, energyCharge_mAh(&ledger, &POWER_PROFILE_WROOM32));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, charge, energyAverageCurrent_mA(&ledger, &POWER_PROFILE_WROOM32));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2000.0f / charge / 24.0f,
+                             energyBatteryLife_days(&ledger, &POWER_PROFILE_WROOM32, 2000.0f));
+}
+
+void test_batch_drops_oldest() {
+    ReadingBatch<uint32_t, 3> batch = {};
+    TEST_ASSERT_TRUE(batch.push(1));
+    TEST_ASSERT_TRUE(batch.push(2));
+    TEST_ASSERT_TRUE(batch.push(3));
+    TEST_ASSERT_TRUE(batch.full());
+    TEST_ASSERT_FALSE(batch.push(4));
+    TEST_ASSERT_EQUAL_UINT8(3, batch.count);
+    TEST_ASSERT_EQUAL_UINT32(2, batch.packets[0]);
+    TEST_ASSERT_EQUAL_UINT32(4, batch.packets[2]);
+
+    // Two delivered, the newest waits for the next session
+    batch.consume(2);
+    TEST_ASSERT_EQUAL_UINT8(1, batch.count);
+    TEST_ASSERT_EQUAL_UINT32(4, batch.packets[0]);
+    batch.consume(5);
+    TEST_ASSERT_EQUAL_UINT8(0, batch.count);
+}
+
+void test_threshold_crossing() {
+    int8_t band = 0;
+    TEST_ASSERT_FALSE(thresholdCrossed(&band, 50.0f, 30.0f, 80.0f));
+    TEST_ASSERT_TRUE(thresholdCrossed(&band, 29.0f, 30.0f, 80.0f));
+    TEST_ASSERT_EQUAL_INT(-1, band);
+    TEST_ASSERT_FALSE(thresholdCrossed(&band, 20.0f, 30.0f, 80.0f));
+    TEST_ASSERT_TRUE(thresholdCrossed(&band, 81.0f, 30.0f, 80.0f));
+    TEST_ASSERT_EQUAL_INT(1, band);
+}
+
+void test_batch_send_policy() {
+    // Four 5-minute wakes exceed the 10-minute minimum
+    const uint32_t maxSilence = batchMaxSilence_ms(TEST_SLEEP_MS, TEST_BATCH, TEST_MIN_SILENCE_MS);
+    TEST_ASSERT_EQUAL_UINT32(TEST_SLEEP_MS * TEST_BATCH, maxSilence);
+    TEST_ASSERT_EQUAL_UINT32(TEST_MIN_SILENCE_MS, batchMaxSilence_ms(60000, TEST_BATCH, TEST_MIN_SILENCE_MS));
+
+    TEST_ASSERT_FALSE(batchSendDue(0, TEST_BATCH, true, maxSilence, maxSilence));
+    TEST_ASSERT_FALSE(batchSendDue(1, TEST_BATCH, false, maxSilence - 1, maxSilence));
+    TEST_ASSERT_TRUE(batchSendDue(TEST_BATCH, TEST_BATCH, false, 0, maxSilence));
+    TEST_ASSERT_TRUE(batchSendDue(1, TEST_BATCH, true, 0, maxSilence));
+    TEST_ASSERT_TRUE(batchSendDue(1, TEST_BATCH, false, maxSilence, maxSilence));
+}
+
+void test_stable_night_one_session_per_batch() {
+    // Only heartbeats, each due after maxSilence: the wake that queues one
+    // is also the one the session is due on, so a night of heartbeats
+    // costs one radio session each
+    const uint32_t maxSilence = batchMaxSilence_ms(TEST_SLEEP_MS, TEST_BATCH, TEST_MIN_SILENCE_MS);
+    uint8_t count = 0;
+    uint32_t lastHeartbeat = 0;
+    uint32_t lastSession = 0;
+    int sessions = 0;
+    int heartbeats = 0;
+    for (uint32_t now = TEST_SLEEP_MS; now <= 12 * 3600000UL; now += TEST_SLEEP_MS) {
+        if (now - lastHeartbeat >= maxSilence) {
+            lastHeartbeat = now;
+            count++;
+            heartbeats++;
+        }
+        if (batchSendDue(count, TEST_BATCH, false, now - lastSession, maxSilence)) {
+            lastSession = now;
+            count = 0;
+            sessions++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(12 * 3600000UL / maxSilence, heartbeats);
+    TEST_ASSERT_EQUAL_INT(heartbeats, sessions);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_energy_ledger);
+    RUN_TEST(test_batch_drops_oldest);
+    RUN_TEST(test_threshold_crossing);
+    RUN_TEST(test_batch_send_policy);
+    RUN_TEST(test_stable_night_one_session_per_batch);
+    return UNITY_END();
+}
+
+#endif // ARDUINO
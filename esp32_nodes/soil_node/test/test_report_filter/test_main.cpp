@@ -0,0 +1,111 @@
+/*
+ * Send-on-change filter: deadbands and heartbeat
+ *
+ * Evaluates scripted readings of a two-channel filter (moisture and a
+ * circular direction channel) on a scripted clock:
+ * - the first reading always goes out
+ * - readings inside every deadband are suppressed and counted into the
+ *   next packet's `skipped`
+ * - a channel past its deadband sends and is named as the trigger
+ * - circular channels compare across north
+ * - a heartbeat goes out once max silence is reached and not before
+ * - a forced reading goes out, a NaN reading counts as a change
+ *
+ * Run: pio test -e native
+ */
+
+#ifndef ARDUINO
+
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "report_filter.h"
+
+#define TEST_MAX_SILENCE_MS 60000
+
+static const ReportChannel CHANNELS[] = {
+    { "moisture", 1.0f, false },
+    { "direction", 10.0f, true },
+};
+
+static ReportFilterState state;
+static ReportFilter* filter;
+
+static ReportDecision evaluate(float moisture, float direction, uint32_t now_ms, bool force = false) {
+    float values[] = { moisture, direction };
+    return filter->evaluate(values, now_ms, force);
+}
+
+void setUp() {
+    memset(&state, 0, sizeof(state));
+    filter = new ReportFilter(&state, CHANNELS, 2, TEST_MAX_SILENCE_MS);
+}
+
+void tearDown() {
+    delete filter;
+}
+
+void test_first_reading_sent() {
+    TEST_ASSERT_EQUAL(REPORT_FIRST, evaluate(50.0f, 90.0f, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, filter->getSent());
+    TEST_ASSERT_EQUAL_UINT16(0, filter->getSkipped());
+}
+
+void test_deadband_suppresses_until_change() {
+    evaluate(50.0f, 90.0f, 0);
+    TEST_ASSERT_EQUAL(REPORT_SUPPRESS, evaluate(50.5f, 95.0f, 1000));
+    TEST_ASSERT_EQUAL(REPORT_SUPPRESS, evaluate(49.0f, 80.0f, 2000));
+    TEST_ASSERT_EQUAL(REPORT_SUPPRESS, evaluate(50.9f, 100.0f, 3000));
+
+    TEST_ASSERT_EQUAL(REPORT_CHANGE, evaluate(51.5f, 90.0f, 4000));
+    TEST_ASSERT_EQUAL_STRING("moisture", filter->getTriggerName());
+    TEST_ASSERT_EQUAL_UINT16(3, filter->getSkipped());
+
+    // The sent reading is the new reference
+    TEST_ASSERT_EQUAL(REPORT_SUPPRESS, evaluate(52.0f, 90.0f, 5000));
+    TEST_ASSERT_EQUAL_UINT32(6, filter->getSamples());
+    TEST_ASSERT_EQUAL_UINT32(2, filter->getSent());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4.0f / 6.0f, filter->getSuppressionRatio());
+}
+
+void test_circular_channel_across_north() {
+    evaluate(50.0f, 355.0f, 0);
+    TEST_ASSERT_EQUAL(REPORT_SUPPRESS, evaluate(50.0f, 3.0f, 1000));
+    TEST_ASSERT_EQUAL(REPORT_CHANGE, evaluate(50.0f, 10.0f, 2000));
+    TEST_ASSERT_EQUAL_STRING("direction", filter->getTriggerName());
+}
+
+void test_heartbeat_after_max_silence() {
+    evaluate(50.0f, 90.0f, 0);
+    for (uint32_t now = 10000; now < TEST_MAX_SILENCE_MS; now += 10000) {
+        TEST_ASSERT_EQUAL(REPORT_SUPPRESS, evaluate(50.0f, 90.0f, now));
+    }
+    TEST_ASSERT_EQUAL(REPORT_SUPPRESS, evaluate(50.0f, 90.0f, TEST_MAX_SILENCE_MS - 1));
+    TEST_ASSERT_EQUAL(REPORT_HEARTBEAT, evaluate(50.0f, 90.0f, TEST_MAX_SILENCE_MS));
+    TEST_ASSERT_EQUAL_UINT32(1, filter->getHeartbeats());
+    TEST_ASSERT_EQUAL_UINT16(6, filter->getSkipped());
+
+    // The silence restarts at the heartbeat
+    TEST_ASSERT_EQUAL(REPORT_SUPPRESS, evaluate(50.0f, 90.0f, 2 * TEST_MAX_SILENCE_MS - 1));
+    TEST_ASSERT_EQUAL(REPORT_HEARTBEAT, evaluate(50.0f, 90.0f, 2 * TEST_MAX_SILENCE_MS));
+}
+
+void test_forced_and_nan_readings_sent() {
+    evaluate(50.0f, 90.0f, 0);
+    TEST_ASSERT_EQUAL(REPORT_FORCED, evaluate(50.0f, 90.0f, 1000, true));
+    TEST_ASSERT_EQUAL(REPORT_CHANGE, evaluate(NAN, 90.0f, 2000));
+    TEST_ASSERT_EQUAL(REPORT_CHANGE, evaluate(50.0f, 90.0f, 3000));
+    TEST_ASSERT_EQUAL_UINT32(0, filter->getHeartbeats());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_reading_sent);
+    RUN_TEST(test_deadband_suppresses_until_change);
+    RUN_TEST(test_circular_channel_across_north);
+    RUN_TEST(test_heartbeat_after_max_silence);
+    RUN_TEST(test_forced_and_nan_readings_sent);
+    return UNITY_END();
+}
+
+#endif // ARDUINO
@@ -0,0 +1,145 @@
+/*
+ * Retry queue: superseding, backoff and expiry
+ *
+ * Feeds sealed soil packets through a RetryQueue on a scripted clock:
+ * - a newer reading superseding a packet that never went out takes the
+ *   old sequence number and adds the old readings to `skipped`
+ * - one superseding a packet that went out keeps its own number and the
+ *   old retry schedule
+ * - the packet on the air is never superseded
+ * - backoff stays within [d/2, d] of the doubled, capped delay
+ * - a packet is given up after maxRetry retries
+ *
+ * Run: pio test -e native
+ */
+
+#ifndef ARDUINO
+
+#include <unity.h>
+#include <string.h>
+#include "retry_queue.h"
+
+static SoilNodeData soilPacket(uint16_t sequence, uint16_t skipped, uint16_t moisture) {
+    SoilNodeData packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.soilMoisture = moisture;
+    packet.header.skipped = skipped;
+    protocolSeal(&packet.header, sizeof(packet), NODE_ID_SOIL, PACKET_SOIL_DATA, sequence, 1000);
+    return packet;
+}
+
+static void push(RetryQueue& queue, const SoilNodeData& packet, uint32_t now_ms, bool reused) {
+    TEST_ASSERT_EQUAL(reused, queue.push((const uint8_t*)&packet, sizeof(packet), now_ms));
+}
+
+// Next packet handed out, as a soil packet that still validates
+static void transmit(RetryQueue& queue, uint32_t now_ms, SoilNodeData& packet) {
+    size_t length = 0;
+    const uint8_t* data = queue.next(now_ms, length);
+    TEST_ASSERT_TRUE(data != nullptr);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(SoilNodeData), length);
+    TEST_ASSERT_EQUAL_HEX8(PACKET_OK, protocolValidate(data, (int)length));
+    memcpy(&packet, data, sizeof(packet));
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_supersede_unsent_reuses_sequence() {
+    RetryQueue queue(3);
+    push(queue, soilPacket(7, 2, 100), 0, false);
+    push(queue, soilPacket(8, 1, 200), 10, true);
+    TEST_ASSERT_EQUAL_UINT8(1, queue.size());
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getStats().superseded);
+
+    // The gateway sees no gap: sequence 7 carries both suppressed runs
+    // and the superseded reading itself
+    SoilNodeData sent;
+    transmit(queue, 10, sent);
+    TEST_ASSERT_EQUAL_UINT16(7, sent.header.sequence);
+    TEST_ASSERT_EQUAL_UINT16(2 + 1 + 1, sent.header.skipped);
+    TEST_ASSERT_EQUAL_UINT16(200, sent.soilMoisture);
+}
+
+void test_supersede_sent_keeps_sequence() {
+    RetryQueue queue(3, 200, 5000, 42);
+    push(queue, soilPacket(7, 0, 100), 0, false);
+    SoilNodeData sent;
+    transmit(queue, 0, sent);
+    queue.complete(false, 0);
+
+    // The failed packet waits for its backoff; the newer reading takes
+    // its place and schedule but not its number
+    push(queue, soilPacket(8, 0, 200), 10, false);
+    TEST_ASSERT_EQUAL_UINT8(1, queue.size());
+    size_t length;
+    TEST_ASSERT_TRUE(queue.next(10, length) == nullptr);
+
+    transmit(queue, RETRY_BASE_DELAY_MS, sent);
+    TEST_ASSERT_EQUAL_UINT16(8, sent.header.sequence);
+    TEST_ASSERT_EQUAL_UINT16(0, sent.header.skipped);
+    TEST_ASSERT_EQUAL_UINT16(200, sent.soilMoisture);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getStats().retries);
+}
+
+void test_in_flight_not_superseded() {
+    RetryQueue queue(3);
+    push(queue, soilPacket(7, 0, 100), 0, false);
+    SoilNodeData sent;
+    transmit(queue, 0, sent);
+    TEST_ASSERT_TRUE(queue.busy());
+
+    push(queue, soilPacket(8, 0, 200), 5, false);
+    TEST_ASSERT_EQUAL_UINT8(2, queue.size());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.getStats().superseded);
+
+    queue.complete(true, 5);
+    transmit(queue, 5, sent);
+    TEST_ASSERT_EQUAL_UINT16(8, sent.header.sequence);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getStats().delivered);
+}
+
+void test_backoff_bounds() {
+    RetryQueue queue(8, 200, 5000, 1234);
+    for (int round = 0; round < 100; round++) {
+        for (uint8_t attempt = 1; attempt <= 8; attempt++) {
+            uint32_t delay = 200UL << (attempt - 1);
+            if (delay > 5000) delay = 5000;
+            uint32_t backoff = queue.backoff(attempt);
+            TEST_ASSERT_GREATER_OR_EQUAL(delay / 2, backoff);
+            TEST_ASSERT_LESS_OR_EQUAL(delay, backoff);
+        }
+    }
+}
+
+void test_expires_after_max_retry() {
+    RetryQueue queue(2);
+    push(queue, soilPacket(1, 0, 100), 0, false);
+
+    uint32_t now = 0;
+    SoilNodeData sent;
+    for (int attempt = 0; attempt < 3; attempt++) {
+        transmit(queue, now, sent);
+        queue.complete(false, now);
+        now += RETRY_MAX_DELAY_MS;
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, queue.size());
+    TEST_ASSERT_EQUAL_UINT32(3, queue.getStats().attempts);
+    TEST_ASSERT_EQUAL_UINT32(2, queue.getStats().retries);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getStats().expired);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_supersede_unsent_reuses_sequence);
+    RUN_TEST(test_supersede_sent_keeps_sequence);
+    RUN_TEST(test_in_flight_not_superseded);
+    RUN_TEST(test_backoff_bounds);
+    RUN_TEST(test_expires_after_max_retry);
+    return UNITY_END();
+}
+
+#endif // ARDUINO
@@ -9,18 +9,40 @@
  * - Environmental Monitoring (Air Temp/Humidity)
  * - Rainfall Monitoring
  * 
- * Communication: ESP-NOW (Send to Gateway)
+ * Communication: ESP-NOW (Send to Gateway), send-on-change: a reading
+ * goes out only when a channel leaves its deadband, or as a heartbeat.
+ * Broadcasts until the Gateway answers, then unicasts with ACK and
+ * retries with exponential backoff.
+ *
+ * Power: always-on, or duty-cycled with deep sleep (SLEEP_ENABLED).
+ * Readings are batched in RTC memory and sent when the batch is full or
+ * a reading crosses an alert threshold; rain tips wake the node briefly
+ * so none are lost while it sleeps.
  */
 
 #include <Arduino.h>
 #include <esp_now.h>
 #include <WiFi.h>
 #include <DHT.h>
+#include <sys/time.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/rtc_io.h>
+#include "protocol.h"
+#include "wind_vector.h"
+#include "rain_gauge.h"
+#include "duty_cycle.h"
+#include "report_filter.h"
+#include "retry_queue.h"
 
 // ============================================
-// CONFIGURATION - REPLACE WITH YOUR GATEWAY MAC ADDRESS
+// CONFIGURATION - GATEWAY MAC ADDRESS
 // ============================================
-uint8_t gatewayAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+// Learned by pairing (see the Soil Node); to skip it, enter the Gateway
+// MAC and set gatewayPaired to true
+const uint8_t BROADCAST_ADDRESS[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+RTC_DATA_ATTR uint8_t gatewayAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+RTC_DATA_ATTR bool gatewayPaired = false;
 
 // ============================================
 // PIN DEFINITIONS
@@ -31,7 +53,7 @@ uint8_t gatewayAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 #define LDR_PIN 33            // Analog pin for light sensor
 #define WIND_SPEED_PIN 36     // Analog pin for wind speed sensor
 #define WIND_DIR_PIN 39       // Analog pin for wind direction sensor
-#define RAINFALL_PIN 39       // Analog pin for rainfall sensor
+#define RAINFALL_PIN 27       // Tipping bucket reed switch (to GND)
 
 // ============================================
 // SENSOR SETUP
@@ -42,27 +64,126 @@ DHT dht(DHT_PIN, DHTTYPE);
 // ============================================
 // DATA STRUCTURE FOR ESP-NOW
 // ============================================
-typedef struct struct_weather_message {
-  char nodeId[20];
+// Wire format lives in common/include/data_structures.h (WeatherNodeData)
+WeatherNodeData weatherPacket;
+RTC_DATA_ATTR uint16_t packetSequence = 0;  // Kept across deep sleep
+esp_now_peer_info_t peerInfo;
+
+// Latest readings in engineering units
+struct WeatherReadings {
   float leafWetness;      // Percentage (0-100%)
   float leafTemp;         // Temperature in Celsius
   float airTemp;          // Air temperature in Celsius
   float humidity;         // Relative humidity (0-100%)
   float lightIntensity;   // Light intensity (0-1000 lux approx)
   float windSpeed;        // Wind speed (m/s)
-  float windDirection;    // Wind direction (0-360 degrees)
-  float rainfall;         // Rainfall (mm)
-  unsigned long timestamp;
-} struct_weather_message;
+  float windDirection;    // Wind direction, 2-minute vector mean (0-360 degrees)
+  float windDirStdDev;    // Directional standard deviation over 2 minutes
+  float windDirection10;  // 10-minute vector mean
+  float rainfall;         // Rainfall, rolling 24 h (mm)
+  float rainfall1h;       // Rainfall, rolling 1 h (mm)
+  float rainEvent;        // Rainfall of the current event (mm)
+  float rainRate;         // Intensity (mm/h)
+  unsigned long timestamp; // Uptime ms, or RTC ms when duty-cycled
+};
 
-struct_weather_message weatherData;
-esp_now_peer_info_t peerInfo;
+WeatherReadings weatherData;
 
 // ============================================
 // TIMING CONFIGURATION
 // ============================================
-const unsigned long SEND_INTERVAL = 5000;  // Send data every 5 seconds
-unsigned long lastSendTime = 0;
+const unsigned long SAMPLE_INTERVAL = 5000;  // Sample every 5 seconds
+unsigned long lastSampleTime = 0;
+
+// Send-on-change: a reading is sent when a channel moves past its
+// deadband, or as a heartbeat after the max silence without one
+const ReportChannel REPORT_CHANNELS[] = {
+  { "airTemp", 0.3, false },       // °C
+  { "humidity", 2.0, false },      // %
+  { "light", 50.0, false },        // lux
+  { "rainfall", 0.2, false },      // mm, below one bucket tip
+  { "windSpeed", 1.0, false },     // m/s
+  { "windDirection", 20.0, true }, // degrees
+  { "leafTemp", 0.5, false },      // °C
+  { "leafWetness", 3.0, false },   // %
+};
+
+// Wind vane sampled at 1 Hz into rolling vector windows
+const unsigned long WIND_DIR_SAMPLE_INTERVAL = 1000;
+const uint16_t WIND_DIR_SHORT_WINDOW = 120;   // 2 minutes
+const uint16_t WIND_DIR_LONG_WINDOW = 600;    // 10 minutes
+const float WIND_DIR_VARIABLE_STDDEV = 30.0;  // Degrees, drift path unpredictable above
+unsigned long lastWindDirSample = 0;
+WindVectorAverage windDirAverage;
+int windDirShort = -1;
+int windDirLong = -1;
+
+// Duty cycling: wake every SLEEP_DURATION_MS, batch the reading in RTC
+// memory and send every BATCH_SIZE wakes or on a threshold crossing.
+// false keeps the radio on and samples every SAMPLE_INTERVAL.
+const bool SLEEP_ENABLED = false;
+const unsigned long SLEEP_DURATION_MS = 300000;  // Wake every 5 minutes
+#define BATCH_SIZE 6                             // Readings per radio session
+const unsigned long SEND_ACK_TIMEOUT_MS = 50;    // Wait for each send callback
+const unsigned long PAIR_WAIT_MS = 100;          // Listen for a pairing reply
+const float BATTERY_CAPACITY_MAH = 2000.0;       // For the battery-life estimate
+
+// Duty-cycled, heartbeats wait in the batch like other readings: the radio
+// comes up at least every SESSION_MAX_SILENCE_MS (one batch of wakes, 30
+// min), and the heartbeat is due as often, not every REPORT_MAX_SILENCE_MS
+const uint32_t SESSION_MAX_SILENCE_MS = batchMaxSilence_ms(SLEEP_DURATION_MS, BATCH_SIZE, REPORT_MAX_SILENCE_MS);
+RTC_DATA_ATTR ReportFilterState reportState;
+ReportFilter reportFilter(&reportState, REPORT_CHANNELS, 8,
+                          SLEEP_ENABLED ? SESSION_MAX_SILENCE_MS : REPORT_MAX_SILENCE_MS);
+
+// Vane averages cannot span a sleep; each wake takes a short burst instead
+const uint8_t WIND_DIR_BURST_SAMPLES = 10;
+const unsigned long WIND_DIR_BURST_INTERVAL = 50;
+const unsigned long RAIN_RELEASE_TIMEOUT_MS = 500;  // Wait for the reed switch to open
+
+// ============================================
+// DEEP-SLEEP STATE (RTC memory)
+// ============================================
+RTC_DATA_ATTR ReadingBatch<WeatherNodeData, BATCH_SIZE> pendingPackets;
+RTC_DATA_ATTR EnergyLedger energyLedger;
+RTC_DATA_ATTR uint32_t lastSessionMs = 0;   // RTC ms of the last radio session
+RTC_DATA_ATTR uint32_t sleepStartMs = 0;    // RTC ms when the last sleep began
+RTC_DATA_ATTR uint32_t nextSampleMs = 0;    // RTC ms of the next sampling wake
+RTC_DATA_ATTR int8_t airTempBand = 0;       // Alert band of the last reading
+RTC_DATA_ATTR int8_t windBand = 0;
+RTC_DATA_ATTR int8_t rainBand = 0;
+RTC_DATA_ATTR int8_t leafWetBand = 0;
+
+// Delivery: unicast packets wait in a retry queue until ESP-NOW reports
+// the ACK; after MAX_RETRY retries a packet is dropped, and after
+// PAIR_LOST_AFTER dropped packets in a row the node pairs again
+#define MAX_RETRY 3
+#define PAIR_LOST_AFTER 3
+RetryQueue retryQueue(MAX_RETRY, RETRY_BASE_DELAY_MS, RETRY_MAX_DELAY_MS, esp_random());
+RTC_DATA_ATTR uint8_t expiredInRow = 0;
+unsigned long sendStartTime = 0;
+
+volatile bool sendDone = false;
+volatile bool sendDelivered = false;
+volatile bool pairReceived = false;
+uint8_t pairAddress[6];
+
+// ============================================
+// RAIN GAUGE
+// ============================================
+#define RAIN_MM_PER_TIP 0.2794f       // 0.011 in bucket
+#define RAIN_DEBOUNCE_MS 25
+#define RAIN_TIP_QUEUE 32
+
+// Counters survive deep sleep and resets (validated on boot)
+RTC_NOINIT_ATTR RainGaugeState rainState;
+RainGauge rainGauge(&rainState, RAIN_MM_PER_TIP);
+
+// Tip times (millis) queued by the ISR, drained in loop()
+volatile uint32_t rainTipTimes[RAIN_TIP_QUEUE];
+volatile uint8_t rainTipHead = 0;
+volatile uint8_t rainTipTail = 0;
+volatile uint32_t rainLastEdge = 0;
 
 // ============================================
 // ESP-NOW CALLBACKS
@@ -70,6 +191,18 @@ unsigned long lastSendTime = 0;
 void OnDataSent(const uint8_t *mac_addr, esp_now_send_status_t status) {
   Serial.print("\r\n[ESP-NOW] Last Packet Send Status: ");
   Serial.println(status == ESP_NOW_SEND_SUCCESS ? "✓ Success" : "✗ Failed");
+  sendDelivered = status == ESP_NOW_SEND_SUCCESS;
+  sendDone = true;
+}
+
+// Only a Gateway's pairing reply is expected
+void OnDataRecv(const uint8_t *mac, const uint8_t *incomingData, int len) {
+  if (protocolValidate(incomingData, len) != PACKET_OK ||
+      ((const PacketHeader *)incomingData)->packetType != PACKET_PAIR) {
+    return;
+  }
+  memcpy(pairAddress, mac, sizeof(pairAddress));
+  pairReceived = true;
 }
 
 // ============================================
@@ -110,69 +243,493 @@ float readWindDirection() {
   return direction;
 }
 
-String getWindDirectionName(float degrees) {
-  if (degrees >= 337.5 || degrees < 22.5) return "N";
-  else if (degrees >= 22.5 && degrees < 67.5) return "NE";
-  else if (degrees >= 67.5 && degrees < 112.5) return "E";
-  else if (degrees >= 112.5 && degrees < 157.5) return "SE";
-  else if (degrees >= 157.5 && degrees < 202.5) return "S";
-  else if (degrees >= 202.5 && degrees < 247.5) return "SW";
-  else if (degrees >= 247.5 && degrees < 292.5) return "W";
-  else return "NW";
+void IRAM_ATTR onRainTip() {
+  uint32_t now = millis();
+  if (now - rainLastEdge < RAIN_DEBOUNCE_MS) return;
+  rainLastEdge = now;
+
+  uint8_t next = (rainTipHead + 1) % RAIN_TIP_QUEUE;
+  if (next == rainTipTail) return;  // Queue full, tip lost
+  rainTipTimes[rainTipHead] = now;
+  rainTipHead = next;
+}
+
+// RTC time keeps counting through deep sleep and resets
+uint32_t rtcSeconds() {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  return (uint32_t)now.tv_sec;
 }
 
-float readRainfall() {
-  int rawValue = analogRead(RAINFALL_PIN);
-  // Map to rainfall in mm (0-100 mm)
-  float rain = map(rawValue, 0, 4095, 0, 100);
-  return rain;
+// Milliseconds on the same RTC clock
+uint32_t rtcMillis() {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  return (uint32_t)(now.tv_sec * 1000ULL + now.tv_usec / 1000);
+}
+
+// Move queued tips into the gauge, placed on the RTC time line
+void drainRainTips() {
+  uint32_t nowMs = millis();
+  uint32_t nowS = rtcSeconds();
+  while (rainTipTail != rainTipHead) {
+    rainGauge.addTip(nowS - (nowMs - rainTipTimes[rainTipTail]) / 1000);
+    rainTipTail = (rainTipTail + 1) % RAIN_TIP_QUEUE;
+  }
 }
 
 // ============================================
-// SETUP
+// SAMPLING AND TRANSMISSION
 // ============================================
-void setup() {
-  Serial.begin(115200);
-  delay(1000);
+
+// Read all sensors and report them. Wind direction
+// comes from whatever the vane average holds.
+void sampleWeather(uint32_t timestamp) {
+  weatherData.leafWetness = readLeafWetness();
+  weatherData.leafTemp = readLeafTemp();
+  weatherData.airTemp = dht.readTemperature();
+  weatherData.humidity = dht.readHumidity();
+  weatherData.lightIntensity = readLightIntensity();
+  weatherData.windSpeed = readWindSpeed();
+  WindVectorStats shortWind = windDirAverage.stats(windDirShort);
+  weatherData.windDirection = shortWind.direction;
+  weatherData.windDirStdDev = shortWind.stdDev;
+  weatherData.windDirection10 = windDirAverage.stats(windDirLong).direction;
+  drainRainTips();
+  uint32_t nowS = rtcSeconds();
+  weatherData.rainfall = rainGauge.last24h(nowS);
+  weatherData.rainfall1h = rainGauge.lastHour(nowS);
+  weatherData.rainEvent = rainGauge.event(nowS);
+  weatherData.rainRate = rainGauge.intensity(nowS);
+  weatherData.timestamp = timestamp;
   
-  Serial.println("\r\n\r\n╔════════════════════════════════════════╗");
-  Serial.println("║  ESP32 WEATHER NODE - Initializing... ║");
-  Serial.println("╚════════════════════════════════════════╝\r\n");
+  // Check for DHT22 reading errors
+  if (isnan(weatherData.airTemp) || isnan(weatherData.humidity)) {
+    Serial.println("[WARNING] Failed to read from DHT sensor!");
+    weatherData.airTemp = -999;
+    weatherData.humidity = -999;
+  }
   
-  // Set device as a Wi-Fi Station
-  WiFi.mode(WIFI_STA);
+  // Print data to Serial Monitor
+  Serial.println("\r\n┌──────────────────────────────────────────┐");
+  Serial.println("│      WEATHER NODE - Sensor Data         │");
+  Serial.println("├──────────────────────────────────────────┤");
+  Serial.printf("│ Leaf Wetness:     %6.2f %%             │\r\n", weatherData.leafWetness);
+  Serial.printf("│ Leaf Temperature: %6.2f °C             │\r\n", weatherData.leafTemp);
+  Serial.printf("│ Air Temperature:  %6.2f °C             │\r\n", weatherData.airTemp);
+  Serial.printf("│ Humidity:         %6.2f %%             │\r\n", weatherData.humidity);
+  Serial.printf("│ Light Intensity:  %6.0f lux            │\r\n", weatherData.lightIntensity);
+  Serial.printf("│ Wind Speed:       %6.2f m/s            │\r\n", weatherData.windSpeed);
+  Serial.printf("│ Wind Direction:   %6.1f° (%-3s) ±%4.1f°  │\r\n", 
+                weatherData.windDirection, 
+                windCardinal16(weatherData.windDirection),
+                weatherData.windDirStdDev);
+  Serial.printf("│ Wind Dir 10 min:  %6.1f° (%-3s)         │\r\n",
+                weatherData.windDirection10,
+                windCardinal16(weatherData.windDirection10));
+  Serial.printf("│ Rainfall 24 h:    %6.2f mm             │\r\n", weatherData.rainfall);
+  Serial.printf("│ Rainfall 1 h:     %6.2f mm             │\r\n", weatherData.rainfall1h);
+  Serial.printf("│ Rain Event:       %6.2f mm             │\r\n", weatherData.rainEvent);
+  Serial.printf("│ Rain Rate:        %6.1f mm/h           │\r\n", weatherData.rainRate);
+  Serial.printf("│ Timestamp:        %lu ms              │\r\n", weatherData.timestamp);
+  Serial.println("└──────────────────────────────────────────┘");
   
-  // Print MAC Address
-  Serial.print("[WiFi] This Device MAC Address: ");
-  Serial.println(WiFi.macAddress());
+  // Environmental analysis
+  Serial.println("\r\n[Analysis]");
+  
+  // Leaf wetness & disease risk
+  if (weatherData.leafWetness > 80) {
+    Serial.println("  ⚠ HIGH FUNGAL DISEASE RISK - Leaves very wet");
+  } else if (weatherData.leafWetness > 50) {
+    Serial.println("  ⚠ MODERATE FUNGAL DISEASE RISK - Monitor closely");
+  } else {
+    Serial.println("  ✓ Low disease risk - Leaves relatively dry");
+  }
+  
+  // Light conditions
+  if (weatherData.lightIntensity < 200) {
+    Serial.println("  ⚠ LOW LIGHT - Photosynthesis limited");
+  } else if (weatherData.lightIntensity > 800) {
+    Serial.println("  ✓ EXCELLENT LIGHT - Optimal photosynthesis");
+  } else {
+    Serial.println("  ✓ ADEQUATE LIGHT for plant growth");
+  }
+  
+  // Wind conditions for spraying
+  if (weatherData.windSpeed > 15) {
+    Serial.println("  ⚠ HIGH WIND - DO NOT SPRAY (drift risk)");
+  } else if (weatherData.windSpeed > 10) {
+    Serial.println("  ⚠ MODERATE WIND - Spraying not recommended");
+  } else if (weatherData.windSpeed < 3) {
+    Serial.println("  ⚠ LOW WIND - Spraying may have reduced coverage");
+  } else {
+    Serial.println("  ✓ IDEAL WIND CONDITIONS for spraying");
+  }
+  if (weatherData.windDirStdDev > WIND_DIR_VARIABLE_STDDEV) {
+    Serial.println("  ⚠ VARIABLE WIND DIRECTION - Drift path unpredictable");
+  } else {
+    Serial.printf("  ✓ Steady wind from %s - Drift moves %s\r\n",
+                  windCardinal8(weatherData.windDirection),
+                  windCardinal8(weatherData.windDirection + 180.0f));
+  }
+  
+  // Rainfall
+  if (weatherData.rainRate > 7.6) {
+    Serial.println("  ⚠ HEAVY RAIN NOW - Postpone spraying");
+  }
+  if (weatherData.rainfall > 50) {
+    Serial.println("  ⚠ HEAVY RAIN - Field operations suspended");
+  } else if (weatherData.rainfall > 10) {
+    Serial.println("  ⚠ MODERATE RAIN - Limit field access");
+  }
+  
+  // Temperature & humidity
+  if (weatherData.airTemp > 35) {
+    Serial.println("  ⚠ HIGH TEMPERATURE - Heat stress possible");
+  } else if (weatherData.airTemp < 5) {
+    Serial.println("  ⚠ LOW TEMPERATURE - Frost risk");
+  }
+  
+  if (weatherData.humidity < 30) {
+    Serial.println("  ⚠ LOW HUMIDITY - Increase irrigation");
+  } else if (weatherData.humidity > 80) {
+    Serial.println("  ⚠ HIGH HUMIDITY - Monitor for disease");
+  }
+  
+}
+
+// Run the reading through the send-on-change filter and, unless it is
+// suppressed, encode and seal weatherPacket. `force` sends it regardless.
+ReportDecision filterWeatherReading(uint32_t now, bool force) {
+  float values[] = {
+    weatherData.airTemp, weatherData.humidity, weatherData.lightIntensity, weatherData.rainfall,
+    weatherData.windSpeed, weatherData.windDirection, weatherData.leafTemp, weatherData.leafWetness
+  };
+  ReportDecision decision = reportFilter.evaluate(values, now, force);
+  
+  if (decision != REPORT_SUPPRESS) {
+    // Encode fixed-point packet and seal header
+    weatherPacket.airTemp = toFixedS16(weatherData.airTemp, FIXED_CENTI);
+    weatherPacket.humidity = toFixedU16(weatherData.humidity, FIXED_CENTI);
+    weatherPacket.light = toFixedU16(weatherData.lightIntensity, 1.0f);
+    weatherPacket.rainfall = toFixedU16(weatherData.rainfall, FIXED_DECI);
+    weatherPacket.windSpeed = toFixedU16(weatherData.windSpeed, FIXED_CENTI);
+    weatherPacket.windDirection = toFixedU16(weatherData.windDirection, 1.0f);
+    weatherPacket.leafTemp = toFixedS16(weatherData.leafTemp, FIXED_CENTI);
+    weatherPacket.leafWetness = toFixedU16(weatherData.leafWetness, FIXED_CENTI);
+    weatherPacket.windDirection10 = toFixedU16(weatherData.windDirection10, 1.0f);
+    weatherPacket.windDirStdDev = toFixedU16(weatherData.windDirStdDev, FIXED_DECI);
+    weatherPacket.rainfall1h = toFixedU16(weatherData.rainfall1h, FIXED_DECI);
+    weatherPacket.rainEvent = toFixedU16(weatherData.rainEvent, FIXED_DECI);
+    weatherPacket.rainRate = toFixedU16(weatherData.rainRate, FIXED_DECI);
+    weatherPacket.header.skipped = reportFilter.getSkipped();
+    weatherPacket.header.flags = (decision == REPORT_HEARTBEAT ? PACKET_FLAG_HEARTBEAT : 0) |
+                                 (gatewayPaired ? 0 : PACKET_FLAG_PAIRING);
+    protocolSeal(&weatherPacket.header, sizeof(weatherPacket), NODE_ID_WEATHER,
+                 PACKET_WEATHER_DATA, packetSequence++, weatherData.timestamp);
+  }
+  
+  Serial.printf("[Report] %s%s%s | %lu of %lu readings suppressed (%.1f%%)\r\n",
+                reportDecisionName(decision),
+                decision == REPORT_CHANGE ? ": " : "",
+                decision == REPORT_CHANGE ? reportFilter.getTriggerName() : "",
+                (unsigned long)(reportFilter.getSamples() - reportFilter.getSent()),
+                (unsigned long)reportFilter.getSamples(),
+                reportFilter.getSuppressionRatio() * 100.0f);
+  return decision;
+}
+
+// Bring up WiFi in station mode, ESP-NOW and the Gateway peer
+bool startEspNow() {
+  WiFi.mode(WIFI_STA);
   
-  // Initialize ESP-NOW
   if (esp_now_init() != ESP_OK) {
     Serial.println("[ERROR] ESP-NOW initialization failed!");
-    return;
+    return false;
   }
-  Serial.println("[ESP-NOW] ✓ Initialized successfully");
-  
-  // Register send callback
   esp_now_register_send_cb(OnDataSent);
+  esp_now_register_recv_cb(OnDataRecv);
   
-  // Register Gateway peer
-  memcpy(peerInfo.peer_addr, gatewayAddress, 6);
+  // Broadcast peer for pairing, and the Gateway once known
   peerInfo.channel = 0;  
   peerInfo.encrypt = false;
-  
+  memcpy(peerInfo.peer_addr, BROADCAST_ADDRESS, 6);
   if (esp_now_add_peer(&peerInfo) != ESP_OK) {
+    Serial.println("[ERROR] Failed to add broadcast peer!");
+    return false;
+  }
+  if (gatewayPaired) {
+    memcpy(peerInfo.peer_addr, gatewayAddress, 6);
+    if (esp_now_add_peer(&peerInfo) != ESP_OK) {
+      Serial.println("[ERROR] Failed to add Gateway peer!");
+      return false;
+    }
+  }
+  return true;
+}
+
+// Switch to unicast once the Gateway has answered
+void applyPairing() {
+  if (!pairReceived) {
+    return;
+  }
+  pairReceived = false;
+  if (gatewayPaired && memcmp(gatewayAddress, pairAddress, 6) == 0) {
+    return;
+  }
+  
+  memcpy(peerInfo.peer_addr, pairAddress, 6);
+  if (!esp_now_is_peer_exist(pairAddress) && esp_now_add_peer(&peerInfo) != ESP_OK) {
     Serial.println("[ERROR] Failed to add Gateway peer!");
     return;
   }
-  Serial.println("[ESP-NOW] ✓ Gateway peer registered");
+  memcpy(gatewayAddress, pairAddress, 6);
+  gatewayPaired = true;
+  expiredInRow = 0;
+  Serial.printf("[ESP-NOW] ✓ Paired with Gateway %02X:%02X:%02X:%02X:%02X:%02X, sending unicast\r\n",
+                gatewayAddress[0], gatewayAddress[1], gatewayAddress[2],
+                gatewayAddress[3], gatewayAddress[4], gatewayAddress[5]);
+}
+
+// Count a packet given up on; too many in a row and the Gateway is
+// presumed gone (replaced, or moved channel), so pair again
+void countExpired() {
+  Serial.printf("[ESP-NOW] ✗ Packet dropped after %d retries\r\n", MAX_RETRY);
+  if (gatewayPaired && ++expiredInRow >= PAIR_LOST_AFTER) {
+    Serial.println("[ESP-NOW] ⚠ Gateway not answering, pairing again");
+    esp_now_del_peer(gatewayAddress);
+    memcpy(gatewayAddress, BROADCAST_ADDRESS, 6);
+    gatewayPaired = false;
+    expiredInRow = 0;
+  }
+}
+
+// Finish the transmission on the air, then start the next one that is due
+void serviceRetryQueue(unsigned long now) {
+  if (retryQueue.busy()) {
+    if (!sendDone && now - sendStartTime < SEND_ACK_TIMEOUT_MS) {
+      return;
+    }
+    uint32_t expired = retryQueue.getStats().expired;
+    bool delivered = sendDone && sendDelivered;
+    retryQueue.complete(delivered, now);
+    if (delivered) {
+      expiredInRow = 0;
+    } else if (retryQueue.getStats().expired != expired) {
+      countExpired();
+    }
+  }
+  
+  size_t length;
+  const uint8_t *packet = retryQueue.next(now, length);
+  if (packet == nullptr) {
+    return;
+  }
+  sendDone = false;
+  sendStartTime = now;
+  if (esp_now_send(gatewayAddress, (uint8_t *) packet, length) != ESP_OK) {
+    Serial.println("[ERROR] Failed to send data packet!");
+    sendDone = true;
+    sendDelivered = false;
+  }
+}
+
+// Send the batch oldest first, retrying each packet up to MAX_RETRY times
+// with backoff. Packets from the first one that fails for good on stay
+// batched for the next radio session.
+uint8_t sendPendingPackets() {
+  uint8_t delivered = 0;
+  
+  while (delivered < pendingPackets.count) {
+    bool acknowledged = false;
+    for (uint8_t attempt = 0; attempt <= MAX_RETRY && !acknowledged; attempt++) {
+      if (attempt > 0) {
+        delay(retryQueue.backoff(attempt));
+      }
+      sendDone = false;
+      esp_err_t result = esp_now_send(gatewayAddress, (uint8_t *) &pendingPackets.packets[delivered],
+                                      sizeof(WeatherNodeData));
+      if (result != ESP_OK) {
+        Serial.println("[ERROR] Failed to send data packet!");
+        continue;
+      }
+      energyLedger.packets++;
+      
+      unsigned long start = millis();
+      while (!sendDone && millis() - start < SEND_ACK_TIMEOUT_MS) {
+        delay(1);
+      }
+      acknowledged = sendDone && sendDelivered;
+    }
+    if (!acknowledged) {
+      countExpired();
+      break;
+    }
+    expiredInRow = 0;
+    delivered++;
+  }
+  
+  // Unpaired: the Gateway answers the broadcast with its address
+  if (!gatewayPaired) {
+    unsigned long start = millis();
+    while (!pairReceived && millis() - start < PAIR_WAIT_MS) {
+      delay(1);
+    }
+    applyPairing();
+  }
+  
+  pendingPackets.consume(delivered);
+  return delivered;
+}
+
+// Sleep until the next sampling wake or a bucket tip
+void enterDeepSleep() {
+  uint32_t now = rtcMillis();
+  uint32_t remaining = (int32_t)(nextSampleMs - now) > 0 ? nextSampleMs - now : 1;
+  
+  // The reed switch pulls the pin low; keep the pull-up in the RTC domain
+  rtc_gpio_init((gpio_num_t)RAINFALL_PIN);
+  rtc_gpio_set_direction((gpio_num_t)RAINFALL_PIN, RTC_GPIO_MODE_INPUT_ONLY);
+  rtc_gpio_pullup_en((gpio_num_t)RAINFALL_PIN);
+  rtc_gpio_pulldown_dis((gpio_num_t)RAINFALL_PIN);
+  esp_sleep_enable_ext0_wakeup((gpio_num_t)RAINFALL_PIN, 0);
+  esp_sleep_enable_timer_wakeup(remaining * 1000ULL);
+  
+  Serial.flush();
+  sleepStartMs = now;
+  esp_deep_sleep_start();
+}
+
+// One wake of the duty cycle. A rain wake records the tip and sleeps
+// again; a timer wake samples, batches, sends if due and sleeps.
+// Never returns; the next wake starts over in setup().
+void runDutyCycle() {
+  if (!energyRestore(&energyLedger)) {
+    pendingPackets.clear();
+    lastSessionMs = rtcMillis();
+    nextSampleMs = rtcMillis();
+    Serial.println("[Sleep] Cold boot - energy ledger reset");
+  } else if (sleepStartMs != 0) {
+    // RTC time since going to sleep, less the time awake so far
+    uint32_t elapsed = rtcMillis() - sleepStartMs;
+    uint32_t awake = millis();
+    if (elapsed > awake) {
+      energyAccount(&energyLedger, POWER_SLEEP, (elapsed - awake) * 1000ULL);
+    }
+  }
+  energyLedger.wakes++;
+  
+  if (!rainGauge.restore()) {
+    Serial.println("[Sleep] Rain gauge state cleared");
+  }
+  
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0) {
+    rainGauge.addTip(rtcSeconds());
+    
+    // Sleeping while the switch is still closed would wake straight away
+    rtc_gpio_deinit((gpio_num_t)RAINFALL_PIN);
+    pinMode(RAINFALL_PIN, INPUT_PULLUP);
+    unsigned long start = millis();
+    while (digitalRead(RAINFALL_PIN) == LOW && millis() - start < RAIN_RELEASE_TIMEOUT_MS) {
+      delay(1);
+    }
+    delay(RAIN_DEBOUNCE_MS);
+    
+    if ((int32_t)(nextSampleMs - rtcMillis()) > 0) {
+      energyAccount(&energyLedger, POWER_ACTIVE, esp_timer_get_time());
+      enterDeepSleep();
+    }
+  }
+  nextSampleMs = rtcMillis() + SLEEP_DURATION_MS;
+  
+  dht.begin();
+  windDirShort = windDirAverage.addWindow(WIND_DIR_SHORT_WINDOW);
+  windDirLong = windDirAverage.addWindow(WIND_DIR_LONG_WINDOW);
+  for (uint8_t i = 0; i < WIND_DIR_BURST_SAMPLES; i++) {
+    windDirAverage.add(readWindDirection());
+    delay(WIND_DIR_BURST_INTERVAL);
+  }
+  
+  sampleWeather(rtcMillis());
+  
+  // Update every band, then decide
+  bool crossed = thresholdCrossed(&airTempBand, weatherData.airTemp, 5, 35);
+  crossed |= thresholdCrossed(&windBand, weatherData.windSpeed, 0, 15);
+  crossed |= thresholdCrossed(&rainBand, weatherData.rainRate, 0, 0);
+  crossed |= thresholdCrossed(&leafWetBand, weatherData.leafWetness, 0, 80);
+  
+  // Unchanged readings are not batched
+  if (filterWeatherReading(rtcMillis(), crossed) != REPORT_SUPPRESS && !pendingPackets.push(weatherPacket)) {
+    Serial.println("[Sleep] Batch full - oldest reading dropped");
+  }
+  
+  uint64_t radioTime = 0;
+  if (batchSendDue(pendingPackets.count, BATCH_SIZE, crossed, rtcMillis() - lastSessionMs,
+                   SESSION_MAX_SILENCE_MS)) {
+    lastSessionMs = rtcMillis();
+    uint64_t radioStart = esp_timer_get_time();
+    uint8_t queued = pendingPackets.count;
+    Serial.printf("\r\n[ESP-NOW] Transmitting %u batched reading(s)%s...\r\n",
+                  queued, crossed ? " (threshold crossed)" : "");
+    uint8_t delivered = startEspNow() ? sendPendingPackets() : 0;
+    esp_now_deinit();
+    WiFi.mode(WIFI_OFF);
+    
+    radioTime = esp_timer_get_time() - radioStart;
+    energyAccount(&energyLedger, POWER_RADIO, radioTime);
+    energyLedger.transmissions++;
+    Serial.printf("[ESP-NOW] %u/%u delivered\r\n", delivered, queued);
+  } else {
+    Serial.printf("\r\n[Sleep] Batched %u/%u readings\r\n", pendingPackets.count, BATCH_SIZE);
+  }
+  
+  energyAccount(&energyLedger, POWER_ACTIVE, esp_timer_get_time() - radioTime);
+  Serial.printf("[Energy] %lu wakes, %lu radio sessions | avg %.3f mA | ~%.0f days on %.0f mAh\r\n",
+                (unsigned long)energyLedger.wakes, (unsigned long)energyLedger.transmissions,
+                energyAverageCurrent_mA(&energyLedger, &POWER_PROFILE_WROOM32),
+                energyBatteryLife_days(&energyLedger, &POWER_PROFILE_WROOM32, BATTERY_CAPACITY_MAH),
+                BATTERY_CAPACITY_MAH);
+  enterDeepSleep();
+}
+
+// ============================================
+// SETUP
+// ============================================
+void setup() {
+  Serial.begin(115200);
+  
+  // Duty-cycled: skip the banner and never reach loop()
+  if (SLEEP_ENABLED) {
+    runDutyCycle();
+  }
+  delay(1000);
+  
+  Serial.println("\r\n\r\n╔════════════════════════════════════════╗");
+  Serial.println("║  ESP32 WEATHER NODE - Initializing... ║");
+  Serial.println("╚════════════════════════════════════════╝\r\n");
+  
+  // Set device as a Wi-Fi Station, initialize ESP-NOW and register the Gateway peer
+  if (!startEspNow()) {
+    return;
+  }
+  
+  // Print MAC Address
+  Serial.print("[WiFi] This Device MAC Address: ");
+  Serial.println(WiFi.macAddress());
+  Serial.println("[ESP-NOW] ✓ Initialized, Gateway peer registered");
   
   // Initialize sensors
   dht.begin();
-  Serial.println("[Sensors] ✓ DHT22 initialized");
+  windDirShort = windDirAverage.addWindow(WIND_DIR_SHORT_WINDOW);
+  windDirLong = windDirAverage.addWindow(WIND_DIR_LONG_WINDOW);
   
-  // Set node ID
-  strcpy(weatherData.nodeId, "WEATHER_NODE");
+  if (rainGauge.restore()) {
+    Serial.printf("[Sensors] ✓ Rain gauge restored (%lu tips)\r\n", (unsigned long)rainGauge.totalTips());
+  }
+  pinMode(RAINFALL_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(RAINFALL_PIN), onRainTip, FALLING);
+  Serial.println("[Sensors] ✓ Tipping bucket rain gauge initialized");
+  Serial.println("[Sensors] ✓ DHT22 initialized");
   
   Serial.println("\r\n╔════════════════════════════════════════╗");
   Serial.println("║    WEATHER NODE Ready - Monitoring    ║");
@@ -185,104 +742,34 @@ void setup() {
 void loop() {
   unsigned long currentTime = millis();
   
-  if (currentTime - lastSendTime >= SEND_INTERVAL) {
-    lastSendTime = currentTime;
+  // Sample the vane on its own cadence so the means are not built from
+  // one noisy reading per report
+  if (currentTime - lastWindDirSample >= WIND_DIR_SAMPLE_INTERVAL) {
+    lastWindDirSample = currentTime;
+    windDirAverage.add(readWindDirection());
+  }
+  
+  if (currentTime - lastSampleTime >= SAMPLE_INTERVAL) {
+    lastSampleTime = currentTime;
     
     // Read all sensor data
-    weatherData.leafWetness = readLeafWetness();
-    weatherData.leafTemp = readLeafTemp();
-    weatherData.airTemp = dht.readTemperature();
-    weatherData.humidity = dht.readHumidity();
-    weatherData.lightIntensity = readLightIntensity();
-    weatherData.windSpeed = readWindSpeed();
-    weatherData.windDirection = readWindDirection();
-    weatherData.rainfall = readRainfall();
-    weatherData.timestamp = currentTime;
-    
-    // Check for DHT22 reading errors
-    if (isnan(weatherData.airTemp) || isnan(weatherData.humidity)) {
-      Serial.println("[WARNING] Failed to read from DHT sensor!");
-      weatherData.airTemp = -999;
-      weatherData.humidity = -999;
-    }
-    
-    // Print data to Serial Monitor
-    Serial.println("\r\n┌──────────────────────────────────────────┐");
-    Serial.println("│      WEATHER NODE - Sensor Data         │");
-    Serial.println("├──────────────────────────────────────────┤");
-    Serial.printf("│ Leaf Wetness:     %6.2f %%             │\r\n", weatherData.leafWetness);
-    Serial.printf("│ Leaf Temperature: %6.2f °C             │\r\n", weatherData.leafTemp);
-    Serial.printf("│ Air Temperature:  %6.2f °C             │\r\n", weatherData.airTemp);
-    Serial.printf("│ Humidity:         %6.2f %%             │\r\n", weatherData.humidity);
-    Serial.printf("│ Light Intensity:  %6.0f lux            │\r\n", weatherData.lightIntensity);
-    Serial.printf("│ Wind Speed:       %6.2f m/s            │\r\n", weatherData.windSpeed);
-    Serial.printf("│ Wind Direction:   %6.1f° (%s)          │\r\n", 
-                  weatherData.windDirection, 
-                  getWindDirectionName(weatherData.windDirection).c_str());
-    Serial.printf("│ Rainfall:         %6.2f mm             │\r\n", weatherData.rainfall);
-    Serial.printf("│ Timestamp:        %lu ms              │\r\n", weatherData.timestamp);
-    Serial.println("└──────────────────────────────────────────┘");
-    
-    // Environmental analysis
-    Serial.println("\r\n[Analysis]");
-    
-    // Leaf wetness & disease risk
-    if (weatherData.leafWetness > 80) {
-      Serial.println("  ⚠ HIGH FUNGAL DISEASE RISK - Leaves very wet");
-    } else if (weatherData.leafWetness > 50) {
-      Serial.println("  ⚠ MODERATE FUNGAL DISEASE RISK - Monitor closely");
-    } else {
-      Serial.println("  ✓ Low disease risk - Leaves relatively dry");
-    }
-    
-    // Light conditions
-    if (weatherData.lightIntensity < 200) {
-      Serial.println("  ⚠ LOW LIGHT - Photosynthesis limited");
-    } else if (weatherData.lightIntensity > 800) {
-      Serial.println("  ✓ EXCELLENT LIGHT - Optimal photosynthesis");
-    } else {
-      Serial.println("  ✓ ADEQUATE LIGHT for plant growth");
-    }
+    sampleWeather(currentTime);
     
-    // Wind conditions for spraying
-    if (weatherData.windSpeed > 15) {
-      Serial.println("  ⚠ HIGH WIND - DO NOT SPRAY (drift risk)");
-    } else if (weatherData.windSpeed > 10) {
-      Serial.println("  ⚠ MODERATE WIND - Spraying not recommended");
-    } else if (weatherData.windSpeed < 3) {
-      Serial.println("  ⚠ LOW WIND - Spraying may have reduced coverage");
-    } else {
-      Serial.println("  ✓ IDEAL WIND CONDITIONS for spraying");
-    }
-    
-    // Rainfall
-    if (weatherData.rainfall > 50) {
-      Serial.println("  ⚠ HEAVY RAIN - Field operations suspended");
-    } else if (weatherData.rainfall > 10) {
-      Serial.println("  ⚠ MODERATE RAIN - Limit field access");
-    }
-    
-    // Temperature & humidity
-    if (weatherData.airTemp > 35) {
-      Serial.println("  ⚠ HIGH TEMPERATURE - Heat stress possible");
-    } else if (weatherData.airTemp < 5) {
-      Serial.println("  ⚠ LOW TEMPERATURE - Frost risk");
-    }
-    
-    if (weatherData.humidity < 30) {
-      Serial.println("  ⚠ LOW HUMIDITY - Increase irrigation");
-    } else if (weatherData.humidity > 80) {
-      Serial.println("  ⚠ HIGH HUMIDITY - Monitor for disease");
-    }
-    
-    // Send message via ESP-NOW to Gateway
-    Serial.println("\r\n[ESP-NOW] Transmitting to Gateway...");
-    esp_err_t result = esp_now_send(gatewayAddress, (uint8_t *) &weatherData, sizeof(weatherData));
-    
-    if (result != ESP_OK) {
-      Serial.println("[ERROR] Failed to send data packet!");
+    // Queue it for the Gateway, unless nothing changed; a reading still
+    // waiting for a retry is replaced by this one
+    if (filterWeatherReading(currentTime, false) != REPORT_SUPPRESS) {
+      uint32_t superseded = retryQueue.getStats().superseded;
+      if (retryQueue.push((const uint8_t *) &weatherPacket, sizeof(weatherPacket), currentTime)) {
+        packetSequence--;  // It took the replaced packet's number
+      }
+      Serial.printf("\r\n[ESP-NOW] Queued for Gateway (%s)%s\r\n",
+                    gatewayPaired ? "unicast" : "broadcast, pairing",
+                    retryQueue.getStats().superseded != superseded ? ", replaces an undelivered reading" : "");
     }
   }
   
-  delay(100); // Small delay to prevent watchdog issues
+  applyPairing();
+  serviceRetryQueue(currentTime);
+  
+  delay(10); // Small delay to prevent watchdog issues
 }
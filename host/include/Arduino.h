@@ -0,0 +1,159 @@
+/*
+ * Arduino.h (host)
+ * Minimal Arduino core replacement for the PlatformIO `native` environment
+ *
+ * Only the language-level pieces the drivers use live here (String, Serial,
+ * map, constrain, pin constants). Hardware access goes through HAL.h, whose
+ * host backend is HAL_Host.cpp.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+using std::abs;
+using std::isnan;
+
+// ==================== PIN CONSTANTS ====================
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define IRAM_ATTR
+#define digitalPinToInterrupt(p) (p)
+
+// ==================== MATH HELPERS ====================
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    const long run = in_max - in_min;
+    if (run == 0) {
+        return out_min;
+    }
+    return (x - in_min) * (out_max - out_min) / run + out_min;
+}
+
+// ==================== STRING ====================
+class String {
+private:
+    std::string buffer;
+
+public:
+    String() {}
+    String(const char* text) : buffer(text ? text : "") {}
+    String(const std::string& text) : buffer(text) {}
+    String(char c) : buffer(1, c) {}
+    String(int value) : buffer(std::to_string(value)) {}
+    String(unsigned int value) : buffer(std::to_string(value)) {}
+    String(long value) : buffer(std::to_string(value)) {}
+    String(unsigned long value) : buffer(std::to_string(value)) {}
+    String(float value, unsigned int decimals = 2) { setFloat(value, decimals); }
+    String(double value, unsigned int decimals = 2) { setFloat(value, decimals); }
+
+    const char* c_str() const { return buffer.c_str(); }
+    unsigned int length() const { return (unsigned int)buffer.size(); }
+
+    String& operator+=(const String& other) { buffer += other.buffer; return *this; }
+    friend String operator+(const String& a, const String& b) { return String(a.buffer + b.buffer); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a) + b.buffer); }
+    friend String operator+(const String& a, const char* b) { return String(a.buffer + b); }
+
+    bool operator==(const String& other) const { return buffer == other.buffer; }
+    bool operator==(const char* other) const { return buffer == other; }
+    bool operator!=(const String& other) const { return buffer != other.buffer; }
+
+private:
+    void setFloat(double value, unsigned int decimals) {
+        char text[48];
+        snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+        buffer = text;
+    }
+};
+
+// ==================== SERIAL ====================
+class HardwareSerial {
+private:
+    bool echo;
+    unsigned long written;          // Bytes printed, echoed or not
+
+public:
+    HardwareSerial() : echo(true), written(0) {}
+
+    void begin(unsigned long baud) { (void)baud; }
+
+    // Silence output for long simulated runs
+    void setEcho(bool enabled) { echo = enabled; }
+
+    // What would have gone out on the wire
+    unsigned long getBytesWritten() const { return written; }
+
+    int available() { return 0; }
+    int read() { return -1; }
+
+    size_t write(const uint8_t* data, size_t length) {
+        if (echo) fwrite(data, 1, length, stdout);
+        written += length;
+        return length;
+    }
+
+    size_t print(const String& s) { return out("%s", s.c_str()); }
+    size_t print(const char* s) { return out("%s", s); }
+    size_t print(char c) { return out("%c", c); }
+    size_t print(int v) { return out("%d", v); }
+    size_t print(unsigned int v) { return out("%u", v); }
+    size_t print(long v) { return out("%ld", v); }
+    size_t print(unsigned long v) { return out("%lu", v); }
+    size_t print(double v, int decimals = 2) { return out("%.*f", decimals, v); }
+
+    size_t println() { return out("\n"); }
+    template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    size_t println(double v, int decimals) { size_t n = print(v, decimals); return n + println(); }
+
+    size_t printf(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        size_t n = emit(format, args);
+        va_end(args);
+        return n;
+    }
+
+private:
+    size_t out(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        size_t n = emit(format, args);
+        va_end(args);
+        return n;
+    }
+
+    size_t emit(const char* format, va_list args) {
+        int n = echo ? vprintf(format, args) : vsnprintf(nullptr, 0, format, args);
+        if (n <= 0) return 0;
+        written += (unsigned long)n;
+        return (size_t)n;
+    }
+};
+
+extern HardwareSerial Serial;
+
+#endif
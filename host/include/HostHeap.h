@@ -0,0 +1,83 @@
+/*
+ * HostHeap.h
+ * Heap tracking for host programs: malloc, calloc, realloc, free and
+ * new/delete are counted
+ *
+ * Defines the allocator entry points, so include it in exactly one file
+ * of a host program. Counts live and peak bytes (usable size of each
+ * block) and the number of allocations.
+ */
+
+#ifndef HOST_HEAP_H
+#define HOST_HEAP_H
+
+#ifndef ARDUINO
+
+#include <stdlib.h>
+#include <new>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+static long liveBytes = 0;
+static long peakBytes = 0;
+static unsigned long allocations = 0;
+
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* block, size_t size);
+extern "C" void __libc_free(void* block);
+
+static void* tracked(void* block) {
+    if (block != nullptr) {
+        allocations++;
+        liveBytes += (long)malloc_usable_size(block);
+        if (liveBytes > peakBytes) peakBytes = liveBytes;
+    }
+    return block;
+}
+
+extern "C" void* malloc(size_t size) {
+    return tracked(__libc_malloc(size));
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    return tracked(__libc_calloc(count, size));
+}
+
+extern "C" void* realloc(void* block, size_t size) {
+    if (block != nullptr) liveBytes -= (long)malloc_usable_size(block);
+    void* moved = __libc_realloc(block, size);
+    if (moved == nullptr && block != nullptr) {
+        liveBytes += (long)malloc_usable_size(block);          // Old block kept
+        return nullptr;
+    }
+    return tracked(moved);
+}
+
+extern "C" void free(void* block) {
+    if (block != nullptr) liveBytes -= (long)malloc_usable_size(block);
+    __libc_free(block);
+}
+#endif
+
+// new/delete end up in malloc/free above
+void* operator new(size_t size) {
+    void* block = malloc(size ? size : 1);
+    if (block == nullptr) throw std::bad_alloc();
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+#endif // !ARDUINO
+
+#endif
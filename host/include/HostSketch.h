@@ -0,0 +1,31 @@
+/*
+ * HostSketch.h
+ * Lets a host program compile main.ino unchanged
+ *
+ * Include this, then "main.ino", from one host program source file. It
+ * supplies the Arduino core calls the sketch makes directly (routed to the
+ * HAL) and the function prototypes the Arduino builder would generate.
+ */
+
+#ifndef HOST_SKETCH_H
+#define HOST_SKETCH_H
+
+#include <Arduino.h>
+#include "HAL.h"
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+    HAL::gpio().setMode(pin, mode);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+    HAL::gpio().write(pin, value);
+}
+
+inline void delay(unsigned long ms) {
+    HAL::clock().delay(ms);
+}
+
+// Prototypes the Arduino builder would generate
+void checkSerialCommands();
+
+#endif
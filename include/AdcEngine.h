@@ -0,0 +1,104 @@
+/*
+ * AdcEngine.h
+ * Continuous multi-channel ADC acquisition
+ *
+ * Features:
+ * - Background scanning of all registered analog pins via HalAdcScanner
+ *   (ESP32 ADC1 DMA on the device, replayable signals on the host)
+ * - Oversampling: each block of ADC_ENGINE_BLOCK conversions is averaged
+ * - Per-channel ring of block averages with a running sum, so drivers
+ *   read a filtered value in O(1) without touching the ADC
+ * - Pins the scanner cannot serve (ADC2) fall back to one-shot reads
+ */
+
+#ifndef ADCENGINE_H
+#define ADCENGINE_H
+
+#include <Arduino.h>
+#include "HAL.h"
+
+#define ADC_ENGINE_MAX_CHANNELS 8
+#define ADC_ENGINE_PIN_COUNT 64
+#define ADC_ENGINE_SAMPLE_RATE 20000   // Total conversions/s (ESP32 DMA minimum)
+#define ADC_ENGINE_BLOCK 64            // Conversions averaged into one ring entry
+#define ADC_ENGINE_WINDOW 16           // Ring entries in the moving average
+#define ADC_ENGINE_DRAIN 128           // Conversions fetched per scanner read
+#define ADC_ENGINE_MAX_DRAINS 16       // Scanner reads per service() call
+
+struct AdcChannelStats {
+    unsigned long conversions;     // Conversions received
+    unsigned long blocks;          // Block averages pushed into the ring
+    unsigned long reads;           // Values handed to drivers
+};
+
+struct AdcEngineStats {
+    unsigned long conversions;     // All conversions received
+    unsigned long services;        // service() calls that found data
+    unsigned long maxBatch;        // Most conversions handled in one service()
+    unsigned long fallbackReads;   // One-shot reads for pins not (yet) scanned
+    unsigned long overruns;        // Scanner buffer overflows
+};
+
+class AdcEngine {
+private:
+    struct Channel {
+        uint8_t pin;
+        uint32_t blockSum;
+        uint16_t blockCount;
+        uint16_t window[ADC_ENGINE_WINDOW];
+        uint8_t head;              // Next ring entry to overwrite
+        uint8_t filled;
+        uint32_t windowSum;
+        uint16_t latest;           // Latest block average
+        AdcChannelStats stats;
+    };
+
+    Channel channels[ADC_ENGINE_MAX_CHANNELS];
+    uint8_t channelCount;
+    uint8_t pinChannel[ADC_ENGINE_PIN_COUNT];
+    bool running;
+    AdcEngineStats stats;
+    HalAdcSample batch[ADC_ENGINE_DRAIN];
+
+    void pushBlock(Channel& channel, uint16_t average);
+
+public:
+    // Constructor
+    AdcEngine();
+
+    // Register a pin for scanning (before begin). False if the scanner
+    // cannot serve it; the pin then keeps using one-shot reads.
+    bool addChannel(uint8_t pin);
+
+    // Start background acquisition of the registered pins
+    bool begin(uint32_t sampleRate_hz = ADC_ENGINE_SAMPLE_RATE);
+    void end();
+
+    // Drain the scanner and update the channel averages (call from loop)
+    void service();
+
+    // Fold converted samples into the channels (service() feeds the
+    // scanner output; also used to replay recorded streams)
+    void ingest(const HalAdcSample* samples, size_t count);
+
+    // True once the pin is scanned and has at least one block average
+    bool isScanning(uint8_t pin);
+
+    // Moving average of a scanned pin; one-shot conversion otherwise
+    int read(uint8_t pin);
+
+    // Latest block average of a scanned pin; one-shot conversion otherwise
+    int readLatest(uint8_t pin);
+
+    // Statistics
+    uint8_t getChannelCount();
+    uint8_t getChannelPin(uint8_t index);
+    const AdcChannelStats& getChannelStats(uint8_t index);
+    const AdcEngineStats& getStats();
+    void printStats();
+};
+
+// Shared by all analog drivers
+extern AdcEngine adcEngine;
+
+#endif
@@ -1,11 +1,13 @@
 /*
  * AlertSystem.h
  * Driver for Buzzer Alert System
- * 
+ *
  * Features:
  * - Audio alerts for critical conditions
  * - Different beep patterns for different alerts
- * - Alert priority management
+ * - Alert priority management (active alerts queued by severity)
+ * - Per-alert threshold hysteresis and debounce
+ * - Non-blocking pattern player driven from update()
  * - Mute/unmute functionality
  */
 
@@ -14,6 +16,10 @@
 
 #include <Arduino.h>
 
+#define ALERT_TONE_CHANNEL 0
+#define ALERT_TONE_FREQUENCY 2000  // Hz
+#define ALERT_TONE_DUTY 128        // 50% at 8-bit resolution
+
 enum AlertType {
     ALERT_NONE = 0,
     ALERT_LOW_WATER,
@@ -22,43 +28,94 @@ enum AlertType {
     ALERT_LOW_SOIL_MOISTURE,
     ALERT_GAS_DETECTED,
     ALERT_MOTION_DETECTED,
-    ALERT_OVERWEIGHT
+    ALERT_OVERWEIGHT,
+    ALERT_TYPE_COUNT
 };
 
 class AlertSystem {
 private:
+    // Condition tracking for one alert type
+    struct AlertState {
+        bool active;                // Raised and queued
+        bool oneShot;               // Raised by triggerAlert(), cleared after playing
+        bool condition;             // Last reported input state
+        unsigned long changedAt;    // When `condition` last changed
+        unsigned long raisedAt;     // When the alert was queued
+        bool hasThresholds;
+        float raiseAt;
+        float clearAt;
+        unsigned long debounce_ms;
+        unsigned long lastSounded;
+        bool sounded;
+    };
+
     uint8_t buzzerPin;
     bool muted;
-    AlertType currentAlert;
-    unsigned long lastAlertTime;
     unsigned long alertInterval;
-    
+    AlertState states[ALERT_TYPE_COUNT];
+
+    // Active alerts, highest severity first
+    AlertType queue[ALERT_TYPE_COUNT];
+    int queueLength;
+
+    // Pattern player
+    AlertType playing;
+    uint8_t phase;                  // Even = tone on, odd = tone off
+    unsigned long nextToggle;
+
     // Play different beep patterns
-    void beepShort();
-    void beepLong();
-    void beepPattern(int times, int duration);
+    void startPattern(AlertType type, unsigned long now);
+    void stopPattern();
+    void setTone(bool on);
+
+    // Queue management
+    void raise(AlertType type, bool oneShot);
+    void release(AlertType type);
 
 public:
     // Constructor
     AlertSystem(uint8_t buzzerPin, unsigned long alertInterval = 5000);
-    
+
     // Initialize the alert system
     void begin();
-    
-    // Trigger alert
+
+    // Configure hysteresis for reportValue(). raiseAt < clearAt is a low alarm
+    // (raised at or below raiseAt, cleared at or above clearAt), otherwise a
+    // high alarm. The new state must hold for debounce_ms before it is taken.
+    void setThresholds(AlertType type, float raiseAt, float clearAt, unsigned long debounce_ms = 0);
+
+    // Set debounce time for reportCondition()
+    void setDebounce(AlertType type, unsigned long debounce_ms);
+
+    // Feed a measurement checked against the configured thresholds
+    void reportValue(AlertType type, float value);
+
+    // Feed the current state of a boolean condition
+    void reportCondition(AlertType type, bool present);
+
+    // Trigger a one-shot alert (plays once, rate-limited by alertInterval)
     void triggerAlert(AlertType type);
-    
-    // Update alert (call in loop)
+
+    // Update alert (call in loop, never blocks)
     void update();
-    
+
     // Mute/unmute alerts
     void mute();
     void unmute();
     bool isMuted();
-    
-    // Get current alert type
+
+    // Get highest-severity active alert
     AlertType getCurrentAlert();
-    
+
+    // Check a single alert
+    bool isActive(AlertType type);
+
+    // Number of active alerts
+    int getActiveCount();
+
+    // Severity rank of an alert type (higher wins)
+    static uint8_t getSeverity(AlertType type);
+
     // Clear all alerts
     void clearAlerts();
 };
@@ -13,6 +13,29 @@
 #define CO2SENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+#include "MQCurve.h"
+
+#define CO2_SAMPLE_INTERVAL_MS 10  // Spacing between averaged samples
+
+// CO2 curve of the MQ135 and its load circuit (kOhm)
+#ifndef CO2_CURVE_A
+#define CO2_CURVE_A 110.47
+#define CO2_CURVE_B -2.862
+#endif
+#ifndef MQ135_RL
+#define MQ135_RL 10.0
+#define MQ135_RO 10.0
+#endif
+
+// Air quality classes by CO2, best first
+enum AirQuality : uint8_t {
+    AIR_EXCELLENT = 0,
+    AIR_GOOD,
+    AIR_FAIR,
+    AIR_POOR,
+    AIR_BAD
+};
 
 class CO2Sensor {
 private:
@@ -20,8 +43,17 @@ private:
     int rawValue;
     float co2PPM;
     int samples;
+    long sampleSum;
+    int sampleCount;
+    unsigned long nextSample_ms;
 
 public:
+    // ppm = A * (Rs/R0)^B, clamped to [400.0, 5000.0] ppm
+    static constexpr MQCurve CURVE = {CO2_CURVE_A, CO2_CURVE_B, MQ135_RL, MQ135_RO, 400.0f, 5000.0f};
+
+    // Concentration for a raw 12-bit ADC code (table lookup)
+    static float ppmFromRaw(int raw);
+
     // Constructor
     CO2Sensor(uint8_t analogPin, int samples = 10);
     
@@ -31,8 +63,22 @@ public:
     // Read CO2 concentration
     float readCO2();
     
+    // Non-blocking read: startRead(), then pollRead() until it returns true,
+    // then finishRead() computes the result
+    void startRead();
+    bool pollRead();
+    float finishRead();
+    
+    // Get CO2 concentration in ppm
+    float getCO2PPM();
+    
+    // Class boundaries (ppm) and names of getAirQuality()
+    static constexpr StatusScale<AirQuality, 4> AIR_QUALITY_SCALE = {
+        {800, 1000, 1500, 2000},
+        {"Excellent", "Good", "Fair", "Poor", "Bad"}};
+
     // Get air quality status
-    String getAirQuality();
+    AirQuality getAirQuality();
     
     // Check if CO2 is at dangerous level
     bool isDangerous();
@@ -41,4 +87,10 @@ public:
     int getRawValue();
 };
 
+static_assert(CO2Sensor::AIR_QUALITY_SCALE.valid(), "AIR_QUALITY_SCALE must ascend and name every class");
+
+inline const char* statusName(AirQuality status) {
+    return CO2Sensor::AIR_QUALITY_SCALE.name(status);
+}
+
 #endif
@@ -13,6 +13,29 @@
 #define COSENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+#include "MQCurve.h"
+
+#define CO_SAMPLE_INTERVAL_MS 10  // Spacing between averaged samples
+
+// CO curve of the MQ7 and its load circuit (kOhm)
+#ifndef CO_CURVE_A
+#define CO_CURVE_A 99.042
+#define CO_CURVE_B -1.518
+#endif
+#ifndef MQ7_RL
+#define MQ7_RL 10.0
+#define MQ7_RO 10.0
+#endif
+
+// CO exposure classes, safest first
+enum COStatus : uint8_t {
+    CO_SAFE = 0,
+    CO_ACCEPTABLE,
+    CO_CAUTION,
+    CO_DANGEROUS,
+    CO_LETHAL
+};
 
 class COSensor {
 private:
@@ -20,8 +43,17 @@ private:
     int rawValue;
     float coPPM;
     int samples;
+    long sampleSum;
+    int sampleCount;
+    unsigned long nextSample_ms;
 
 public:
+    // ppm = A * (Rs/R0)^B, clamped to [0.0, 1000.0] ppm
+    static constexpr MQCurve CURVE = {CO_CURVE_A, CO_CURVE_B, MQ7_RL, MQ7_RO, 0.0f, 1000.0f};
+
+    // Concentration for a raw 12-bit ADC code (table lookup)
+    static float ppmFromRaw(int raw);
+
     // Constructor
     COSensor(uint8_t analogPin, int samples = 10);
     
@@ -31,8 +63,22 @@ public:
     // Read CO concentration
     float readCO();
     
+    // Non-blocking read: startRead(), then pollRead() until it returns true,
+    // then finishRead() computes the result
+    void startRead();
+    bool pollRead();
+    float finishRead();
+    
+    // Get CO concentration in ppm
+    float getCOPPM();
+    
+    // Class boundaries (ppm) and names of getCOStatus()
+    static constexpr StatusScale<COStatus, 4> CO_SCALE = {
+        {9, 35, 100, 400},
+        {"Safe", "Acceptable", "Caution", "Dangerous", "LETHAL"}};
+
     // Get CO status
-    String getCOStatus();
+    COStatus getCOStatus();
     
     // Check if CO is at dangerous level
     bool isDangerous();
@@ -41,4 +87,10 @@ public:
     int getRawValue();
 };
 
+static_assert(COSensor::CO_SCALE.valid(), "CO_SCALE must ascend and name every class");
+
+inline const char* statusName(COStatus status) {
+    return COSensor::CO_SCALE.name(status);
+}
+
 #endif
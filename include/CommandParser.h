@@ -0,0 +1,228 @@
+/*
+ * CommandParser.h
+ * Streaming parser for the dashboard's remote sensor overrides
+ *
+ * Features:
+ * - Fed one byte at a time as it arrives, fixed buffers, no heap
+ * - Text frames: flat JSON objects, e.g. {"sensor":"soilMoisture","value":45.5}
+ *   (any key order, whitespace, unknown keys skipped), ended by '}'
+ * - Channel names are looked up through a perfect hash built at compile
+ *   time: one hash, one table load, one name compare
+ * - Binary frames: 0xA5, channel index, float32 value (little endian),
+ *   CRC-8; 7 bytes instead of about 40
+ * - Malformed input is dropped up to the next newline or frame start
+ */
+
+#ifndef COMMANDPARSER_H
+#define COMMANDPARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== CHANNELS ====================
+
+// Remote override channels; the order is the binary frame's channel index
+enum RemoteChannel : uint8_t {
+    REMOTE_SOIL_MOISTURE = 0,
+    REMOTE_SOIL_TEMP,
+    REMOTE_SOIL_PH,
+    REMOTE_LEAF_TEMP,
+    REMOTE_LEAF_WETNESS,
+    REMOTE_AIR_TEMP,
+    REMOTE_HUMIDITY,
+    REMOTE_LIGHT,
+    REMOTE_RAINFALL,
+    REMOTE_WIND_SPEED,
+    REMOTE_WIND_DIRECTION,
+    REMOTE_GAS,
+    REMOTE_CO2,
+    REMOTE_CO,
+    REMOTE_WATER_LEVEL,
+    REMOTE_WEIGHT,
+    REMOTE_CHANNEL_COUNT
+};
+
+struct RemoteChannelInfo {
+    const char* name;            // As sent by the dashboard
+    const char* label;           // For the confirmation message
+};
+
+constexpr RemoteChannelInfo REMOTE_CHANNELS[REMOTE_CHANNEL_COUNT] = {
+    {"soilMoisture", "Soil Moisture"},
+    {"soilTemp", "Soil Temp"},
+    {"soilPH", "Soil pH"},
+    {"leafTemp", "Leaf Temp"},
+    {"leafWetness", "Leaf Wetness"},
+    {"airTemp", "Air Temp"},
+    {"humidity", "Humidity"},
+    {"light", "Light"},
+    {"rainfall", "Rainfall"},
+    {"windSpeed", "Wind Speed"},
+    {"windDirection", "Wind Direction"},
+    {"gas", "Gas"},
+    {"co2", "CO2"},
+    {"co", "CO"},
+    {"waterLevel", "Water Level"},
+    {"weight", "Weight"},
+};
+
+// ==================== PERFECT HASH ====================
+#define REMOTE_HASH_BITS 5
+#define REMOTE_HASH_SLOTS (1 << REMOTE_HASH_BITS)
+#define REMOTE_HASH_SEED 49u         // Smallest odd multiplier without collisions
+#define REMOTE_NO_CHANNEL 0xFF
+
+// FNV-1a, one byte at a time so the parser can hash while reading
+constexpr uint32_t remoteHashStart() {
+    return 2166136261u;
+}
+
+constexpr uint32_t remoteHashStep(uint32_t hash, uint8_t c) {
+    return (hash ^ c) * 16777619u;
+}
+
+constexpr uint8_t remoteHashSlot(uint32_t hash) {
+    return (uint8_t)((uint32_t)(hash * REMOTE_HASH_SEED) >> (32 - REMOTE_HASH_BITS));
+}
+
+constexpr uint32_t remoteHashName(const char* name) {
+    uint32_t hash = remoteHashStart();
+    while (*name) hash = remoteHashStep(hash, (uint8_t)*name++);
+    return hash;
+}
+
+struct RemoteHashTable {
+    uint8_t channel[REMOTE_HASH_SLOTS];          // REMOTE_NO_CHANNEL if empty
+    bool perfect;                                // No two names share a slot
+};
+
+constexpr RemoteHashTable makeRemoteHashTable() {
+    RemoteHashTable table = {};
+    table.perfect = true;
+    for (int slot = 0; slot < REMOTE_HASH_SLOTS; slot++) table.channel[slot] = REMOTE_NO_CHANNEL;
+    for (int i = 0; i < REMOTE_CHANNEL_COUNT; i++) {
+        uint8_t slot = remoteHashSlot(remoteHashName(REMOTE_CHANNELS[i].name));
+        if (table.channel[slot] != REMOTE_NO_CHANNEL) table.perfect = false;
+        table.channel[slot] = (uint8_t)i;
+    }
+    return table;
+}
+
+constexpr RemoteHashTable REMOTE_HASH = makeRemoteHashTable();
+static_assert(REMOTE_HASH.perfect, "channel names collide, pick another REMOTE_HASH_SEED");
+
+// ==================== PARSER ====================
+#define COMMAND_SYNC 0xA5            // First byte of a binary frame
+#define COMMAND_BINARY_LENGTH 7
+#define COMMAND_NAME_MAX 15          // Longest channel name is 13
+#define COMMAND_KEY_MAX 7            // "sensor"
+
+// What a byte completed
+enum CommandStatus : uint8_t {
+    COMMAND_PENDING = 0,             // Nothing yet
+    COMMAND_READY,                   // getCommand() holds a new command
+    COMMAND_UNKNOWN,                 // Well-formed, unknown channel (getName())
+    COMMAND_MALFORMED                // Frame dropped
+};
+
+struct RemoteCommand {
+    uint8_t channel;                 // RemoteChannel
+    float value;
+};
+
+struct CommandParserStats {
+    unsigned long bytes;
+    unsigned long commands;
+    unsigned long binaryCommands;
+    unsigned long unknown;
+    unsigned long malformed;
+};
+
+// CRC-8 (polynomial 0x07) of a binary frame's channel and value bytes
+uint8_t commandCrc8(const uint8_t* data, size_t length);
+
+// Fill a 7-byte binary frame
+void encodeBinaryCommand(uint8_t channel, float value, uint8_t* frame);
+
+class CommandParser {
+private:
+    enum State : uint8_t {
+        WAIT_FRAME,                  // Between frames: '{' or COMMAND_SYNC
+        WAIT_KEY,                    // '"' of a key, or '}'
+        IN_KEY,
+        WAIT_COLON,
+        WAIT_VALUE,
+        IN_STRING,
+        IN_NUMBER,
+        IN_LITERAL,                  // true/false/null of an ignored key
+        WAIT_SEPARATOR,              // ',' or '}'
+        IN_BINARY,
+        SKIP_LINE                    // After an error, up to '\n'
+    };
+
+    enum Key : uint8_t { KEY_OTHER, KEY_SENSOR, KEY_VALUE };
+
+    // Number being read: mantissa digits, decimal exponent, sign
+    struct NumberState {
+        uint32_t mantissa;
+        int16_t exponent;
+        int16_t exponentValue;
+        uint8_t digits;
+        bool negative;
+        bool fraction;
+        bool inExponent;
+        bool exponentNegative;
+        bool valid;
+    };
+
+    State state;
+    Key key;
+    char keyText[COMMAND_KEY_MAX + 1];
+    uint8_t keyLength;
+    char name[COMMAND_NAME_MAX + 1];
+    uint8_t nameLength;
+    uint32_t nameHash;
+    bool haveName;
+    bool haveValue;
+    float value;
+    NumberState number;
+    uint8_t binary[COMMAND_BINARY_LENGTH];
+    uint8_t binaryLength;
+    RemoteCommand command;
+    CommandParserStats stats;
+
+    void startFrame();
+    CommandStatus fail(bool skipLine);
+    CommandStatus endFrame();
+    CommandStatus endBinary();
+    void startNumber(char c);
+    bool numberByte(char c);
+    bool endNumber();
+    CommandStatus afterValue(char c);
+    static bool isSpace(char c);
+
+public:
+    // Constructor
+    CommandParser();
+
+    // Consume one received byte
+    CommandStatus feed(uint8_t c);
+
+    // Last complete command (valid after COMMAND_READY)
+    const RemoteCommand& getCommand();
+
+    // Channel name of the last text frame (for COMMAND_UNKNOWN)
+    const char* getName();
+
+    // Channel for a name, REMOTE_NO_CHANNEL if unknown
+    static uint8_t lookup(const char* name, size_t length, uint32_t hash);
+
+    // Drop any partial frame
+    void reset();
+
+    // Statistics
+    const CommandParserStats& getStats();
+    void printStats();
+};
+
+#endif
@@ -13,17 +13,41 @@
 #define DHTSENSOR_H
 
 #include <Arduino.h>
-#include <DHT.h>
+#include "StatusScale.h"
+#include "HAL.h"
 
-#define DHT_TYPE DHT22
+#define DHT_TYPE 22  // DHT22
+#define DHT_STARTUP_MS 2000  // DHT22 needs time to stabilize after power-up
+
+// Air temperature classes, coldest first
+enum AirTempStatus : uint8_t {
+    AIR_TEMP_FREEZING = 0,
+    AIR_TEMP_COLD,
+    AIR_TEMP_COOL,
+    AIR_TEMP_COMFORTABLE,
+    AIR_TEMP_WARM,
+    AIR_TEMP_HOT,
+    AIR_TEMP_VERY_HOT
+};
+
+// Relative humidity classes, driest first
+enum HumidityStatus : uint8_t {
+    HUMIDITY_VERY_DRY = 0,
+    HUMIDITY_DRY,
+    HUMIDITY_COMFORTABLE,
+    HUMIDITY_HUMID,
+    HUMIDITY_VERY_HUMID,
+    HUMIDITY_EXTREMELY_HUMID
+};
 
 class DHTSensor {
 private:
     uint8_t pin;
-    DHT* dht;
+    HalHumiditySensor* dht;
     float temperature;
     float humidity;
     bool lastReadSuccess;
+    unsigned long readyTime;
 
 public:
     // Constructor
@@ -38,17 +62,36 @@ public:
     // Read temperature and humidity from sensor
     bool readSensor();
     
+    // True once the start-up settling time has passed
+    bool isReady();
+    
+    // Non-blocking read: pollRead() returns true once the sensor has settled,
+    // finishRead() performs the read
+    void startRead();
+    bool pollRead();
+    bool finishRead();
+    
     // Get temperature in Celsius
     float getTemperature();
     
     // Get humidity percentage
     float getHumidity();
     
+    // Class boundaries (C) and names of getTemperatureStatus()
+    static constexpr StatusScale<AirTempStatus, 6> TEMPERATURE_SCALE = {
+        {0, 10, 20, 25, 30, 35},
+        {"Freezing", "Cold", "Cool", "Comfortable", "Warm", "Hot", "Very Hot"}};
+
     // Get temperature status
-    String getTemperatureStatus();
+    AirTempStatus getTemperatureStatus();
     
+    // Class boundaries (%) and names of getHumidityStatus()
+    static constexpr StatusScale<HumidityStatus, 5> HUMIDITY_SCALE = {
+        {20, 30, 50, 70, 85},
+        {"Very Dry", "Dry", "Comfortable", "Humid", "Very Humid", "Extremely Humid"}};
+
     // Get humidity status
-    String getHumidityStatus();
+    HumidityStatus getHumidityStatus();
     
     // Check if last reading was successful
     bool isReadingValid();
@@ -57,4 +100,16 @@ public:
     float getHeatIndex();
 };
 
+static_assert(DHTSensor::TEMPERATURE_SCALE.valid(), "TEMPERATURE_SCALE must ascend and name every class");
+
+inline const char* statusName(AirTempStatus status) {
+    return DHTSensor::TEMPERATURE_SCALE.name(status);
+}
+
+static_assert(DHTSensor::HUMIDITY_SCALE.valid(), "HUMIDITY_SCALE must ascend and name every class");
+
+inline const char* statusName(HumidityStatus status) {
+    return DHTSensor::HUMIDITY_SCALE.name(status);
+}
+
 #endif
@@ -13,6 +13,29 @@
 #define GASSENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+#include "MQCurve.h"
+
+#define GAS_SAMPLE_INTERVAL_MS 2  // Spacing between averaged samples
+
+// Smoke/LPG curve of the MQ2 and its load circuit (kOhm)
+#ifndef GAS_CURVE_A
+#define GAS_CURVE_A 116.6020682
+#define GAS_CURVE_B -2.769034857
+#endif
+#ifndef MQ2_RL
+#define MQ2_RL 10.0
+#define MQ2_RO 10.0
+#endif
+
+// Combustible gas classes, cleanest first
+enum GasStatus : uint8_t {
+    GAS_CLEAN_AIR = 0,
+    GAS_SLIGHT,
+    GAS_MODERATE,
+    GAS_HIGH,
+    GAS_DANGEROUS
+};
 
 class GasSensor {
 private:
@@ -20,8 +43,17 @@ private:
     int rawValue;
     float gasPPM;
     int samples;
+    long sampleSum;
+    int sampleCount;
+    unsigned long nextSample_ms;
 
 public:
+    // ppm = A * (Rs/R0)^B, clamped to [0.0, 10000.0] ppm
+    static constexpr MQCurve CURVE = {GAS_CURVE_A, GAS_CURVE_B, MQ2_RL, MQ2_RO, 0.0f, 10000.0f};
+
+    // Concentration for a raw 12-bit ADC code (table lookup)
+    static float ppmFromRaw(int raw);
+
     // Constructor
     GasSensor(uint8_t analogPin, int samples = 10);
     
@@ -31,17 +63,34 @@ public:
     // Read gas concentration
     float readGas();
     
+    // Non-blocking read: startRead(), then pollRead() until it returns true,
+    // then finishRead() computes the result
+    void startRead();
+    bool pollRead();
+    float finishRead();
+    
     // Get gas concentration in ppm
     float getGasPPM();
     
     // Get raw ADC value
     int getRawValue();
     
+    // Class boundaries (ppm) and names of getGasStatus()
+    static constexpr StatusScale<GasStatus, 4> GAS_SCALE = {
+        {300, 1000, 3000, 5000},
+        {"Clean Air", "Slight Gas", "Moderate Gas", "High Gas", "DANGEROUS!"}};
+
     // Get gas status
-    String getGasStatus();
+    GasStatus getGasStatus();
     
     // Check if gas level is dangerous
     bool isDangerous();
 };
 
+static_assert(GasSensor::GAS_SCALE.valid(), "GAS_SCALE must ascend and name every class");
+
+inline const char* statusName(GasStatus status) {
+    return GasSensor::GAS_SCALE.name(status);
+}
+
 #endif
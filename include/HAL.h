@@ -0,0 +1,292 @@
+/*
+ * HAL.h
+ * Hardware Abstraction Layer for the sensor drivers
+ *
+ * Features:
+ * - ADC, GPIO, pulse timer, clock, periodic timer and PWM tone interfaces
+ * - Continuous (DMA) ADC scanning of a pin set in the background
+ * - Hardware pulse counter (PCNT) with glitch filter and edge-period capture
+ * - RTC clock and retained memory that survive deep sleep and resets
+ * - I2C bus, OneWire temperature bus, DHT and HX711 device interfaces
+ * - Console UART transmit queue that never blocks the caller
+ * - Input observer that sees every value the drivers read (trace recording)
+ * - ESP32 backend (HAL_ESP32.cpp) used when building with the Arduino framework
+ * - Host backend (HAL_Host.cpp) with a virtual clock and scripted input
+ *   signals for the PlatformIO `native` environment (see HostHAL.h)
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+// Value reported by a temperature bus when the probe does not answer
+#define HAL_TEMP_DISCONNECTED -127.0f
+
+// Kinds of input value passed to a HalInputObserver, with their unit
+enum HalInputKind : uint8_t {
+    HAL_INPUT_ANALOG = 1,        // ADC code, one-shot or scanned
+    HAL_INPUT_DIGITAL,           // Level (0/1)
+    HAL_INPUT_PULSE,             // Pulse width (us), 0 on timeout
+    HAL_INPUT_PROBE_TEMP,        // DS18B20 (1/16 °C, the probe's resolution)
+    HAL_INPUT_AIR_TEMP,          // DHT temperature (0.1 °C)
+    HAL_INPUT_HUMIDITY,          // DHT humidity (0.1 %)
+    HAL_INPUT_LOAD_CELL          // HX711 raw counts
+};
+
+#define HAL_INPUT_PROBE_SCALE 16.0f
+#define HAL_INPUT_DHT_SCALE 10.0f
+#define HAL_INPUT_INVALID INT32_MIN  // Failed read (NaN)
+
+// Fixed-point form of a float reading for observers
+inline int32_t halInputFixed(float value, float scale) {
+    return isnan(value) ? HAL_INPUT_INVALID : (int32_t)lroundf(value * scale);
+}
+
+// Storage for variables that must survive deep sleep and software resets
+// (RTC slow memory on the ESP32). It is never initialized, so users
+// validate it (magic value, checksum) before trusting the contents.
+#ifdef ARDUINO
+#include <esp_attr.h>
+#define HAL_RETAINED RTC_NOINIT_ATTR
+#else
+#define HAL_RETAINED
+#endif
+
+// Analog-to-digital converter
+class HalAdc {
+public:
+    virtual ~HalAdc() {}
+
+    // Set conversion width in bits (12 = 0-4095)
+    virtual void setResolution(uint8_t bits) = 0;
+
+    // One-shot conversion of an analog pin
+    virtual int read(uint8_t pin) = 0;
+};
+
+// One conversion delivered by the continuous ADC scanner
+struct HalAdcSample {
+    uint8_t pin;
+    uint16_t value;          // 12-bit
+};
+
+// Continuous ADC acquisition: the converter scans a pin set round-robin at
+// a fixed total rate and DMA fills a buffer that read() drains. Conversions
+// not drained in time are lost (counted as overruns).
+class HalAdcScanner {
+public:
+    virtual ~HalAdcScanner() {}
+
+    // True if the pin can be scanned (on the ESP32 only ADC1 pins can)
+    virtual bool supportsPin(uint8_t pin) = 0;
+
+    // Start scanning; sampleRate_hz is the total over all pins
+    virtual bool begin(const uint8_t* pins, uint8_t count, uint32_t sampleRate_hz) = 0;
+    virtual void end() = 0;
+
+    // Copy up to `max` buffered conversions, oldest first. Never blocks.
+    virtual size_t read(HalAdcSample* samples, size_t max) = 0;
+
+    // Times the buffer overflowed before it was drained
+    virtual uint32_t getOverruns() = 0;
+};
+
+// Digital I/O and edge interrupts
+class HalGpio {
+public:
+    virtual ~HalGpio() {}
+
+    virtual void setMode(uint8_t pin, uint8_t mode) = 0;
+    virtual int read(uint8_t pin) = 0;
+    virtual void write(uint8_t pin, uint8_t value) = 0;
+
+    // Attach an edge interrupt (mode: RISING, FALLING or CHANGE)
+    virtual void attachInterrupt(uint8_t pin, void (*handler)(), int mode) = 0;
+    virtual void detachInterrupt(uint8_t pin) = 0;
+};
+
+// Pulse width measurement (pulseIn)
+class HalPulseTimer {
+public:
+    virtual ~HalPulseTimer() {}
+
+    // Width in microseconds of the next pulse at `state`, 0 on timeout
+    virtual unsigned long measurePulse(uint8_t pin, uint8_t state, unsigned long timeout_us) = 0;
+
+    // Non-blocking capture: arm once, then poll readCapture() until it
+    // returns true (width stored in width_us). The caller owns the timeout.
+    virtual void startCapture(uint8_t pin, uint8_t state) = 0;
+    virtual bool readCapture(uint8_t pin, unsigned long& width_us) = 0;
+    virtual void stopCapture(uint8_t pin) = 0;
+};
+
+// Hardware edge counter (PCNT on the ESP32). Counting needs no CPU; the
+// optional period capture timestamps each counted edge in an interrupt and
+// is meant for slow signals only.
+class HalPulseCounter {
+public:
+    virtual ~HalPulseCounter() {}
+
+    // Count `edge` (RISING, FALLING or CHANGE) transitions on `pin`;
+    // pulses shorter than filter_ns are ignored
+    virtual bool begin(uint8_t unit, uint8_t pin, int edge, uint32_t filter_ns) = 0;
+    virtual void end(uint8_t unit) = 0;
+
+    // Edges since the previous call. The hardware counter is never
+    // cleared, so no edge is lost between the read and the reset.
+    virtual uint32_t takeCount(uint8_t unit) = 0;
+
+    // Period capture: time between the last two counted edges and the
+    // timestamp (micros) of the last one. False until two edges were seen.
+    virtual void enableCapture(uint8_t unit, bool enable) = 0;
+    virtual bool readPeriod(uint8_t unit, unsigned long& period_us, unsigned long& lastEdge_us) = 0;
+};
+
+// Time base
+class HalClock {
+public:
+    virtual ~HalClock() {}
+
+    virtual unsigned long millis() = 0;
+    virtual unsigned long micros() = 0;
+    virtual void delay(unsigned long ms) = 0;
+    virtual void delayMicroseconds(unsigned long us) = 0;
+
+    // Seconds on the RTC timer, which keeps counting through deep sleep
+    // and software resets (not through power loss)
+    virtual uint32_t rtcSeconds() = 0;
+};
+
+// Periodic hardware timer with an interrupt handler
+class HalTimer {
+public:
+    virtual ~HalTimer() {}
+
+    virtual bool start(uint8_t timerId, uint64_t period_us, void (*handler)()) = 0;
+    virtual void setPeriod(uint8_t timerId, uint64_t period_us) = 0;
+    virtual void stop(uint8_t timerId) = 0;
+};
+
+// PWM tone generator (buzzer)
+class HalTone {
+public:
+    virtual ~HalTone() {}
+
+    virtual void setup(uint8_t channel, uint32_t frequency, uint8_t resolutionBits) = 0;
+    virtual void attach(uint8_t pin, uint8_t channel) = 0;
+    virtual void setFrequency(uint8_t channel, uint32_t frequency) = 0;
+    virtual void setDuty(uint8_t channel, uint32_t duty) = 0;
+};
+
+// I2C master
+class HalI2C {
+public:
+    virtual ~HalI2C() {}
+
+    virtual void begin() = 0;
+
+    // Write a block to a 7-bit address, returns 0 on success (Wire convention)
+    virtual uint8_t write(uint8_t address, const uint8_t* data, size_t length) = 0;
+};
+
+// Console UART (Serial) transmit side. Bytes go into the driver's transmit
+// buffer and the hardware drains it in the background.
+class HalUart {
+public:
+    virtual ~HalUart() {}
+
+    // Open the port with a transmit buffer of txBuffer bytes
+    virtual void begin(unsigned long baud, size_t txBuffer) = 0;
+
+    // Bytes the transmit buffer can take right now
+    virtual size_t availableForWrite() = 0;
+
+    // Queue up to length bytes without waiting, returns the number taken
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+};
+
+// DS18B20 probes on a OneWire bus
+class HalTemperatureBus {
+public:
+    virtual ~HalTemperatureBus() {}
+
+    // Returns the number of probes found
+    virtual int begin() = 0;
+    virtual int getDeviceCount() = 0;
+
+    // Blocks for the conversion time unless waiting is disabled, in which
+    // case poll isConversionComplete() before reading
+    virtual void setWaitForConversion(bool wait) = 0;
+    virtual void requestTemperatures() = 0;
+    virtual bool isConversionComplete() = 0;
+
+    // Temperature in Celsius, HAL_TEMP_DISCONNECTED on error
+    virtual float getTempC(uint8_t index) = 0;
+};
+
+// DHT temperature/humidity sensor
+class HalHumiditySensor {
+public:
+    virtual ~HalHumiditySensor() {}
+
+    virtual void begin() = 0;
+
+    // Both return NAN on a failed read
+    virtual float readTemperature() = 0;
+    virtual float readHumidity() = 0;
+    virtual float computeHeatIndex(float temperature, float humidity) = 0;
+};
+
+// HX711 load cell amplifier
+class HalLoadCell {
+public:
+    virtual ~HalLoadCell() {}
+
+    virtual void begin() = 0;
+    virtual bool isReady() = 0;
+    virtual bool waitReady(unsigned long timeout_ms) = 0;
+    virtual void setScale(float scale) = 0;
+    virtual void tare() = 0;
+
+    // Averaged reading in calibrated units
+    virtual float getUnits(uint8_t times) = 0;
+};
+
+// Receives every input value the backend hands to a driver, in the context
+// of the read. Edges counted in hardware or seen only by an interrupt
+// handler (pulse counter, rain gauge) do not pass through it on the ESP32.
+class HalInputObserver {
+public:
+    virtual ~HalInputObserver() {}
+
+    virtual void onInput(HalInputKind kind, uint8_t pin, int32_t value) = 0;
+};
+
+// Backend access. Exactly one backend is linked: HAL_ESP32.cpp when ARDUINO
+// is defined, HAL_Host.cpp otherwise.
+class HAL {
+public:
+    static HalAdc& adc();
+    static HalAdcScanner& adcScanner();
+    static HalGpio& gpio();
+    static HalPulseTimer& pulse();
+    static HalPulseCounter& counter();
+    static HalClock& clock();
+    static HalTimer& timer();
+    static HalTone& tone();
+    static HalI2C& i2c();
+    static HalUart& uart();
+
+    // Install an input observer, nullptr to remove it
+    static void setInputObserver(HalInputObserver* observer);
+
+    // Device factories, the caller owns the returned object
+    static HalTemperatureBus* openTemperatureBus(uint8_t pin);
+    static HalHumiditySensor* openHumiditySensor(uint8_t pin, uint8_t type);
+    static HalLoadCell* openLoadCell(uint8_t dataPin, uint8_t clockPin);
+};
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * HostHAL.h
+ * Control interface of the host (native) HAL backend
+ *
+ * Features:
+ * - Virtual clock: delays and blocking reads advance simulated time instantly
+ * - Scripted analog, digital and pulse-width input signals per pin
+ * - Replay of recorded analog sample streams
+ * - Continuous ADC scanner fed from the same analog signals
+ * - Pin-to-pin wiring so simulator outputs can drive sensor inputs
+ * - Pulse counter units with glitch filter and period capture on digital edges
+ * - Scripted DS18B20, DHT22 and HX711 devices
+ * - Per-pin conversion counters and per-address I2C byte counters
+ * - Console UART whose transmit buffer drains at the configured baud rate,
+ *   with the bytes kept for the host program to decode
+ */
+
+#ifndef HOSTHAL_H
+#define HOSTHAL_H
+
+#ifndef ARDUINO
+
+#include "HAL.h"
+#include <functional>
+#include <vector>
+
+// Simulated cost of blocking operations (microseconds)
+#define HOST_ADC_CONVERSION_US 10
+#define HOST_ADC_DMA_BUFFER 1024            // Conversions the scan buffer holds
+#define HOST_DS18B20_CONVERSION_US 750000   // 12-bit conversion
+#define HOST_DHT_READ_US 5000
+#define HOST_HX711_SAMPLE_US 100000         // 10 SPS
+#define HOST_I2C_BYTE_US 90                 // 100 kHz, 9 clocks per byte
+
+class HostHAL {
+public:
+    typedef std::function<int(uint64_t now_us)> AnalogSource;
+    typedef std::function<unsigned long(uint64_t now_us)> PulseSource;
+    typedef std::function<void(const uint8_t* data, size_t length)> I2CDevice;
+
+    // Restore power-on state (time 0, all signals cleared)
+    static void reset();
+
+    // Virtual clock
+    static uint64_t nowMicros();
+    static void advanceMicros(uint64_t us);
+    static void advanceMillis(unsigned long ms);
+
+    // RTC time (HalClock::rtcSeconds), counts with the virtual clock
+    static void setRtcSeconds(uint32_t seconds);
+
+    // Analog inputs
+    static void setAnalog(uint8_t pin, int value);
+    static void setAnalogSource(uint8_t pin, AnalogSource source);
+    static uint64_t getAnalogReadCount(uint8_t pin);
+
+    // Replay recorded conversions on an analog pin, looping at the end.
+    // The text file form holds one 12-bit value per line.
+    static void setAnalogRecording(uint8_t pin, const std::vector<uint16_t>& samples, uint32_t sampleRate_hz);
+    static bool loadAnalogRecording(uint8_t pin, const char* path, uint32_t sampleRate_hz);
+
+    // Conversions delivered by the continuous scanner
+    static uint64_t getAnalogScanCount(uint8_t pin);
+
+    // Digital pins (setDigital fires attached interrupts and feeds the
+    // pulse counter units on edges)
+    static void setDigital(uint8_t pin, int level);
+    static int getDigital(uint8_t pin);
+    static void connectPins(uint8_t outputPin, uint8_t inputPin);
+
+    // Echo/pulse inputs, width 0 means no pulse (timeout)
+    static void setPulseWidth(uint8_t pin, unsigned long width_us);
+    static void setPulseSource(uint8_t pin, PulseSource source);
+
+    // Scripted devices
+    static void setTemperatureProbe(uint8_t pin, int count, float tempC);
+    static void setHumidity(uint8_t pin, float temperature, float humidity);
+    static void setLoadCell(uint8_t dataPin, long rawCounts, bool ready = true);
+
+    // I2C bus
+    static void attachI2CDevice(uint8_t address, I2CDevice device);
+    static uint64_t getI2CBytesWritten(uint8_t address);
+
+    // Console UART (HalUart): append the bytes written since the last call
+    static void takeUartOutput(std::vector<uint8_t>& bytes);
+    static uint64_t getUartBytesWritten();
+
+    // Bytes still waiting in the transmit buffer
+    static size_t getUartQueued();
+
+    // PWM tone output
+    static uint32_t getToneFrequency(uint8_t channel);
+    static uint32_t getToneDuty(uint8_t channel);
+};
+
+#endif // ARDUINO
+
+#endif
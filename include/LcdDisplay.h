@@ -0,0 +1,91 @@
+/*
+ * LcdDisplay.h
+ * 20x4 HD44780 character LCD on a PCF8574 I2C backpack, drawn through a
+ * shadow framebuffer
+ *
+ * Features:
+ * - Drawing (clear, setCursor, print) only touches RAM; flush() sends the
+ *   cells that differ from what the panel shows
+ * - The shadow copy and the diff are the LcdFramebuffer the gateway uses
+ *   (esp32_nodes/common): dirty cells go out as runs in DDRAM order, runs
+ *   one clean cell apart are merged, and the cursor only moves when a run
+ *   starts elsewhere. LcdDisplay is its LcdSink on a PCF8574 backpack.
+ * - Four expander bytes per LCD byte, many per I2C transaction (the usual
+ *   Arduino driver sends one byte per transaction, six per LCD byte)
+ * - Text is clipped at the row end instead of wrapping into another row
+ * - Bus traffic counters for comparing refresh strategies
+ */
+
+#ifndef LCDDISPLAY_H
+#define LCDDISPLAY_H
+
+#include <Arduino.h>
+#include "HAL.h"
+#include "lcd_framebuffer.h"
+
+#define LCD_COLUMNS LCD_FB_COLUMNS
+#define LCD_ROWS LCD_FB_ROWS
+#define LCD_I2C_CHUNK 120              // Expander bytes per transaction (Wire buffer: 128)
+
+struct LcdStats {
+    unsigned long flushes;
+    unsigned long cellsSent;           // Characters written to the panel
+    unsigned long cursorMoves;         // Set-DDRAM-address commands
+    unsigned long transactions;        // I2C transactions
+    unsigned long busBytes;            // Expander bytes plus one address byte per transaction
+    unsigned long lastBusBytes;        // ... of the latest flush
+};
+
+class LcdDisplay : public LcdSink {
+private:
+    uint8_t address;
+    uint8_t backlight;                 // Expander bit for the backlight
+    LcdFramebuffer framebuffer;
+    uint8_t lastMode;                  // RS of the previous expander byte
+    uint8_t chunk[LCD_I2C_CHUNK];
+    size_t chunkLength;
+    LcdStats stats;
+
+    void pushExpander(uint8_t value);
+    void sendByte(uint8_t value, uint8_t mode);
+    void sendNibble(uint8_t value);
+    void sendChunk();
+
+public:
+    // Constructor; 0x27 is the usual PCF8574 backpack address
+    LcdDisplay(uint8_t address = 0x27);
+
+    // Initialise the controller in 4-bit mode and blank the panel
+    void begin();
+    void setBacklight(bool on);
+
+    // Drawing into the framebuffer (no bus traffic)
+    void clear();
+    void setCursor(uint8_t column, uint8_t row);
+    void print(char c);
+    void print(const char* text);
+    void print(const String& text);
+    void print(float value, uint8_t decimals = 2);
+    void print(long value);
+    void print(int value);
+    void print(unsigned long value);
+
+    // Send the cells that changed since the last flush
+    void flush();
+
+    // Resend every cell on the next flush (panel content unknown)
+    void invalidate();
+
+    // Character the framebuffer holds at a position
+    char getCell(uint8_t column, uint8_t row);
+
+    // LcdSink: the framebuffer's changes as HD44780 commands and characters
+    void setAddress(uint8_t address) override;
+    void write(uint8_t c) override;
+
+    // Statistics
+    const LcdStats& getStats();
+    void printStats();
+};
+
+#endif
@@ -11,6 +11,16 @@
 #define LEAF_TEMPERATURE_SENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+
+// Leaf temperature classes, coldest first
+enum LeafTempStatus : uint8_t {
+    LEAF_TEMP_TOO_COLD = 0,
+    LEAF_TEMP_COLD,
+    LEAF_TEMP_OPTIMAL,
+    LEAF_TEMP_WARM,
+    LEAF_TEMP_TOO_HOT
+};
 
 class LeafTemperatureSensor {
 private:
@@ -69,11 +79,22 @@ public:
      */
     bool isConnected();
 
+    // Class boundaries (C) and names of getTemperatureStatus()
+    static constexpr StatusScale<LeafTempStatus, 4> TEMPERATURE_SCALE = {
+        {10, 20, 30, 40},
+        {"Too Cold", "Cold", "Optimal", "Warm", "Too Hot"}};
+
     /**
-     * @brief Get leaf temperature status as text
-     * @return Status string based on leaf temperature
+     * @brief Get leaf temperature status
+     * @return Status class based on leaf temperature
      */
-    String getTemperatureStatus();
+    LeafTempStatus getTemperatureStatus();
 };
 
+static_assert(LeafTemperatureSensor::TEMPERATURE_SCALE.valid(), "TEMPERATURE_SCALE must ascend and name every class");
+
+inline const char* statusName(LeafTempStatus status) {
+    return LeafTemperatureSensor::TEMPERATURE_SCALE.name(status);
+}
+
 #endif // LEAF_TEMPERATURE_SENSOR_H
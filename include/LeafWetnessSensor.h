@@ -11,6 +11,15 @@
 #define LEAF_WETNESS_SENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+
+// Leaf wetness classes, driest first
+enum WetnessStatus : uint8_t {
+    WETNESS_DRY = 0,
+    WETNESS_SLIGHTLY_WET,
+    WETNESS_WET,
+    WETNESS_VERY_WET
+};
 
 class LeafWetnessSensor {
 private:
@@ -52,11 +61,16 @@ public:
      */
     int getRawValue();
 
+    // Class boundaries (%) and names of getWetnessStatus()
+    static constexpr StatusScale<WetnessStatus, 3> WETNESS_SCALE = {
+        {20, 50, 80},
+        {"Dry", "Slightly Wet", "Wet", "Very Wet"}};
+
     /**
-     * @brief Get wetness status as text
-     * @return Status string (Dry, Slightly Wet, Wet, Very Wet)
+     * @brief Get wetness status
+     * @return Status class (Dry, Slightly Wet, Wet, Very Wet)
      */
-    String getWetnessStatus();
+    WetnessStatus getWetnessStatus();
 
     /**
      * @brief Calibrate the sensor for dry conditions
@@ -77,4 +91,10 @@ public:
     bool isWet();
 };
 
+static_assert(LeafWetnessSensor::WETNESS_SCALE.valid(), "WETNESS_SCALE must ascend and name every class");
+
+inline const char* statusName(WetnessStatus status) {
+    return LeafWetnessSensor::WETNESS_SCALE.name(status);
+}
+
 #endif // LEAF_WETNESS_SENSOR_H
@@ -13,6 +13,18 @@
 #define LIGHTSENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+
+// Light classes, darkest first
+enum LightStatus : uint8_t {
+    LIGHT_VERY_DARK = 0,
+    LIGHT_DARK,
+    LIGHT_DIM,
+    LIGHT_MODERATE,
+    LIGHT_BRIGHT,
+    LIGHT_VERY_BRIGHT,
+    LIGHT_INTENSE
+};
 
 class LightSensor {
 private:
@@ -38,8 +50,13 @@ public:
     // Get raw ADC value
     int getRawValue();
     
+    // Class boundaries (%) and names of getLightStatus()
+    static constexpr StatusScale<LightStatus, 6> LIGHT_SCALE = {
+        {10, 25, 40, 60, 75, 90},
+        {"Very Dark", "Dark", "Dim", "Moderate", "Bright", "Very Bright", "Intense"}};
+
     // Get light condition status
-    String getLightStatus();
+    LightStatus getLightStatus();
     
     // Calibration methods
     void calibrateDark(int value);
@@ -49,4 +66,10 @@ public:
     bool isDark();
 };
 
+static_assert(LightSensor::LIGHT_SCALE.valid(), "LIGHT_SCALE must ascend and name every class");
+
+inline const char* statusName(LightStatus status) {
+    return LightSensor::LIGHT_SCALE.name(status);
+}
+
 #endif
@@ -0,0 +1,104 @@
+/*
+ * MQCurve.h
+ * Compile-time ppm lookup tables for MQ-series gas sensors
+ *
+ * Features:
+ * - Rs/R0 power-law conversion: ppm = A * (Rs/R0)^B
+ * - Rs from the load divider: Rs = RL * (4095 - raw) / raw
+ * - One table entry per 12-bit ADC code, built by the compiler
+ *   (constexpr log/exp), so a conversion is a single table load
+ * - libm reference conversion for verification and benchmarking
+ */
+
+#ifndef MQCURVE_H
+#define MQCURVE_H
+
+#include <math.h>
+
+#define MQ_ADC_CODES 4096
+
+// Datasheet curve and circuit of one MQ sensor
+struct MQCurve {
+    double a;                    // ppm at Rs/R0 = 1
+    double b;                    // Slope of the log-log curve
+    double loadResistance;       // RL (kOhm)
+    double cleanAirResistance;   // R0 (kOhm)
+    float minPPM;                // Result clamp
+    float maxPPM;
+};
+
+struct MQTable {
+    float ppm[MQ_ADC_CODES];
+
+    // Concentration for a raw ADC code (clamped to 0-4095)
+    constexpr float operator[](int raw) const {
+        return ppm[raw < 0 ? 0 : (raw >= MQ_ADC_CODES ? MQ_ADC_CODES - 1 : raw)];
+    }
+};
+
+// Natural logarithm for constant evaluation (x > 0)
+constexpr double mqLog(double x) {
+    // x = m * 2^k with m in [0.75, 1.5)
+    int k = 0;
+    while (x >= 1.5) { x /= 2.0; k++; }
+    while (x < 0.75) { x *= 2.0; k--; }
+
+    // log(m) = 2 * atanh((m - 1) / (m + 1)), |z| <= 0.2
+    double z = (x - 1.0) / (x + 1.0);
+    double z2 = z * z;
+    double term = z;
+    double sum = 0.0;
+    for (int n = 1; n < 40; n += 2) {
+        sum += term / n;
+        term *= z2;
+    }
+    return 2.0 * sum + k * 0.69314718055994530942;
+}
+
+// Exponential for constant evaluation
+constexpr double mqExp(double x) {
+    // x = k * ln2 + r with |r| <= ln2 / 2
+    int k = (int)(x / 0.69314718055994530942 + (x < 0 ? -0.5 : 0.5));
+    double r = x - k * 0.69314718055994530942;
+
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 24; n++) {
+        term *= r / n;
+        sum += term;
+    }
+    for (; k > 0; k--) sum *= 2.0;
+    for (; k < 0; k++) sum /= 2.0;
+    return sum;
+}
+
+constexpr float mqClamp(double ppm, const MQCurve& curve) {
+    return ppm < curve.minPPM ? curve.minPPM : (ppm > curve.maxPPM ? curve.maxPPM : (float)ppm);
+}
+
+// Build the table of a curve; use it to initialize a constexpr variable
+// so the work happens at compile time
+constexpr MQTable makeMQTable(const MQCurve& curve) {
+    MQTable table = {};
+
+    // Code 0: no current through RL, Rs is infinite (cleanest air)
+    table.ppm[0] = curve.b < 0 ? curve.minPPM : curve.maxPPM;
+    for (int raw = 1; raw < MQ_ADC_CODES - 1; raw++) {
+        double ratio = curve.loadResistance * (MQ_ADC_CODES - 1 - raw) / raw / curve.cleanAirResistance;
+        table.ppm[raw] = mqClamp(mqExp(mqLog(curve.a) + curve.b * mqLog(ratio)), curve);
+    }
+    // Full scale: Rs is zero
+    table.ppm[MQ_ADC_CODES - 1] = curve.b < 0 ? curve.maxPPM : curve.minPPM;
+    return table;
+}
+
+// Same conversion at run time with libm (reference for the tables)
+inline float mqCurvePPM(const MQCurve& curve, int raw) {
+    if (raw <= 0) return curve.b < 0 ? curve.minPPM : curve.maxPPM;
+    if (raw >= MQ_ADC_CODES - 1) return curve.b < 0 ? curve.maxPPM : curve.minPPM;
+
+    float ratio = (float)(curve.loadResistance * (MQ_ADC_CODES - 1 - raw) / raw / curve.cleanAirResistance);
+    return mqClamp(curve.a * powf(ratio, (float)curve.b), curve);
+}
+
+#endif
@@ -14,6 +14,13 @@
 
 #include <Arduino.h>
 
+// Motion states, quietest first
+enum MotionStatus : uint8_t {
+    MOTION_NONE = 0,
+    MOTION_RECENT,           // Within the last 10 s
+    MOTION_DETECTED
+};
+
 class MotionSensor {
 private:
     uint8_t pin;
@@ -44,8 +51,15 @@ public:
     // Reset motion count
     void resetCount();
     
+    // Names of getMotionStatus()
+    static constexpr const char* STATUS_NAMES[] = {"No Motion", "Recent Motion", "Motion Detected"};
+
     // Get motion status
-    String getMotionStatus();
+    MotionStatus getMotionStatus();
 };
 
+inline const char* statusName(MotionStatus status) {
+    return status <= MOTION_DETECTED ? MotionSensor::STATUS_NAMES[status] : "?";
+}
+
 #endif
@@ -1,51 +1,125 @@
 /*
  * RainfallSensor.h
- * Driver for Rain Gauge/Rain Sensor
- * 
+ * Driver for Tipping Bucket Rain Gauge
+ *
  * Features:
- * - Analog rainfall sensor simulation
- * - Continuous rainfall measurement
- * - Rainfall calculation in mm and inches
- * - Rain rate calculation (mm/hour)
- * - Potentiometer simulation for Wokwi testing
+ * - Bucket tips counted by a debounced edge interrupt, each tip
+ *   timestamped into a ring buffer drained by update()
+ * - Rolling 1 h and 24 h totals and the current rain event total
+ * - Sliding-window rain rate (mm/hour)
+ * - Counters kept in RTC memory by the RainGauge the weather node shares
+ *   (esp32_nodes/common), so totals survive deep sleep and resets
+ * - Rainfall in mm and inches
+ * - Pushbutton simulation of bucket tips for Wokwi testing
  */
 
 #ifndef RAINFALLSENSOR_H
 #define RAINFALLSENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+#include "rain_gauge.h"
+
+#define RAIN_MM_PER_TIP 0.2794          // 0.011 in bucket
+#define RAIN_DEBOUNCE_MS 25             // Reed switch bounce
+#define RAIN_TIP_QUEUE 32               // Tips buffered between ISR and update()
+
+// 24-hour rainfall classes, driest first
+enum RainStatus : uint8_t {
+    RAIN_NONE = 0,
+    RAIN_LIGHT,
+    RAIN_MODERATE,
+    RAIN_HEAVY,
+    RAIN_VERY_HEAVY
+};
+
+// Rain rate classes, driest first
+enum RainIntensity : uint8_t {
+    RAIN_RATE_NONE = 0,
+    RAIN_RATE_DRIZZLE,
+    RAIN_RATE_LIGHT,
+    RAIN_RATE_MODERATE,
+    RAIN_RATE_HEAVY,
+    RAIN_RATE_VIOLENT
+};
 
 class RainfallSensor {
 private:
-    uint8_t analogPin;
-    float rainfall_mm;        // Total rainfall in mm
-    float rainRate;           // Rainfall rate in mm/min
-    unsigned long lastReading;
+    uint8_t pin;
+    RainGauge gauge;
+
+    // Tip timestamps (millis) from the interrupt; the ISR only writes
+    // tipHead, update() only writes tipTail
+    volatile uint32_t tipTimes[RAIN_TIP_QUEUE];
+    volatile uint8_t tipHead;
+    volatile uint8_t tipTail;
+    volatile uint32_t lastEdge_ms;
+
+    float rainfall1h_mm;
+    float rainfall24h_mm;
+    float eventRainfall_mm;
+    float rainRate;           // Rainfall rate in mm/hour
+
+    static RainfallSensor* instance;
+    static void IRAM_ATTR handleInterrupt();
 
 public:
     // Constructor
-    RainfallSensor(uint8_t analogPin);
-    
-    // Initialize the sensor
+    RainfallSensor(uint8_t pin, float mmPerTip = RAIN_MM_PER_TIP);
+
+    // Initialize the sensor (restores retained totals)
     void begin();
-    
-    // Update rainfall calculations (call periodically)
+
+    // Fold queued tips into the totals (call periodically)
     void update();
-    
-    // Get total rainfall in mm
+
+    // Get rolling 24 h rainfall in mm
     float getRainfall_mm();
-    
-    // Get total rainfall in inches
+
+    // Get rolling 24 h rainfall in inches
     float getRainfall_inches();
-    
-    // Get rain rate
+
+    // Rolling 1 h total and total of the current rain event (mm)
+    float getRainfall1h_mm();
+    float getEventRainfall_mm();
+
+    // Get rain rate (mm/hour)
     float getRainRate();
-    
+
+    // Tips since the retained state was cleared
+    unsigned long getTipCount();
+
+    // Clear all retained totals
+    void resetTotals();
+
+    // Class boundaries (mm) and names of getRainStatus()
+    static constexpr StatusScale<RainStatus, 4> RAIN_SCALE = {
+        {1, 10, 30, 50},
+        {"No Rain", "Light Rain", "Moderate Rain", "Heavy Rain", "Very Heavy"}};
+
     // Get rain status
-    String getRainStatus();
-    
+    RainStatus getRainStatus();
+
+    // Class boundaries (mm/h) and names of getRainIntensity(); the first
+    // bound is the smallest float above 0, so every rate <= 0 is "None"
+    static constexpr StatusScale<RainIntensity, 5> INTENSITY_SCALE = {
+        {__FLT_DENORM_MIN__, 0.5f, 2.5f, 7.6f, 50},
+        {"None", "Drizzle", "Light", "Moderate", "Heavy", "Violent"}};
+
     // Get rain intensity description
-    String getRainIntensity();
+    RainIntensity getRainIntensity();
 };
 
+static_assert(RainfallSensor::RAIN_SCALE.valid(), "RAIN_SCALE must ascend and name every class");
+
+inline const char* statusName(RainStatus status) {
+    return RainfallSensor::RAIN_SCALE.name(status);
+}
+
+static_assert(RainfallSensor::INTENSITY_SCALE.valid(), "INTENSITY_SCALE must ascend and name every class");
+
+inline const char* statusName(RainIntensity status) {
+    return RainfallSensor::INTENSITY_SCALE.name(status);
+}
+
 #endif
@@ -0,0 +1,142 @@
+/*
+ * SensorTrace.h
+ * Compact recording of the raw sensor inputs for replay on the host
+ *
+ * Features:
+ * - TraceRecorder is a HalInputObserver: it sees every ADC code, level,
+ *   pulse width, DS18B20, DHT and HX711 value the drivers read
+ * - Only changes are recorded (replay holds a value until the next
+ *   record). Analog channels are further limited to one record per
+ *   TRACE_ANALOG_INTERVAL_US, since the scanner alone reads 20k codes/s.
+ * - Self-contained chunks of at most TRACE_CHUNK_MAX bytes: times and
+ *   values are delta coded as varints inside a chunk only, so a lost chunk
+ *   loses its own records and nothing after it
+ * - Chunks go to a sink: a file on the host, telemetry trace frames on the
+ *   device (SENSOR_TRACE, see main.ino and serial_bridge.py --record)
+ * - TraceChunkReader decodes a chunk back into events without allocating
+ *
+ * Chunk layout (varints are LEB128, values zigzag coded):
+ *   varint  time of the first record (us since boot)
+ *   records, each:
+ *     uint8   kind (HalInputKind)
+ *     uint8   pin
+ *     varint  time since the previous record of the chunk (us)
+ *     varint  value minus the channel's previous value in this chunk
+ *             (minus 0 on its first record in the chunk)
+ *
+ * Trace file: "STRC", uint8 version, then every chunk as a little endian
+ * uint16 length followed by the chunk.
+ */
+
+#ifndef SENSORTRACE_H
+#define SENSORTRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "HAL.h"
+
+#define TRACE_FILE_MAGIC "STRC"
+#define TRACE_FILE_VERSION 1
+#define TRACE_CHUNK_MAX 128              // Fits one telemetry frame
+#define TRACE_RECORD_MAX 17              // kind, pin, 10-byte varint, 5-byte varint
+#define TRACE_MAX_CHANNELS 32
+#define TRACE_ANALOG_INTERVAL_US 1000000 // Fastest record rate of an analog channel
+#define TRACE_FLUSH_US 1000000           // Oldest record a chunk may hold back
+
+// One recorded input value
+struct TraceEvent {
+    uint64_t time_us;
+    HalInputKind kind;
+    uint8_t pin;
+    int32_t value;
+};
+
+// Receives each finished chunk; false if it could not be kept
+typedef bool (*TraceSink)(const uint8_t* chunk, size_t length);
+
+struct TraceStats {
+    unsigned long inputs;            // Values seen
+    unsigned long records;           // Values recorded
+    unsigned long chunks;            // Chunks the sink kept
+    unsigned long chunksDropped;     // Chunks the sink refused
+    unsigned long bytes;             // Bytes in kept chunks
+    unsigned long untracked;         // Values of channels past TRACE_MAX_CHANNELS
+};
+
+class TraceRecorder : public HalInputObserver {
+private:
+    struct Channel {
+        HalInputKind kind;
+        uint8_t pin;
+        int32_t value;               // Last recorded value
+        uint64_t time_us;            // When it was recorded
+        uint32_t chunk;              // Chunk it was last recorded in
+    };
+
+    Channel channels[TRACE_MAX_CHANNELS];
+    uint8_t channelCount;
+    TraceSink sink;
+    uint8_t chunk[TRACE_CHUNK_MAX];
+    size_t length;
+    uint32_t chunkNumber;
+    uint64_t chunkStart_us;
+    uint64_t last_us;                // Time of the chunk's previous record
+    uint64_t now_us;                 // 64-bit extension of the HAL micros()
+    uint32_t lastMicros;
+    TraceStats stats;
+
+    Channel* findChannel(HalInputKind kind, uint8_t pin);
+    uint64_t now();
+
+public:
+    // Constructor
+    TraceRecorder();
+
+    // Install as the HAL input observer and start recording into sink
+    void begin(TraceSink sink);
+
+    // Hand over the open chunk and stop observing
+    void end();
+
+    // Hand the open chunk to the sink
+    void flush();
+
+    void onInput(HalInputKind kind, uint8_t pin, int32_t value) override;
+
+    // Statistics
+    const TraceStats& getStats();
+    void printStats();
+};
+
+class TraceChunkReader {
+private:
+    struct Channel {
+        HalInputKind kind;
+        uint8_t pin;
+        int32_t value;
+    };
+
+    const uint8_t* data;
+    size_t length;
+    size_t position;
+    uint64_t time_us;
+    bool malformed;
+    Channel channels[TRACE_MAX_CHANNELS];
+    uint8_t channelCount;
+
+    bool readVarint(uint64_t& value);
+
+public:
+    // Constructor
+    TraceChunkReader();
+
+    // Start on a chunk; false if its header is malformed
+    bool begin(const uint8_t* chunk, size_t length);
+
+    // Next event of the chunk; false at its end or on malformed data
+    bool next(TraceEvent& event);
+
+    bool isMalformed();
+};
+
+#endif
@@ -10,6 +10,16 @@
 #define SOIL_MOISTURE_SENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+
+// Soil moisture classes, driest first
+enum MoistureStatus : uint8_t {
+    MOISTURE_DRY = 0,
+    MOISTURE_LOW,
+    MOISTURE_MODERATE,
+    MOISTURE_HIGH,
+    MOISTURE_WET
+};
 
 class SoilMoistureSensor {
 private:
@@ -63,11 +73,22 @@ public:
      */
     void calibrateWet(int value);
 
+    // Class boundaries (%) and names of getMoistureStatus()
+    static constexpr StatusScale<MoistureStatus, 4> MOISTURE_SCALE = {
+        {20, 40, 60, 80},
+        {"Dry", "Low", "Moderate", "High", "Wet"}};
+
     /**
-     * @brief Get moisture level status as text
-     * @return Status string (Dry, Low, Moderate, High, Wet)
+     * @brief Get moisture level status
+     * @return Status class (Dry, Low, Moderate, High, Wet)
      */
-    String getMoistureStatus();
+    MoistureStatus getMoistureStatus();
 };
 
+static_assert(SoilMoistureSensor::MOISTURE_SCALE.valid(), "MOISTURE_SCALE must ascend and name every class");
+
+inline const char* statusName(MoistureStatus status) {
+    return SoilMoistureSensor::MOISTURE_SCALE.name(status);
+}
+
 #endif // SOIL_MOISTURE_SENSOR_H
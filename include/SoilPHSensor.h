@@ -11,6 +11,18 @@
 #define SOIL_PH_SENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+
+// Soil pH classes, most acidic first
+enum PHStatus : uint8_t {
+    PH_VERY_ACIDIC = 0,
+    PH_ACIDIC,
+    PH_SLIGHTLY_ACIDIC,
+    PH_NEUTRAL,
+    PH_SLIGHTLY_ALKALINE,
+    PH_ALKALINE,
+    PH_VERY_ALKALINE
+};
 
 class SoilPHSensor {
 private:
@@ -60,11 +72,16 @@ public:
      */
     float getVoltage();
 
+    // Class boundaries (pH) and names of getPHStatus()
+    static constexpr StatusScale<PHStatus, 6> PH_SCALE = {
+        {4.5f, 5.5f, 6.5f, 7.5f, 8.5f, 9.5f},
+        {"Very Acidic", "Acidic", "Slightly Acidic", "Neutral", "Slightly Alkaline", "Alkaline", "Very Alkaline"}};
+
     /**
-     * @brief Get pH status as text
-     * @return Status string describing soil pH condition
+     * @brief Get pH status
+     * @return Status class describing soil pH condition
      */
-    String getPHStatus();
+    PHStatus getPHStatus();
 
     /**
      * @brief Calibrate the sensor at pH 4.0 (acidic)
@@ -85,4 +102,10 @@ public:
     void calibrateAlkaline(float voltage);
 };
 
+static_assert(SoilPHSensor::PH_SCALE.valid(), "PH_SCALE must ascend and name every class");
+
+inline const char* statusName(PHStatus status) {
+    return SoilPHSensor::PH_SCALE.name(status);
+}
+
 #endif // SOIL_PH_SENSOR_H
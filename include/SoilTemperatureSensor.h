@@ -10,17 +10,34 @@
 #define SOIL_TEMPERATURE_SENSOR_H
 
 #include <Arduino.h>
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include "StatusScale.h"
+#include "HAL.h"
+
+#define SOIL_TEMP_CONVERSION_TIMEOUT_MS 1000  // 12-bit conversion takes 750 ms
+
+// Soil temperature classes, coldest first
+enum SoilTempStatus : uint8_t {
+    SOIL_TEMP_TOO_COLD = 0,
+    SOIL_TEMP_COLD,
+    SOIL_TEMP_OPTIMAL,
+    SOIL_TEMP_WARM,
+    SOIL_TEMP_TOO_HOT
+};
 
 class SoilTemperatureSensor {
 private:
     uint8_t pin;                    // Digital pin connected to DS18B20
-    OneWire* oneWire;               // OneWire instance
-    DallasTemperature* sensors;     // DallasTemperature instance
+    HalTemperatureBus* sensors;     // DS18B20 bus (OneWire)
     float temperatureC;             // Last temperature reading in Celsius
     float temperatureF;             // Last temperature reading in Fahrenheit
     bool sensorFound;               // Flag to indicate if sensor is detected
+    unsigned long requestTime;      // millis() when the pending conversion started
+
+    /**
+     * @brief Store a raw reading and derive Fahrenheit
+     * @return Temperature in Celsius, -127 on error
+     */
+    float storeReading(float tempC);
 
 public:
     /**
@@ -40,6 +57,23 @@ public:
      */
     float readTemperature();
 
+    /**
+     * @brief Start a conversion without waiting for it
+     */
+    void startRead();
+
+    /**
+     * @brief Poll the pending conversion
+     * @return true once the conversion has completed or timed out
+     */
+    bool pollRead();
+
+    /**
+     * @brief Read the converted temperature
+     * @return Temperature in Celsius, -127 on error
+     */
+    float finishRead();
+
     /**
      * @brief Get the last temperature reading in Celsius
      * @return Temperature in Celsius
@@ -58,11 +92,16 @@ public:
      */
     bool isConnected();
 
+    // Class boundaries (C) and names of getTemperatureStatus()
+    static constexpr StatusScale<SoilTempStatus, 4> TEMPERATURE_SCALE = {
+        {5, 15, 25, 35},
+        {"Too Cold", "Cold", "Optimal", "Warm", "Too Hot"}};
+
     /**
-     * @brief Get temperature status as text
-     * @return Status string based on soil temperature
+     * @brief Get temperature status
+     * @return Status class based on soil temperature
      */
-    String getTemperatureStatus();
+    SoilTempStatus getTemperatureStatus();
 
     /**
      * @brief Get number of DS18B20 sensors on the bus
@@ -71,4 +110,10 @@ public:
     int getDeviceCount();
 };
 
+static_assert(SoilTemperatureSensor::TEMPERATURE_SCALE.valid(), "TEMPERATURE_SCALE must ascend and name every class");
+
+inline const char* statusName(SoilTempStatus status) {
+    return SoilTemperatureSensor::TEMPERATURE_SCALE.name(status);
+}
+
 #endif // SOIL_TEMPERATURE_SENSOR_H
@@ -0,0 +1,49 @@
+/*
+ * StatusScale.h
+ * Threshold tables that classify a reading into a status enum
+ *
+ * Features:
+ * - Ascending class boundaries and one constant name per class, both
+ *   built at compile time (no String, no heap)
+ * - classify() counts the boundaries a value is not below: a fixed
+ *   number of compares and adds, no branches
+ * - A value below the first boundary is class 0; NaN lands in the top
+ *   class, as it did with the if/else chains these replace
+ */
+
+#ifndef STATUSSCALE_H
+#define STATUSSCALE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+template <typename Status, size_t N>
+struct StatusScale {
+    float bounds[N];                 // Class i covers [bounds[i - 1], bounds[i])
+    const char* names[N + 1];
+
+    constexpr Status classify(float value) const {
+        uint8_t level = 0;
+        for (size_t i = 0; i < N; i++) {
+            level += !(value < bounds[i]);
+        }
+        return (Status)level;
+    }
+
+    constexpr const char* name(Status status) const {
+        return (size_t)status <= N ? names[(size_t)status] : "?";
+    }
+
+    // Boundaries ascending and every class named (for static_assert)
+    constexpr bool valid() const {
+        for (size_t i = 1; i < N; i++) {
+            if (!(bounds[i - 1] < bounds[i])) return false;
+        }
+        for (size_t i = 0; i <= N; i++) {
+            if (names[i] == nullptr) return false;
+        }
+        return true;
+    }
+};
+
+#endif
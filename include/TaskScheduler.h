@@ -0,0 +1,129 @@
+/*
+ * TaskScheduler.h
+ * Cooperative, non-blocking sampling scheduler
+ *
+ * Features:
+ * - Each task declares its own period and completion deadline
+ * - Acquisition split into start / poll / finish phases so a slow sensor
+ *   (ultrasonic echo, DS18B20 conversion, HX711) never stalls the others
+ * - Per-task release jitter, response time, deadline-miss and overrun counters
+ * - Longest scheduler pass (loop latency) tracking
+ * - Optional probe around every task step, for host benchmarks
+ */
+
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <Arduino.h>
+
+#define SCHEDULER_MAX_TASKS 24
+
+// A unit of periodic work. Only start() is mandatory; poll() returns true
+// once the acquisition has completed and finish() then publishes the result.
+class ScheduledTask {
+public:
+    virtual ~ScheduledTask() {}
+
+    virtual void start() = 0;
+    virtual bool poll() { return true; }
+    virtual void finish() {}
+};
+
+// Task running a plain function in its start phase
+class CallbackTask : public ScheduledTask {
+private:
+    void (*callback)();
+
+public:
+    CallbackTask(void (*callback)()) : callback(callback) {}
+
+    void start() override { callback(); }
+};
+
+// Task driving a sensor with startRead() / pollRead() / finishRead()
+template <class Sensor>
+class SensorTask : public ScheduledTask {
+private:
+    Sensor& sensor;
+
+public:
+    SensorTask(Sensor& sensor) : sensor(sensor) {}
+
+    void start() override { sensor.startRead(); }
+    bool poll() override { return sensor.pollRead(); }
+    void finish() override { sensor.finishRead(); }
+};
+
+// Sees every start/poll/finish call of a task (index as from addTask);
+// finished is set after the finish() call that completes a run
+class TaskProbe {
+public:
+    virtual ~TaskProbe() {}
+
+    virtual void beginStep(int index) = 0;
+    virtual void endStep(int index, bool finished) = 0;
+};
+
+struct TaskStats {
+    unsigned long runs;             // Completed acquisitions
+    unsigned long overruns;         // Releases dropped (still running or loop stalled)
+    unsigned long deadlineMisses;   // Completed later than release + deadline
+    unsigned long maxJitter_us;     // Worst release lateness
+    uint64_t totalJitter_us;        // For the mean release lateness
+    unsigned long maxResponse_us;   // Worst release-to-finish time
+    unsigned long maxStep_us;       // Longest single start/poll/finish call
+};
+
+class TaskScheduler {
+private:
+    struct TaskEntry {
+        ScheduledTask* task;
+        const char* name;
+        unsigned long period_us;
+        unsigned long deadline_us;
+        unsigned long nextRelease_us;
+        unsigned long release_us;
+        bool running;
+        TaskStats stats;
+    };
+
+    TaskEntry tasks[SCHEDULER_MAX_TASKS];
+    int taskCount;
+    unsigned long passes;
+    unsigned long maxPass_us;
+    TaskProbe* probe;
+
+    void releaseTask(TaskEntry& entry, unsigned long now);
+    void pollTask(TaskEntry& entry);
+    unsigned long beginStep(TaskEntry& entry);
+    void recordStep(TaskEntry& entry, unsigned long stepStart, bool finished = false);
+
+public:
+    // Constructor
+    TaskScheduler();
+
+    // Register a task. The first release is `offset_ms` after begin();
+    // deadline_ms = 0 uses the period as deadline. Returns the task index or -1.
+    int addTask(ScheduledTask* task, const char* name, unsigned long period_ms,
+                unsigned long deadline_ms = 0, unsigned long offset_ms = 0);
+
+    // Anchor all release times to now
+    void begin();
+
+    // Run one non-blocking pass (call from loop)
+    void run();
+
+    // Install a step probe, nullptr to remove it
+    void setProbe(TaskProbe* probe);
+
+    // Statistics
+    int getTaskCount();
+    const char* getTaskName(int index);
+    const TaskStats& getStats(int index);
+    unsigned long getMaxPassTime_us();
+    unsigned long getPassCount();
+    void resetStats();
+    void printStats();
+};
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * Telemetry.h
+ * Serial output of the sketch: the text report or COBS-framed binary records
+ *
+ * Features:
+ * - Build flag TELEMETRY_BINARY selects binary mode, the default is text
+ * - One snapshot record per report (about 120 bytes on the wire instead of
+ *   about 1.5 KB of text), CRC-16 checked and COBS framed: 0x00 ends every
+ *   frame and appears nowhere inside one, so the reader resynchronizes on
+ *   the next zero after any damage
+ * - Frames go whole into the UART driver's transmit buffer or not at all;
+ *   nothing waits for the wire. Frames that do not fit are dropped and
+ *   counted (the sequence number shows the gap on the other end). Log
+ *   frames leave room for a snapshot, so log bursts only drop log lines.
+ * - Log text is its own channel: logPrintf() prints as before in text mode;
+ *   in binary mode each call becomes a log frame if TELEMETRY_LOG is also
+ *   set, otherwise it is discarded
+ * - Trace frames carry SensorTrace chunks (SENSOR_TRACE builds) with the
+ *   same room kept for snapshots as log frames
+ * - Decoder: dashboard/serial_bridge.py (BINARY_TELEMETRY)
+ *
+ * Frame payload, little endian, followed by the CRC-16 of the payload:
+ *   0  uint8   frame type (TELEMETRY_FRAME_*)
+ *   1  uint16  sequence number, counts every frame sent
+ *   3  uint32  uptime (ms)
+ *   snapshot:
+ *   7  uint16  flags (TELEMETRY_FLAG_*)
+ *   9  uint16  remote override mask (bit = RemoteChannel)
+ *   11 float32 values[TELEMETRY_VALUE_COUNT]
+ *   99 uint8   status[TELEMETRY_STATUS_COUNT] (status enum of each driver)
+ *   log:
+ *   7  char    text, no terminator
+ *   trace:
+ *   7  uint8   SensorTrace chunk
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "CommandParser.h"
+
+#ifdef TELEMETRY_BINARY
+#define TELEMETRY_DEFAULT_MODE TELEMETRY_MODE_BINARY
+#else
+#define TELEMETRY_DEFAULT_MODE TELEMETRY_MODE_TEXT
+#endif
+
+#ifdef TELEMETRY_LOG
+#define TELEMETRY_DEFAULT_LOG true
+#else
+#define TELEMETRY_DEFAULT_LOG false
+#endif
+
+#define TELEMETRY_TX_BUFFER 2048     // UART driver transmit buffer (bytes)
+#define TELEMETRY_LOG_MAX 160        // Longest log line, longer ones are cut
+#define TELEMETRY_HEADER_SIZE 7
+#define TELEMETRY_CRC_SIZE 2
+
+#define TELEMETRY_FRAME_SNAPSHOT 0x01
+#define TELEMETRY_FRAME_LOG 0x02
+#define TELEMETRY_FRAME_TRACE 0x03
+
+enum TelemetryMode : uint8_t {
+    TELEMETRY_MODE_TEXT = 0,         // Human-readable report on Serial
+    TELEMETRY_MODE_BINARY            // COBS frames only
+};
+
+// ==================== SNAPSHOT ====================
+
+// Snapshot values; the first 16 are the remote channels, in the same order
+enum TelemetryValue : uint8_t {
+    TELEMETRY_SOIL_MOISTURE = 0,     // %
+    TELEMETRY_SOIL_TEMP,             // °C
+    TELEMETRY_SOIL_PH,
+    TELEMETRY_LEAF_TEMP,             // °C
+    TELEMETRY_LEAF_WETNESS,          // %
+    TELEMETRY_AIR_TEMP,              // °C
+    TELEMETRY_HUMIDITY,              // %
+    TELEMETRY_LIGHT,                 // %
+    TELEMETRY_RAINFALL,              // mm, last 24 h
+    TELEMETRY_WIND_SPEED,            // km/h
+    TELEMETRY_WIND_DIRECTION,        // degrees
+    TELEMETRY_GAS,                   // ppm
+    TELEMETRY_CO2,                   // ppm
+    TELEMETRY_CO,                    // ppm
+    TELEMETRY_WATER_LEVEL,           // %
+    TELEMETRY_WEIGHT,                // kg
+    TELEMETRY_RAIN_RATE,             // mm/h
+    TELEMETRY_RAINFALL_1H,           // mm
+    TELEMETRY_WIND_GUST,             // km/h
+    TELEMETRY_WIND_MEAN_10MIN,       // km/h
+    TELEMETRY_WIND_DIRECTION_10MIN,  // degrees
+    TELEMETRY_WATER_VOLUME,          // liters
+    TELEMETRY_VALUE_COUNT
+};
+
+static_assert((int)TELEMETRY_WEIGHT == (int)REMOTE_WEIGHT && (int)TELEMETRY_SOIL_MOISTURE == (int)REMOTE_SOIL_MOISTURE,
+              "the first telemetry values follow RemoteChannel");
+
+// Status class of each classifier (the driver's status enum as a byte)
+enum TelemetryStatus : uint8_t {
+    TELEMETRY_STATUS_MOISTURE = 0,
+    TELEMETRY_STATUS_SOIL_TEMP,
+    TELEMETRY_STATUS_PH,
+    TELEMETRY_STATUS_LEAF_TEMP,
+    TELEMETRY_STATUS_WETNESS,
+    TELEMETRY_STATUS_AIR_TEMP,
+    TELEMETRY_STATUS_HUMIDITY,
+    TELEMETRY_STATUS_LIGHT,
+    TELEMETRY_STATUS_WIND,
+    TELEMETRY_STATUS_RAIN,
+    TELEMETRY_STATUS_RAIN_INTENSITY,
+    TELEMETRY_STATUS_TANK,
+    TELEMETRY_STATUS_GAS,
+    TELEMETRY_STATUS_AIR_QUALITY,
+    TELEMETRY_STATUS_CO,
+    TELEMETRY_STATUS_MOTION,
+    TELEMETRY_STATUS_WEIGHT,
+    TELEMETRY_STATUS_COUNT
+};
+
+// Snapshot flag bits
+#define TELEMETRY_FLAG_DHT_VALID 0x0001
+#define TELEMETRY_FLAG_MOTION 0x0002
+#define TELEMETRY_FLAG_LOW_WATER 0x0004
+#define TELEMETRY_FLAG_GAS_DANGER 0x0008
+#define TELEMETRY_FLAG_CO2_DANGER 0x0010
+#define TELEMETRY_FLAG_CO_DANGER 0x0020
+#define TELEMETRY_FLAG_OVERLOADED 0x0040
+
+struct TelemetrySnapshot {
+    uint16_t flags;
+    uint16_t remoteMask;
+    float values[TELEMETRY_VALUE_COUNT];
+    uint8_t status[TELEMETRY_STATUS_COUNT];
+};
+
+#define TELEMETRY_SNAPSHOT_SIZE (TELEMETRY_HEADER_SIZE + 4 + 4 * TELEMETRY_VALUE_COUNT + TELEMETRY_STATUS_COUNT)
+
+// COBS adds one byte per 254, plus the leading code byte and the 0x00
+#define TELEMETRY_ENCODED_MAX(n) ((n) + (n) / 254 + 2)
+#define TELEMETRY_PAYLOAD_MAX (TELEMETRY_HEADER_SIZE + TELEMETRY_LOG_MAX + TELEMETRY_CRC_SIZE)
+#define TELEMETRY_FRAME_MAX TELEMETRY_ENCODED_MAX(TELEMETRY_PAYLOAD_MAX)
+#define TELEMETRY_SNAPSHOT_RESERVE TELEMETRY_ENCODED_MAX(TELEMETRY_SNAPSHOT_SIZE + TELEMETRY_CRC_SIZE)
+
+// ==================== FRAMING ====================
+
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial 0xFFFF)
+uint16_t telemetryCrc16(const uint8_t* data, size_t length);
+
+// COBS-encode length bytes and append the 0x00 delimiter; out needs
+// TELEMETRY_ENCODED_MAX(length) bytes. Returns the bytes written.
+size_t cobsEncode(const uint8_t* data, size_t length, uint8_t* out);
+
+// Decode one frame without its delimiter; returns the decoded length, or
+// 0 if the frame is malformed. out needs length bytes.
+size_t cobsDecode(const uint8_t* frame, size_t length, uint8_t* out);
+
+// ==================== LINK ====================
+
+struct TelemetryStats {
+    unsigned long snapshots;
+    unsigned long logFrames;
+    unsigned long bytes;             // Frame bytes handed to the UART
+    unsigned long dropped;           // Snapshots that did not fit the buffer
+    unsigned long logsDropped;       // Log frames that did not fit
+    unsigned long logsDiscarded;     // Log lines with logging off
+    unsigned long traceChunks;
+    unsigned long traceDropped;      // Trace chunks that did not fit
+};
+
+class TelemetryLink {
+private:
+    TelemetryMode mode;
+    bool logEnabled;
+    uint16_t sequence;
+    uint8_t payload[TELEMETRY_PAYLOAD_MAX];
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    TelemetryStats stats;
+
+    size_t startPayload(uint8_t type);
+    bool sendPayload(size_t length, size_t reserve);
+
+public:
+    // Constructor
+    TelemetryLink();
+
+    // Open the UART (replaces Serial.begin). In binary mode a lone 0x00
+    // ends whatever the boot ROM printed before the first frame.
+    void begin(unsigned long baud, TelemetryMode mode = TELEMETRY_DEFAULT_MODE, bool log = TELEMETRY_DEFAULT_LOG);
+
+    bool isBinary();
+
+    // Queue one snapshot frame; false if it was dropped (text mode: no-op)
+    bool sendSnapshot(const TelemetrySnapshot& snapshot);
+
+    // One line of log text, already formatted
+    void log(const char* text);
+
+    // Queue one trace chunk (binary mode only); false if it was dropped
+    bool sendTrace(const uint8_t* chunk, size_t length);
+
+    // Statistics
+    const TelemetryStats& getStats();
+    void printStats();
+};
+
+// Global instance used by logPrintf()
+extern TelemetryLink telemetry;
+
+// printf to the log channel: Serial in text mode, a log frame (or nothing)
+// in binary mode
+void logPrintf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+#endif
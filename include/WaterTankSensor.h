@@ -14,6 +14,19 @@
 #define WATERTANKSENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+
+#define WATER_ECHO_TIMEOUT_US 30000  // No echo within 30 ms = out of range
+
+// Tank level classes, emptiest first
+enum TankStatus : uint8_t {
+    TANK_CRITICAL_LOW = 0,
+    TANK_LOW,
+    TANK_MEDIUM,
+    TANK_GOOD,
+    TANK_HIGH,
+    TANK_FULL
+};
 
 class WaterTankSensor {
 private:
@@ -25,9 +38,17 @@ private:
     float waterLevel_cm;
     float waterLevel_percent;
     float waterVolume_liters;
+    unsigned long pingStart_us;     // Trigger time of the pending measurement
+    unsigned long echoWidth_us;     // Captured echo width, 0 on timeout
+    
+    // Send the 10us trigger pulse
+    void trigger();
+    
+    // Convert an echo width to distance, 0 when out of range
+    float echoToDistance(unsigned long duration);
     
-    // Measure distance using ultrasonic sensor
-    float measureDistance();
+    // Update level, percentage and volume from distance_cm
+    void updateLevel();
 
 public:
     // Constructor
@@ -39,6 +60,12 @@ public:
     // Read water level
     float readLevel();
     
+    // Non-blocking read: startRead() triggers a ping, pollRead() returns true
+    // once the echo is captured or timed out, finishRead() updates the level
+    void startRead();
+    bool pollRead();
+    float finishRead();
+    
     // Get distance from sensor to water
     float getDistance_cm();
     
@@ -51,8 +78,13 @@ public:
     // Get water volume in liters
     float getVolume_liters();
     
+    // Class boundaries (%) and names of getTankStatus()
+    static constexpr StatusScale<TankStatus, 5> TANK_SCALE = {
+        {10, 25, 50, 75, 90},
+        {"Critical Low", "Low", "Medium", "Good", "High", "Full"}};
+
     // Get tank status
-    String getTankStatus();
+    TankStatus getTankStatus();
     
     // Check if water is low
     bool isLowLevel();
@@ -62,4 +94,10 @@ public:
     void setTankCapacity(float capacity_liters);
 };
 
+static_assert(WaterTankSensor::TANK_SCALE.valid(), "TANK_SCALE must ascend and name every class");
+
+inline const char* statusName(TankStatus status) {
+    return WaterTankSensor::TANK_SCALE.name(status);
+}
+
 #endif
@@ -14,16 +14,34 @@
 #define WEIGHTSENSOR_H
 
 #include <Arduino.h>
-#include <HX711.h>
+#include "StatusScale.h"
+#include "HAL.h"
+
+#define WEIGHT_SAMPLES 5             // Readings averaged per measurement
+#define WEIGHT_READY_TIMEOUT_MS 200  // Give up if the HX711 stays busy this long
+
+// Load classes, emptiest first
+enum WeightStatus : uint8_t {
+    WEIGHT_EMPTY = 0,
+    WEIGHT_LOW,
+    WEIGHT_QUARTER_FULL,
+    WEIGHT_HALF_FULL,
+    WEIGHT_NEARLY_FULL,
+    WEIGHT_FULL,
+    WEIGHT_OVERLOADED
+};
 
 class WeightSensor {
 private:
-    HX711 scale;
+    HalLoadCell* scale;
     uint8_t dataPin;
     uint8_t clockPin;
     float weight_kg;
     float calibrationFactor;
     float maxCapacity_kg;
+    float sampleSum;
+    uint8_t sampleCount;
+    unsigned long lastSample_ms;
 
 public:
     // Constructor
@@ -38,14 +56,26 @@ public:
     // Read weight
     float readWeight();
     
+    // Non-blocking read: startRead(), then pollRead() collects one HX711
+    // conversion per call as they become ready, finishRead() averages them
+    void startRead();
+    bool pollRead();
+    float finishRead();
+    
     // Get weight in kg
     float getWeight_kg();
     
     // Get weight in pounds
     float getWeight_lbs();
     
+    // Class boundaries (% of capacity) and names of getWeightStatus(); loads
+    // under 0.1 kg are classified as -1 %, "Empty"
+    static constexpr StatusScale<WeightStatus, 6> WEIGHT_SCALE = {
+        {0, 25, 50, 75, 90, 100},
+        {"Empty", "Low", "Quarter Full", "Half Full", "Nearly Full", "Full", "OVERLOADED!"}};
+
     // Get weight status
-    String getWeightStatus();
+    WeightStatus getWeightStatus();
     
     // Set calibration factor
     void setCalibrationFactor(float factor);
@@ -54,4 +84,10 @@ public:
     bool isOverloaded();
 };
 
+static_assert(WeightSensor::WEIGHT_SCALE.valid(), "WEIGHT_SCALE must ascend and name every class");
+
+inline const char* statusName(WeightStatus status) {
+    return WeightSensor::WEIGHT_SCALE.name(status);
+}
+
 #endif
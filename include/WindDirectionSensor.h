@@ -7,6 +7,9 @@
  * - 8 or 16-direction wind vane support
  * - Cardinal direction output (N, NE, E, SE, S, SW, W, NW)
  * - Degree output (0-360°)
+ * - Vector-mean direction and Yamartino standard deviation over rolling
+ *   2-minute and 10-minute windows (one sample per read), using the
+ *   WindVectorAverage the weather node shares (esp32_nodes/common)
  * - Potentiometer simulation for Wokwi
  */
 
@@ -14,6 +17,17 @@
 #define WINDDIRECTIONSENSOR_H
 
 #include <Arduino.h>
+#include "wind_vector.h"
+
+#define WIND_DIR_SAMPLE_INTERVAL_MS 2  // Spacing between averaged samples
+
+// Rolling windows in reads (the direction task runs at 1 Hz)
+#ifndef WIND_DIR_SHORT_WINDOW
+#define WIND_DIR_SHORT_WINDOW 120
+#endif
+#ifndef WIND_DIR_LONG_WINDOW
+#define WIND_DIR_LONG_WINDOW 600
+#endif
 
 class WindDirectionSensor {
 private:
@@ -21,12 +35,17 @@ private:
     int rawValue;
     float voltage;
     int direction;  // 0-360 degrees
-    String cardinalDirection;
+    const char* cardinalDirection;  // Constant from windCardinal16()
     int samples;    // number of samples for averaging
+    long sampleSum;
+    int sampleCount;
+    unsigned long nextSample_ms;
+    WindVectorAverage average;
+    int shortWindow;
+    int longWindow;
     
     // Convert ADC value to direction
     int voltageToDirection(int adcValue);
-    String directionToCardinal(int degrees);
 
 public:
     // Constructor
@@ -38,11 +57,24 @@ public:
     // Read wind direction
     int readDirection();
     
+    // Non-blocking read: startRead(), then pollRead() until it returns true,
+    // then finishRead() computes the result
+    void startRead();
+    bool pollRead();
+    int finishRead();
+    
     // Get direction in degrees (0-360)
     int getDirectionDegrees();
     
     // Get cardinal direction (N, NE, E, SE, S, SW, W, NW, etc.)
-    String getCardinalDirection();
+    const char* getCardinalDirection();
+    
+    // Vector-mean direction (0-360) and Yamartino standard deviation
+    // (degrees) over the 2-minute and 10-minute windows
+    float getMeanDirection2Min();
+    float getMeanDirection10Min();
+    float getDirectionStdDev2Min();
+    float getDirectionStdDev10Min();
     
     // Get raw ADC value
     int getRawValue();
@@ -0,0 +1,49 @@
+/*
+ * WindSimulator.h
+ * Anemometer test signal source for Wokwi and the host build
+ *
+ * Features:
+ * - Square wave on an output pin from a hardware timer, wired to the
+ *   anemometer input (the host backend emulates timer and wiring)
+ * - Frequency set from a potentiometer (0-50 m/s) or directly
+ */
+
+#ifndef WINDSIMULATOR_H
+#define WINDSIMULATOR_H
+
+#include <Arduino.h>
+
+// Hardware timer used by the signal generator
+#define WIND_SIM_TIMER 0
+#define WIND_SIM_MAX_SPEED 50.0         // m/s at full potentiometer scale
+#define WIND_SIM_HYSTERESIS 1.0         // m/s change before retuning
+
+class WindSimulator {
+private:
+    uint8_t outputPin;
+    uint8_t potPin;
+    uint8_t timerId;
+    float calibrationFactor;       // Pulses per second per m/s
+    float speed_ms;
+    bool running;
+    volatile bool toggleState;
+
+    static WindSimulator* instance;
+    static void IRAM_ATTR onTimer();
+
+public:
+    // Constructor
+    WindSimulator(float calibrationFactor = 2.4, uint8_t timerId = WIND_SIM_TIMER);
+
+    // Start the generator; potentiometerPin 0xFF disables the pot input
+    void begin(uint8_t outputPin, uint8_t potentiometerPin);
+
+    // Follow the potentiometer (call from loop)
+    void update();
+
+    // Generate a fixed speed
+    void setSpeed(float speed_ms);
+    float getSpeed();
+};
+
+#endif
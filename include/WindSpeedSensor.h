@@ -1,72 +1,105 @@
 /*
  * WindSpeedSensor.h
  * Driver for Anemometer wind speed sensor using pulse counting
- * 
+ *
  * Features:
- * - Pulse counting via interrupt
+ * - Hardware pulse counting (ESP32 PCNT) with glitch filter, no
+ *   interrupt per pulse and no read/reset race
+ * - Pulse-period capture at low speed for sub-pulse resolution
  * - Wind speed calculation in m/s, km/h, and mph
+ * - 3-second gust, 2-minute and 10-minute mean (WindStatistics)
  * - Calibration factor support
  * - Wind condition categorization
- * - PWM simulation mode for Wokwi testing
  */
 
 #ifndef WINDSPEEDSENSOR_H
 #define WINDSPEEDSENSOR_H
 
 #include <Arduino.h>
+#include "StatusScale.h"
+#include "WindStatistics.h"
+
+#define WIND_COUNTER_UNIT 0
+#define WIND_SAMPLE_INTERVAL_MS 250     // 4 Hz, the 3-s gust spans 12 samples
+#define WIND_GLITCH_FILTER_NS 12000     // Longest PCNT filter (1023 APB cycles)
+#define WIND_CAPTURE_ENTER_HZ 10.0      // Switch to period capture below this
+#define WIND_CAPTURE_EXIT_HZ 15.0       // and back to counting above this
+#define WIND_CALM_TIMEOUT_US 3000000    // No pulse for this long means calm
+
+// Beaufort classes, calm first
+enum WindStatus : uint8_t {
+    WIND_CALM = 0,
+    WIND_LIGHT_AIR,
+    WIND_LIGHT_BREEZE,
+    WIND_GENTLE_BREEZE,
+    WIND_MODERATE_BREEZE,
+    WIND_FRESH_BREEZE,
+    WIND_STRONG_BREEZE,
+    WIND_NEAR_GALE,
+    WIND_GALE,
+    WIND_STRONG_GALE,
+    WIND_STORM,
+    WIND_VIOLENT_STORM
+};
 
 class WindSpeedSensor {
 private:
     uint8_t pin;
-    volatile unsigned long pulseCount;
+    uint8_t unit;
+    unsigned long pulseCount;      // Total pulses since reset
     unsigned long lastMeasurementTime;
     float windSpeed_ms;  // meters per second
     float calibrationFactor; // pulses per second per m/s
-    
-    // Simulation mode
-    bool simulationMode;
-    uint8_t simulatorPin;
-    uint8_t potPin;
-    hw_timer_t* timer;
-    float simulatedWindSpeed;
-    volatile bool toggleState;
-    
-    static WindSpeedSensor* instance;
-    static void IRAM_ATTR handleInterrupt();
-    static void IRAM_ATTR onSimulatorTimer();
+    bool captureMode;
+    WindStatistics statistics;
+
+    float captureFrequency(float countFrequency);
 
 public:
     // Constructor
-    WindSpeedSensor(uint8_t pin, float calibrationFactor = 2.4);
-    
+    WindSpeedSensor(uint8_t pin, float calibrationFactor = 2.4, uint8_t unit = WIND_COUNTER_UNIT);
+
     // Initialize the sensor
     void begin();
-    
-    // Enable simulation mode with PWM generator
-    void enableSimulation(uint8_t simPin, uint8_t potentiometerPin);
-    
-    // Update simulated wind speed from potentiometer
-    void updateSimulation();
-    
-    // Calculate wind speed (call periodically)
+
+    // Calculate wind speed (call every WIND_SAMPLE_INTERVAL_MS)
     float calculateWindSpeed();
-    
+
     // Get wind speed in different units
     float getWindSpeed_ms();    // meters per second
     float getWindSpeed_kmh();   // kilometers per hour
     float getWindSpeed_mph();   // miles per hour
-    
+
+    // Rolling statistics (m/s)
+    float getGust_ms();         // Highest 3-s mean in 10 minutes
+    float getMean2Min_ms();
+    float getMean10Min_ms();
+
+    // Class boundaries (km/h) and names of getWindStatus()
+    static constexpr StatusScale<WindStatus, 11> WIND_SCALE = {
+        {1, 5, 12, 20, 29, 39, 50, 62, 75, 89, 103},
+        {"Calm", "Light Air", "Light Breeze", "Gentle Breeze", "Moderate Breeze", "Fresh Breeze", "Strong Breeze", "Near Gale", "Gale", "Strong Gale", "Storm", "Violent Storm"}};
+
     // Get wind condition status
-    String getWindStatus();
-    
+    WindStatus getWindStatus();
+
     // Get pulse count
     unsigned long getPulseCount();
-    
+
+    // True while low speed is measured from the pulse period
+    bool isCaptureMode();
+
     // Reset pulse count
     void resetPulseCount();
-    
+
     // Set calibration factor
     void setCalibrationFactor(float factor);
 };
 
+static_assert(WindSpeedSensor::WIND_SCALE.valid(), "WIND_SCALE must ascend and name every class");
+
+inline const char* statusName(WindStatus status) {
+    return WindSpeedSensor::WIND_SCALE.name(status);
+}
+
 #endif
@@ -0,0 +1,66 @@
+/*
+ * WindStatistics.h
+ * Rolling WMO-style wind statistics
+ *
+ * Features:
+ * - 3-second gust: running mean of the last WIND_STATS_GUST_SAMPLES samples
+ * - One bucket per second (mean speed and highest 3-s mean) for 10 minutes
+ * - 2-minute and 10-minute means from running sums, O(1) per sample
+ * - 10-minute gust: highest 3-s mean in the window
+ * - Seconds without samples are left out of the means
+ */
+
+#ifndef WINDSTATISTICS_H
+#define WINDSTATISTICS_H
+
+#include <Arduino.h>
+
+#define WIND_STATS_GUST_SAMPLES 12      // 3 s at the 4 Hz sample rate
+#define WIND_STATS_SECONDS 600          // 10-minute window
+#define WIND_STATS_SHORT_SECONDS 120    // 2-minute window
+#define WIND_STATS_NO_DATA 0xFFFF
+
+class WindStatistics {
+private:
+    // Speeds are kept in cm/s
+    uint16_t gustRing[WIND_STATS_GUST_SAMPLES];
+    uint8_t gustHead;
+    uint8_t gustFilled;
+    uint32_t gustSum;
+    uint16_t gust;                 // Current 3-s mean
+
+    uint16_t secondMean[WIND_STATS_SECONDS];
+    uint16_t secondGust[WIND_STATS_SECONDS];
+    uint16_t head;                 // Next bucket to overwrite
+    uint32_t shortSum;
+    uint16_t shortCount;
+    uint32_t longSum;
+    uint16_t longCount;
+
+    // Second being accumulated
+    bool started;
+    unsigned long currentSecond;
+    uint32_t pendingSum;
+    uint16_t pendingSamples;
+    uint16_t pendingGust;
+
+    void closeSecond();
+
+public:
+    // Constructor
+    WindStatistics();
+
+    // Clear all windows
+    void reset();
+
+    // Add one speed sample taken at now_ms
+    void addSample(float speed_ms, unsigned long now_ms);
+
+    // Statistics in m/s
+    float getGust3s();
+    float getGust10Min();
+    float getMean2Min();
+    float getMean10Min();
+};
+
+#endif
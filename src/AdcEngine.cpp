@@ -0,0 +1,166 @@
+/*
+ * AdcEngine.cpp
+ * Implementation of the continuous ADC acquisition engine
+ */
+
+#include "AdcEngine.h"
+#include "Telemetry.h"
+
+#define ADC_ENGINE_NO_CHANNEL 0xFF
+
+AdcEngine adcEngine;
+
+// Constructor
+AdcEngine::AdcEngine() {
+    this->channelCount = 0;
+    this->running = false;
+    memset(&stats, 0, sizeof(stats));
+    memset(channels, 0, sizeof(channels));
+    memset(pinChannel, ADC_ENGINE_NO_CHANNEL, sizeof(pinChannel));
+}
+
+// Register a pin for scanning
+bool AdcEngine::addChannel(uint8_t pin) {
+    if (running || pin >= ADC_ENGINE_PIN_COUNT) return false;
+    if (pinChannel[pin] != ADC_ENGINE_NO_CHANNEL) return true;
+    if (channelCount >= ADC_ENGINE_MAX_CHANNELS || !HAL::adcScanner().supportsPin(pin)) return false;
+
+    Channel& channel = channels[channelCount];
+    memset(&channel, 0, sizeof(channel));
+    channel.pin = pin;
+    pinChannel[pin] = channelCount;
+    channelCount++;
+    return true;
+}
+
+// Start background acquisition
+bool AdcEngine::begin(uint32_t sampleRate_hz) {
+    if (running || channelCount == 0) return false;
+
+    uint8_t pins[ADC_ENGINE_MAX_CHANNELS];
+    for (uint8_t i = 0; i < channelCount; i++) {
+        pins[i] = channels[i].pin;
+    }
+
+    running = HAL::adcScanner().begin(pins, channelCount, sampleRate_hz);
+    if (running) {
+        logPrintf("[ADC] Scanning %u channels at %lu conversions/s\n",
+                  channelCount, (unsigned long)sampleRate_hz);
+    } else {
+        logPrintf("[ADC] Continuous mode unavailable, using one-shot reads\n");
+    }
+    return running;
+}
+
+// Stop background acquisition
+void AdcEngine::end() {
+    if (!running) return;
+    HAL::adcScanner().end();
+    running = false;
+}
+
+// Drain the scanner
+void AdcEngine::service() {
+    if (!running) return;
+
+    unsigned long handled = 0;
+    for (int i = 0; i < ADC_ENGINE_MAX_DRAINS; i++) {
+        size_t count = HAL::adcScanner().read(batch, ADC_ENGINE_DRAIN);
+        ingest(batch, count);
+        handled += count;
+        if (count < ADC_ENGINE_DRAIN) break;
+    }
+
+    if (handled > 0) {
+        stats.services++;
+        if (handled > stats.maxBatch) stats.maxBatch = handled;
+    }
+    stats.overruns = HAL::adcScanner().getOverruns();
+}
+
+// Fold converted samples into the channels
+void AdcEngine::ingest(const HalAdcSample* samples, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint8_t pin = samples[i].pin;
+        if (pin >= ADC_ENGINE_PIN_COUNT || pinChannel[pin] == ADC_ENGINE_NO_CHANNEL) continue;
+
+        Channel& channel = channels[pinChannel[pin]];
+        channel.blockSum += samples[i].value;
+        channel.stats.conversions++;
+        if (++channel.blockCount == ADC_ENGINE_BLOCK) {
+            pushBlock(channel, (uint16_t)(channel.blockSum / ADC_ENGINE_BLOCK));
+            channel.blockSum = 0;
+            channel.blockCount = 0;
+        }
+    }
+    stats.conversions += count;
+}
+
+// Replace the oldest ring entry and keep the running sum
+void AdcEngine::pushBlock(Channel& channel, uint16_t average) {
+    if (channel.filled == ADC_ENGINE_WINDOW) {
+        channel.windowSum -= channel.window[channel.head];
+    } else {
+        channel.filled++;
+    }
+    channel.window[channel.head] = average;
+    channel.windowSum += average;
+    channel.head = (channel.head + 1) % ADC_ENGINE_WINDOW;
+    channel.latest = average;
+    channel.stats.blocks++;
+}
+
+// True once the pin has a block average
+bool AdcEngine::isScanning(uint8_t pin) {
+    return pin < ADC_ENGINE_PIN_COUNT && pinChannel[pin] != ADC_ENGINE_NO_CHANNEL &&
+           channels[pinChannel[pin]].filled > 0;
+}
+
+// Moving average of a scanned pin
+int AdcEngine::read(uint8_t pin) {
+    if (!isScanning(pin)) {
+        stats.fallbackReads++;
+        return HAL::adc().read(pin);
+    }
+    Channel& channel = channels[pinChannel[pin]];
+    channel.stats.reads++;
+    return channel.windowSum / channel.filled;
+}
+
+// Latest block average of a scanned pin
+int AdcEngine::readLatest(uint8_t pin) {
+    if (!isScanning(pin)) {
+        stats.fallbackReads++;
+        return HAL::adc().read(pin);
+    }
+    Channel& channel = channels[pinChannel[pin]];
+    channel.stats.reads++;
+    return channel.latest;
+}
+
+uint8_t AdcEngine::getChannelCount() {
+    return channelCount;
+}
+
+uint8_t AdcEngine::getChannelPin(uint8_t index) {
+    return channels[index].pin;
+}
+
+const AdcChannelStats& AdcEngine::getChannelStats(uint8_t index) {
+    return channels[index].stats;
+}
+
+const AdcEngineStats& AdcEngine::getStats() {
+    return stats;
+}
+
+// Print per-channel and engine counters
+void AdcEngine::printStats() {
+    logPrintf("[ADC] pin  conversions   blocks    reads\n");
+    for (uint8_t i = 0; i < channelCount; i++) {
+        const AdcChannelStats& s = channels[i].stats;
+        logPrintf("[ADC] %3u %12lu %8lu %8lu\n", channels[i].pin, s.conversions, s.blocks, s.reads);
+    }
+    logPrintf("[ADC] %lu conversions, largest batch %lu, %lu one-shot reads, %lu overruns\n",
+              stats.conversions, stats.maxBatch, stats.fallbackReads, stats.overruns);
+}
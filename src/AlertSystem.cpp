@@ -4,122 +4,271 @@
  */
 
 #include "AlertSystem.h"
+#include "HAL.h"
+#include "Telemetry.h"
+
+// Beep pattern, severity and log message of each alert type
+struct AlertPattern {
+    uint8_t beeps;
+    uint16_t duration_ms;   // Length of each tone and each gap
+    uint8_t severity;
+    const char* message;
+};
+
+static const AlertPattern ALERT_PATTERNS[ALERT_TYPE_COUNT] = {
+    { 0,   0, 0, "" },                              // ALERT_NONE
+    { 2, 200, 2, "LOW WATER WARNING!" },            // ALERT_LOW_WATER
+    { 3, 150, 3, "HIGH TEMPERATURE WARNING!" },     // ALERT_HIGH_TEMP
+    { 3, 150, 3, "LOW TEMPERATURE WARNING!" },      // ALERT_LOW_TEMP
+    { 2, 250, 1, "LOW SOIL MOISTURE WARNING!" },    // ALERT_LOW_SOIL_MOISTURE
+    { 5, 100, 4, "DANGEROUS GAS DETECTED!" },       // ALERT_GAS_DETECTED
+    { 1, 100, 1, "Motion detected" },               // ALERT_MOTION_DETECTED
+    { 4, 200, 2, "OVERWEIGHT WARNING!" }            // ALERT_OVERWEIGHT
+};
 
 // Constructor
 AlertSystem::AlertSystem(uint8_t buzzerPin, unsigned long alertInterval) {
     this->buzzerPin = buzzerPin;
     this->alertInterval = alertInterval;
     this->muted = false;
-    this->currentAlert = ALERT_NONE;
-    this->lastAlertTime = 0;
+    this->queueLength = 0;
+    this->playing = ALERT_NONE;
+    this->phase = 0;
+    this->nextToggle = 0;
+    memset(states, 0, sizeof(states));
 }
 
 // Initialize the alert system
 void AlertSystem::begin() {
-    pinMode(buzzerPin, OUTPUT);
-    
+    HAL::gpio().setMode(buzzerPin, OUTPUT);
+
     // Configure LEDC for buzzer (PWM)
-    ledcSetup(0, 2000, 8);  // Channel 0, 2000 Hz, 8-bit resolution
-    ledcAttachPin(buzzerPin, 0);
-    ledcWrite(0, 0);  // Start with buzzer off
-    
-    Serial.println("[Alert] Buzzer Alert System initialized");
-}
-
-// Play short beep
-void AlertSystem::beepShort() {
-    if (!muted) {
-        ledcWriteTone(0, 2000);  // 2000 Hz
-        ledcWrite(0, 128);  // 50% duty cycle
-        delay(100);
-        ledcWrite(0, 0);  // Off
+    HAL::tone().setup(ALERT_TONE_CHANNEL, ALERT_TONE_FREQUENCY, 8);  // 8-bit resolution
+    HAL::tone().attach(buzzerPin, ALERT_TONE_CHANNEL);
+    HAL::tone().setDuty(ALERT_TONE_CHANNEL, 0);  // Start with buzzer off
+
+    logPrintf("[Alert] Buzzer Alert System initialized\n");
+}
+
+// Severity rank of an alert type
+uint8_t AlertSystem::getSeverity(AlertType type) {
+    if (type <= ALERT_NONE || type >= ALERT_TYPE_COUNT) return 0;
+    return ALERT_PATTERNS[type].severity;
+}
+
+// Switch the buzzer on or off
+void AlertSystem::setTone(bool on) {
+    if (on) {
+        HAL::tone().setFrequency(ALERT_TONE_CHANNEL, ALERT_TONE_FREQUENCY);
+        HAL::tone().setDuty(ALERT_TONE_CHANNEL, ALERT_TONE_DUTY);
+    } else {
+        HAL::tone().setDuty(ALERT_TONE_CHANNEL, 0);
     }
 }
 
-// Play long beep
-void AlertSystem::beepLong() {
-    if (!muted) {
-        ledcWriteTone(0, 2000);  // 2000 Hz
-        ledcWrite(0, 128);  // 50% duty cycle
-        delay(500);
-        ledcWrite(0, 0);  // Off
+// Begin playing the pattern of an alert
+void AlertSystem::startPattern(AlertType type, unsigned long now) {
+    playing = type;
+    phase = 0;
+    nextToggle = now + ALERT_PATTERNS[type].duration_ms;
+    states[type].sounded = true;
+    states[type].lastSounded = now;
+    setTone(true);
+}
+
+// Abort the current pattern
+void AlertSystem::stopPattern() {
+    setTone(false);
+    playing = ALERT_NONE;
+}
+
+// Queue an alert, keeping the queue ordered by severity
+void AlertSystem::raise(AlertType type, bool oneShot) {
+    AlertState& s = states[type];
+    s.active = true;
+    s.oneShot = oneShot;
+    s.sounded = false;
+    s.raisedAt = HAL::clock().millis();
+
+    // Insert behind alerts of equal or higher severity
+    int i = queueLength++;
+    while (i > 0 && getSeverity(queue[i - 1]) < getSeverity(type)) {
+        queue[i] = queue[i - 1];
+        i--;
+    }
+    queue[i] = type;
+
+    logPrintf("[Alert] %s\n", ALERT_PATTERNS[type].message);
+
+    // A more severe alert interrupts the pattern being played
+    if (playing != ALERT_NONE && getSeverity(type) > getSeverity(playing)) {
+        stopPattern();
     }
 }
 
-// Play beep pattern
-void AlertSystem::beepPattern(int times, int duration) {
-    if (!muted) {
-        for (int i = 0; i < times; i++) {
-            ledcWriteTone(0, 2000);  // 2000 Hz
-            ledcWrite(0, 128);  // 50% duty cycle
-            delay(duration);
-            ledcWrite(0, 0);  // Off
-            delay(duration);
+// Remove an alert from the queue
+void AlertSystem::release(AlertType type) {
+    AlertState& s = states[type];
+    bool wasOneShot = s.oneShot;
+    s.active = false;
+    s.oneShot = false;
+
+    for (int i = 0; i < queueLength; i++) {
+        if (queue[i] == type) {
+            for (int j = i; j < queueLength - 1; j++) {
+                queue[j] = queue[j + 1];
+            }
+            queueLength--;
+            break;
         }
     }
+
+    if (playing == type) {
+        stopPattern();
+    }
+
+    if (!wasOneShot) {
+        logPrintf("[Alert] Cleared: %s\n", ALERT_PATTERNS[type].message);
+    }
 }
 
-// Trigger alert
-void AlertSystem::triggerAlert(AlertType type) {
-    if (type == ALERT_NONE) return;
-    
-    currentAlert = type;
-    unsigned long currentTime = millis();
-    
-    // Only trigger if enough time has passed since last alert
-    if (currentTime - lastAlertTime >= alertInterval) {
-        lastAlertTime = currentTime;
-        
-        switch (type) {
-            case ALERT_LOW_WATER:
-                beepPattern(2, 200);
-                Serial.println("[Alert] LOW WATER WARNING!");
-                break;
-            case ALERT_HIGH_TEMP:
-                beepPattern(3, 150);
-                Serial.println("[Alert] HIGH TEMPERATURE WARNING!");
-                break;
-            case ALERT_LOW_TEMP:
-                beepPattern(3, 150);
-                Serial.println("[Alert] LOW TEMPERATURE WARNING!");
-                break;
-            case ALERT_LOW_SOIL_MOISTURE:
-                beepPattern(2, 250);
-                Serial.println("[Alert] LOW SOIL MOISTURE WARNING!");
-                break;
-            case ALERT_GAS_DETECTED:
-                beepPattern(5, 100);
-                Serial.println("[Alert] DANGEROUS GAS DETECTED!");
-                break;
-            case ALERT_MOTION_DETECTED:
-                beepShort();
-                Serial.println("[Alert] Motion detected");
-                break;
-            case ALERT_OVERWEIGHT:
-                beepPattern(4, 200);
-                Serial.println("[Alert] OVERWEIGHT WARNING!");
-                break;
-            default:
-                break;
+// Configure threshold hysteresis and debounce
+void AlertSystem::setThresholds(AlertType type, float raiseAt, float clearAt, unsigned long debounce_ms) {
+    if (type <= ALERT_NONE || type >= ALERT_TYPE_COUNT) return;
+
+    states[type].hasThresholds = true;
+    states[type].raiseAt = raiseAt;
+    states[type].clearAt = clearAt;
+    states[type].debounce_ms = debounce_ms;
+}
+
+// Set debounce time for a boolean condition
+void AlertSystem::setDebounce(AlertType type, unsigned long debounce_ms) {
+    if (type <= ALERT_NONE || type >= ALERT_TYPE_COUNT) return;
+
+    states[type].debounce_ms = debounce_ms;
+}
+
+// Feed a measurement
+void AlertSystem::reportValue(AlertType type, float value) {
+    if (type <= ALERT_NONE || type >= ALERT_TYPE_COUNT) return;
+
+    AlertState& s = states[type];
+    if (!s.hasThresholds) return;
+
+    // Raised conditions are held until the value crosses the clear level
+    bool lowAlarm = s.raiseAt < s.clearAt;
+    bool present;
+    if (s.condition) {
+        present = lowAlarm ? (value < s.clearAt) : (value > s.clearAt);
+    } else {
+        present = lowAlarm ? (value <= s.raiseAt) : (value >= s.raiseAt);
+    }
+
+    reportCondition(type, present);
+}
+
+// Feed the current state of a condition
+void AlertSystem::reportCondition(AlertType type, bool present) {
+    if (type <= ALERT_NONE || type >= ALERT_TYPE_COUNT) return;
+
+    AlertState& s = states[type];
+    unsigned long now = HAL::clock().millis();
+
+    if (present != s.condition) {
+        s.condition = present;
+        s.changedAt = now;
+    }
+
+    // Wait until the new state has been stable long enough
+    if (now - s.changedAt < s.debounce_ms) return;
+
+    if (s.condition) {
+        if (!s.active) {
+            raise(type, false);
+        } else if (s.oneShot) {
+            s.oneShot = false;  // Latch a pending one-shot
         }
+    } else if (s.active && !s.oneShot) {
+        release(type);
     }
 }
 
+// Trigger a one-shot alert
+void AlertSystem::triggerAlert(AlertType type) {
+    if (type <= ALERT_NONE || type >= ALERT_TYPE_COUNT) return;
+
+    AlertState& s = states[type];
+    if (s.active) return;
+
+    // Only trigger if enough time has passed since this alert last sounded
+    if (s.sounded && HAL::clock().millis() - s.lastSounded < alertInterval) return;
+
+    raise(type, true);
+}
+
 // Update alert (call in loop)
 void AlertSystem::update() {
-    // Can add continuous alert logic here if needed
+    unsigned long now = HAL::clock().millis();
+
+    // Advance the pattern being played
+    if (playing != ALERT_NONE) {
+        if ((long)(now - nextToggle) < 0) return;
+
+        const AlertPattern& pattern = ALERT_PATTERNS[playing];
+        phase++;
+        if (phase < pattern.beeps * 2) {
+            setTone(phase % 2 == 0);
+            nextToggle += pattern.duration_ms;
+            return;
+        }
+
+        AlertType finished = playing;
+        stopPattern();
+        if (states[finished].oneShot) {
+            release(finished);
+        }
+    }
+
+    // Drop one-shots that were outranked for a whole interval
+    for (int i = queueLength - 1; i >= 0; i--) {
+        AlertState& s = states[queue[i]];
+        if (s.oneShot && now - s.raisedAt >= alertInterval) {
+            release(queue[i]);
+        }
+    }
+
+    if (queueLength == 0) return;
+
+    // Only the most severe alert sounds; latched alerts repeat every interval
+    AlertType head = queue[0];
+    AlertState& s = states[head];
+    if (s.sounded && now - s.lastSounded < alertInterval) return;
+
+    if (muted) {
+        if (s.oneShot) {
+            release(head);
+        } else {
+            s.sounded = true;
+            s.lastSounded = now;
+        }
+        return;
+    }
+
+    startPattern(head, now);
 }
 
 // Mute alerts
 void AlertSystem::mute() {
     muted = true;
-    Serial.println("[Alert] Alerts muted");
+    stopPattern();
+    logPrintf("[Alert] Alerts muted\n");
 }
 
 // Unmute alerts
 void AlertSystem::unmute() {
     muted = false;
-    Serial.println("[Alert] Alerts unmuted");
+    logPrintf("[Alert] Alerts unmuted\n");
 }
 
 // Check if muted
@@ -127,13 +276,30 @@ bool AlertSystem::isMuted() {
     return muted;
 }
 
-// Get current alert type
+// Get highest-severity active alert
 AlertType AlertSystem::getCurrentAlert() {
-    return currentAlert;
+    return queueLength > 0 ? queue[0] : ALERT_NONE;
+}
+
+// Check a single alert
+bool AlertSystem::isActive(AlertType type) {
+    if (type <= ALERT_NONE || type >= ALERT_TYPE_COUNT) return false;
+    return states[type].active;
+}
+
+// Number of active alerts
+int AlertSystem::getActiveCount() {
+    return queueLength;
 }
 
 // Clear all alerts
 void AlertSystem::clearAlerts() {
-    currentAlert = ALERT_NONE;
-    digitalWrite(buzzerPin, LOW);
+    for (int i = 0; i < ALERT_TYPE_COUNT; i++) {
+        states[i].active = false;
+        states[i].oneShot = false;
+        states[i].condition = false;
+    }
+    queueLength = 0;
+    stopPattern();
+    HAL::gpio().write(buzzerPin, LOW);
 }
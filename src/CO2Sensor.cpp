@@ -4,54 +4,91 @@
  */
 
 #include "CO2Sensor.h"
+#include "HAL.h"
+#include "AdcEngine.h"
+#include "Telemetry.h"
+
+// Built by the compiler, one entry per ADC code
+static constexpr MQTable MQ135_TABLE = makeMQTable(CO2Sensor::CURVE);
+
+// Concentration for a raw ADC code
+float CO2Sensor::ppmFromRaw(int raw) {
+    return MQ135_TABLE[raw];
+}
 
 // Constructor
 CO2Sensor::CO2Sensor(uint8_t analogPin, int samples) {
     this->analogPin = analogPin;
     this->samples = samples;
+    this->sampleSum = 0;
+    this->sampleCount = 0;
+    this->nextSample_ms = 0;
     this->rawValue = 0;
     this->co2PPM = 0.0;
 }
 
 // Initialize sensor
 void CO2Sensor::begin() {
-    pinMode(analogPin, INPUT);
-    Serial.println("CO2 Sensor (MQ135) initialized on pin " + String(analogPin));
+    HAL::gpio().setMode(analogPin, INPUT);
+    adcEngine.addChannel(analogPin);  // Background scan when the pin supports it
+    logPrintf("CO2 Sensor (MQ135) initialized on pin %d\n", analogPin);
 }
 
-// Read CO2 concentration
-float CO2Sensor::readCO2() {
-    // Take multiple samples and average
-    long sum = 0;
-    for (int i = 0; i < samples; i++) {
-        sum += analogRead(analogPin);
-        delay(10);
+// Start a non-blocking read
+void CO2Sensor::startRead() {
+    sampleSum = 0;
+    sampleCount = 0;
+    nextSample_ms = HAL::clock().millis();
+    
+    // Already oversampled in the background, no conversions needed
+    if (adcEngine.isScanning(analogPin)) {
+        sampleSum = (long)adcEngine.read(analogPin) * samples;
+        sampleCount = samples;
     }
-    rawValue = sum / samples;
+}
+
+// Take the next sample once it is due, true when all samples are in
+bool CO2Sensor::pollRead() {
+    unsigned long now = HAL::clock().millis();
+    if (sampleCount < samples && (long)(now - nextSample_ms) >= 0) {
+        sampleSum += HAL::adc().read(analogPin);
+        sampleCount++;
+        nextSample_ms = now + CO2_SAMPLE_INTERVAL_MS;
+    }
+    return sampleCount >= samples;
+}
+
+// Average the collected samples and convert
+float CO2Sensor::finishRead() {
+    rawValue = sampleSum / samples;
     
-    // Convert ADC value (0-4095) to CO2 ppm (400-5000 ppm)
+    // Rs/R0 power-law curve, precomputed per ADC code (400-5000 ppm)
     // Normal outdoor CO2: ~400 ppm
     // Indoor acceptable: 400-1000 ppm
     // Poor ventilation: 1000-2000 ppm
     // Unhealthy: 2000-5000 ppm
-    co2PPM = map(rawValue, 0, 4095, 400, 5000);
+    co2PPM = MQ135_TABLE[rawValue];
     
     return co2PPM;
 }
 
-// Get air quality status
-String CO2Sensor::getAirQuality() {
-    if (co2PPM < 800) {
-        return "Excellent";
-    } else if (co2PPM < 1000) {
-        return "Good";
-    } else if (co2PPM < 1500) {
-        return "Fair";
-    } else if (co2PPM < 2000) {
-        return "Poor";
-    } else {
-        return "Bad";
+// Read CO2 concentration
+float CO2Sensor::readCO2() {
+    startRead();
+    while (!pollRead()) {
+        HAL::clock().delay(1);
     }
+    return finishRead();
+}
+
+// Get CO2 concentration in ppm
+float CO2Sensor::getCO2PPM() {
+    return co2PPM;
+}
+
+// Get air quality status
+AirQuality CO2Sensor::getAirQuality() {
+    return AIR_QUALITY_SCALE.classify(co2PPM);
 }
 
 // Check if dangerous
@@ -4,54 +4,91 @@
  */
 
 #include "COSensor.h"
+#include "HAL.h"
+#include "AdcEngine.h"
+#include "Telemetry.h"
+
+// Built by the compiler, one entry per ADC code
+static constexpr MQTable MQ7_TABLE = makeMQTable(COSensor::CURVE);
+
+// Concentration for a raw ADC code
+float COSensor::ppmFromRaw(int raw) {
+    return MQ7_TABLE[raw];
+}
 
 // Constructor
 COSensor::COSensor(uint8_t analogPin, int samples) {
     this->analogPin = analogPin;
     this->samples = samples;
+    this->sampleSum = 0;
+    this->sampleCount = 0;
+    this->nextSample_ms = 0;
     this->rawValue = 0;
     this->coPPM = 0.0;
 }
 
 // Initialize sensor
 void COSensor::begin() {
-    pinMode(analogPin, INPUT);
-    Serial.println("CO Sensor (MQ7) initialized on pin " + String(analogPin));
+    HAL::gpio().setMode(analogPin, INPUT);
+    adcEngine.addChannel(analogPin);  // Background scan when the pin supports it
+    logPrintf("CO Sensor (MQ7) initialized on pin %d\n", analogPin);
 }
 
-// Read CO concentration
-float COSensor::readCO() {
-    // Take multiple samples and average
-    long sum = 0;
-    for (int i = 0; i < samples; i++) {
-        sum += analogRead(analogPin);
-        delay(10);
+// Start a non-blocking read
+void COSensor::startRead() {
+    sampleSum = 0;
+    sampleCount = 0;
+    nextSample_ms = HAL::clock().millis();
+    
+    // Already oversampled in the background, no conversions needed
+    if (adcEngine.isScanning(analogPin)) {
+        sampleSum = (long)adcEngine.read(analogPin) * samples;
+        sampleCount = samples;
     }
-    rawValue = sum / samples;
+}
+
+// Take the next sample once it is due, true when all samples are in
+bool COSensor::pollRead() {
+    unsigned long now = HAL::clock().millis();
+    if (sampleCount < samples && (long)(now - nextSample_ms) >= 0) {
+        sampleSum += HAL::adc().read(analogPin);
+        sampleCount++;
+        nextSample_ms = now + CO_SAMPLE_INTERVAL_MS;
+    }
+    return sampleCount >= samples;
+}
+
+// Average the collected samples and convert
+float COSensor::finishRead() {
+    rawValue = sampleSum / samples;
     
-    // Convert ADC value (0-4095) to CO ppm (0-1000 ppm)
+    // Rs/R0 power-law curve, precomputed per ADC code (0-1000 ppm)
     // Safe level: 0-9 ppm
     // Acceptable: 10-50 ppm
     // Dangerous: 50-400 ppm
     // Lethal: 400+ ppm
-    coPPM = map(rawValue, 0, 4095, 0, 1000);
+    coPPM = MQ7_TABLE[rawValue];
     
     return coPPM;
 }
 
-// Get CO status
-String COSensor::getCOStatus() {
-    if (coPPM < 9) {
-        return "Safe";
-    } else if (coPPM < 35) {
-        return "Acceptable";
-    } else if (coPPM < 100) {
-        return "Caution";
-    } else if (coPPM < 400) {
-        return "Dangerous";
-    } else {
-        return "LETHAL";
+// Read CO concentration
+float COSensor::readCO() {
+    startRead();
+    while (!pollRead()) {
+        HAL::clock().delay(1);
     }
+    return finishRead();
+}
+
+// Get CO concentration in ppm
+float COSensor::getCOPPM() {
+    return coPPM;
+}
+
+// Get CO status
+COStatus COSensor::getCOStatus() {
+    return CO_SCALE.classify(coPPM);
 }
 
 // Check if dangerous
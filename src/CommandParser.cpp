@@ -0,0 +1,327 @@
+/*
+ * CommandParser.cpp
+ * Implementation of the streaming remote command parser
+ */
+
+#include "CommandParser.h"
+#include "Telemetry.h"
+#include <Arduino.h>
+
+#define COMMAND_MANTISSA_DIGITS 9    // Fits a uint32_t; further digits only scale
+#define COMMAND_EXPONENT_MAX 45
+
+// Constructor
+CommandParser::CommandParser() {
+    memset(&stats, 0, sizeof(stats));
+    command.channel = REMOTE_NO_CHANNEL;
+    command.value = 0.0f;
+    name[0] = '\0';
+    reset();
+}
+
+void CommandParser::reset() {
+    state = WAIT_FRAME;
+    startFrame();
+}
+
+void CommandParser::startFrame() {
+    key = KEY_OTHER;
+    keyLength = 0;
+    nameLength = 0;
+    haveName = false;
+    haveValue = false;
+    value = 0.0f;
+    binaryLength = 0;
+}
+
+bool CommandParser::isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// ==================== CRC / BINARY FRAMES ====================
+
+uint8_t commandCrc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void encodeBinaryCommand(uint8_t channel, float value, uint8_t* frame) {
+    frame[0] = COMMAND_SYNC;
+    frame[1] = channel;
+    memcpy(&frame[2], &value, sizeof(value));       // Little endian on ESP32 and x86
+    frame[6] = commandCrc8(&frame[1], 5);
+}
+
+CommandStatus CommandParser::endBinary() {
+    state = WAIT_FRAME;
+    float received;
+    memcpy(&received, &binary[2], sizeof(received));
+    if (commandCrc8(&binary[1], 5) != binary[6] || binary[1] >= REMOTE_CHANNEL_COUNT || !isfinite(received)) {
+        stats.malformed++;
+        return COMMAND_MALFORMED;
+    }
+    command.channel = binary[1];
+    command.value = received;
+    stats.commands++;
+    stats.binaryCommands++;
+    return COMMAND_READY;
+}
+
+// ==================== NUMBERS ====================
+
+// Digits are accumulated as they arrive: mantissa * 10^exponent
+void CommandParser::startNumber(char c) {
+    memset(&number, 0, sizeof(number));
+    if (c == '-') {
+        number.negative = true;
+    } else {
+        numberByte(c);
+    }
+}
+
+bool CommandParser::numberByte(char c) {
+    if (c >= '0' && c <= '9') {
+        if (number.inExponent) {
+            if (number.exponentValue < COMMAND_EXPONENT_MAX) {
+                number.exponentValue = number.exponentValue * 10 + (c - '0');
+            }
+            number.valid = true;
+            return true;
+        }
+        if (number.digits < COMMAND_MANTISSA_DIGITS) {
+            number.mantissa = number.mantissa * 10 + (c - '0');
+            if (number.mantissa > 0) number.digits++;
+            if (number.fraction) number.exponent--;
+        } else if (!number.fraction) {
+            number.exponent++;
+        }
+        number.valid = true;
+        return true;
+    }
+    if (c == '.' && !number.fraction && !number.inExponent) {
+        number.fraction = true;
+        return true;
+    }
+    if ((c == 'e' || c == 'E') && number.valid && !number.inExponent) {
+        number.inExponent = true;
+        number.valid = false;                        // Needs exponent digits
+        return true;
+    }
+    if ((c == '-' || c == '+') && number.inExponent && !number.valid && number.exponentValue == 0) {
+        number.exponentNegative = c == '-';
+        return true;
+    }
+    return false;
+}
+
+bool CommandParser::endNumber() {
+    if (!number.valid) return false;
+
+    int exponent = number.exponent + (number.exponentNegative ? -number.exponentValue : number.exponentValue);
+    if (exponent > COMMAND_EXPONENT_MAX) exponent = COMMAND_EXPONENT_MAX;
+    if (exponent < -COMMAND_EXPONENT_MAX) exponent = -COMMAND_EXPONENT_MAX;
+
+    // Dividing keeps 45.5 exact where multiplying by 0.1 would not
+    double result = number.mantissa;
+    for (; exponent > 0; exponent--) result *= 10.0;
+    for (; exponent < 0; exponent++) result /= 10.0;
+    value = (float)(number.negative ? -result : result);
+    return true;
+}
+
+// ==================== TEXT FRAMES ====================
+
+uint8_t CommandParser::lookup(const char* name, size_t length, uint32_t hash) {
+    uint8_t channel = REMOTE_HASH.channel[remoteHashSlot(hash)];
+    if (channel == REMOTE_NO_CHANNEL) return REMOTE_NO_CHANNEL;
+
+    const char* expected = REMOTE_CHANNELS[channel].name;
+    if (strlen(expected) != length || memcmp(expected, name, length) != 0) return REMOTE_NO_CHANNEL;
+    return channel;
+}
+
+CommandStatus CommandParser::fail(bool skipLine) {
+    state = skipLine ? SKIP_LINE : WAIT_FRAME;
+    stats.malformed++;
+    return COMMAND_MALFORMED;
+}
+
+CommandStatus CommandParser::endFrame() {
+    state = WAIT_FRAME;
+    if (!haveName || !haveValue) {
+        stats.malformed++;
+        return COMMAND_MALFORMED;
+    }
+
+    uint8_t channel = nameLength <= COMMAND_NAME_MAX ? lookup(name, nameLength, nameHash) : REMOTE_NO_CHANNEL;
+    if (channel == REMOTE_NO_CHANNEL) {
+        stats.unknown++;
+        return COMMAND_UNKNOWN;
+    }
+    command.channel = channel;
+    command.value = value;
+    stats.commands++;
+    return COMMAND_READY;
+}
+
+// Byte after a value: ',' for the next key, '}' to end the frame
+CommandStatus CommandParser::afterValue(char c) {
+    if (isSpace(c)) {
+        state = WAIT_SEPARATOR;
+        return COMMAND_PENDING;
+    }
+    if (c == ',') {
+        state = WAIT_KEY;
+        return COMMAND_PENDING;
+    }
+    if (c == '}') return endFrame();
+    return fail(true);
+}
+
+CommandStatus CommandParser::feed(uint8_t c) {
+    stats.bytes++;
+
+    if (state == IN_BINARY) {
+        binary[binaryLength++] = c;
+        return binaryLength == COMMAND_BINARY_LENGTH ? endBinary() : COMMAND_PENDING;
+    }
+    if (state == WAIT_FRAME) {
+        if (c == '{') {
+            startFrame();
+            state = WAIT_KEY;
+        } else if (c == COMMAND_SYNC) {
+            startFrame();
+            binary[binaryLength++] = c;
+            state = IN_BINARY;
+        }
+        return COMMAND_PENDING;
+    }
+
+    // Text frames are single lines
+    if (c == '\n') {
+        if (state == SKIP_LINE) {
+            state = WAIT_FRAME;
+            return COMMAND_PENDING;
+        }
+        return fail(false);
+    }
+
+    switch (state) {
+        case WAIT_KEY:
+            if (isSpace(c)) return COMMAND_PENDING;
+            if (c == '"') {
+                keyLength = 0;
+                state = IN_KEY;
+                return COMMAND_PENDING;
+            }
+            if (c == '}') return endFrame();
+            return fail(true);
+
+        case IN_KEY:
+            if (c == '"') {
+                keyText[keyLength <= COMMAND_KEY_MAX ? keyLength : COMMAND_KEY_MAX] = '\0';
+                if (keyLength == 6 && memcmp(keyText, "sensor", 6) == 0) {
+                    key = KEY_SENSOR;
+                } else if (keyLength == 5 && memcmp(keyText, "value", 5) == 0) {
+                    key = KEY_VALUE;
+                } else {
+                    key = KEY_OTHER;
+                }
+                state = WAIT_COLON;
+                return COMMAND_PENDING;
+            }
+            if (c == '\\') return fail(true);
+            if (keyLength < COMMAND_KEY_MAX) {
+                keyText[keyLength] = (char)c;
+            }
+            if (keyLength <= COMMAND_KEY_MAX) keyLength++;      // Stops one past: too long
+            return COMMAND_PENDING;
+
+        case WAIT_COLON:
+            if (isSpace(c)) return COMMAND_PENDING;
+            if (c == ':') {
+                state = WAIT_VALUE;
+                return COMMAND_PENDING;
+            }
+            return fail(true);
+
+        case WAIT_VALUE:
+            if (isSpace(c)) return COMMAND_PENDING;
+            if (c == '"' && key != KEY_VALUE) {
+                if (key == KEY_SENSOR) {
+                    nameLength = 0;
+                    nameHash = remoteHashStart();
+                }
+                state = IN_STRING;
+                return COMMAND_PENDING;
+            }
+            if ((c == '-' || (c >= '0' && c <= '9')) && key != KEY_SENSOR) {
+                startNumber((char)c);
+                state = IN_NUMBER;
+                return COMMAND_PENDING;
+            }
+            if (c >= 'a' && c <= 'z' && key == KEY_OTHER) {
+                state = IN_LITERAL;
+                return COMMAND_PENDING;
+            }
+            return fail(true);
+
+        case IN_STRING:
+            if (c == '"') {
+                if (key == KEY_SENSOR) {
+                    name[nameLength <= COMMAND_NAME_MAX ? nameLength : COMMAND_NAME_MAX] = '\0';
+                    haveName = true;
+                }
+                state = WAIT_SEPARATOR;
+                return COMMAND_PENDING;
+            }
+            if (c == '\\') return fail(true);             // Channel names need no escapes
+            if (key == KEY_SENSOR) {
+                nameHash = remoteHashStep(nameHash, c);
+                if (nameLength < COMMAND_NAME_MAX) name[nameLength] = (char)c;
+                if (nameLength <= COMMAND_NAME_MAX) nameLength++;
+            }
+            return COMMAND_PENDING;
+
+        case IN_NUMBER:
+            if (numberByte((char)c)) return COMMAND_PENDING;
+            if (!endNumber()) return fail(true);
+            if (key == KEY_VALUE) haveValue = true;
+            return afterValue((char)c);
+
+        case IN_LITERAL:
+            if (c >= 'a' && c <= 'z') return COMMAND_PENDING;
+            return afterValue((char)c);
+
+        case WAIT_SEPARATOR:
+            return afterValue((char)c);
+
+        default:                                           // SKIP_LINE
+            return COMMAND_PENDING;
+    }
+}
+
+const RemoteCommand& CommandParser::getCommand() {
+    return command;
+}
+
+const char* CommandParser::getName() {
+    return name;
+}
+
+// ==================== STATISTICS ====================
+
+const CommandParserStats& CommandParser::getStats() {
+    return stats;
+}
+
+void CommandParser::printStats() {
+    logPrintf("[Commands] %lu bytes, %lu commands (%lu binary), %lu unknown, %lu malformed\n",
+              stats.bytes, stats.commands, stats.binaryCommands, stats.unknown, stats.malformed);
+}
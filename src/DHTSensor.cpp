@@ -11,7 +11,8 @@ DHTSensor::DHTSensor(uint8_t pin) {
     this->temperature = 0.0;
     this->humidity = 0.0;
     this->lastReadSuccess = false;
-    this->dht = new DHT(pin, DHT_TYPE);
+    this->readyTime = 0;
+    this->dht = HAL::openHumiditySensor(pin, DHT_TYPE);
 }
 
 // Destructor
@@ -22,11 +23,35 @@ DHTSensor::~DHTSensor() {
 // Initialize the sensor
 void DHTSensor::begin() {
     dht->begin();
-    delay(2000); // DHT22 needs time to stabilize
+    readyTime = HAL::clock().millis() + DHT_STARTUP_MS; // DHT22 needs time to stabilize
+}
+
+// True once the start-up settling time has passed
+bool DHTSensor::isReady() {
+    return (long)(HAL::clock().millis() - readyTime) >= 0;
+}
+
+// Start a non-blocking read
+void DHTSensor::startRead() {
+}
+
+// Wait for the sensor to settle
+bool DHTSensor::pollRead() {
+    return isReady();
+}
+
+// Read the sensor
+bool DHTSensor::finishRead() {
+    return readSensor();
 }
 
 // Read temperature and humidity from sensor
 bool DHTSensor::readSensor() {
+    // Blocking callers wait out the start-up time here instead of in begin()
+    if (!isReady()) {
+        HAL::clock().delay(readyTime - HAL::clock().millis());
+    }
+    
     float temp = dht->readTemperature();
     float hum = dht->readHumidity();
     
@@ -53,39 +78,13 @@ float DHTSensor::getHumidity() {
 }
 
 // Get temperature status
-String DHTSensor::getTemperatureStatus() {
-    if (temperature < 0) {
-        return "Freezing";
-    } else if (temperature < 10) {
-        return "Cold";
-    } else if (temperature < 20) {
-        return "Cool";
-    } else if (temperature < 25) {
-        return "Comfortable";
-    } else if (temperature < 30) {
-        return "Warm";
-    } else if (temperature < 35) {
-        return "Hot";
-    } else {
-        return "Very Hot";
-    }
+AirTempStatus DHTSensor::getTemperatureStatus() {
+    return TEMPERATURE_SCALE.classify(temperature);
 }
 
 // Get humidity status
-String DHTSensor::getHumidityStatus() {
-    if (humidity < 20) {
-        return "Very Dry";
-    } else if (humidity < 30) {
-        return "Dry";
-    } else if (humidity < 50) {
-        return "Comfortable";
-    } else if (humidity < 70) {
-        return "Humid";
-    } else if (humidity < 85) {
-        return "Very Humid";
-    } else {
-        return "Extremely Humid";
-    }
+HumidityStatus DHTSensor::getHumidityStatus() {
+    return HUMIDITY_SCALE.classify(humidity);
 }
 
 // Check if last reading was successful
@@ -95,5 +94,5 @@ bool DHTSensor::isReadingValid() {
 
 // Get heat index (feels like temperature)
 float DHTSensor::getHeatIndex() {
-    return dht->computeHeatIndex(temperature, humidity, false);
+    return dht->computeHeatIndex(temperature, humidity);
 }
@@ -4,40 +4,80 @@
  */
 
 #include "GasSensor.h"
+#include "HAL.h"
+#include "AdcEngine.h"
+#include "Telemetry.h"
+
+// Built by the compiler, one entry per ADC code
+static constexpr MQTable MQ2_TABLE = makeMQTable(GasSensor::CURVE);
+
+// Concentration for a raw ADC code
+float GasSensor::ppmFromRaw(int raw) {
+    return MQ2_TABLE[raw];
+}
 
 // Constructor
 GasSensor::GasSensor(uint8_t analogPin, int samples) {
     this->analogPin = analogPin;
     this->samples = samples;
+    this->sampleSum = 0;
+    this->sampleCount = 0;
+    this->nextSample_ms = 0;
     this->rawValue = 0;
     this->gasPPM = 0.0;
 }
 
 // Initialize the sensor
 void GasSensor::begin() {
-    pinMode(analogPin, INPUT);
-    Serial.println("[Gas] MQ2 Gas Sensor initialized");
-    Serial.println("[Gas] Warming up... (Allow 20-30 seconds for calibration)");
+    HAL::gpio().setMode(analogPin, INPUT);
+    adcEngine.addChannel(analogPin);  // Background scan when the pin supports it
+    logPrintf("[Gas] MQ2 Gas Sensor initialized\n");
+    logPrintf("[Gas] Warming up... (Allow 20-30 seconds for calibration)\n");
 }
 
-// Read gas concentration
-float GasSensor::readGas() {
-    // Read analog value and average multiple samples
-    long sum = 0;
-    for (int i = 0; i < samples; i++) {
-        sum += analogRead(analogPin);
-        delay(2);
+// Start a non-blocking read
+void GasSensor::startRead() {
+    sampleSum = 0;
+    sampleCount = 0;
+    nextSample_ms = HAL::clock().millis();
+    
+    // Already oversampled in the background, no conversions needed
+    if (adcEngine.isScanning(analogPin)) {
+        sampleSum = (long)adcEngine.read(analogPin) * samples;
+        sampleCount = samples;
+    }
+}
+
+// Take the next sample once it is due, true when all samples are in
+bool GasSensor::pollRead() {
+    unsigned long now = HAL::clock().millis();
+    if (sampleCount < samples && (long)(now - nextSample_ms) >= 0) {
+        sampleSum += HAL::adc().read(analogPin);
+        sampleCount++;
+        nextSample_ms = now + GAS_SAMPLE_INTERVAL_MS;
     }
-    rawValue = sum / samples;
+    return sampleCount >= samples;
+}
+
+// Average the collected samples and convert
+float GasSensor::finishRead() {
+    rawValue = sampleSum / samples;
     
-    // Convert to approximate PPM (simplified calculation)
-    // MQ2 has non-linear response, this is an approximation
-    // Map 0-4095 ADC to 0-10000 ppm range
-    gasPPM = map(rawValue, 0, 4095, 0, 10000);
+    // Rs/R0 power-law curve, precomputed per ADC code
+    gasPPM = MQ2_TABLE[rawValue];
     
     return gasPPM;
 }
 
+// Read gas concentration
+float GasSensor::readGas() {
+    startRead();
+    while (!pollRead()) {
+        HAL::clock().delay(1);
+    }
+    return finishRead();
+}
+
 // Get gas concentration in ppm
 float GasSensor::getGasPPM() {
     return gasPPM;
@@ -49,18 +89,8 @@ int GasSensor::getRawValue() {
 }
 
 // Get gas status
-String GasSensor::getGasStatus() {
-    if (gasPPM < 300) {
-        return "Clean Air";
-    } else if (gasPPM < 1000) {
-        return "Slight Gas";
-    } else if (gasPPM < 3000) {
-        return "Moderate Gas";
-    } else if (gasPPM < 5000) {
-        return "High Gas";
-    } else {
-        return "DANGEROUS!";
-    }
+GasStatus GasSensor::getGasStatus() {
+    return GAS_SCALE.classify(gasPPM);
 }
 
 // Check if gas level is dangerous
@@ -0,0 +1,639 @@
+/*
+ * HAL_ESP32.cpp
+ * ESP32 (Arduino framework) backend of the Hardware Abstraction Layer
+ */
+
+#ifdef ARDUINO
+
+#include "HAL.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include <DHT.h>
+#include <HX711.h>
+#include <driver/adc.h>
+#include <driver/pcnt.h>
+#include <sys/time.h>
+
+static HalInputObserver* inputObserver = nullptr;
+
+static inline void observeInput(HalInputKind kind, uint8_t pin, int32_t value) {
+    if (inputObserver != nullptr) inputObserver->onInput(kind, pin, value);
+}
+
+class Esp32Adc : public HalAdc {
+public:
+    void setResolution(uint8_t bits) override {
+        analogReadResolution(bits);
+    }
+
+    int read(uint8_t pin) override {
+        int value = analogRead(pin);
+        observeInput(HAL_INPUT_ANALOG, pin, value);
+        return value;
+    }
+};
+
+#define ESP32_ADC1_CHANNELS 8
+#define ESP32_ADC_DMA_FRAME 256        // Bytes per DMA transfer
+#define ESP32_ADC_DMA_BUFFER 1024      // Bytes the driver buffers between reads
+#define ESP32_ADC_NO_PIN 0xFF
+
+// ADC1 in DMA (digital controller) mode; ADC2 is shared with WiFi and
+// cannot be scanned
+class Esp32AdcScanner : public HalAdcScanner {
+private:
+    uint8_t channelPin[ESP32_ADC1_CHANNELS];
+    uint8_t frame[ESP32_ADC_DMA_FRAME];
+    uint32_t frameLength;
+    uint32_t framePosition;
+    uint32_t overruns;
+    bool running;
+
+public:
+    Esp32AdcScanner() {
+        for (int i = 0; i < ESP32_ADC1_CHANNELS; i++) {
+            channelPin[i] = ESP32_ADC_NO_PIN;
+        }
+        frameLength = 0;
+        framePosition = 0;
+        overruns = 0;
+        running = false;
+    }
+
+    bool supportsPin(uint8_t pin) override {
+        int8_t channel = digitalPinToAnalogChannel(pin);
+        return channel >= 0 && channel < ESP32_ADC1_CHANNELS;
+    }
+
+    bool begin(const uint8_t* pins, uint8_t count, uint32_t sampleRate_hz) override {
+        if (running || count == 0 || count > SOC_ADC_PATT_LEN_MAX) return false;
+
+        adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX] = {};
+        uint32_t channelMask = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!supportsPin(pins[i])) return false;
+            uint8_t channel = digitalPinToAnalogChannel(pins[i]);
+            channelPin[channel] = pins[i];
+            channelMask |= 1UL << channel;
+
+            pattern[i].atten = ADC_ATTEN_DB_11;
+            pattern[i].channel = channel;
+            pattern[i].unit = 0;  // ADC1
+            pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        }
+
+        adc_digi_init_config_t init = {};
+        init.max_store_buf_size = ESP32_ADC_DMA_BUFFER;
+        init.conv_num_each_intr = ESP32_ADC_DMA_FRAME;
+        init.adc1_chan_mask = channelMask;
+        init.adc2_chan_mask = 0;
+        if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+        adc_digi_configuration_t config = {};
+        config.conv_limit_en = 1;  // Required on the ESP32
+        config.conv_limit_num = 250;
+        config.pattern_num = count;
+        config.adc_pattern = pattern;
+        config.sample_freq_hz = sampleRate_hz;
+        config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+        config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+        if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK) {
+            adc_digi_deinitialize();
+            return false;
+        }
+
+        frameLength = 0;
+        framePosition = 0;
+        running = true;
+        return true;
+    }
+
+    void end() override {
+        if (!running) return;
+        adc_digi_stop();
+        adc_digi_deinitialize();
+        running = false;
+    }
+
+    size_t read(HalAdcSample* samples, size_t max) override {
+        size_t count = 0;
+        while (running && count < max) {
+            if (framePosition >= frameLength) {
+                uint32_t length = 0;
+                esp_err_t result = adc_digi_read_bytes(frame, sizeof(frame), &length, 0);
+                // INVALID_STATE: the driver buffer overflowed, data is still valid
+                if (result == ESP_ERR_INVALID_STATE) overruns++;
+                else if (result != ESP_OK) break;
+                if (length == 0) break;
+                frameLength = length;
+                framePosition = 0;
+            }
+
+            const adc_digi_output_data_t* data = (const adc_digi_output_data_t*)&frame[framePosition];
+            framePosition += SOC_ADC_DIGI_RESULT_BYTES;
+
+            uint8_t channel = data->type1.channel;
+            if (channel >= ESP32_ADC1_CHANNELS || channelPin[channel] == ESP32_ADC_NO_PIN) continue;
+            samples[count].pin = channelPin[channel];
+            samples[count].value = data->type1.data;
+            observeInput(HAL_INPUT_ANALOG, samples[count].pin, samples[count].value);
+            count++;
+        }
+        return count;
+    }
+
+    uint32_t getOverruns() override {
+        return overruns;
+    }
+};
+
+class Esp32Gpio : public HalGpio {
+public:
+    void setMode(uint8_t pin, uint8_t mode) override {
+        pinMode(pin, mode);
+    }
+
+    int read(uint8_t pin) override {
+        int level = digitalRead(pin);
+        observeInput(HAL_INPUT_DIGITAL, pin, level);
+        return level;
+    }
+
+    // Called from timer ISRs, keep it in IRAM
+    void IRAM_ATTR write(uint8_t pin, uint8_t value) override {
+        digitalWrite(pin, value);
+    }
+
+    void attachInterrupt(uint8_t pin, void (*handler)(), int mode) override {
+        ::attachInterrupt(digitalPinToInterrupt(pin), handler, mode);
+    }
+
+    void detachInterrupt(uint8_t pin) override {
+        ::detachInterrupt(digitalPinToInterrupt(pin));
+    }
+};
+
+#define ESP32_CAPTURE_SLOTS 4
+#define ESP32_CAPTURE_FREE 0xFF
+
+// One armed pulse capture, filled in by the edge interrupt
+struct CaptureSlot {
+    uint8_t pin;
+    uint8_t state;
+    volatile bool started;
+    volatile bool done;
+    volatile unsigned long edge_us;
+    volatile unsigned long width_us;
+};
+
+static void IRAM_ATTR onCaptureEdge(void* arg) {
+    CaptureSlot* slot = (CaptureSlot*)arg;
+    unsigned long now = micros();
+
+    if (digitalRead(slot->pin) == slot->state) {
+        slot->edge_us = now;
+        slot->started = true;
+    } else if (slot->started && !slot->done) {
+        slot->width_us = now - slot->edge_us;
+        slot->done = true;
+    }
+}
+
+class Esp32PulseTimer : public HalPulseTimer {
+private:
+    CaptureSlot slots[ESP32_CAPTURE_SLOTS];
+
+    CaptureSlot* findSlot(uint8_t pin) {
+        for (int i = 0; i < ESP32_CAPTURE_SLOTS; i++) {
+            if (slots[i].pin == pin) return &slots[i];
+        }
+        return nullptr;
+    }
+
+public:
+    Esp32PulseTimer() {
+        for (int i = 0; i < ESP32_CAPTURE_SLOTS; i++) {
+            slots[i].pin = ESP32_CAPTURE_FREE;
+        }
+    }
+
+    unsigned long measurePulse(uint8_t pin, uint8_t state, unsigned long timeout_us) override {
+        unsigned long width = pulseIn(pin, state, timeout_us);
+        observeInput(HAL_INPUT_PULSE, pin, (int32_t)width);
+        return width;
+    }
+
+    void startCapture(uint8_t pin, uint8_t state) override {
+        CaptureSlot* slot = findSlot(pin);
+        if (slot == nullptr) slot = findSlot(ESP32_CAPTURE_FREE);
+        if (slot == nullptr) return;
+
+        detachInterrupt(digitalPinToInterrupt(pin));
+        slot->pin = pin;
+        slot->state = state;
+        slot->started = false;
+        slot->done = false;
+        slot->width_us = 0;
+        attachInterruptArg(digitalPinToInterrupt(pin), onCaptureEdge, slot, CHANGE);
+    }
+
+    bool readCapture(uint8_t pin, unsigned long& width_us) override {
+        CaptureSlot* slot = findSlot(pin);
+        if (slot == nullptr || !slot->done) return false;
+        width_us = slot->width_us;
+        observeInput(HAL_INPUT_PULSE, pin, (int32_t)width_us);
+        return true;
+    }
+
+    void stopCapture(uint8_t pin) override {
+        CaptureSlot* slot = findSlot(pin);
+        if (slot != nullptr) {
+            detachInterrupt(digitalPinToInterrupt(pin));
+            slot->pin = ESP32_CAPTURE_FREE;
+        }
+    }
+};
+
+#define ESP32_COUNTER_UNITS 8
+#define ESP32_COUNTER_LIMIT 32767       // Counter wraps to 0 here
+#define ESP32_COUNTER_MAX_FILTER 1023   // Filter register width (APB cycles)
+
+// Edge timestamps of one unit, written by the capture interrupt
+struct CounterCapture {
+    uint8_t pin;
+    uint32_t filter_us;
+    volatile unsigned long lastEdge_us;
+    volatile unsigned long period_us;
+    volatile uint8_t edges;            // Saturates at 2
+};
+
+static void IRAM_ATTR onCounterEdge(void* arg) {
+    CounterCapture* capture = (CounterCapture*)arg;
+    unsigned long now = micros();
+    unsigned long since = now - capture->lastEdge_us;
+
+    if (capture->edges > 0 && since < capture->filter_us) return;
+    if (capture->edges > 0) capture->period_us = since;
+    capture->lastEdge_us = now;
+    if (capture->edges < 2) capture->edges++;
+}
+
+class Esp32PulseCounter : public HalPulseCounter {
+private:
+    bool active[ESP32_COUNTER_UNITS];
+    int edgeMode[ESP32_COUNTER_UNITS];
+    int16_t lastCount[ESP32_COUNTER_UNITS];
+    CounterCapture capture[ESP32_COUNTER_UNITS];
+
+public:
+    Esp32PulseCounter() {
+        for (int i = 0; i < ESP32_COUNTER_UNITS; i++) {
+            active[i] = false;
+        }
+    }
+
+    bool begin(uint8_t unit, uint8_t pin, int edge, uint32_t filter_ns) override {
+        if (unit >= ESP32_COUNTER_UNITS) return false;
+
+        pcnt_config_t config = {};
+        config.pulse_gpio_num = pin;
+        config.ctrl_gpio_num = PCNT_PIN_NOT_USED;
+        config.lctrl_mode = PCNT_MODE_KEEP;
+        config.hctrl_mode = PCNT_MODE_KEEP;
+        config.pos_mode = (edge == RISING || edge == CHANGE) ? PCNT_COUNT_INC : PCNT_COUNT_DIS;
+        config.neg_mode = (edge == FALLING || edge == CHANGE) ? PCNT_COUNT_INC : PCNT_COUNT_DIS;
+        config.counter_h_lim = ESP32_COUNTER_LIMIT;
+        config.counter_l_lim = 0;
+        config.unit = (pcnt_unit_t)unit;
+        config.channel = PCNT_CHANNEL_0;
+        if (pcnt_unit_config(&config) != ESP_OK) return false;
+
+        // Filter counts APB clock cycles (80 MHz)
+        uint32_t cycles = filter_ns * 80 / 1000;
+        if (cycles > ESP32_COUNTER_MAX_FILTER) cycles = ESP32_COUNTER_MAX_FILTER;
+        if (cycles > 0) {
+            pcnt_set_filter_value((pcnt_unit_t)unit, (uint16_t)cycles);
+            pcnt_filter_enable((pcnt_unit_t)unit);
+        } else {
+            pcnt_filter_disable((pcnt_unit_t)unit);
+        }
+
+        pcnt_counter_pause((pcnt_unit_t)unit);
+        pcnt_counter_clear((pcnt_unit_t)unit);
+        pcnt_counter_resume((pcnt_unit_t)unit);
+
+        active[unit] = true;
+        edgeMode[unit] = edge;
+        lastCount[unit] = 0;
+        capture[unit].pin = pin;
+        capture[unit].filter_us = filter_ns / 1000;
+        capture[unit].edges = 0;
+        return true;
+    }
+
+    void end(uint8_t unit) override {
+        if (unit >= ESP32_COUNTER_UNITS || !active[unit]) return;
+        enableCapture(unit, false);
+        pcnt_counter_pause((pcnt_unit_t)unit);
+        active[unit] = false;
+    }
+
+    // Difference to the previous read, modulo the hardware wrap
+    uint32_t takeCount(uint8_t unit) override {
+        if (unit >= ESP32_COUNTER_UNITS || !active[unit]) return 0;
+
+        int16_t count = 0;
+        pcnt_get_counter_value((pcnt_unit_t)unit, &count);
+        int32_t delta = count - lastCount[unit];
+        if (delta < 0) delta += ESP32_COUNTER_LIMIT;
+        lastCount[unit] = count;
+        return (uint32_t)delta;
+    }
+
+    void enableCapture(uint8_t unit, bool enable) override {
+        if (unit >= ESP32_COUNTER_UNITS || !active[unit]) return;
+
+        uint8_t pin = capture[unit].pin;
+        detachInterrupt(digitalPinToInterrupt(pin));
+        if (enable) {
+            capture[unit].edges = 0;
+            attachInterruptArg(digitalPinToInterrupt(pin), onCounterEdge, &capture[unit], edgeMode[unit]);
+        }
+    }
+
+    bool readPeriod(uint8_t unit, unsigned long& period_us, unsigned long& lastEdge_us) override {
+        if (unit >= ESP32_COUNTER_UNITS || !active[unit]) return false;
+
+        noInterrupts();
+        bool valid = capture[unit].edges >= 2;
+        period_us = capture[unit].period_us;
+        lastEdge_us = capture[unit].lastEdge_us;
+        interrupts();
+        return valid;
+    }
+};
+
+class Esp32Clock : public HalClock {
+public:
+    // Used to timestamp edges in ISRs, keep it in IRAM
+    unsigned long IRAM_ATTR millis() override {
+        return ::millis();
+    }
+
+    unsigned long micros() override {
+        return ::micros();
+    }
+
+    void delay(unsigned long ms) override {
+        ::delay(ms);
+    }
+
+    void delayMicroseconds(unsigned long us) override {
+        ::delayMicroseconds(us);
+    }
+
+    // System time runs on the RTC timer and is kept across deep sleep
+    // and software resets
+    uint32_t rtcSeconds() override {
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        return (uint32_t)now.tv_sec;
+    }
+};
+
+class Esp32Timer : public HalTimer {
+private:
+    hw_timer_t* timers[4];
+
+public:
+    Esp32Timer() {
+        for (int i = 0; i < 4; i++) {
+            timers[i] = nullptr;
+        }
+    }
+
+    bool start(uint8_t timerId, uint64_t period_us, void (*handler)()) override {
+        if (timerId >= 4) return false;
+
+        // Prescaler 80 = 1 MHz tick, count up, auto-reload
+        timers[timerId] = timerBegin(timerId, 80, true);
+        if (timers[timerId] == nullptr) return false;
+
+        timerAttachInterrupt(timers[timerId], handler, true);
+        timerAlarmWrite(timers[timerId], period_us, true);
+        timerAlarmEnable(timers[timerId]);
+        return true;
+    }
+
+    void setPeriod(uint8_t timerId, uint64_t period_us) override {
+        if (timerId < 4 && timers[timerId] != nullptr) {
+            timerAlarmWrite(timers[timerId], period_us, true);
+        }
+    }
+
+    void stop(uint8_t timerId) override {
+        if (timerId < 4 && timers[timerId] != nullptr) {
+            timerAlarmDisable(timers[timerId]);
+            timerEnd(timers[timerId]);
+            timers[timerId] = nullptr;
+        }
+    }
+};
+
+class Esp32Tone : public HalTone {
+public:
+    void setup(uint8_t channel, uint32_t frequency, uint8_t resolutionBits) override {
+        ledcSetup(channel, frequency, resolutionBits);
+    }
+
+    void attach(uint8_t pin, uint8_t channel) override {
+        ledcAttachPin(pin, channel);
+    }
+
+    void setFrequency(uint8_t channel, uint32_t frequency) override {
+        ledcWriteTone(channel, frequency);
+    }
+
+    void setDuty(uint8_t channel, uint32_t duty) override {
+        ledcWrite(channel, duty);
+    }
+};
+
+class Esp32I2C : public HalI2C {
+public:
+    void begin() override {
+        Wire.begin();
+    }
+
+    uint8_t write(uint8_t address, const uint8_t* data, size_t length) override {
+        Wire.beginTransmission(address);
+        Wire.write(data, length);
+        return Wire.endTransmission();
+    }
+};
+
+// UART0 through the Arduino core: the IDF driver copies into its transmit
+// ring buffer and refills the hardware FIFO from the TX-empty interrupt
+class Esp32Uart : public HalUart {
+public:
+    void begin(unsigned long baud, size_t txBuffer) override {
+        Serial.setTxBufferSize(txBuffer);        // Only takes effect before begin()
+        Serial.begin(baud);
+    }
+
+    size_t availableForWrite() override {
+        return Serial.availableForWrite();
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        size_t room = Serial.availableForWrite();
+        return Serial.write(data, length < room ? length : room);
+    }
+};
+
+class Esp32TemperatureBus : public HalTemperatureBus {
+private:
+    OneWire oneWire;
+    DallasTemperature sensors;
+    uint8_t pin;
+
+public:
+    Esp32TemperatureBus(uint8_t pin) : oneWire(pin), sensors(&oneWire), pin(pin) {}
+
+    int begin() override {
+        sensors.begin();
+        return sensors.getDeviceCount();
+    }
+
+    int getDeviceCount() override {
+        return sensors.getDeviceCount();
+    }
+
+    void setWaitForConversion(bool wait) override {
+        sensors.setWaitForConversion(wait);
+    }
+
+    void requestTemperatures() override {
+        sensors.requestTemperatures();
+    }
+
+    bool isConversionComplete() override {
+        return sensors.isConversionComplete();
+    }
+
+    float getTempC(uint8_t index) override {
+        float temp = sensors.getTempCByIndex(index);
+        if (temp == DEVICE_DISCONNECTED_C) temp = HAL_TEMP_DISCONNECTED;
+        observeInput(HAL_INPUT_PROBE_TEMP, pin, halInputFixed(temp, HAL_INPUT_PROBE_SCALE));
+        return temp;
+    }
+};
+
+class Esp32HumiditySensor : public HalHumiditySensor {
+private:
+    DHT dht;
+    uint8_t pin;
+
+public:
+    Esp32HumiditySensor(uint8_t pin, uint8_t type) : dht(pin, type), pin(pin) {}
+
+    void begin() override {
+        dht.begin();
+    }
+
+    float readTemperature() override {
+        float temperature = dht.readTemperature();
+        observeInput(HAL_INPUT_AIR_TEMP, pin, halInputFixed(temperature, HAL_INPUT_DHT_SCALE));
+        return temperature;
+    }
+
+    float readHumidity() override {
+        float humidity = dht.readHumidity();
+        observeInput(HAL_INPUT_HUMIDITY, pin, halInputFixed(humidity, HAL_INPUT_DHT_SCALE));
+        return humidity;
+    }
+
+    float computeHeatIndex(float temperature, float humidity) override {
+        return dht.computeHeatIndex(temperature, humidity, false);
+    }
+};
+
+class Esp32LoadCell : public HalLoadCell {
+private:
+    HX711 scale;
+    uint8_t dataPin;
+    uint8_t clockPin;
+
+public:
+    Esp32LoadCell(uint8_t dataPin, uint8_t clockPin) : dataPin(dataPin), clockPin(clockPin) {}
+
+    void begin() override {
+        scale.begin(dataPin, clockPin);
+    }
+
+    bool isReady() override {
+        return scale.is_ready();
+    }
+
+    bool waitReady(unsigned long timeout_ms) override {
+        return scale.wait_ready_timeout(timeout_ms);
+    }
+
+    void setScale(float factor) override {
+        scale.set_scale(factor);
+    }
+
+    void tare() override {
+        scale.tare();
+    }
+
+    // get_units() with the raw average exposed to the observer
+    float getUnits(uint8_t times) override {
+        long raw = scale.read_average(times);
+        observeInput(HAL_INPUT_LOAD_CELL, dataPin, (int32_t)raw);
+        return (float)(raw - scale.get_offset()) / scale.get_scale();
+    }
+};
+
+// ==================== BACKEND INSTANCES ====================
+static Esp32Adc esp32Adc;
+static Esp32AdcScanner esp32AdcScanner;
+static Esp32Gpio esp32Gpio;
+static Esp32PulseTimer esp32Pulse;
+static Esp32PulseCounter esp32Counter;
+static Esp32Clock esp32Clock;
+static Esp32Timer esp32Timer;
+static Esp32Tone esp32Tone;
+static Esp32I2C esp32I2C;
+static Esp32Uart esp32Uart;
+
+HalAdc& HAL::adc() { return esp32Adc; }
+HalAdcScanner& HAL::adcScanner() { return esp32AdcScanner; }
+HalGpio& HAL::gpio() { return esp32Gpio; }
+HalPulseTimer& HAL::pulse() { return esp32Pulse; }
+HalPulseCounter& HAL::counter() { return esp32Counter; }
+HalClock& HAL::clock() { return esp32Clock; }
+HalTimer& HAL::timer() { return esp32Timer; }
+HalTone& HAL::tone() { return esp32Tone; }
+HalI2C& HAL::i2c() { return esp32I2C; }
+HalUart& HAL::uart() { return esp32Uart; }
+
+void HAL::setInputObserver(HalInputObserver* observer) {
+    inputObserver = observer;
+}
+
+HalTemperatureBus* HAL::openTemperatureBus(uint8_t pin) {
+    return new Esp32TemperatureBus(pin);
+}
+
+HalHumiditySensor* HAL::openHumiditySensor(uint8_t pin, uint8_t type) {
+    return new Esp32HumiditySensor(pin, type);
+}
+
+HalLoadCell* HAL::openLoadCell(uint8_t dataPin, uint8_t clockPin) {
+    return new Esp32LoadCell(dataPin, clockPin);
+}
+
+#endif // ARDUINO
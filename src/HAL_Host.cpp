@@ -0,0 +1,868 @@
+/*
+ * HAL_Host.cpp
+ * Host (native) backend of the Hardware Abstraction Layer
+ *
+ * All time is virtual: blocking calls advance the simulated clock by the
+ * time the real part would take, so long runs finish in seconds.
+ */
+
+#ifndef ARDUINO
+
+#include "HostHAL.h"
+#include <Arduino.h>
+#include <map>
+#include <memory>
+
+#define HOST_PIN_COUNT 64
+#define HOST_TIMER_COUNT 4
+#define HOST_TONE_CHANNELS 16
+#define HOST_COUNTER_UNITS 8
+
+// ==================== SIMULATION STATE ====================
+struct HostTimerState {
+    bool active = false;
+    uint64_t period_us = 0;
+    uint64_t next_us = 0;
+    void (*handler)() = nullptr;
+};
+
+struct HostPinState {
+    int analogValue = 0;
+    HostHAL::AnalogSource analogSource;
+    uint64_t analogReads = 0;
+    uint64_t analogScans = 0;
+    int level = LOW;
+    int connectedTo = -1;          // -1 if not wired to another pin
+    void (*isr)() = nullptr;
+    int isrMode = 0;
+    unsigned long pulseWidth = 0;
+    HostHAL::PulseSource pulseSource;
+    bool captureArmed = false;
+    uint64_t captureStart = 0;
+    unsigned long captureWidth = 0;
+};
+
+struct HostCounterState {
+    bool active = false;
+    uint8_t pin = 0;
+    int edge = 0;
+    uint64_t filter_ns = 0;
+    uint64_t lastChange_us = 0;    // Last level change on the pin (glitch filter)
+    bool seenChange = false;
+    uint32_t count = 0;
+    uint32_t taken = 0;            // Count at the previous takeCount()
+    bool capture = false;
+    uint8_t edges = 0;             // Captured edges, saturates at 2
+    uint64_t lastEdge_us = 0;
+    uint64_t period_us = 0;
+};
+
+struct HostProbeState {
+    int count;
+    float tempC;
+    bool waitForConversion;
+    uint64_t conversionDone;
+};
+
+struct HostDhtState {
+    float temperature;
+    float humidity;
+};
+
+struct HostLoadCellState {
+    long rawCounts;
+    bool ready;
+};
+
+// Console UART: the transmit buffer drains at baud / 10 bytes per second
+struct HostUartState {
+    unsigned long baud = 0;
+    size_t capacity = 0;
+    size_t queued = 0;              // Bytes still in the transmit buffer
+    uint64_t drained_us = 0;        // Virtual time queued was last brought up to
+    uint64_t bytesWritten = 0;
+    std::vector<uint8_t> output;    // Wire bytes not yet taken by the host program
+};
+
+static uint64_t hostNow = 0;
+static int64_t rtcOffset_us = 0;       // RTC time minus virtual time
+static HostPinState pins[HOST_PIN_COUNT];
+static HostTimerState timers[HOST_TIMER_COUNT];
+static HostCounterState counters[HOST_COUNTER_UNITS];
+static uint32_t toneFrequency[HOST_TONE_CHANNELS];
+static uint32_t toneDuty[HOST_TONE_CHANNELS];
+static std::map<uint8_t, HostProbeState> probes;
+static std::map<uint8_t, HostDhtState> dhtSensors;
+static std::map<uint8_t, HostLoadCellState> loadCells;
+static std::map<uint8_t, HostHAL::I2CDevice> i2cDevices;
+static std::map<uint8_t, uint64_t> i2cBytes;
+static HostUartState uart;
+static HalInputObserver* inputObserver = nullptr;
+
+HardwareSerial Serial;
+
+static inline void observeInput(HalInputKind kind, uint8_t pin, int32_t value) {
+    if (inputObserver != nullptr) inputObserver->onInput(kind, pin, value);
+}
+
+static void fireTimersUntil(uint64_t target) {
+    for (;;) {
+        int due = -1;
+        for (int i = 0; i < HOST_TIMER_COUNT; i++) {
+            if (timers[i].active && timers[i].next_us <= target &&
+                (due < 0 || timers[i].next_us < timers[due].next_us)) {
+                due = i;
+            }
+        }
+        if (due < 0) break;
+
+        hostNow = timers[due].next_us;
+        timers[due].next_us += timers[due].period_us;
+        timers[due].handler();
+    }
+    hostNow = target;
+}
+
+// Feed a level change into the counter units watching the pin. Like the
+// PCNT filter, a level that lasted less than filter_ns is not counted.
+static void countEdge(uint8_t pin, bool rising) {
+    for (int i = 0; i < HOST_COUNTER_UNITS; i++) {
+        HostCounterState& c = counters[i];
+        if (!c.active || c.pin != pin) continue;
+
+        bool glitch = c.seenChange && (hostNow - c.lastChange_us) * 1000 < c.filter_ns;
+        c.lastChange_us = hostNow;
+        c.seenChange = true;
+        if (glitch) continue;
+        if (!(c.edge == CHANGE || (c.edge == RISING && rising) || (c.edge == FALLING && !rising))) continue;
+
+        c.count++;
+        if (c.capture) {
+            if (c.edges > 0) c.period_us = hostNow - c.lastEdge_us;
+            c.lastEdge_us = hostNow;
+            if (c.edges < 2) c.edges++;
+        }
+    }
+}
+
+static int analogValueAt(uint8_t pin, uint64_t now_us) {
+    int value = pins[pin].analogSource ? pins[pin].analogSource(now_us) : pins[pin].analogValue;
+    return constrain(value, 0, 4095);
+}
+
+// Drive a pin's level: edges reach the counter units, interrupt handlers
+// and wired pins
+static void driveDigital(uint8_t pin, int level) {
+    HostPinState& p = pins[pin];
+    int previous = p.level;
+    p.level = level ? HIGH : LOW;
+
+    if (previous != p.level) {
+        countEdge(pin, p.level == HIGH);
+    }
+
+    if (p.isr != nullptr && previous != p.level) {
+        bool rising = (p.level == HIGH);
+        if (p.isrMode == CHANGE || (p.isrMode == RISING && rising) || (p.isrMode == FALLING && !rising)) {
+            p.isr();
+        }
+    }
+
+    if (p.connectedTo >= 0) {
+        driveDigital((uint8_t)p.connectedTo, p.level);
+    }
+}
+
+// ==================== BACKEND CLASSES ====================
+class HostAdc : public HalAdc {
+public:
+    void setResolution(uint8_t bits) override {
+        (void)bits;
+    }
+
+    int read(uint8_t pin) override {
+        if (pin >= HOST_PIN_COUNT) return 0;
+        HostHAL::advanceMicros(HOST_ADC_CONVERSION_US);
+        pins[pin].analogReads++;
+        int value = analogValueAt(pin, hostNow);
+        observeInput(HAL_INPUT_ANALOG, pin, value);
+        return value;
+    }
+};
+
+// Conversions are produced lazily: read() emits every conversion the
+// scanner would have made since the previous call, at its virtual time
+class HostAdcScanner : public HalAdcScanner {
+private:
+    uint8_t scanPins[HOST_PIN_COUNT];
+    uint8_t count = 0;
+    uint8_t next = 0;            // Index of the pin converted next
+    uint64_t period_ns = 0;
+    uint64_t next_ns = 0;        // Virtual time of the next conversion
+    bool running = false;
+    uint32_t overruns = 0;
+
+public:
+    // Same constraint as the ESP32: only ADC1 (GPIO 32-39) is scanned
+    bool supportsPin(uint8_t pin) override {
+        return pin >= 32 && pin <= 39;
+    }
+
+    bool begin(const uint8_t* pins, uint8_t count, uint32_t sampleRate_hz) override {
+        if (count == 0 || sampleRate_hz == 0) return false;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!supportsPin(pins[i])) return false;
+            scanPins[i] = pins[i];
+        }
+        this->count = count;
+        this->next = 0;
+        this->period_ns = 1000000000ULL / sampleRate_hz;
+        this->next_ns = hostNow * 1000;
+        this->running = true;
+        return true;
+    }
+
+    void end() override {
+        running = false;
+    }
+
+    size_t read(HalAdcSample* samples, size_t max) override {
+        if (!running || hostNow * 1000 < next_ns) return 0;
+
+        // Conversions that no longer fit the buffer were overwritten
+        uint64_t due = (hostNow * 1000 - next_ns) / period_ns + 1;
+        if (due > HOST_ADC_DMA_BUFFER) {
+            uint64_t lost = due - HOST_ADC_DMA_BUFFER;
+            next_ns += lost * period_ns;
+            next = (next + lost) % count;
+            due = HOST_ADC_DMA_BUFFER;
+            overruns++;
+        }
+
+        size_t n = due < max ? (size_t)due : max;
+        for (size_t i = 0; i < n; i++) {
+            uint8_t pin = scanPins[next];
+            samples[i].pin = pin;
+            samples[i].value = analogValueAt(pin, next_ns / 1000);
+            observeInput(HAL_INPUT_ANALOG, pin, samples[i].value);
+            pins[pin].analogScans++;
+            next = (next + 1) % count;
+            next_ns += period_ns;
+        }
+        return n;
+    }
+
+    uint32_t getOverruns() override {
+        return overruns;
+    }
+};
+
+class HostGpio : public HalGpio {
+public:
+    void setMode(uint8_t pin, uint8_t mode) override {
+        if (pin < HOST_PIN_COUNT && mode == INPUT_PULLUP) {
+            pins[pin].level = HIGH;
+        }
+    }
+
+    int read(uint8_t pin) override {
+        if (pin >= HOST_PIN_COUNT) return LOW;
+        observeInput(HAL_INPUT_DIGITAL, pin, pins[pin].level);
+        return pins[pin].level;
+    }
+
+    void write(uint8_t pin, uint8_t value) override {
+        if (pin < HOST_PIN_COUNT) driveDigital(pin, value);
+    }
+
+    void attachInterrupt(uint8_t pin, void (*handler)(), int mode) override {
+        if (pin < HOST_PIN_COUNT) {
+            pins[pin].isr = handler;
+            pins[pin].isrMode = mode;
+        }
+    }
+
+    void detachInterrupt(uint8_t pin) override {
+        if (pin < HOST_PIN_COUNT) {
+            pins[pin].isr = nullptr;
+        }
+    }
+};
+
+class HostPulseTimer : public HalPulseTimer {
+public:
+    unsigned long measurePulse(uint8_t pin, uint8_t state, unsigned long timeout_us) override {
+        (void)state;
+        if (pin >= HOST_PIN_COUNT) return 0;
+
+        unsigned long width = pins[pin].pulseSource ? pins[pin].pulseSource(hostNow) : pins[pin].pulseWidth;
+        if (width == 0 || width > timeout_us) {
+            HostHAL::advanceMicros(timeout_us);
+            observeInput(HAL_INPUT_PULSE, pin, 0);
+            return 0;
+        }
+        HostHAL::advanceMicros(width);
+        observeInput(HAL_INPUT_PULSE, pin, (int32_t)width);
+        return width;
+    }
+
+    // The echo is modelled as starting at arm time and ending `width` later
+    void startCapture(uint8_t pin, uint8_t state) override {
+        (void)state;
+        if (pin >= HOST_PIN_COUNT) return;
+        HostPinState& p = pins[pin];
+        p.captureArmed = true;
+        p.captureStart = hostNow;
+        p.captureWidth = p.pulseSource ? p.pulseSource(hostNow) : p.pulseWidth;
+    }
+
+    bool readCapture(uint8_t pin, unsigned long& width_us) override {
+        if (pin >= HOST_PIN_COUNT) return false;
+        HostPinState& p = pins[pin];
+        if (!p.captureArmed || p.captureWidth == 0 || hostNow < p.captureStart + p.captureWidth) {
+            return false;
+        }
+        width_us = p.captureWidth;
+        observeInput(HAL_INPUT_PULSE, pin, (int32_t)width_us);
+        return true;
+    }
+
+    void stopCapture(uint8_t pin) override {
+        if (pin < HOST_PIN_COUNT) pins[pin].captureArmed = false;
+    }
+};
+
+class HostPulseCounter : public HalPulseCounter {
+public:
+    bool begin(uint8_t unit, uint8_t pin, int edge, uint32_t filter_ns) override {
+        if (unit >= HOST_COUNTER_UNITS || pin >= HOST_PIN_COUNT) return false;
+        counters[unit] = HostCounterState();
+        counters[unit].active = true;
+        counters[unit].pin = pin;
+        counters[unit].edge = edge;
+        counters[unit].filter_ns = filter_ns;
+        return true;
+    }
+
+    void end(uint8_t unit) override {
+        if (unit < HOST_COUNTER_UNITS) counters[unit].active = false;
+    }
+
+    uint32_t takeCount(uint8_t unit) override {
+        if (unit >= HOST_COUNTER_UNITS || !counters[unit].active) return 0;
+        HostCounterState& c = counters[unit];
+        uint32_t delta = c.count - c.taken;
+        c.taken = c.count;
+        return delta;
+    }
+
+    void enableCapture(uint8_t unit, bool enable) override {
+        if (unit >= HOST_COUNTER_UNITS) return;
+        counters[unit].capture = enable;
+        counters[unit].edges = 0;
+    }
+
+    bool readPeriod(uint8_t unit, unsigned long& period_us, unsigned long& lastEdge_us) override {
+        if (unit >= HOST_COUNTER_UNITS || !counters[unit].active) return false;
+        HostCounterState& c = counters[unit];
+        period_us = (unsigned long)c.period_us;
+        lastEdge_us = (unsigned long)c.lastEdge_us;
+        return c.edges >= 2;
+    }
+};
+
+class HostClock : public HalClock {
+public:
+    unsigned long millis() override {
+        return (unsigned long)(hostNow / 1000);
+    }
+
+    unsigned long micros() override {
+        return (unsigned long)hostNow;
+    }
+
+    void delay(unsigned long ms) override {
+        HostHAL::advanceMicros((uint64_t)ms * 1000);
+    }
+
+    void delayMicroseconds(unsigned long us) override {
+        HostHAL::advanceMicros(us);
+    }
+
+    uint32_t rtcSeconds() override {
+        return (uint32_t)(((int64_t)hostNow + rtcOffset_us) / 1000000);
+    }
+};
+
+class HostTimer : public HalTimer {
+public:
+    bool start(uint8_t timerId, uint64_t period_us, void (*handler)()) override {
+        if (timerId >= HOST_TIMER_COUNT || period_us == 0) return false;
+        timers[timerId].active = true;
+        timers[timerId].period_us = period_us;
+        timers[timerId].next_us = hostNow + period_us;
+        timers[timerId].handler = handler;
+        return true;
+    }
+
+    void setPeriod(uint8_t timerId, uint64_t period_us) override {
+        if (timerId < HOST_TIMER_COUNT && period_us > 0) {
+            timers[timerId].period_us = period_us;
+            timers[timerId].next_us = hostNow + period_us;
+        }
+    }
+
+    void stop(uint8_t timerId) override {
+        if (timerId < HOST_TIMER_COUNT) {
+            timers[timerId].active = false;
+        }
+    }
+};
+
+class HostTone : public HalTone {
+public:
+    void setup(uint8_t channel, uint32_t frequency, uint8_t resolutionBits) override {
+        (void)resolutionBits;
+        if (channel < HOST_TONE_CHANNELS) toneFrequency[channel] = frequency;
+    }
+
+    void attach(uint8_t pin, uint8_t channel) override {
+        (void)pin;
+        (void)channel;
+    }
+
+    void setFrequency(uint8_t channel, uint32_t frequency) override {
+        if (channel < HOST_TONE_CHANNELS) toneFrequency[channel] = frequency;
+    }
+
+    void setDuty(uint8_t channel, uint32_t duty) override {
+        if (channel < HOST_TONE_CHANNELS) toneDuty[channel] = duty;
+    }
+};
+
+class HostI2C : public HalI2C {
+public:
+    void begin() override {}
+
+    uint8_t write(uint8_t address, const uint8_t* data, size_t length) override {
+        // Address byte plus payload
+        HostHAL::advanceMicros((uint64_t)(length + 1) * HOST_I2C_BYTE_US);
+        i2cBytes[address] += length + 1;
+
+        std::map<uint8_t, HostHAL::I2CDevice>::iterator it = i2cDevices.find(address);
+        if (it == i2cDevices.end()) {
+            return 2;  // NACK on address
+        }
+        it->second(data, length);
+        return 0;
+    }
+};
+
+class HostUart : public HalUart {
+private:
+    void drain() {
+        if (uart.baud == 0) return;
+        uint64_t sent = (hostNow - uart.drained_us) * uart.baud / 10000000ULL;
+        if (sent >= uart.queued) {
+            uart.queued = 0;
+            uart.drained_us = hostNow;
+        } else {
+            uart.queued -= (size_t)sent;
+            uart.drained_us += sent * 10000000ULL / uart.baud;
+        }
+    }
+
+public:
+    void begin(unsigned long baud, size_t txBuffer) override {
+        uart.baud = baud;
+        uart.capacity = txBuffer;
+        uart.queued = 0;
+        uart.drained_us = hostNow;
+    }
+
+    size_t availableForWrite() override {
+        drain();
+        return uart.capacity - uart.queued;
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        size_t room = availableForWrite();
+        size_t n = length < room ? length : room;
+        uart.output.insert(uart.output.end(), data, data + n);
+        uart.queued += n;
+        uart.bytesWritten += n;
+        return n;
+    }
+};
+
+class HostTemperatureBus : public HalTemperatureBus {
+private:
+    uint8_t pin;
+
+public:
+    HostTemperatureBus(uint8_t pin) : pin(pin) {}
+
+    int begin() override {
+        return getDeviceCount();
+    }
+
+    int getDeviceCount() override {
+        std::map<uint8_t, HostProbeState>::iterator it = probes.find(pin);
+        return it == probes.end() ? 0 : it->second.count;
+    }
+
+    void setWaitForConversion(bool wait) override {
+        std::map<uint8_t, HostProbeState>::iterator it = probes.find(pin);
+        if (it != probes.end()) it->second.waitForConversion = wait;
+    }
+
+    void requestTemperatures() override {
+        std::map<uint8_t, HostProbeState>::iterator it = probes.find(pin);
+        if (it == probes.end() || it->second.waitForConversion) {
+            HostHAL::advanceMicros(HOST_DS18B20_CONVERSION_US);
+        } else {
+            it->second.conversionDone = hostNow + HOST_DS18B20_CONVERSION_US;
+        }
+    }
+
+    bool isConversionComplete() override {
+        std::map<uint8_t, HostProbeState>::iterator it = probes.find(pin);
+        return it == probes.end() || hostNow >= it->second.conversionDone;
+    }
+
+    float getTempC(uint8_t index) override {
+        std::map<uint8_t, HostProbeState>::iterator it = probes.find(pin);
+        float tempC = (it == probes.end() || index >= it->second.count) ? HAL_TEMP_DISCONNECTED : it->second.tempC;
+        observeInput(HAL_INPUT_PROBE_TEMP, pin, halInputFixed(tempC, HAL_INPUT_PROBE_SCALE));
+        return tempC;
+    }
+};
+
+class HostHumiditySensor : public HalHumiditySensor {
+private:
+    uint8_t pin;
+
+public:
+    HostHumiditySensor(uint8_t pin) : pin(pin) {}
+
+    void begin() override {}
+
+    float readTemperature() override {
+        HostHAL::advanceMicros(HOST_DHT_READ_US);
+        std::map<uint8_t, HostDhtState>::iterator it = dhtSensors.find(pin);
+        float temperature = it == dhtSensors.end() ? NAN : it->second.temperature;
+        observeInput(HAL_INPUT_AIR_TEMP, pin, halInputFixed(temperature, HAL_INPUT_DHT_SCALE));
+        return temperature;
+    }
+
+    float readHumidity() override {
+        HostHAL::advanceMicros(HOST_DHT_READ_US);
+        std::map<uint8_t, HostDhtState>::iterator it = dhtSensors.find(pin);
+        float humidity = it == dhtSensors.end() ? NAN : it->second.humidity;
+        observeInput(HAL_INPUT_HUMIDITY, pin, halInputFixed(humidity, HAL_INPUT_DHT_SCALE));
+        return humidity;
+    }
+
+    // Rothfusz regression, same as the Adafruit DHT library
+    float computeHeatIndex(float temperature, float humidity) override {
+        float t = temperature * 1.8f + 32.0f;
+        float hi = 0.5f * (t + 61.0f + ((t - 68.0f) * 1.2f) + (humidity * 0.094f));
+        if (hi > 79.0f) {
+            hi = -42.379f + 2.04901523f * t + 10.14333127f * humidity +
+                 -0.22475541f * t * humidity + -0.00683783f * t * t +
+                 -0.05481717f * humidity * humidity + 0.00122874f * t * t * humidity +
+                 0.00085282f * t * humidity * humidity + -0.00000199f * t * t * humidity * humidity;
+        }
+        return (hi - 32.0f) / 1.8f;
+    }
+};
+
+// Conversions complete every HOST_HX711_SAMPLE_US; reading one consumes it
+class HostLoadCell : public HalLoadCell {
+private:
+    uint8_t dataPin;
+    float scale;
+    long offset;
+    uint64_t nextReady;
+
+    long readSample() {
+        HostLoadCellState* s = state();
+        if (hostNow < nextReady) {
+            HostHAL::advanceMicros(nextReady - hostNow);
+        }
+        nextReady = hostNow + HOST_HX711_SAMPLE_US;
+        long raw = s ? s->rawCounts : 0;
+        observeInput(HAL_INPUT_LOAD_CELL, dataPin, (int32_t)raw);
+        return raw;
+    }
+
+    HostLoadCellState* state() {
+        std::map<uint8_t, HostLoadCellState>::iterator it = loadCells.find(dataPin);
+        return it == loadCells.end() ? nullptr : &it->second;
+    }
+
+public:
+    HostLoadCell(uint8_t dataPin) : dataPin(dataPin), scale(1.0f), offset(0), nextReady(0) {}
+
+    void begin() override {
+        nextReady = hostNow + HOST_HX711_SAMPLE_US;
+    }
+
+    bool isReady() override {
+        HostLoadCellState* s = state();
+        return s != nullptr && s->ready && hostNow >= nextReady;
+    }
+
+    bool waitReady(unsigned long timeout_ms) override {
+        HostLoadCellState* s = state();
+        if (s == nullptr || !s->ready) {
+            HostHAL::advanceMillis(timeout_ms);
+            return false;
+        }
+        if (nextReady > hostNow + (uint64_t)timeout_ms * 1000) {
+            HostHAL::advanceMillis(timeout_ms);
+            return false;
+        }
+        if (hostNow < nextReady) {
+            HostHAL::advanceMicros(nextReady - hostNow);
+        }
+        return true;
+    }
+
+    void setScale(float factor) override {
+        scale = factor;
+    }
+
+    // HX711::tare() averages 10 readings
+    void tare() override {
+        long sum = 0;
+        for (int i = 0; i < 10; i++) {
+            sum += readSample();
+        }
+        offset = sum / 10;
+    }
+
+    float getUnits(uint8_t times) override {
+        long sum = 0;
+        for (uint8_t i = 0; i < times; i++) {
+            sum += readSample();
+        }
+        long raw = times > 0 ? sum / times : 0;
+        return (float)(raw - offset) / scale;
+    }
+};
+
+// ==================== BACKEND INSTANCES ====================
+static HostAdc hostAdc;
+static HostAdcScanner hostAdcScanner;
+static HostGpio hostGpio;
+static HostPulseTimer hostPulse;
+static HostPulseCounter hostCounter;
+static HostClock hostClock;
+static HostTimer hostTimer;
+static HostTone hostTone;
+static HostI2C hostI2C;
+static HostUart hostUart;
+
+HalAdc& HAL::adc() { return hostAdc; }
+HalAdcScanner& HAL::adcScanner() { return hostAdcScanner; }
+HalGpio& HAL::gpio() { return hostGpio; }
+HalPulseTimer& HAL::pulse() { return hostPulse; }
+HalPulseCounter& HAL::counter() { return hostCounter; }
+HalClock& HAL::clock() { return hostClock; }
+HalTimer& HAL::timer() { return hostTimer; }
+HalTone& HAL::tone() { return hostTone; }
+HalI2C& HAL::i2c() { return hostI2C; }
+HalUart& HAL::uart() { return hostUart; }
+
+void HAL::setInputObserver(HalInputObserver* observer) {
+    inputObserver = observer;
+}
+
+HalTemperatureBus* HAL::openTemperatureBus(uint8_t pin) {
+    return new HostTemperatureBus(pin);
+}
+
+HalHumiditySensor* HAL::openHumiditySensor(uint8_t pin, uint8_t type) {
+    (void)type;
+    return new HostHumiditySensor(pin);
+}
+
+HalLoadCell* HAL::openLoadCell(uint8_t dataPin, uint8_t clockPin) {
+    (void)clockPin;
+    return new HostLoadCell(dataPin);
+}
+
+// ==================== HOST CONTROL ====================
+void HostHAL::reset() {
+    hostNow = 0;
+    rtcOffset_us = 0;
+    for (int i = 0; i < HOST_PIN_COUNT; i++) {
+        pins[i] = HostPinState();
+    }
+    for (int i = 0; i < HOST_TIMER_COUNT; i++) {
+        timers[i] = HostTimerState();
+    }
+    for (int i = 0; i < HOST_COUNTER_UNITS; i++) {
+        counters[i] = HostCounterState();
+    }
+    hostAdcScanner = HostAdcScanner();
+    for (int i = 0; i < HOST_TONE_CHANNELS; i++) {
+        toneFrequency[i] = 0;
+        toneDuty[i] = 0;
+    }
+    probes.clear();
+    dhtSensors.clear();
+    loadCells.clear();
+    i2cDevices.clear();
+    i2cBytes.clear();
+    uart = HostUartState();
+    inputObserver = nullptr;
+}
+
+uint64_t HostHAL::nowMicros() {
+    return hostNow;
+}
+
+void HostHAL::advanceMicros(uint64_t us) {
+    fireTimersUntil(hostNow + us);
+}
+
+void HostHAL::advanceMillis(unsigned long ms) {
+    advanceMicros((uint64_t)ms * 1000);
+}
+
+void HostHAL::setRtcSeconds(uint32_t seconds) {
+    rtcOffset_us = (int64_t)seconds * 1000000 - (int64_t)hostNow;
+}
+
+void HostHAL::setAnalog(uint8_t pin, int value) {
+    if (pin < HOST_PIN_COUNT) {
+        pins[pin].analogValue = value;
+        pins[pin].analogSource = nullptr;
+    }
+}
+
+void HostHAL::setAnalogSource(uint8_t pin, AnalogSource source) {
+    if (pin < HOST_PIN_COUNT) pins[pin].analogSource = source;
+}
+
+uint64_t HostHAL::getAnalogReadCount(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? pins[pin].analogReads : 0;
+}
+
+void HostHAL::setAnalogRecording(uint8_t pin, const std::vector<uint16_t>& samples, uint32_t sampleRate_hz) {
+    if (samples.empty() || sampleRate_hz == 0) return;
+
+    std::shared_ptr<std::vector<uint16_t> > recording(new std::vector<uint16_t>(samples));
+    setAnalogSource(pin, [recording, sampleRate_hz](uint64_t now) {
+        uint64_t index = now * sampleRate_hz / 1000000;
+        return (int)(*recording)[index % recording->size()];
+    });
+}
+
+bool HostHAL::loadAnalogRecording(uint8_t pin, const char* path, uint32_t sampleRate_hz) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) return false;
+
+    std::vector<uint16_t> samples;
+    unsigned int value;
+    while (fscanf(file, "%u", &value) == 1) {
+        samples.push_back((uint16_t)(value > 4095 ? 4095 : value));
+    }
+    fclose(file);
+
+    if (samples.empty()) return false;
+    setAnalogRecording(pin, samples, sampleRate_hz);
+    return true;
+}
+
+uint64_t HostHAL::getAnalogScanCount(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? pins[pin].analogScans : 0;
+}
+
+// An input changing from outside; the observer sees the new level, since
+// interrupt handlers and counters take it without a read
+void HostHAL::setDigital(uint8_t pin, int level) {
+    if (pin >= HOST_PIN_COUNT) return;
+    if ((level ? HIGH : LOW) != pins[pin].level) {
+        observeInput(HAL_INPUT_DIGITAL, pin, level ? HIGH : LOW);
+    }
+    driveDigital(pin, level);
+}
+
+int HostHAL::getDigital(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? pins[pin].level : LOW;
+}
+
+void HostHAL::connectPins(uint8_t outputPin, uint8_t inputPin) {
+    if (outputPin < HOST_PIN_COUNT && inputPin < HOST_PIN_COUNT && outputPin != inputPin) {
+        pins[outputPin].connectedTo = inputPin;
+    }
+}
+
+void HostHAL::setPulseWidth(uint8_t pin, unsigned long width_us) {
+    if (pin < HOST_PIN_COUNT) {
+        pins[pin].pulseWidth = width_us;
+        pins[pin].pulseSource = nullptr;
+    }
+}
+
+void HostHAL::setPulseSource(uint8_t pin, PulseSource source) {
+    if (pin < HOST_PIN_COUNT) pins[pin].pulseSource = source;
+}
+
+// A probe already on the bus keeps its conversion mode and pending conversion
+void HostHAL::setTemperatureProbe(uint8_t pin, int count, float tempC) {
+    std::map<uint8_t, HostProbeState>::iterator it = probes.find(pin);
+    if (it != probes.end()) {
+        it->second.count = count;
+        it->second.tempC = tempC;
+        return;
+    }
+    HostProbeState state = { count, tempC, true, 0 };
+    probes[pin] = state;
+}
+
+void HostHAL::setHumidity(uint8_t pin, float temperature, float humidity) {
+    HostDhtState state = { temperature, humidity };
+    dhtSensors[pin] = state;
+}
+
+void HostHAL::setLoadCell(uint8_t dataPin, long rawCounts, bool ready) {
+    HostLoadCellState state = { rawCounts, ready };
+    loadCells[dataPin] = state;
+}
+
+void HostHAL::attachI2CDevice(uint8_t address, I2CDevice device) {
+    i2cDevices[address] = device;
+}
+
+uint64_t HostHAL::getI2CBytesWritten(uint8_t address) {
+    std::map<uint8_t, uint64_t>::iterator it = i2cBytes.find(address);
+    return it == i2cBytes.end() ? 0 : it->second;
+}
+
+void HostHAL::takeUartOutput(std::vector<uint8_t>& bytes) {
+    bytes.insert(bytes.end(), uart.output.begin(), uart.output.end());
+    uart.output.clear();
+}
+
+uint64_t HostHAL::getUartBytesWritten() {
+    return uart.bytesWritten;
+}
+
+size_t HostHAL::getUartQueued() {
+    hostUart.availableForWrite();                    // Drains up to now
+    return uart.queued;
+}
+
+uint32_t HostHAL::getToneFrequency(uint8_t channel) {
+    return channel < HOST_TONE_CHANNELS ? toneFrequency[channel] : 0;
+}
+
+uint32_t HostHAL::getToneDuty(uint8_t channel) {
+    return channel < HOST_TONE_CHANNELS ? toneDuty[channel] : 0;
+}
+
+#endif // !ARDUINO
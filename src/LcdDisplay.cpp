@@ -0,0 +1,184 @@
+/*
+ * LcdDisplay.cpp
+ * Implementation of the framebuffered 20x4 I2C LCD
+ */
+
+#include "LcdDisplay.h"
+#include "Telemetry.h"
+
+// PCF8574 pins of the common backpack: P0 RS, P1 RW, P2 EN, P3 backlight,
+// P4-P7 data lines D4-D7
+#define LCD_RS 0x01
+#define LCD_EN 0x04
+#define LCD_BACKLIGHT 0x08
+
+// HD44780 commands
+#define LCD_CLEAR 0x01
+#define LCD_ENTRY_INCREMENT 0x06
+#define LCD_DISPLAY_ON 0x0C
+#define LCD_FUNCTION_4BIT_2LINE 0x28
+#define LCD_SET_DDRAM 0x80
+
+// Constructor
+LcdDisplay::LcdDisplay(uint8_t address) {
+    this->address = address;
+    this->backlight = LCD_BACKLIGHT;
+    this->lastMode = 0;
+    this->chunkLength = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ==================== BUS ====================
+
+void LcdDisplay::pushExpander(uint8_t value) {
+    chunk[chunkLength++] = value;
+    if (chunkLength == LCD_I2C_CHUNK) {
+        sendChunk();
+    }
+}
+
+// Write the collected expander bytes in one transaction
+void LcdDisplay::sendChunk() {
+    if (chunkLength == 0) return;
+    HAL::i2c().write(address, chunk, chunkLength);
+    stats.transactions++;
+    stats.busBytes += chunkLength + 1;
+    chunkLength = 0;
+}
+
+// Data on D4-D7, latched on the falling edge of EN
+void LcdDisplay::sendNibble(uint8_t value) {
+    uint8_t bits = (value << 4) | lastMode | backlight;
+    pushExpander(bits | LCD_EN);
+    pushExpander(bits);
+}
+
+// One command (mode 0) or character (mode LCD_RS) as two nibbles. RS must
+// settle before EN rises, so a change of mode gets a byte of its own.
+void LcdDisplay::sendByte(uint8_t value, uint8_t mode) {
+    if (mode != lastMode) {
+        lastMode = mode;
+        pushExpander(mode | backlight);
+    }
+    sendNibble(value >> 4);
+    sendNibble(value & 0x0F);
+}
+
+// HD44780 reset into 4-bit mode (datasheet figure 24), then a cleared panel
+void LcdDisplay::begin() {
+    HAL::i2c().begin();
+    HAL::clock().delay(50);
+    chunkLength = 0;
+    lastMode = 0;
+    pushExpander(backlight);
+    sendChunk();
+
+    sendNibble(0x03);
+    sendChunk();
+    HAL::clock().delayMicroseconds(4500);
+    sendNibble(0x03);
+    sendChunk();
+    HAL::clock().delayMicroseconds(4500);
+    sendNibble(0x03);
+    sendChunk();
+    HAL::clock().delayMicroseconds(150);
+    sendNibble(0x02);
+
+    sendByte(LCD_FUNCTION_4BIT_2LINE, 0);
+    sendByte(LCD_DISPLAY_ON, 0);
+    sendByte(LCD_ENTRY_INCREMENT, 0);
+    sendByte(LCD_CLEAR, 0);
+    sendChunk();
+    HAL::clock().delayMicroseconds(2000);
+
+    framebuffer.panelCleared();
+    framebuffer.clear();
+}
+
+void LcdDisplay::setBacklight(bool on) {
+    backlight = on ? LCD_BACKLIGHT : 0;
+    pushExpander(lastMode | backlight);
+    sendChunk();
+}
+
+// ==================== DRAWING ====================
+
+void LcdDisplay::clear() {
+    framebuffer.clear();
+}
+
+void LcdDisplay::setCursor(uint8_t column, uint8_t row) {
+    framebuffer.setCursor(column, row);
+}
+
+// Characters past the end of the row are dropped
+void LcdDisplay::print(char c) {
+    const char text[2] = { c, '\0' };
+    framebuffer.print(text);
+}
+
+void LcdDisplay::print(const char* text) {
+    framebuffer.print(text);
+}
+
+void LcdDisplay::print(const String& text) {
+    print(text.c_str());
+}
+
+void LcdDisplay::print(float value, uint8_t decimals) {
+    framebuffer.printf("%.*f", (int)decimals, value);
+}
+
+void LcdDisplay::print(long value) {
+    framebuffer.printf("%ld", value);
+}
+
+void LcdDisplay::print(int value) {
+    print((long)value);
+}
+
+void LcdDisplay::print(unsigned long value) {
+    framebuffer.printf("%lu", value);
+}
+
+char LcdDisplay::getCell(uint8_t column, uint8_t row) {
+    return framebuffer.getCell(column, row);
+}
+
+// ==================== FLUSH ====================
+
+void LcdDisplay::setAddress(uint8_t address) {
+    sendByte(LCD_SET_DDRAM | address, 0);
+}
+
+void LcdDisplay::write(uint8_t c) {
+    sendByte(c, LCD_RS);
+}
+
+void LcdDisplay::flush() {
+    unsigned long before = stats.busBytes;
+    framebuffer.flush(*this);
+    sendChunk();
+
+    const LcdFramebufferStats& frameStats = framebuffer.getStats();
+    stats.flushes = frameStats.flushes;
+    stats.cellsSent = frameStats.cellsSent;
+    stats.cursorMoves = frameStats.cursorMoves;
+    stats.lastBusBytes = stats.busBytes - before;
+}
+
+void LcdDisplay::invalidate() {
+    framebuffer.invalidate();
+}
+
+// ==================== STATISTICS ====================
+
+const LcdStats& LcdDisplay::getStats() {
+    return stats;
+}
+
+void LcdDisplay::printStats() {
+    logPrintf("[LCD] %lu flushes, %lu cells, %lu cursor moves, %lu transactions, %lu bus bytes (%.1f per flush)\n",
+              stats.flushes, stats.cellsSent, stats.cursorMoves, stats.transactions, stats.busBytes,
+              stats.flushes ? (float)stats.busBytes / stats.flushes : 0.0f);
+}
@@ -4,6 +4,9 @@
  */
 
 #include "LeafTemperatureSensor.h"
+#include "HAL.h"
+#include "AdcEngine.h"
+#include "Telemetry.h"
 
 LeafTemperatureSensor::LeafTemperatureSensor(uint8_t pin) : analogPin(pin) {
     objectTempC = 0.0;
@@ -13,14 +16,15 @@ LeafTemperatureSensor::LeafTemperatureSensor(uint8_t pin) : analogPin(pin) {
 }
 
 bool LeafTemperatureSensor::begin() {
-    pinMode(analogPin, INPUT);
-    Serial.println("Leaf Temperature Sensor initialized (Potentiometer simulation)");
+    HAL::gpio().setMode(analogPin, INPUT);
+    adcEngine.addChannel(analogPin);  // Background scan when the pin supports it
+    logPrintf("Leaf Temperature Sensor initialized (Potentiometer simulation)\n");
     return true;
 }
 
 float LeafTemperatureSensor::readTemperature() {
     // Read potentiometer value (0-4095 on ESP32)
-    int rawValue = analogRead(analogPin);
+    int rawValue = adcEngine.read(analogPin);
     
     // Map to temperature range: 10°C to 50°C
     objectTempC = map(rawValue, 0, 4095, 10, 50);
@@ -53,16 +57,6 @@ bool LeafTemperatureSensor::isConnected() {
     return true;  // Always connected in simulation mode
 }
 
-String LeafTemperatureSensor::getTemperatureStatus() {
-    if (objectTempC < 10) {
-        return "Too Cold";
-    } else if (objectTempC < 20) {
-        return "Cold";
-    } else if (objectTempC < 30) {
-        return "Optimal";
-    } else if (objectTempC < 40) {
-        return "Warm";
-    } else {
-        return "Too Hot";
-    }
+LeafTempStatus LeafTemperatureSensor::getTemperatureStatus() {
+    return TEMPERATURE_SCALE.classify(objectTempC);
 }
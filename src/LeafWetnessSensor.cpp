@@ -4,6 +4,9 @@
  */
 
 #include "LeafWetnessSensor.h"
+#include "HAL.h"
+#include "AdcEngine.h"
+#include "Telemetry.h"
 
 LeafWetnessSensor::LeafWetnessSensor(uint8_t analogPin, int dryVal, int wetVal) {
     pin = analogPin;
@@ -14,14 +17,15 @@ LeafWetnessSensor::LeafWetnessSensor(uint8_t analogPin, int dryVal, int wetVal)
 }
 
 void LeafWetnessSensor::begin() {
-    pinMode(pin, INPUT);
-    analogReadResolution(12);  // 12-bit ADC (0-4095)
-    Serial.println("Leaf Wetness Sensor initialized on pin " + String(pin));
+    HAL::gpio().setMode(pin, INPUT);
+    adcEngine.addChannel(pin);  // Background scan when the pin supports it
+    HAL::adc().setResolution(12);  // 12-bit ADC (0-4095)
+    logPrintf("Leaf Wetness Sensor initialized on pin %d\n", pin);
 }
 
 float LeafWetnessSensor::readWetness() {
     // Read analog value
-    rawValue = analogRead(pin);
+    rawValue = adcEngine.read(pin);
     
     // Convert to percentage (inverted: lower resistance = more wetness)
     wetnessPercent = map(rawValue, dryValue, wetValue, 0, 100);
@@ -40,26 +44,18 @@ int LeafWetnessSensor::getRawValue() {
     return rawValue;
 }
 
-String LeafWetnessSensor::getWetnessStatus() {
-    if (wetnessPercent < 20) {
-        return "Dry";
-    } else if (wetnessPercent < 50) {
-        return "Slightly Wet";
-    } else if (wetnessPercent < 80) {
-        return "Wet";
-    } else {
-        return "Very Wet";
-    }
+WetnessStatus LeafWetnessSensor::getWetnessStatus() {
+    return WETNESS_SCALE.classify(wetnessPercent);
 }
 
 void LeafWetnessSensor::calibrateDry(int value) {
     dryValue = value;
-    Serial.println("Dry value calibrated to: " + String(dryValue));
+    logPrintf("Dry value calibrated to: %d\n", dryValue);
 }
 
 void LeafWetnessSensor::calibrateWet(int value) {
     wetValue = value;
-    Serial.println("Wet value calibrated to: " + String(wetValue));
+    logPrintf("Wet value calibrated to: %d\n", wetValue);
 }
 
 bool LeafWetnessSensor::isWet() {
@@ -4,6 +4,8 @@
  */
 
 #include "LightSensor.h"
+#include "HAL.h"
+#include "AdcEngine.h"
 
 // Constructor
 LightSensor::LightSensor(uint8_t pin) {
@@ -16,12 +18,13 @@ LightSensor::LightSensor(uint8_t pin) {
 
 // Initialize the sensor
 void LightSensor::begin() {
-    pinMode(pin, INPUT);
+    HAL::gpio().setMode(pin, INPUT);
+    adcEngine.addChannel(pin);  // Background scan when the pin supports it
 }
 
 // Read light intensity from sensor
 float LightSensor::readLight() {
-    rawValue = analogRead(pin);
+    rawValue = adcEngine.read(pin);
     
     // Map ADC value to percentage (0-100%)
     // Higher ADC value = more light for typical LDR circuit
@@ -45,22 +48,8 @@ int LightSensor::getRawValue() {
 }
 
 // Get light condition status
-String LightSensor::getLightStatus() {
-    if (lightPercent < 10) {
-        return "Very Dark";
-    } else if (lightPercent < 25) {
-        return "Dark";
-    } else if (lightPercent < 40) {
-        return "Dim";
-    } else if (lightPercent < 60) {
-        return "Moderate";
-    } else if (lightPercent < 75) {
-        return "Bright";
-    } else if (lightPercent < 90) {
-        return "Very Bright";
-    } else {
-        return "Intense";
-    }
+LightStatus LightSensor::getLightStatus() {
+    return LIGHT_SCALE.classify(lightPercent);
 }
 
 // Calibration methods
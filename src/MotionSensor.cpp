@@ -4,6 +4,8 @@
  */
 
 #include "MotionSensor.h"
+#include "HAL.h"
+#include "Telemetry.h"
 
 // Constructor
 MotionSensor::MotionSensor(uint8_t pin, unsigned long debounceDelay) {
@@ -16,16 +18,16 @@ MotionSensor::MotionSensor(uint8_t pin, unsigned long debounceDelay) {
 
 // Initialize the sensor
 void MotionSensor::begin() {
-    pinMode(pin, INPUT);
-    Serial.println("[Motion] PIR Motion Sensor initialized");
-    Serial.println("[Motion] Allow 30-60 seconds for PIR calibration");
-    delay(2000); // Brief calibration delay
+    HAL::gpio().setMode(pin, INPUT);
+    logPrintf("[Motion] PIR Motion Sensor initialized\n");
+    logPrintf("[Motion] Allow 30-60 seconds for PIR calibration\n");
+    HAL::clock().delay(2000); // Brief calibration delay
 }
 
 // Read motion status
 bool MotionSensor::readMotion() {
-    bool currentState = digitalRead(pin);
-    unsigned long currentTime = millis();
+    bool currentState = HAL::gpio().read(pin);
+    unsigned long currentTime = HAL::clock().millis();
     
     // Detect new motion with debouncing
     if (currentState == HIGH && !motionDetected) {
@@ -44,12 +46,12 @@ bool MotionSensor::readMotion() {
 
 // Check if motion is currently detected
 bool MotionSensor::isMotionDetected() {
-    return digitalRead(pin) == HIGH;
+    return HAL::gpio().read(pin) == HIGH;
 }
 
 // Get time since last motion
 unsigned long MotionSensor::getTimeSinceMotion() {
-    return millis() - lastMotionTime;
+    return HAL::clock().millis() - lastMotionTime;
 }
 
 // Get total motion count
@@ -63,15 +65,9 @@ void MotionSensor::resetCount() {
 }
 
 // Get motion status
-String MotionSensor::getMotionStatus() {
+MotionStatus MotionSensor::getMotionStatus() {
     if (isMotionDetected()) {
-        return "Motion Detected";
-    } else {
-        unsigned long timeSince = getTimeSinceMotion();
-        if (timeSince < 10000) {
-            return "Recent Motion";
-        } else {
-            return "No Motion";
-        }
+        return MOTION_DETECTED;
     }
+    return getTimeSinceMotion() < 10000 ? MOTION_RECENT : MOTION_NONE;
 }
@@ -1,52 +1,95 @@
 /*
  * RainfallSensor.cpp
- * Implementation of Analog Rainfall Sensor Driver (Potentiometer simulation)
+ * Implementation of Tipping Bucket Rain Gauge driver
  */
 
 #include "RainfallSensor.h"
+#include "HAL.h"
+#include "Telemetry.h"
+
+// Totals survive deep sleep and resets
+static HAL_RETAINED RainGaugeState retainedRain;
+
+// Static member initialization
+RainfallSensor* RainfallSensor::instance = nullptr;
 
 // Constructor
-RainfallSensor::RainfallSensor(uint8_t analogPin) {
-    this->analogPin = analogPin;
-    this->rainfall_mm = 0.0;
+RainfallSensor::RainfallSensor(uint8_t pin, float mmPerTip)
+    : gauge(&retainedRain, mmPerTip) {
+    this->pin = pin;
+    this->tipHead = 0;
+    this->tipTail = 0;
+    this->lastEdge_ms = 0;
+    this->rainfall1h_mm = 0.0;
+    this->rainfall24h_mm = 0.0;
+    this->eventRainfall_mm = 0.0;
     this->rainRate = 0.0;
-    this->lastReading = 0;
+    instance = this;
+}
+
+// Static interrupt handler, queues the tip time
+void IRAM_ATTR RainfallSensor::handleInterrupt() {
+    if (instance == nullptr) return;
+
+    uint32_t now = HAL::clock().millis();
+    if (now - instance->lastEdge_ms < RAIN_DEBOUNCE_MS) return;
+    instance->lastEdge_ms = now;
+
+    // A full queue (more than RAIN_TIP_QUEUE tips between updates) drops the tip
+    uint8_t next = (instance->tipHead + 1) % RAIN_TIP_QUEUE;
+    if (next == instance->tipTail) return;
+    instance->tipTimes[instance->tipHead] = now;
+    instance->tipHead = next;
 }
 
 // Initialize sensor
 void RainfallSensor::begin() {
-    pinMode(analogPin, INPUT);
-    Serial.println("Rainfall Sensor (Analog) initialized on pin " + String(analogPin));
-} 
+    if (gauge.restore()) {
+        logPrintf("[Rain] Restored %lu tips from RTC memory\n", (unsigned long)gauge.totalTips());
+    }
+
+    HAL::gpio().setMode(pin, INPUT_PULLUP);
+    lastEdge_ms = HAL::clock().millis() - RAIN_DEBOUNCE_MS;
+    HAL::gpio().attachInterrupt(pin, handleInterrupt, FALLING);
+    logPrintf("Rainfall Sensor (Tipping Bucket) initialized on pin %d\n", pin);
+}
 
-// Update rainfall reading
+// Fold queued tips into the totals
 void RainfallSensor::update() {
-    // Read analog value (0-4095 for ESP32)
-    int rawValue = analogRead(analogPin);
-    
-    // Map to rainfall in mm (0-100mm range)
-    rainfall_mm = map(rawValue, 0, 4095, 0, 10000) / 100.0; // Convert to float with 2 decimals
-    
-    // Calculate rain rate (simplified - assume reading per minute)
-    unsigned long currentTime = millis();
-    if (lastReading > 0) {
-        float timeDiff = (currentTime - lastReading) / 60000.0; // Convert to minutes
-        if (timeDiff > 0) {
-            float prevRainfall = rainfall_mm;
-            rainRate = (rainfall_mm - prevRainfall) / timeDiff; // mm per minute
-        }
+    uint32_t now_ms = HAL::clock().millis();
+    uint32_t now_s = HAL::clock().rtcSeconds();
+
+    // Queue holds millis(); place each tip on the RTC time line
+    while (tipTail != tipHead) {
+        uint32_t age_s = (now_ms - tipTimes[tipTail]) / 1000;
+        gauge.addTip(now_s - age_s);
+        tipTail = (tipTail + 1) % RAIN_TIP_QUEUE;
     }
-    lastReading = currentTime;
+
+    rainfall1h_mm = gauge.lastHour(now_s);
+    rainfall24h_mm = gauge.last24h(now_s);
+    eventRainfall_mm = gauge.event(now_s);
+    rainRate = gauge.intensity(now_s);
 }
 
-// Get total rainfall in mm
+// Get rolling 24 h rainfall in mm
 float RainfallSensor::getRainfall_mm() {
-    return rainfall_mm;
+    return rainfall24h_mm;
 }
 
-// Get total rainfall in inches
+// Get rolling 24 h rainfall in inches
 float RainfallSensor::getRainfall_inches() {
-    return rainfall_mm * 0.0393701; // Convert mm to inches
+    return rainfall24h_mm * 0.0393701; // Convert mm to inches
+}
+
+// Get rolling 1 h rainfall in mm
+float RainfallSensor::getRainfall1h_mm() {
+    return rainfall1h_mm;
+}
+
+// Get rainfall of the current event in mm
+float RainfallSensor::getEventRainfall_mm() {
+    return eventRainfall_mm;
 }
 
 // Get rain rate
@@ -54,32 +97,23 @@ float RainfallSensor::getRainRate() {
     return rainRate;
 }
 
+// Get tip count
+unsigned long RainfallSensor::getTipCount() {
+    return gauge.totalTips();
+}
+
+// Clear all retained totals
+void RainfallSensor::resetTotals() {
+    gauge.clear();
+    update();
+}
+
 // Get rain status
-String RainfallSensor::getRainStatus() {
-    if (rainfall_mm < 1.0) {
-        return "No Rain";
-    } else if (rainfall_mm < 10.0) {
-        return "Light Rain";
-    } else if (rainfall_mm < 30.0) {
-        return "Moderate Rain";
-    } else if (rainfall_mm < 50.0) {
-        return "Heavy Rain";
-    } else {
-        return "Very Heavy";
-    }
+RainStatus RainfallSensor::getRainStatus() {
+    return RAIN_SCALE.classify(rainfall24h_mm);
 }
 
-// Get rain intensity description
-String RainfallSensor::getRainIntensity() {
-    if (rainRate < 0.5) {
-        return "Drizzle";
-    } else if (rainRate < 2.0) {
-        return "Light";
-    } else if (rainRate < 10.0) {
-        return "Moderate";
-    } else if (rainRate < 50.0) {
-        return "Heavy";
-    } else {
-        return "Violent";
-    }
+// Get rain intensity description (mm/hour)
+RainIntensity RainfallSensor::getRainIntensity() {
+    return INTENSITY_SCALE.classify(rainRate);
 }
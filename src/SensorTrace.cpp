@@ -0,0 +1,206 @@
+/*
+ * SensorTrace.cpp
+ * Implementation of the sensor input recorder and the chunk reader
+ */
+
+#include "SensorTrace.h"
+#include "Telemetry.h"
+#include <Arduino.h>
+
+static_assert(TRACE_CHUNK_MAX <= TELEMETRY_LOG_MAX, "a trace chunk must fit one telemetry frame");
+
+static size_t writeVarint(uint8_t* out, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// ==================== RECORDER ====================
+
+// Constructor
+TraceRecorder::TraceRecorder() {
+    channelCount = 0;
+    sink = nullptr;
+    length = 0;
+    chunkNumber = 1;
+    chunkStart_us = 0;
+    last_us = 0;
+    now_us = 0;
+    lastMicros = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+void TraceRecorder::begin(TraceSink sink) {
+    this->sink = sink;
+    lastMicros = (uint32_t)HAL::clock().micros();
+    now_us = lastMicros;
+    HAL::setInputObserver(this);
+}
+
+void TraceRecorder::end() {
+    HAL::setInputObserver(nullptr);
+    flush();
+}
+
+// micros() is 32 bits on the ESP32 and wraps every 71 minutes
+uint64_t TraceRecorder::now() {
+    uint32_t micros = (uint32_t)HAL::clock().micros();
+    now_us += (uint32_t)(micros - lastMicros);
+    lastMicros = micros;
+    return now_us;
+}
+
+TraceRecorder::Channel* TraceRecorder::findChannel(HalInputKind kind, uint8_t pin) {
+    for (uint8_t i = 0; i < channelCount; i++) {
+        if (channels[i].pin == pin && channels[i].kind == kind) return &channels[i];
+    }
+    return nullptr;
+}
+
+void TraceRecorder::flush() {
+    if (length == 0) return;
+    if (sink != nullptr && sink(chunk, length)) {
+        stats.chunks++;
+        stats.bytes += length;
+    } else {
+        stats.chunksDropped++;
+    }
+    length = 0;
+    chunkNumber++;
+}
+
+void TraceRecorder::onInput(HalInputKind kind, uint8_t pin, int32_t value) {
+    stats.inputs++;
+    uint64_t time = now();
+
+    Channel* channel = findChannel(kind, pin);
+    if (channel != nullptr) {
+        if (value == channel->value) return;
+        if (kind == HAL_INPUT_ANALOG && time - channel->time_us < TRACE_ANALOG_INTERVAL_US) return;
+    } else if (channelCount < TRACE_MAX_CHANNELS) {
+        channel = &channels[channelCount++];
+        channel->kind = kind;
+        channel->pin = pin;
+        channel->chunk = 0;
+    } else {
+        stats.untracked++;
+        return;
+    }
+
+    if (length > 0 && (length + TRACE_RECORD_MAX > TRACE_CHUNK_MAX || time - chunkStart_us >= TRACE_FLUSH_US)) {
+        flush();
+    }
+    if (length == 0) {
+        chunkStart_us = time;
+        last_us = time;
+        length = writeVarint(chunk, time);
+    }
+
+    int64_t previous = channel->chunk == chunkNumber ? channel->value : 0;
+    chunk[length++] = kind;
+    chunk[length++] = pin;
+    length += writeVarint(&chunk[length], time - last_us);
+    length += writeVarint(&chunk[length], zigzag((int64_t)value - previous));
+
+    channel->value = value;
+    channel->time_us = time;
+    channel->chunk = chunkNumber;
+    last_us = time;
+    stats.records++;
+}
+
+// ==================== STATISTICS ====================
+
+const TraceStats& TraceRecorder::getStats() {
+    return stats;
+}
+
+void TraceRecorder::printStats() {
+    logPrintf("[Trace] %lu inputs, %lu recorded in %lu chunks (%lu bytes, %lu chunks dropped), %lu untracked\n",
+              stats.inputs, stats.records, stats.chunks, stats.bytes, stats.chunksDropped, stats.untracked);
+}
+
+// ==================== READER ====================
+
+// Constructor
+TraceChunkReader::TraceChunkReader() {
+    data = nullptr;
+    length = 0;
+    position = 0;
+    time_us = 0;
+    malformed = false;
+    channelCount = 0;
+}
+
+bool TraceChunkReader::readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && position < length; shift += 7) {
+        uint8_t byte = data[position++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool TraceChunkReader::begin(const uint8_t* chunk, size_t length) {
+    this->data = chunk;
+    this->length = length;
+    this->position = 0;
+    this->channelCount = 0;
+    this->malformed = !readVarint(time_us);
+    return !malformed;
+}
+
+bool TraceChunkReader::next(TraceEvent& event) {
+    if (malformed || position >= length) return false;
+
+    uint64_t delta_us;
+    uint64_t delta;
+    if (position + 2 > length) {
+        malformed = true;
+        return false;
+    }
+    event.kind = (HalInputKind)data[position++];
+    event.pin = data[position++];
+    if (!readVarint(delta_us) || !readVarint(delta)) {
+        malformed = true;
+        return false;
+    }
+
+    Channel* channel = nullptr;
+    for (uint8_t i = 0; i < channelCount; i++) {
+        if (channels[i].pin == event.pin && channels[i].kind == event.kind) channel = &channels[i];
+    }
+    if (channel == nullptr) {
+        if (channelCount >= TRACE_MAX_CHANNELS) {
+            malformed = true;
+            return false;
+        }
+        channel = &channels[channelCount++];
+        channel->kind = event.kind;
+        channel->pin = event.pin;
+        channel->value = 0;
+    }
+
+    time_us += delta_us;
+    channel->value = (int32_t)((int64_t)channel->value + unzigzag(delta));
+    event.time_us = time_us;
+    event.value = channel->value;
+    return true;
+}
+
+bool TraceChunkReader::isMalformed() {
+    return malformed;
+}
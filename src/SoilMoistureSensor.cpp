@@ -4,6 +4,9 @@
  */
 
 #include "SoilMoistureSensor.h"
+#include "HAL.h"
+#include "AdcEngine.h"
+#include "Telemetry.h"
 
 SoilMoistureSensor::SoilMoistureSensor(uint8_t analogPin, int dryVal, int wetVal) {
     pin = analogPin;
@@ -14,15 +17,16 @@ SoilMoistureSensor::SoilMoistureSensor(uint8_t analogPin, int dryVal, int wetVal
 }
 
 void SoilMoistureSensor::begin() {
-    pinMode(pin, INPUT);
+    HAL::gpio().setMode(pin, INPUT);
+    adcEngine.addChannel(pin);  // Background scan when the pin supports it
     // Set ADC resolution to 12-bit (0-4095)
-    analogReadResolution(12);
-    Serial.println("Soil Moisture Sensor initialized on pin " + String(pin));
+    HAL::adc().setResolution(12);
+    logPrintf("Soil Moisture Sensor initialized on pin %d\n", pin);
 }
 
 float SoilMoistureSensor::readMoisture() {
     // Read analog value
-    rawValue = analogRead(pin);
+    rawValue = adcEngine.read(pin);
     
     // Convert to percentage (inverted: lower value = more moisture)
     moisturePercent = map(rawValue, dryValue, wetValue, 0, 100);
@@ -43,24 +47,14 @@ float SoilMoistureSensor::getMoisturePercent() {
 
 void SoilMoistureSensor::calibrateDry(int value) {
     dryValue = value;
-    Serial.println("Dry value calibrated to: " + String(dryValue));
+    logPrintf("Dry value calibrated to: %d\n", dryValue);
 }
 
 void SoilMoistureSensor::calibrateWet(int value) {
     wetValue = value;
-    Serial.println("Wet value calibrated to: " + String(wetValue));
+    logPrintf("Wet value calibrated to: %d\n", wetValue);
 }
 
-String SoilMoistureSensor::getMoistureStatus() {
-    if (moisturePercent < 20) {
-        return "Dry";
-    } else if (moisturePercent < 40) {
-        return "Low";
-    } else if (moisturePercent < 60) {
-        return "Moderate";
-    } else if (moisturePercent < 80) {
-        return "High";
-    } else {
-        return "Wet";
-    }
+MoistureStatus SoilMoistureSensor::getMoistureStatus() {
+    return MOISTURE_SCALE.classify(moisturePercent);
 }
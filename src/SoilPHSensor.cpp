@@ -4,6 +4,9 @@
  */
 
 #include "SoilPHSensor.h"
+#include "HAL.h"
+#include "AdcEngine.h"
+#include "Telemetry.h"
 
 SoilPHSensor::SoilPHSensor(uint8_t analogPin) {
     pin = analogPin;
@@ -18,14 +21,15 @@ SoilPHSensor::SoilPHSensor(uint8_t analogPin) {
 }
 
 void SoilPHSensor::begin() {
-    pinMode(pin, INPUT);
-    analogReadResolution(12);  // 12-bit ADC (0-4095)
-    Serial.println("Soil pH Sensor initialized on pin " + String(pin));
+    HAL::gpio().setMode(pin, INPUT);
+    adcEngine.addChannel(pin);  // Background scan when the pin supports it
+    HAL::adc().setResolution(12);  // 12-bit ADC (0-4095)
+    logPrintf("Soil pH Sensor initialized on pin %d\n", pin);
 }
 
 float SoilPHSensor::readPH() {
     // Read analog value
-    rawValue = analogRead(pin);
+    rawValue = adcEngine.read(pin);
     
     // Convert to voltage (ESP32: 0-3.3V for 0-4095)
     voltage = (rawValue / 4095.0) * 3.3;
@@ -58,35 +62,21 @@ float SoilPHSensor::getVoltage() {
     return voltage;
 }
 
-String SoilPHSensor::getPHStatus() {
-    if (phValue < 4.5) {
-        return "Very Acidic";
-    } else if (phValue < 5.5) {
-        return "Acidic";
-    } else if (phValue < 6.5) {
-        return "Slightly Acidic";
-    } else if (phValue < 7.5) {
-        return "Neutral";
-    } else if (phValue < 8.5) {
-        return "Slightly Alkaline";
-    } else if (phValue < 9.5) {
-        return "Alkaline";
-    } else {
-        return "Very Alkaline";
-    }
+PHStatus SoilPHSensor::getPHStatus() {
+    return PH_SCALE.classify(phValue);
 }
 
 void SoilPHSensor::calibrateAcid(float voltage) {
     acidVoltage = voltage;
-    Serial.println("pH 4.0 calibrated to voltage: " + String(voltage, 3) + "V");
+    logPrintf("pH 4.0 calibrated to voltage: %.3fV\n", voltage);
 }
 
 void SoilPHSensor::calibrateNeutral(float voltage) {
     neutralVoltage = voltage;
-    Serial.println("pH 7.0 calibrated to voltage: " + String(voltage, 3) + "V");
+    logPrintf("pH 7.0 calibrated to voltage: %.3fV\n", voltage);
 }
 
 void SoilPHSensor::calibrateAlkaline(float voltage) {
     alkalineVoltage = voltage;
-    Serial.println("pH 10.0 calibrated to voltage: " + String(voltage, 3) + "V");
+    logPrintf("pH 10.0 calibrated to voltage: %.3fV\n", voltage);
 }
@@ -4,58 +4,86 @@
  */
 
 #include "SoilTemperatureSensor.h"
+#include "Telemetry.h"
 
 SoilTemperatureSensor::SoilTemperatureSensor(uint8_t dataPin) {
     pin = dataPin;
     temperatureC = 0.0;
     temperatureF = 0.0;
     sensorFound = false;
-    oneWire = nullptr;
     sensors = nullptr;
+    requestTime = 0;
 }
 
 void SoilTemperatureSensor::begin() {
-    // Create OneWire instance
-    oneWire = new OneWire(pin);
-    sensors = new DallasTemperature(oneWire);
+    // Open the OneWire bus
+    sensors = HAL::openTemperatureBus(pin);
     
-    // Start the library
-    sensors->begin();
-    
-    // Check if sensor is connected
-    sensorFound = (sensors->getDeviceCount() > 0);
+    // Start the bus and check if sensor is connected
+    sensorFound = (sensors->begin() > 0);
     
     if (sensorFound) {
-        Serial.println("DS18B20 Soil Temperature Sensor initialized on pin " + String(pin));
-        Serial.print("Sensors found: ");
-        Serial.println(sensors->getDeviceCount());
+        logPrintf("DS18B20 Soil Temperature Sensor initialized on pin %d\n", pin);
+        logPrintf("Sensors found: %d\n", sensors->getDeviceCount());
     } else {
-        Serial.println("WARNING: No DS18B20 sensor detected on pin " + String(pin));
+        logPrintf("WARNING: No DS18B20 sensor detected on pin %d\n", pin);
     }
 }
 
+float SoilTemperatureSensor::storeReading(float tempC) {
+    temperatureC = tempC;
+    
+    // Convert to Fahrenheit
+    temperatureF = (temperatureC * 9.0 / 5.0) + 32.0;
+    
+    // Check for reading error
+    if (temperatureC == HAL_TEMP_DISCONNECTED) {
+        logPrintf("Error: Failed to read temperature!\n");
+        return -127.0;
+    }
+    
+    return temperatureC;
+}
+
 float SoilTemperatureSensor::readTemperature() {
     if (!sensorFound) {
-        Serial.println("Error: No DS18B20 sensor found!");
+        logPrintf("Error: No DS18B20 sensor found!\n");
         return -127.0; // Error value
     }
     
-    // Request temperature reading
+    // Request temperature reading (blocks for the conversion)
+    sensors->setWaitForConversion(true);
     sensors->requestTemperatures();
     
     // Read temperature in Celsius
-    temperatureC = sensors->getTempCByIndex(0);
-    
-    // Convert to Fahrenheit
-    temperatureF = (temperatureC * 9.0 / 5.0) + 32.0;
-    
-    // Check for reading error
-    if (temperatureC == DEVICE_DISCONNECTED_C) {
-        Serial.println("Error: Failed to read temperature!");
-        return -127.0;
+    return storeReading(sensors->getTempC(0));
+}
+
+void SoilTemperatureSensor::startRead() {
+    if (!sensorFound) {
+        return;
     }
     
-    return temperatureC;
+    // Kick off the conversion and return immediately
+    sensors->setWaitForConversion(false);
+    sensors->requestTemperatures();
+    requestTime = HAL::clock().millis();
+}
+
+bool SoilTemperatureSensor::pollRead() {
+    if (!sensorFound) {
+        return true;
+    }
+    return sensors->isConversionComplete() ||
+           HAL::clock().millis() - requestTime >= SOIL_TEMP_CONVERSION_TIMEOUT_MS;
+}
+
+float SoilTemperatureSensor::finishRead() {
+    if (!sensorFound) {
+        logPrintf("Error: No DS18B20 sensor found!\n");
+        return -127.0; // Error value
+    }
+    return storeReading(sensors->getTempC(0));
 }
 
 float SoilTemperatureSensor::getTemperatureC() {
@@ -70,18 +98,8 @@ bool SoilTemperatureSensor::isConnected() {
     return sensorFound;
 }
 
-String SoilTemperatureSensor::getTemperatureStatus() {
-    if (temperatureC < 5) {
-        return "Too Cold";
-    } else if (temperatureC < 15) {
-        return "Cold";
-    } else if (temperatureC < 25) {
-        return "Optimal";
-    } else if (temperatureC < 35) {
-        return "Warm";
-    } else {
-        return "Too Hot";
-    }
+SoilTempStatus SoilTemperatureSensor::getTemperatureStatus() {
+    return TEMPERATURE_SCALE.classify(temperatureC);
 }
 
 int SoilTemperatureSensor::getDeviceCount() {
@@ -0,0 +1,196 @@
+/*
+ * TaskScheduler.cpp
+ * Implementation of the cooperative sampling scheduler
+ */
+
+#include "TaskScheduler.h"
+#include "HAL.h"
+#include "Telemetry.h"
+
+// Constructor
+TaskScheduler::TaskScheduler() {
+    this->taskCount = 0;
+    this->passes = 0;
+    this->maxPass_us = 0;
+    this->probe = nullptr;
+}
+
+// Register a task
+int TaskScheduler::addTask(ScheduledTask* task, const char* name, unsigned long period_ms,
+                           unsigned long deadline_ms, unsigned long offset_ms) {
+    if (taskCount >= SCHEDULER_MAX_TASKS || task == nullptr || period_ms == 0) {
+        logPrintf("[Scheduler] Cannot add task\n");
+        return -1;
+    }
+
+    TaskEntry& entry = tasks[taskCount];
+    entry.task = task;
+    entry.name = name;
+    entry.period_us = period_ms * 1000UL;
+    entry.deadline_us = (deadline_ms == 0 ? period_ms : deadline_ms) * 1000UL;
+    entry.nextRelease_us = offset_ms * 1000UL;  // Relative until begin()
+    entry.release_us = 0;
+    entry.running = false;
+    memset(&entry.stats, 0, sizeof(entry.stats));
+
+    return taskCount++;
+}
+
+// Anchor all release times to now
+void TaskScheduler::begin() {
+    unsigned long now = HAL::clock().micros();
+
+    for (int i = 0; i < taskCount; i++) {
+        tasks[i].nextRelease_us += now;
+        tasks[i].running = false;
+    }
+
+    logPrintf("[Scheduler] Started with %d tasks\n", taskCount);
+}
+
+void TaskScheduler::setProbe(TaskProbe* probe) {
+    this->probe = probe;
+}
+
+// Start timing one phase call of a task
+unsigned long TaskScheduler::beginStep(TaskEntry& entry) {
+    if (probe != nullptr) probe->beginStep((int)(&entry - tasks));
+    return HAL::clock().micros();
+}
+
+// Track the longest single phase call of a task
+void TaskScheduler::recordStep(TaskEntry& entry, unsigned long stepStart, bool finished) {
+    unsigned long step = HAL::clock().micros() - stepStart;
+    if (step > entry.stats.maxStep_us) {
+        entry.stats.maxStep_us = step;
+    }
+    if (probe != nullptr) probe->endStep((int)(&entry - tasks), finished);
+}
+
+// Release a due task, or count an overrun if it is still busy
+void TaskScheduler::releaseTask(TaskEntry& entry, unsigned long now) {
+    unsigned long lateness = now - entry.nextRelease_us;
+
+    // Move to the next release point, dropping every period we slept through
+    unsigned long missed = lateness / entry.period_us;
+    entry.nextRelease_us += (missed + 1) * entry.period_us;
+    entry.stats.overruns += missed;
+
+    if (entry.running) {
+        entry.stats.overruns++;
+        return;
+    }
+
+    lateness %= entry.period_us;
+    entry.stats.totalJitter_us += lateness;
+    if (lateness > entry.stats.maxJitter_us) {
+        entry.stats.maxJitter_us = lateness;
+    }
+
+    entry.release_us = now;
+    entry.running = true;
+
+    unsigned long stepStart = beginStep(entry);
+    entry.task->start();
+    recordStep(entry, stepStart);
+}
+
+// Advance a running task and close it out when it completes
+void TaskScheduler::pollTask(TaskEntry& entry) {
+    unsigned long stepStart = beginStep(entry);
+    bool done = entry.task->poll();
+    recordStep(entry, stepStart);
+
+    if (!done) return;
+
+    stepStart = beginStep(entry);
+    entry.task->finish();
+    recordStep(entry, stepStart, true);
+
+    entry.running = false;
+    entry.stats.runs++;
+
+    unsigned long response = HAL::clock().micros() - entry.release_us;
+    if (response > entry.stats.maxResponse_us) {
+        entry.stats.maxResponse_us = response;
+    }
+    if (response > entry.deadline_us) {
+        entry.stats.deadlineMisses++;
+    }
+}
+
+// Run one non-blocking pass
+void TaskScheduler::run() {
+    unsigned long passStart = HAL::clock().micros();
+
+    for (int i = 0; i < taskCount; i++) {
+        TaskEntry& entry = tasks[i];
+
+        // Wrap-safe "now >= nextRelease"
+        unsigned long now = HAL::clock().micros();
+        if ((long)(now - entry.nextRelease_us) >= 0) {
+            releaseTask(entry, now);
+        }
+
+        if (entry.running) {
+            pollTask(entry);
+        }
+    }
+
+    unsigned long pass = HAL::clock().micros() - passStart;
+    if (pass > maxPass_us) {
+        maxPass_us = pass;
+    }
+    passes++;
+}
+
+// Get number of registered tasks
+int TaskScheduler::getTaskCount() {
+    return taskCount;
+}
+
+// Get task name
+const char* TaskScheduler::getTaskName(int index) {
+    return tasks[index].name;
+}
+
+// Get task statistics
+const TaskStats& TaskScheduler::getStats(int index) {
+    return tasks[index].stats;
+}
+
+// Get longest scheduler pass (worst-case loop latency)
+unsigned long TaskScheduler::getMaxPassTime_us() {
+    return maxPass_us;
+}
+
+// Get number of scheduler passes
+unsigned long TaskScheduler::getPassCount() {
+    return passes;
+}
+
+// Clear all counters
+void TaskScheduler::resetStats() {
+    for (int i = 0; i < taskCount; i++) {
+        memset(&tasks[i].stats, 0, sizeof(tasks[i].stats));
+    }
+    passes = 0;
+    maxPass_us = 0;
+}
+
+// Print statistics table
+void TaskScheduler::printStats() {
+    logPrintf("[Scheduler] task          runs  ovr  miss  jit_max  jit_avg  resp_max  step_max (us)\n");
+
+    for (int i = 0; i < taskCount; i++) {
+        const TaskStats& s = tasks[i].stats;
+        unsigned long released = s.runs + (tasks[i].running ? 1 : 0);
+        unsigned long meanJitter = released > 0 ? (unsigned long)(s.totalJitter_us / released) : 0;
+
+        logPrintf("[Scheduler] %-12s %5lu %4lu %5lu %8lu %8lu %9lu %9lu\n",
+                  tasks[i].name, s.runs, s.overruns, s.deadlineMisses,
+                  s.maxJitter_us, meanJitter, s.maxResponse_us, s.maxStep_us);
+    }
+
+    logPrintf("[Scheduler] %lu passes, longest pass %lu us\n", passes, maxPass_us);
+}
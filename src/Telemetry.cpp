@@ -0,0 +1,185 @@
+/*
+ * Telemetry.cpp
+ * Implementation of the serial telemetry link and the log channel
+ */
+
+#include "Telemetry.h"
+#include "HAL.h"
+#include <Arduino.h>
+
+static_assert(TELEMETRY_SNAPSHOT_SIZE + TELEMETRY_CRC_SIZE <= TELEMETRY_PAYLOAD_MAX,
+              "snapshot does not fit the payload buffer");
+
+TelemetryLink telemetry;
+
+// ==================== FRAMING ====================
+
+uint16_t telemetryCrc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Each run of up to 254 non-zero bytes is preceded by its length + 1; a
+// zero in the data ends a run
+size_t cobsEncode(const uint8_t* data, size_t length, uint8_t* out) {
+    size_t code = 0;                 // Where the current run's length byte goes
+    size_t n = 1;
+    uint8_t run = 1;
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != 0) {
+            out[n++] = data[i];
+            run++;
+        }
+        if (data[i] == 0 || run == 0xFF) {
+            out[code] = run;
+            code = n++;
+            run = 1;
+        }
+    }
+    out[code] = run;
+    out[n++] = 0x00;
+    return n;
+}
+
+size_t cobsDecode(const uint8_t* frame, size_t length, uint8_t* out) {
+    size_t n = 0;
+    size_t i = 0;
+    while (i < length) {
+        uint8_t code = frame[i++];
+        if (code == 0 || i + code - 1 > length) return 0;
+        for (uint8_t k = 1; k < code; k++) {
+            if (frame[i] == 0) return 0;
+            out[n++] = frame[i++];
+        }
+        if (code != 0xFF && i < length) out[n++] = 0;
+    }
+    return n;
+}
+
+// ==================== LINK ====================
+
+// Constructor
+TelemetryLink::TelemetryLink() {
+    mode = TELEMETRY_MODE_TEXT;
+    logEnabled = false;
+    sequence = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+void TelemetryLink::begin(unsigned long baud, TelemetryMode mode, bool log) {
+    this->mode = mode;
+    this->logEnabled = log;
+    HAL::uart().begin(baud, TELEMETRY_TX_BUFFER);
+    if (mode == TELEMETRY_MODE_BINARY) {
+        const uint8_t delimiter = 0x00;
+        HAL::uart().write(&delimiter, 1);
+    }
+}
+
+bool TelemetryLink::isBinary() {
+    return mode == TELEMETRY_MODE_BINARY;
+}
+
+// Common header; returns where the body starts
+size_t TelemetryLink::startPayload(uint8_t type) {
+    uint32_t uptime = HAL::clock().millis();
+    payload[0] = type;
+    memcpy(&payload[1], &sequence, 2);               // Little endian on ESP32 and x86
+    memcpy(&payload[3], &uptime, 4);
+    sequence++;
+    return TELEMETRY_HEADER_SIZE;
+}
+
+// Whole frame or nothing, so a full buffer never splits one. reserve bytes
+// must stay free after the frame.
+bool TelemetryLink::sendPayload(size_t length, size_t reserve) {
+    uint16_t crc = telemetryCrc16(payload, length);
+    memcpy(&payload[length], &crc, 2);
+    size_t frameLength = cobsEncode(payload, length + TELEMETRY_CRC_SIZE, frame);
+
+    if (HAL::uart().availableForWrite() < frameLength + reserve) return false;
+    HAL::uart().write(frame, frameLength);
+    stats.bytes += frameLength;
+    return true;
+}
+
+bool TelemetryLink::sendSnapshot(const TelemetrySnapshot& snapshot) {
+    if (mode != TELEMETRY_MODE_BINARY) return false;
+
+    size_t n = startPayload(TELEMETRY_FRAME_SNAPSHOT);
+    memcpy(&payload[n], &snapshot.flags, 2);
+    memcpy(&payload[n + 2], &snapshot.remoteMask, 2);
+    memcpy(&payload[n + 4], snapshot.values, sizeof(snapshot.values));
+    memcpy(&payload[n + 4 + sizeof(snapshot.values)], snapshot.status, sizeof(snapshot.status));
+    if (!sendPayload(TELEMETRY_SNAPSHOT_SIZE, 0)) {
+        stats.dropped++;
+        return false;
+    }
+    stats.snapshots++;
+    return true;
+}
+
+void TelemetryLink::log(const char* text) {
+    if (mode == TELEMETRY_MODE_TEXT) {
+        Serial.print(text);
+        return;
+    }
+    if (!logEnabled) {
+        stats.logsDiscarded++;
+        return;
+    }
+
+    size_t n = startPayload(TELEMETRY_FRAME_LOG);
+    size_t length = strlen(text);
+    if (length > TELEMETRY_LOG_MAX) length = TELEMETRY_LOG_MAX;
+    memcpy(&payload[n], text, length);
+
+    // A burst of log lines must not crowd out the next snapshot
+    if (sendPayload(n + length, TELEMETRY_SNAPSHOT_RESERVE)) {
+        stats.logFrames++;
+    } else {
+        stats.logsDropped++;
+    }
+}
+
+bool TelemetryLink::sendTrace(const uint8_t* chunk, size_t length) {
+    if (mode != TELEMETRY_MODE_BINARY || length > TELEMETRY_LOG_MAX) return false;
+
+    size_t n = startPayload(TELEMETRY_FRAME_TRACE);
+    memcpy(&payload[n], chunk, length);
+    if (!sendPayload(n + length, TELEMETRY_SNAPSHOT_RESERVE)) {
+        stats.traceDropped++;
+        return false;
+    }
+    stats.traceChunks++;
+    return true;
+}
+
+void logPrintf(const char* format, ...) {
+    char text[TELEMETRY_LOG_MAX + 1];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    telemetry.log(text);
+}
+
+// ==================== STATISTICS ====================
+
+const TelemetryStats& TelemetryLink::getStats() {
+    return stats;
+}
+
+void TelemetryLink::printStats() {
+    logPrintf("[Telemetry] %lu snapshots (%lu dropped), %lu log frames (%lu dropped, %lu discarded), %lu bytes\n",
+              stats.snapshots, stats.dropped, stats.logFrames, stats.logsDropped, stats.logsDiscarded, stats.bytes);
+    if (stats.traceChunks > 0 || stats.traceDropped > 0) {
+        logPrintf("[Telemetry] %lu trace chunks (%lu dropped)\n", stats.traceChunks, stats.traceDropped);
+    }
+}
@@ -4,6 +4,8 @@
  */
 
 #include "WaterTankSensor.h"
+#include "HAL.h"
+#include "Telemetry.h"
 
 // Constructor
 WaterTankSensor::WaterTankSensor(uint8_t trigPin, uint8_t echoPin, float tankHeight_cm, float tankCapacity_liters) {
@@ -15,28 +17,29 @@ WaterTankSensor::WaterTankSensor(uint8_t trigPin, uint8_t echoPin, float tankHei
     this->waterLevel_cm = 0.0;
     this->waterLevel_percent = 0.0;
     this->waterVolume_liters = 0.0;
+    this->pingStart_us = 0;
+    this->echoWidth_us = 0;
 }
 
 // Initialize the sensor
 void WaterTankSensor::begin() {
-    pinMode(trigPin, OUTPUT);
-    pinMode(echoPin, INPUT);
-    Serial.println("[WaterTank] HC-SR04 Water Tank Level Sensor initialized");
-    Serial.printf("[WaterTank] Tank: %.0f cm height, %.0f L capacity\n", tankHeight_cm, tankCapacity_liters);
-}
-
-// Measure distance using ultrasonic sensor
-float WaterTankSensor::measureDistance() {
-    // Send 10us pulse to trigger
-    digitalWrite(trigPin, LOW);
-    delayMicroseconds(2);
-    digitalWrite(trigPin, HIGH);
-    delayMicroseconds(10);
-    digitalWrite(trigPin, LOW);
-    
-    // Read echo pulse duration
-    long duration = pulseIn(echoPin, HIGH, 30000); // 30ms timeout
-    
+    HAL::gpio().setMode(trigPin, OUTPUT);
+    HAL::gpio().setMode(echoPin, INPUT);
+    logPrintf("[WaterTank] HC-SR04 Water Tank Level Sensor initialized\n");
+    logPrintf("[WaterTank] Tank: %.0f cm height, %.0f L capacity\n", tankHeight_cm, tankCapacity_liters);
+}
+
+// Send 10us pulse to trigger
+void WaterTankSensor::trigger() {
+    HAL::gpio().write(trigPin, LOW);
+    HAL::clock().delayMicroseconds(2);
+    HAL::gpio().write(trigPin, HIGH);
+    HAL::clock().delayMicroseconds(10);
+    HAL::gpio().write(trigPin, LOW);
+}
+
+// Convert echo pulse duration to distance
+float WaterTankSensor::echoToDistance(unsigned long duration) {
     // Calculate distance in cm (speed of sound = 343 m/s or 0.0343 cm/us)
     // Distance = (duration * 0.0343) / 2
     float distance = duration * 0.01715;
@@ -49,11 +52,8 @@ float WaterTankSensor::measureDistance() {
     return distance;
 }
 
-// Read water level
-float WaterTankSensor::readLevel() {
-    // Measure distance from sensor to water surface
-    distance_cm = measureDistance();
-    
+// Update level, percentage and volume from the last distance
+void WaterTankSensor::updateLevel() {
     if (distance_cm > 0) {
         // Calculate water level (tank height - distance from top)
         waterLevel_cm = tankHeight_cm - distance_cm;
@@ -77,6 +77,46 @@ float WaterTankSensor::readLevel() {
         waterLevel_percent = 0.0;
         waterVolume_liters = 0.0;
     }
+}
+
+// Start a non-blocking measurement: arm the echo capture, then ping
+void WaterTankSensor::startRead() {
+    echoWidth_us = 0;
+    HAL::pulse().startCapture(echoPin, HIGH);
+    trigger();
+    pingStart_us = HAL::clock().micros();
+}
+
+// True once the echo has been captured or the timeout has expired
+bool WaterTankSensor::pollRead() {
+    if (HAL::pulse().readCapture(echoPin, echoWidth_us)) {
+        return true;
+    }
+    if (HAL::clock().micros() - pingStart_us >= WATER_ECHO_TIMEOUT_US) {
+        echoWidth_us = 0;
+        return true;
+    }
+    return false;
+}
+
+// Release the capture and compute the level
+float WaterTankSensor::finishRead() {
+    HAL::pulse().stopCapture(echoPin);
+    distance_cm = echoToDistance(echoWidth_us);
+    updateLevel();
+    return waterLevel_cm;
+}
+
+// Read water level (blocking)
+float WaterTankSensor::readLevel() {
+    trigger();
+    
+    // Read echo pulse duration
+    long duration = HAL::pulse().measurePulse(echoPin, HIGH, WATER_ECHO_TIMEOUT_US);
+    
+    // Measure distance from sensor to water surface
+    distance_cm = echoToDistance(duration);
+    updateLevel();
     
     return waterLevel_cm;
 }
@@ -102,20 +142,8 @@ float WaterTankSensor::getVolume_liters() {
 }
 
 // Get tank status
-String WaterTankSensor::getTankStatus() {
-    if (waterLevel_percent < 10) {
-        return "Critical Low";
-    } else if (waterLevel_percent < 25) {
-        return "Low";
-    } else if (waterLevel_percent < 50) {
-        return "Medium";
-    } else if (waterLevel_percent < 75) {
-        return "Good";
-    } else if (waterLevel_percent < 90) {
-        return "High";
-    } else {
-        return "Full";
-    }
+TankStatus WaterTankSensor::getTankStatus() {
+    return TANK_SCALE.classify(waterLevel_percent);
 }
 
 // Check if water is low
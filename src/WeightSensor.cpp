@@ -4,6 +4,7 @@
  */
 
 #include "WeightSensor.h"
+#include "Telemetry.h"
 
 // Constructor
 WeightSensor::WeightSensor(uint8_t dataPin, uint8_t clockPin, float calibrationFactor, float maxCapacity_kg) {
@@ -12,36 +13,40 @@ WeightSensor::WeightSensor(uint8_t dataPin, uint8_t clockPin, float calibrationF
     this->calibrationFactor = calibrationFactor;
     this->maxCapacity_kg = maxCapacity_kg;
     this->weight_kg = 0.0;
+    this->sampleSum = 0.0;
+    this->sampleCount = 0;
+    this->lastSample_ms = 0;
+    this->scale = HAL::openLoadCell(dataPin, clockPin);
 }
 
 // Initialize the sensor
 void WeightSensor::begin() {
-    scale.begin(dataPin, clockPin);
+    scale->begin();
     
-    Serial.println("[Weight] HX711 Weight Sensor initialized");
-    Serial.println("[Weight] Calibrating... Please ensure scale is empty");
+    logPrintf("[Weight] HX711 Weight Sensor initialized\n");
+    logPrintf("[Weight] Calibrating... Please ensure scale is empty\n");
     
-    if (scale.wait_ready_timeout(1000)) {
-        scale.set_scale(calibrationFactor);
-        scale.tare(); // Reset scale to 0
-        Serial.println("[Weight] Calibration complete!");
+    if (scale->waitReady(1000)) {
+        scale->setScale(calibrationFactor);
+        scale->tare(); // Reset scale to 0
+        logPrintf("[Weight] Calibration complete!\n");
     } else {
-        Serial.println("[Weight] WARNING: HX711 not ready!");
+        logPrintf("[Weight] WARNING: HX711 not ready!\n");
     }
 }
 
 // Tare/zero the scale
 void WeightSensor::tare() {
-    if (scale.wait_ready_timeout(1000)) {
-        scale.tare();
-        Serial.println("[Weight] Scale tared (zeroed)");
+    if (scale->waitReady(1000)) {
+        scale->tare();
+        logPrintf("[Weight] Scale tared (zeroed)\n");
     }
 }
 
 // Read weight
 float WeightSensor::readWeight() {
-    if (scale.wait_ready_timeout(200)) {
-        weight_kg = scale.get_units(5); // Average of 5 readings
+    if (scale->waitReady(200)) {
+        weight_kg = scale->getUnits(WEIGHT_SAMPLES); // Average of 5 readings
         
         // Ensure weight is not negative
         if (weight_kg < 0) {
@@ -50,11 +55,47 @@ float WeightSensor::readWeight() {
         
         return weight_kg;
     } else {
-        Serial.println("[Weight] Sensor not ready");
+        logPrintf("[Weight] Sensor not ready\n");
         return -1.0;
     }
 }
 
+// Start a non-blocking read
+void WeightSensor::startRead() {
+    sampleSum = 0.0;
+    sampleCount = 0;
+    lastSample_ms = HAL::clock().millis();
+}
+
+// Take a conversion when the HX711 has one, true when done or timed out
+bool WeightSensor::pollRead() {
+    if (scale->isReady()) {
+        sampleSum += scale->getUnits(1);
+        sampleCount++;
+        lastSample_ms = HAL::clock().millis();
+    } else if (HAL::clock().millis() - lastSample_ms >= WEIGHT_READY_TIMEOUT_MS) {
+        return true;
+    }
+    return sampleCount >= WEIGHT_SAMPLES;
+}
+
+// Average the collected conversions
+float WeightSensor::finishRead() {
+    if (sampleCount < WEIGHT_SAMPLES) {
+        logPrintf("[Weight] Sensor not ready\n");
+        return -1.0;
+    }
+    
+    weight_kg = sampleSum / sampleCount;
+    
+    // Ensure weight is not negative
+    if (weight_kg < 0) {
+        weight_kg = 0;
+    }
+    
+    return weight_kg;
+}
+
 // Get weight in kg
 float WeightSensor::getWeight_kg() {
     return weight_kg;
@@ -66,30 +107,15 @@ float WeightSensor::getWeight_lbs() {
 }
 
 // Get weight status
-String WeightSensor::getWeightStatus() {
-    float percent = (weight_kg / maxCapacity_kg) * 100.0;
-    
-    if (weight_kg < 0.1) {
-        return "Empty";
-    } else if (percent < 25) {
-        return "Low";
-    } else if (percent < 50) {
-        return "Quarter Full";
-    } else if (percent < 75) {
-        return "Half Full";
-    } else if (percent < 90) {
-        return "Nearly Full";
-    } else if (percent < 100) {
-        return "Full";
-    } else {
-        return "OVERLOADED!";
-    }
+WeightStatus WeightSensor::getWeightStatus() {
+    float percent = weight_kg < 0.1 ? -1.0f : (weight_kg / maxCapacity_kg) * 100.0f;
+    return WEIGHT_SCALE.classify(percent);
 }
 
 // Set calibration factor
 void WeightSensor::setCalibrationFactor(float factor) {
     calibrationFactor = factor;
-    scale.set_scale(calibrationFactor);
+    scale->setScale(calibrationFactor);
 }
 
 // Check if overloaded
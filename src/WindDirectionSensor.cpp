@@ -4,22 +4,31 @@
  */
 
 #include "WindDirectionSensor.h"
+#include "HAL.h"
+#include "AdcEngine.h"
+#include "Telemetry.h"
 
 // Constructor
 WindDirectionSensor::WindDirectionSensor(uint8_t analogPin, int samples) {
     this->analogPin = analogPin;
     this->samples = samples;
+    this->sampleSum = 0;
+    this->sampleCount = 0;
+    this->nextSample_ms = 0;
     this->rawValue = 0;
     this->voltage = 0.0;
     this->direction = 0;
     this->cardinalDirection = "N";
+    this->shortWindow = average.addWindow(WIND_DIR_SHORT_WINDOW);
+    this->longWindow = average.addWindow(WIND_DIR_LONG_WINDOW);
 }
 
 // Initialize the sensor
 void WindDirectionSensor::begin() {
-    pinMode(analogPin, INPUT);
-    Serial.println("[WindDirection] Wind Direction Sensor initialized");
-    Serial.println("[WindDirection] Using potentiometer for simulation (0-360°)");
+    HAL::gpio().setMode(analogPin, INPUT);
+    adcEngine.addChannel(analogPin);  // Background scan when the pin supports it
+    logPrintf("[WindDirection] Wind Direction Sensor initialized\n");
+    logPrintf("[WindDirection] Using potentiometer for simulation (0-360°)\n");
 }
 
 // Convert ADC value to direction (0-360 degrees)
@@ -30,40 +39,36 @@ int WindDirectionSensor::voltageToDirection(int adcValue) {
     return degrees;
 }
 
-// Convert degrees to cardinal direction
-String WindDirectionSensor::directionToCardinal(int degrees) {
-    // Normalize to 0-359
-    degrees = degrees % 360;
-    if (degrees < 0) degrees += 360;
+// Start a non-blocking read
+void WindDirectionSensor::startRead() {
+    sampleSum = 0;
+    sampleCount = 0;
+    nextSample_ms = HAL::clock().millis();
     
-    // 16-point compass rose
-    if (degrees >= 349 || degrees < 11) return "N";
-    else if (degrees >= 11 && degrees < 34) return "NNE";
-    else if (degrees >= 34 && degrees < 56) return "NE";
-    else if (degrees >= 56 && degrees < 79) return "ENE";
-    else if (degrees >= 79 && degrees < 101) return "E";
-    else if (degrees >= 101 && degrees < 124) return "ESE";
-    else if (degrees >= 124 && degrees < 146) return "SE";
-    else if (degrees >= 146 && degrees < 169) return "SSE";
-    else if (degrees >= 169 && degrees < 191) return "S";
-    else if (degrees >= 191 && degrees < 214) return "SSW";
-    else if (degrees >= 214 && degrees < 236) return "SW";
-    else if (degrees >= 236 && degrees < 259) return "WSW";
-    else if (degrees >= 259 && degrees < 281) return "W";
-    else if (degrees >= 281 && degrees < 304) return "WNW";
-    else if (degrees >= 304 && degrees < 326) return "NW";
-    else return "NNW";  // 326-348
+    // Already oversampled in the background, no conversions needed. The
+    // latest block is used instead of the moving average: averaging raw
+    // codes across north mixes 359 and 1 degree into 180, the vector
+    // windows do the smoothing instead.
+    if (adcEngine.isScanning(analogPin)) {
+        sampleSum = (long)adcEngine.readLatest(analogPin) * samples;
+        sampleCount = samples;
+    }
 }
 
-// Read wind direction
-int WindDirectionSensor::readDirection() {
-    // Read analog value and average multiple samples
-    long sum = 0;
-    for (int i = 0; i < samples; i++) {
-        sum += analogRead(analogPin);
-        delay(2);
+// Take the next sample once it is due, true when all samples are in
+bool WindDirectionSensor::pollRead() {
+    unsigned long now = HAL::clock().millis();
+    if (sampleCount < samples && (long)(now - nextSample_ms) >= 0) {
+        sampleSum += HAL::adc().read(analogPin);
+        sampleCount++;
+        nextSample_ms = now + WIND_DIR_SAMPLE_INTERVAL_MS;
     }
-    rawValue = sum / samples;
+    return sampleCount >= samples;
+}
+
+// Average the collected samples and convert
+int WindDirectionSensor::finishRead() {
+    rawValue = sampleSum / samples;
     
     // Convert to voltage (0-3.3V)
     voltage = (rawValue / 4095.0) * 3.3;
@@ -71,22 +76,54 @@ int WindDirectionSensor::readDirection() {
     // Convert to direction
     direction = voltageToDirection(rawValue);
     
-    // Get cardinal direction
-    cardinalDirection = directionToCardinal(direction);
+    // Get cardinal direction (table lookup)
+    cardinalDirection = windCardinal16(direction);
+    
+    // Feed the rolling vector windows
+    average.add(direction);
     
     return direction;
 }
 
+// Read wind direction
+int WindDirectionSensor::readDirection() {
+    startRead();
+    while (!pollRead()) {
+        HAL::clock().delay(1);
+    }
+    return finishRead();
+}
+
 // Get direction in degrees
 int WindDirectionSensor::getDirectionDegrees() {
     return direction;
 }
 
 // Get cardinal direction
-String WindDirectionSensor::getCardinalDirection() {
+const char* WindDirectionSensor::getCardinalDirection() {
     return cardinalDirection;
 }
 
+// Vector-mean direction over the 2-minute window
+float WindDirectionSensor::getMeanDirection2Min() {
+    return average.stats(shortWindow).direction;
+}
+
+// Vector-mean direction over the 10-minute window
+float WindDirectionSensor::getMeanDirection10Min() {
+    return average.stats(longWindow).direction;
+}
+
+// Directional standard deviation over the 2-minute window
+float WindDirectionSensor::getDirectionStdDev2Min() {
+    return average.stats(shortWindow).stdDev;
+}
+
+// Directional standard deviation over the 10-minute window
+float WindDirectionSensor::getDirectionStdDev10Min() {
+    return average.stats(longWindow).stdDev;
+}
+
 // Get raw ADC value
 int WindDirectionSensor::getRawValue() {
     return rawValue;
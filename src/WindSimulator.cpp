@@ -0,0 +1,84 @@
+/*
+ * WindSimulator.cpp
+ * Implementation of the anemometer test signal source
+ */
+
+#include "WindSimulator.h"
+#include "HAL.h"
+#include "Telemetry.h"
+
+// Static member initialization
+WindSimulator* WindSimulator::instance = nullptr;
+
+// Constructor
+WindSimulator::WindSimulator(float calibrationFactor, uint8_t timerId) {
+    this->outputPin = 0;
+    this->potPin = 0xFF;
+    this->timerId = timerId;
+    this->calibrationFactor = calibrationFactor;
+    this->speed_ms = 0.0;
+    this->running = false;
+    this->toggleState = false;
+    instance = this;
+}
+
+// Timer interrupt, one toggle per half period
+void IRAM_ATTR WindSimulator::onTimer() {
+    if (instance && instance->running) {
+        instance->toggleState = !instance->toggleState;
+        HAL::gpio().write(instance->outputPin, instance->toggleState ? HIGH : LOW);
+    }
+}
+
+// Start the generator
+void WindSimulator::begin(uint8_t outputPin, uint8_t potentiometerPin) {
+    this->outputPin = outputPin;
+    this->potPin = potentiometerPin;
+
+    HAL::gpio().setMode(outputPin, OUTPUT);
+    HAL::gpio().write(outputPin, LOW);
+    if (potPin != 0xFF) {
+        HAL::gpio().setMode(potPin, INPUT);
+    }
+
+    // Start at 100Hz toggling (1MHz tick) until a speed is set
+    running = HAL::timer().start(timerId, 10000, &onTimer);
+
+    logPrintf("[WindSim] Signal generator active on pin %d\n", outputPin);
+    if (potPin != 0xFF) {
+        logPrintf("[WindSim] Control via potentiometer on pin %d\n", potPin);
+    }
+}
+
+// Follow the potentiometer
+void WindSimulator::update() {
+    if (!running || potPin == 0xFF) return;
+
+    // Read potentiometer value (0-4095) and map to wind speed
+    float target = (HAL::adc().read(potPin) / 4095.0) * WIND_SIM_MAX_SPEED;
+
+    // Only retune on significant changes to ignore pot noise
+    if (abs(target - speed_ms) > WIND_SIM_HYSTERESIS) {
+        setSpeed(target);
+    }
+}
+
+// Generate a fixed speed
+void WindSimulator::setSpeed(float speed_ms) {
+    this->speed_ms = speed_ms;
+    if (!running) return;
+
+    // pulses_per_second = wind_speed * calibrationFactor
+    float pulsesPerSecond = speed_ms * calibrationFactor;
+    if (pulsesPerSecond > 0.1) {
+        // Timer period in microseconds for toggle (half period)
+        HAL::timer().setPeriod(timerId, (uint64_t)((1000000.0 / pulsesPerSecond) / 2.0));
+    } else {
+        // Very slow or stopped - set to very long period
+        HAL::timer().setPeriod(timerId, 1000000);
+    }
+}
+
+float WindSimulator::getSpeed() {
+    return speed_ms;
+}
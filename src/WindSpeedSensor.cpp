@@ -4,118 +4,74 @@
  */
 
 #include "WindSpeedSensor.h"
-
-// Static member initialization
-WindSpeedSensor* WindSpeedSensor::instance = nullptr;
+#include "HAL.h"
+#include "Telemetry.h"
 
 // Constructor
-WindSpeedSensor::WindSpeedSensor(uint8_t pin, float calibrationFactor) {
+WindSpeedSensor::WindSpeedSensor(uint8_t pin, float calibrationFactor, uint8_t unit) {
     this->pin = pin;
+    this->unit = unit;
     this->calibrationFactor = calibrationFactor;
     this->pulseCount = 0;
     this->windSpeed_ms = 0.0;
     this->lastMeasurementTime = 0;
-    this->simulationMode = false;
-    this->simulatorPin = 0;
-    this->potPin = 0;
-    this->timer = nullptr;
-    this->simulatedWindSpeed = 0.0;
-    this->toggleState = false;
-    instance = this;
-}
-
-// Static interrupt handler
-void IRAM_ATTR WindSpeedSensor::handleInterrupt() {
-    if (instance != nullptr) {
-        instance->pulseCount++;
-    }
+    this->captureMode = false;
 }
 
 // Initialize the sensor
 void WindSpeedSensor::begin() {
-    pinMode(pin, INPUT_PULLUP);
-    attachInterrupt(digitalPinToInterrupt(pin), handleInterrupt, FALLING);
-    lastMeasurementTime = millis();
-    Serial.println("[WindSpeed] Sensor initialized (Pulse Counting Mode)");
-}
-
-// Enable simulation mode with PWM generator
-void WindSpeedSensor::enableSimulation(uint8_t simPin, uint8_t potentiometerPin) {
-    simulationMode = true;
-    simulatorPin = simPin;
-    potPin = potentiometerPin;
-    
-    pinMode(simulatorPin, OUTPUT);
-    digitalWrite(simulatorPin, LOW);
-    pinMode(potPin, INPUT);
-    
-    // Create hardware timer (Timer 0, prescaler 80 = 1MHz, count up)
-    timer = timerBegin(0, 80, true);
-    timerAttachInterrupt(timer, &onSimulatorTimer, true);
-    timerAlarmWrite(timer, 10000, true); // Start with 100Hz (0.01s = 10000us)
-    timerAlarmEnable(timer);
-    
-    Serial.println("[WindSpeed] Simulation mode enabled");
-    Serial.println("[WindSpeed] PWM generator active on pin " + String(simulatorPin));
-    Serial.println("[WindSpeed] Control via potentiometer on pin " + String(potPin));
-}
-
-// Timer interrupt for PWM generation
-void IRAM_ATTR WindSpeedSensor::onSimulatorTimer() {
-    if (instance && instance->simulationMode) {
-        instance->toggleState = !instance->toggleState;
-        digitalWrite(instance->simulatorPin, instance->toggleState ? HIGH : LOW);
+    HAL::gpio().setMode(pin, INPUT_PULLUP);
+    if (!HAL::counter().begin(unit, pin, FALLING, WIND_GLITCH_FILTER_NS)) {
+        logPrintf("[WindSpeed] Pulse counter unit %d unavailable\n", unit);
     }
+    lastMeasurementTime = HAL::clock().millis();
+    logPrintf("[WindSpeed] Sensor initialized (Hardware Pulse Counter)\n");
 }
 
-// Update simulated wind speed from potentiometer
-void WindSpeedSensor::updateSimulation() {
-    if (!simulationMode) return;
-    
-    // Read potentiometer value (0-4095)
-    int potValue = analogRead(potPin);
-    
-    // Map to wind speed (0-50 m/s)
-    float targetSpeed = (potValue / 4095.0) * 50.0;
-    
-    // Only update if change is significant (> 1.0 m/s to reduce noise)
-    if (abs(targetSpeed - simulatedWindSpeed) > 1.0) {
-        simulatedWindSpeed = targetSpeed;
-        
-        // Calculate required pulse frequency
-        // pulses_per_second = wind_speed * calibrationFactor
-        float pulsesPerSecond = simulatedWindSpeed * calibrationFactor;
-        
-        if (pulsesPerSecond > 0.1) {
-            // Timer period in microseconds for toggle (half period)
-            uint64_t timerPeriod = (1000000.0 / pulsesPerSecond) / 2.0;
-            timerAlarmWrite(timer, timerPeriod, true);
-        } else {
-            // Very slow or stopped - set to very long period
-            timerAlarmWrite(timer, 1000000, true);
-        }
-        
-        // Remove continuous printing - only print on significant changes
-        // Serial.printf("[WindSpeed] Simulated speed: %.1f m/s (%.1f Hz)\n", 
-        //               simulatedWindSpeed, pulsesPerSecond);
+// Frequency from the last pulse period. While no new pulse arrives the
+// period is at least the time since the last one, so the speed decays
+// instead of holding; after the calm timeout it is zero.
+float WindSpeedSensor::captureFrequency(float countFrequency) {
+    unsigned long period_us;
+    unsigned long lastEdge_us;
+    if (!HAL::counter().readPeriod(unit, period_us, lastEdge_us)) {
+        return countFrequency;
     }
+
+    unsigned long since_us = HAL::clock().micros() - lastEdge_us;
+    if (since_us >= WIND_CALM_TIMEOUT_US) return 0.0;
+    if (since_us > period_us) period_us = since_us;
+    return period_us > 0 ? 1000000.0 / period_us : countFrequency;
 }
 
 // Calculate wind speed
 float WindSpeedSensor::calculateWindSpeed() {
-    unsigned long currentTime = millis();
+    unsigned long currentTime = HAL::clock().millis();
     unsigned long elapsedTime = currentTime - lastMeasurementTime;
     
-    if (elapsedTime >= 1000) { // Calculate every second
-        // Calculate rotations per second
-        float rotationsPerSecond = (float)pulseCount / ((float)elapsedTime / 1000.0);
+    if (elapsedTime >= WIND_SAMPLE_INTERVAL_MS) {
+        // The counter keeps running, only the difference is taken
+        uint32_t pulses = HAL::counter().takeCount(unit);
+        pulseCount += pulses;
+        float frequency = (float)pulses / ((float)elapsedTime / 1000.0);
+        
+        // A few pulses per window quantize badly, time them instead
+        if (captureMode) {
+            frequency = captureFrequency(frequency);
+            if (frequency > WIND_CAPTURE_EXIT_HZ) {
+                HAL::counter().enableCapture(unit, false);
+                captureMode = false;
+            }
+        } else if (frequency < WIND_CAPTURE_ENTER_HZ) {
+            HAL::counter().enableCapture(unit, true);
+            captureMode = true;
+        }
         
         // Convert to wind speed (m/s)
-        // Formula: wind_speed = rotations_per_second / calibration_factor
-        windSpeed_ms = rotationsPerSecond / calibrationFactor;
+        // Formula: wind_speed = pulses_per_second / calibration_factor
+        windSpeed_ms = frequency / calibrationFactor;
+        statistics.addSample(windSpeed_ms, currentTime);
         
-        // Reset for next measurement
-        pulseCount = 0;
         lastMeasurementTime = currentTime;
     }
     
@@ -137,35 +93,24 @@ float WindSpeedSensor::getWindSpeed_mph() {
     return windSpeed_ms * 2.23694;
 }
 
+// Highest 3-second mean in the last 10 minutes
+float WindSpeedSensor::getGust_ms() {
+    return statistics.getGust10Min();
+}
+
+// 2-minute mean wind
+float WindSpeedSensor::getMean2Min_ms() {
+    return statistics.getMean2Min();
+}
+
+// 10-minute mean wind
+float WindSpeedSensor::getMean10Min_ms() {
+    return statistics.getMean10Min();
+}
+
 // Get wind condition status
-String WindSpeedSensor::getWindStatus() {
-    float kmh = getWindSpeed_kmh();
-    
-    if (kmh < 1) {
-        return "Calm";
-    } else if (kmh < 5) {
-        return "Light Air";
-    } else if (kmh < 12) {
-        return "Light Breeze";
-    } else if (kmh < 20) {
-        return "Gentle Breeze";
-    } else if (kmh < 29) {
-        return "Moderate Breeze";
-    } else if (kmh < 39) {
-        return "Fresh Breeze";
-    } else if (kmh < 50) {
-        return "Strong Breeze";
-    } else if (kmh < 62) {
-        return "Near Gale";
-    } else if (kmh < 75) {
-        return "Gale";
-    } else if (kmh < 89) {
-        return "Strong Gale";
-    } else if (kmh < 103) {
-        return "Storm";
-    } else {
-        return "Violent Storm";
-    }
+WindStatus WindSpeedSensor::getWindStatus() {
+    return WIND_SCALE.classify(getWindSpeed_kmh());
 }
 
 // Get pulse count
@@ -173,10 +118,16 @@ unsigned long WindSpeedSensor::getPulseCount() {
     return pulseCount;
 }
 
+// True while low speed is measured from the pulse period
+bool WindSpeedSensor::isCaptureMode() {
+    return captureMode;
+}
+
 // Reset pulse count
 void WindSpeedSensor::resetPulseCount() {
+    HAL::counter().takeCount(unit);
     pulseCount = 0;
-    lastMeasurementTime = millis();
+    lastMeasurementTime = HAL::clock().millis();
 }
 
 // Set calibration factor
@@ -0,0 +1,129 @@
+/*
+ * WindStatistics.cpp
+ * Implementation of the rolling wind statistics
+ */
+
+#include "WindStatistics.h"
+
+// Constructor
+WindStatistics::WindStatistics() {
+    reset();
+}
+
+// Clear all windows
+void WindStatistics::reset() {
+    memset(gustRing, 0, sizeof(gustRing));
+    gustHead = 0;
+    gustFilled = 0;
+    gustSum = 0;
+    gust = 0;
+
+    for (int i = 0; i < WIND_STATS_SECONDS; i++) {
+        secondMean[i] = WIND_STATS_NO_DATA;
+        secondGust[i] = WIND_STATS_NO_DATA;
+    }
+    head = 0;
+    shortSum = 0;
+    shortCount = 0;
+    longSum = 0;
+    longCount = 0;
+
+    started = false;
+    currentSecond = 0;
+    pendingSum = 0;
+    pendingSamples = 0;
+    pendingGust = 0;
+}
+
+// Push the accumulated second into the bucket ring
+void WindStatistics::closeSecond() {
+    uint16_t mean = pendingSamples > 0 ? (uint16_t)(pendingSum / pendingSamples) : WIND_STATS_NO_DATA;
+    uint16_t maxGust = pendingSamples > 0 ? pendingGust : WIND_STATS_NO_DATA;
+
+    // Buckets leaving the 10-minute and 2-minute windows
+    uint16_t oldest = secondMean[head];
+    if (oldest != WIND_STATS_NO_DATA) {
+        longSum -= oldest;
+        longCount--;
+    }
+    uint16_t leaving = secondMean[(head + WIND_STATS_SECONDS - WIND_STATS_SHORT_SECONDS) % WIND_STATS_SECONDS];
+    if (leaving != WIND_STATS_NO_DATA) {
+        shortSum -= leaving;
+        shortCount--;
+    }
+
+    secondMean[head] = mean;
+    secondGust[head] = maxGust;
+    if (mean != WIND_STATS_NO_DATA) {
+        longSum += mean;
+        longCount++;
+        shortSum += mean;
+        shortCount++;
+    }
+    head = (head + 1) % WIND_STATS_SECONDS;
+
+    pendingSum = 0;
+    pendingSamples = 0;
+    pendingGust = 0;
+}
+
+// Add one speed sample
+void WindStatistics::addSample(float speed_ms, unsigned long now_ms) {
+    float cms = speed_ms * 100.0 + 0.5;
+    uint16_t speed = cms <= 0 ? 0 : (cms >= WIND_STATS_NO_DATA ? WIND_STATS_NO_DATA - 1 : (uint16_t)cms);
+
+    // Close every second that ended since the last sample; a gap longer
+    // than the window (or a millis() wrap) simply empties it
+    unsigned long second = now_ms / 1000;
+    if (!started) {
+        currentSecond = second;
+        started = true;
+    }
+    unsigned long elapsed = second - currentSecond;
+    if (elapsed > WIND_STATS_SECONDS) elapsed = WIND_STATS_SECONDS;
+    for (unsigned long i = 0; i < elapsed; i++) {
+        closeSecond();
+    }
+    currentSecond = second;
+
+    // 3-second running mean
+    if (gustFilled == WIND_STATS_GUST_SAMPLES) {
+        gustSum -= gustRing[gustHead];
+    } else {
+        gustFilled++;
+    }
+    gustRing[gustHead] = speed;
+    gustSum += speed;
+    gustHead = (gustHead + 1) % WIND_STATS_GUST_SAMPLES;
+    gust = (uint16_t)(gustSum / gustFilled);
+
+    pendingSum += speed;
+    pendingSamples++;
+    if (gust > pendingGust) pendingGust = gust;
+}
+
+// Current 3-second mean
+float WindStatistics::getGust3s() {
+    return gust / 100.0;
+}
+
+// Highest 3-second mean in the last 10 minutes
+float WindStatistics::getGust10Min() {
+    uint16_t highest = pendingSamples > 0 ? pendingGust : 0;
+    for (int i = 0; i < WIND_STATS_SECONDS; i++) {
+        if (secondGust[i] != WIND_STATS_NO_DATA && secondGust[i] > highest) {
+            highest = secondGust[i];
+        }
+    }
+    return highest / 100.0;
+}
+
+// Mean of the last 2 minutes (current 3-s mean until a second is complete)
+float WindStatistics::getMean2Min() {
+    return shortCount > 0 ? (float)shortSum / shortCount / 100.0 : getGust3s();
+}
+
+// Mean of the last 10 minutes
+float WindStatistics::getMean10Min() {
+    return longCount > 0 ? (float)longSum / longCount / 100.0 : getGust3s();
+}
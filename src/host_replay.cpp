@@ -0,0 +1,558 @@
+/*
+ * host_replay.cpp
+ * Record-and-replay benchmark of the full sketch (PlatformIO
+ * `native_replay` environment)
+ *
+ * Compiles main.ino unchanged. `record` runs it on a scripted farm day with
+ * a TraceRecorder on the HAL and writes every raw input the drivers read to
+ * a trace file, the same format serial_bridge.py --record writes from a
+ * SENSOR_TRACE build on the device. `replay` feeds a trace back through the
+ * host HAL on the virtual clock, looping it to the requested length, with
+ * the whole pipeline running: drivers, alerts, the LCD framebuffer, the
+ * snapshot and the telemetry link (binary mode). It reports samples/s
+ * (input values the drivers read per second of wall time), the speed-up
+ * over real time, latency percentiles per stage, the snapshot frames' wire
+ * time at the telemetry baud rate, and the heap allocations after a
+ * one-minute warm-up, which fail the run.
+ * Usage: program record <trace> [hours] [loop step ms]
+ *        program replay <trace> [days] [loop step ms]
+ */
+
+#ifndef ARDUINO
+
+#include <Arduino.h>
+#include <chrono>
+#include <vector>
+#include "HostHAL.h"
+#include "HostHeap.h"
+
+#define REPLAY_DAYS 7
+#define RECORD_HOURS 24
+#define REPLAY_LOOP_STEP_MS 250      // Virtual time per loop() pass (wind sample period)
+#define REPLAY_WARMUP_MS 60000
+#define REPLAY_BAUD 115200
+#define REPLAY_DAY_MS 86400000UL
+
+// ==================== SKETCH ====================
+#include "HostSketch.h"
+#include "main.ino"
+
+// ==================== TRACE FILES ====================
+
+static FILE* traceFile = nullptr;
+
+static bool writeChunk(const uint8_t* chunk, size_t length) {
+    uint8_t header[2] = { (uint8_t)length, (uint8_t)(length >> 8) };
+    return fwrite(header, 1, 2, traceFile) == 2 && fwrite(chunk, 1, length, traceFile) == length;
+}
+
+static bool openTrace(const char* path) {
+    traceFile = fopen(path, "wb");
+    if (traceFile == nullptr) return false;
+    const uint8_t version = TRACE_FILE_VERSION;
+    return fwrite(TRACE_FILE_MAGIC, 1, 4, traceFile) == 4 && fwrite(&version, 1, 1, traceFile) == 1;
+}
+
+// Decode a whole trace file; events are rebased to start at time 0
+static bool loadTrace(const char* path, std::vector<TraceEvent>& events, size_t& bytes, unsigned long& badChunks) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return false;
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(file);
+    bytes = data.size();
+    if (data.size() < 5 || memcmp(data.data(), TRACE_FILE_MAGIC, 4) != 0 || data[4] != TRACE_FILE_VERSION) {
+        return false;
+    }
+
+    TraceChunkReader reader;
+    TraceEvent event;
+    badChunks = 0;
+    for (size_t position = 5; position + 2 <= data.size();) {
+        size_t length = data[position] | (data[position + 1] << 8);
+        position += 2;
+        if (position + length > data.size()) {
+            badChunks++;
+            break;
+        }
+        reader.begin(&data[position], length);
+        while (reader.next(event)) {
+            events.push_back(event);
+        }
+        if (reader.isMalformed()) badChunks++;
+        position += length;
+    }
+
+    if (events.empty()) return false;
+    uint64_t start = events.front().time_us;
+    for (size_t i = 0; i < events.size(); i++) {
+        events[i].time_us -= start;
+    }
+    return true;
+}
+
+// ==================== REPLAY ====================
+
+// Applies trace events to the host HAL as virtual time passes; each value
+// holds until the channel's next event. The trace repeats at its end.
+class TraceReplay {
+private:
+    const std::vector<TraceEvent>& events;
+    size_t next;
+    uint64_t offset_us;
+    uint64_t span_us;
+    float dhtTemperature[64];
+    float dhtHumidity[64];
+
+    void apply(const TraceEvent& event) {
+        float value = (float)event.value;
+        switch (event.kind) {
+            case HAL_INPUT_ANALOG: HostHAL::setAnalog(event.pin, event.value); break;
+            case HAL_INPUT_DIGITAL: HostHAL::setDigital(event.pin, event.value); break;
+            case HAL_INPUT_PULSE: HostHAL::setPulseWidth(event.pin, (unsigned long)event.value); break;
+            case HAL_INPUT_PROBE_TEMP:
+                HostHAL::setTemperatureProbe(event.pin, 1, value / HAL_INPUT_PROBE_SCALE);
+                break;
+            case HAL_INPUT_AIR_TEMP:
+            case HAL_INPUT_HUMIDITY: {
+                float fixed = event.value == HAL_INPUT_INVALID ? NAN : value / HAL_INPUT_DHT_SCALE;
+                uint8_t pin = event.pin & 63;
+                (event.kind == HAL_INPUT_AIR_TEMP ? dhtTemperature : dhtHumidity)[pin] = fixed;
+                HostHAL::setHumidity(event.pin, dhtTemperature[pin], dhtHumidity[pin]);
+                break;
+            }
+            case HAL_INPUT_LOAD_CELL: HostHAL::setLoadCell(event.pin, event.value); break;
+        }
+    }
+
+public:
+    uint64_t applied = 0;
+    uint64_t loops = 0;
+
+    TraceReplay(const std::vector<TraceEvent>& events) : events(events), next(0), offset_us(0) {
+        span_us = events.back().time_us + 1000000;
+        for (int i = 0; i < 64; i++) {
+            dhtTemperature[i] = NAN;
+            dhtHumidity[i] = NAN;
+        }
+    }
+
+    // Set every channel to its first value, so begin() finds the devices
+    void prime() {
+        for (size_t i = 0; i < events.size(); i++) {
+            bool first = true;
+            for (size_t j = 0; j < i && first; j++) {
+                first = events[j].kind != events[i].kind || events[j].pin != events[i].pin;
+            }
+            if (first) apply(events[i]);
+            if (events[i].time_us > 60000000) break;    // Channels unseen for a minute stay unset
+        }
+    }
+
+    void applyUntil(uint64_t now_us) {
+        for (;;) {
+            if (next == events.size()) {
+                next = 0;
+                offset_us += span_us;
+                loops++;
+            }
+            if (events[next].time_us + offset_us > now_us) return;
+            apply(events[next++]);
+            applied++;
+        }
+    }
+};
+
+// ==================== MEASUREMENT ====================
+
+// Log-linear histogram: 16 buckets per power of two, so percentiles are
+// within 1/16 of the value and adding one costs no allocation
+class LatencyHistogram {
+private:
+    uint64_t counts[1024];
+
+    static int bucket(uint64_t value) {
+        if (value < 16) return (int)value;
+        int k = 63 - __builtin_clzll(value);
+        return (k - 3) * 16 + (int)((value >> (k - 4)) & 15);
+    }
+
+    static uint64_t upperBound(int index) {
+        if (index < 16) return (uint64_t)index;
+        int k = index / 16 + 3;
+        uint64_t width = 1ULL << (k - 4);
+        return (uint64_t)(16 + index % 16) * width + width - 1;
+    }
+
+public:
+    uint64_t total;
+    uint64_t max;
+
+    LatencyHistogram() {
+        clear();
+    }
+
+    void clear() {
+        memset(counts, 0, sizeof(counts));
+        total = 0;
+        max = 0;
+    }
+
+    void add(uint64_t value) {
+        counts[bucket(value)]++;
+        total++;
+        if (value > max) max = value;
+    }
+
+    uint64_t percentile(double p) {
+        uint64_t rank = (uint64_t)(p / 100.0 * (double)(total - 1));
+        uint64_t seen = 0;
+        for (int i = 0; i < 1024; i++) {
+            seen += counts[i];
+            if (seen > rank) return upperBound(i) < max ? upperBound(i) : max;
+        }
+        return max;
+    }
+};
+
+enum Stage {
+    STAGE_DRIVERS = 0,               // Sensor task runs
+    STAGE_ALERTS,
+    STAGE_DISPLAY,                   // LCD page into the framebuffer and out over I2C
+    STAGE_SNAPSHOT,                  // Report: snapshot built and queued
+    STAGE_LOOP,                      // Whole loop() pass
+    STAGE_OTHER,
+    STAGE_COUNT
+};
+
+static const char* STAGE_NAMES[STAGE_COUNT] = {
+    "drivers", "alerts", "display", "snapshot", "loop", "other"
+};
+
+static uint64_t wallNanos() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Wall-clock nanoseconds of each task run (its start, poll and finish
+// steps added up), by stage
+class StageProbe : public TaskProbe {
+private:
+    Stage taskStage[SCHEDULER_MAX_TASKS];
+    uint64_t runTime[SCHEDULER_MAX_TASKS];
+    uint64_t stepStart;
+    unsigned long snapshots;
+    uint64_t uartWritten;
+
+public:
+    LatencyHistogram stages[STAGE_COUNT];
+
+    // Snapshot frames on the UART; their wire time follows from the
+    // size and the bytes already queued ahead, so it is not sampled
+    unsigned long frames;
+    size_t frameMin;
+    size_t frameMax;
+    size_t queuedAheadMax;
+
+    StageProbe() : stepStart(0), snapshots(0), uartWritten(0) {
+        clear();
+        for (int i = 0; i < scheduler.getTaskCount(); i++) {
+            const char* name = scheduler.getTaskName(i);
+            taskStage[i] = strcmp(name, "alerts") == 0 ? STAGE_ALERTS :
+                           strcmp(name, "lcd") == 0 ? STAGE_DISPLAY :
+                           strcmp(name, "report") == 0 ? STAGE_SNAPSHOT :
+                           strcmp(name, "stats") == 0 ? STAGE_OTHER : STAGE_DRIVERS;
+            runTime[i] = 0;
+        }
+    }
+
+    void beginStep(int index) override {
+        (void)index;
+        snapshots = telemetry.getStats().snapshots;
+        uartWritten = HostHAL::getUartBytesWritten();
+        stepStart = wallNanos();
+    }
+
+    void endStep(int index, bool finished) override {
+        runTime[index] += wallNanos() - stepStart;
+        if (finished) {
+            stages[taskStage[index]].add(runTime[index]);
+            runTime[index] = 0;
+        }
+        if (telemetry.getStats().snapshots != snapshots) {
+            size_t frame = (size_t)(HostHAL::getUartBytesWritten() - uartWritten);
+            size_t queued = HostHAL::getUartQueued();
+            frames++;
+            if (frame < frameMin) frameMin = frame;
+            if (frame > frameMax) frameMax = frame;
+            if (queued > frame && queued - frame > queuedAheadMax) queuedAheadMax = queued - frame;
+        }
+    }
+
+    void clear() {
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            stages[i].clear();
+        }
+        frames = 0;
+        frameMin = SIZE_MAX;
+        frameMax = 0;
+        queuedAheadMax = 0;
+    }
+};
+
+static const char* INPUT_NAMES[] = {
+    "?", "analog", "digital", "pulse", "DS18B20", "DHT temp", "DHT humidity", "HX711"
+};
+
+// Counts the input values the drivers read, by kind
+class InputCounter : public HalInputObserver {
+public:
+    uint64_t samples = 0;
+    uint64_t byKind[8] = {};
+
+    void onInput(HalInputKind kind, uint8_t pin, int32_t value) override {
+        (void)pin;
+        (void)value;
+        samples++;
+        byKind[kind & 7]++;
+    }
+
+    void clear() {
+        samples = 0;
+        memset(byKind, 0, sizeof(byKind));
+    }
+};
+
+// ==================== RECORD SCRIPT ====================
+
+// Deterministic noise of a few ADC codes, so analog channels change the
+// way real ones do
+static int noise(uint64_t now_us, uint8_t pin) {
+    uint64_t x = (now_us / 1000) * 0x9E3779B97F4A7C15ULL + pin;
+    x ^= x >> 29;
+    return (int)(x % 9) - 4;
+}
+
+// 0 at midnight, 1 at noon
+static float sunlight(uint64_t now_us) {
+    float hour = (float)(now_us / 1000000ULL % 86400) / 3600.0f;
+    float d = 1.0f - fabsf(hour - 12.0f) / 12.0f;
+    return d * d;
+}
+
+static float hourOf(uint64_t now_us) {
+    return (float)(now_us / 1000000ULL % 86400) / 3600.0f;
+}
+
+static void scriptFarmDay() {
+    HostHAL::setAnalogSource(SOIL_MOISTURE_PIN, [](uint64_t now) {   // Dries out, irrigation at 06:00
+        float hour = hourOf(now);
+        float since = hour >= 6.0f ? hour - 6.0f : hour + 18.0f;
+        return 1600 + (int)(since * 80.0f) + noise(now, SOIL_MOISTURE_PIN);
+    });
+    HostHAL::setAnalogSource(SOIL_PH_PIN, [](uint64_t now) { return 1860 + noise(now, SOIL_PH_PIN); });
+    HostHAL::setAnalogSource(LEAF_TEMP_PIN, [](uint64_t now) {
+        return 900 + (int)(1600.0f * sunlight(now)) + noise(now, LEAF_TEMP_PIN);
+    });
+    HostHAL::setAnalogSource(LEAF_WETNESS_PIN, [](uint64_t now) {    // Dew until mid-morning
+        return (hourOf(now) < 9.0f ? 3200 : 800) + noise(now, LEAF_WETNESS_PIN);
+    });
+    HostHAL::setAnalogSource(LDR_PIN, [](uint64_t now) { return 200 + (int)(3800.0f * sunlight(now)) + noise(now, LDR_PIN); });
+    HostHAL::setAnalogSource(WIND_POT_PIN, [](uint64_t now) {        // Breezy afternoon with gusts
+        int gust = (now / 7000000ULL) % 5 == 0 ? 600 : 0;
+        return 300 + (int)(1500.0f * sunlight(now)) + gust + noise(now, WIND_POT_PIN);
+    });
+    HostHAL::setAnalogSource(WIND_DIR_PIN, [](uint64_t now) {
+        return 1800 + (int)(400.0f * sinf(hourOf(now) * 0.5f)) + noise(now, WIND_DIR_PIN);
+    });
+    HostHAL::setAnalogSource(GAS_PIN, [](uint64_t now) {             // Leak 14:00-14:20
+        float hour = hourOf(now);
+        return (hour >= 14.0f && hour < 14.33f ? 3300 : 400) + noise(now, GAS_PIN);
+    });
+    HostHAL::setAnalogSource(CO2_PIN, [](uint64_t now) { return 500 + (int)(300.0f * (1.0f - sunlight(now))) + noise(now, CO2_PIN); });
+    HostHAL::setAnalogSource(CO_PIN, [](uint64_t now) { return 100 + noise(now, CO_PIN); });
+
+    // Tank drains through the day, refilled at 18:00
+    HostHAL::setPulseSource(WATER_ECHO_PIN, [](uint64_t now) {
+        float hour = hourOf(now);
+        float used = hour >= 18.0f ? (hour - 18.0f) / 24.0f : (hour + 6.0f) / 24.0f;
+        return (unsigned long)(600.0f + 4600.0f * used);
+    });
+
+    HostHAL::setTemperatureProbe(SOIL_TEMP_PIN, 1, 18.0f);
+    HostHAL::setHumidity(DHT_PIN, 15.0f, 80.0f);
+    HostHAL::setLoadCell(WEIGHT_DATA_PIN, 0);
+    HostHAL::connectPins(WIND_SIM_PIN, WIND_SPEED_PIN);
+}
+
+// Inputs without a signal source, once per loop() pass
+static void scriptStep(uint64_t now_us) {
+    float day = sunlight(now_us);
+    float hour = hourOf(now_us);
+    unsigned long second = (unsigned long)(now_us / 1000000ULL);
+
+    HostHAL::setTemperatureProbe(SOIL_TEMP_PIN, 1, 14.0f + 10.0f * day);
+    HostHAL::setHumidity(DHT_PIN, 12.0f + 16.0f * day, 90.0f - 45.0f * day);
+    HostHAL::setLoadCell(WEIGHT_DATA_PIN, hour >= 8.0f && hour < 17.0f ? (long)(hour - 8.0f) * 42000L : 0);
+
+    // Shower 16:00-17:00, a bucket tip every 30 s; PIR bursts every 40 min
+    bool showering = hour >= 16.0f && hour < 17.0f;
+    HostHAL::setDigital(RAIN_PIN, showering && second % 30 == 0 ? LOW : HIGH);
+    HostHAL::setDigital(MOTION_PIN, second % 2400 < 20 ? HIGH : LOW);
+}
+
+// ==================== MODES ====================
+
+static int record(const char* path, unsigned long hours, unsigned long step_ms) {
+    HostHAL::reset();
+    scriptFarmDay();
+    scriptStep(0);
+    Serial.setEcho(false);
+    if (!openTrace(path)) {
+        printf("Cannot write %s\n", path);
+        return 1;
+    }
+
+    static TraceRecorder recorder;
+    recorder.begin(writeChunk);
+    setup();
+
+    unsigned long end = HAL::clock().millis() + hours * 3600000UL;
+    while ((long)(HAL::clock().millis() - end) < 0) {
+        scriptStep(HostHAL::nowMicros());
+        loop();
+        HostHAL::advanceMillis(step_ms);
+    }
+    recorder.end();
+    bool ok = fclose(traceFile) == 0;
+
+    const TraceStats& stats = recorder.getStats();
+    printf("[Replay] recorded %lu h: %lu inputs, %lu records in %lu chunks, %lu bytes (%.0f bytes/hour)\n",
+           hours, stats.inputs, stats.records, stats.chunks, stats.bytes, (double)stats.bytes / (double)hours);
+    return ok && stats.chunksDropped == 0 && stats.untracked == 0 ? 0 : 1;
+}
+
+static void printStage(LatencyHistogram& histogram, const char* name, const char* unit) {
+    if (histogram.total == 0) return;
+    printf("[Replay] %-9s %11llu %9.2f %9.2f %9.2f %9.2f %9.2f  %s\n", name, (unsigned long long)histogram.total,
+           histogram.percentile(50) / 1000.0, histogram.percentile(90) / 1000.0, histogram.percentile(99) / 1000.0,
+           histogram.percentile(99.9) / 1000.0, histogram.max / 1000.0, unit);
+}
+
+static int replay(const char* path, unsigned long days, unsigned long step_ms) {
+    std::vector<TraceEvent> events;
+    size_t bytes = 0;
+    unsigned long badChunks = 0;
+    if (!loadTrace(path, events, bytes, badChunks)) {
+        printf("Cannot read trace %s\n", path);
+        return 1;
+    }
+    printf("[Replay] %s: %zu events over %.1f h, %zu bytes, %lu bad chunks\n", path, events.size(),
+           events.back().time_us / 3600e6, bytes, badChunks);
+
+    HostHAL::reset();
+    HostHAL::connectPins(WIND_SIM_PIN, WIND_SPEED_PIN);
+    static TraceReplay trace(events);
+    trace.prime();
+    Serial.setEcho(false);
+    printf("[Replay] %lu days, %lu ms per loop() pass\n", days, step_ms);
+
+    setup();
+    telemetry.begin(REPLAY_BAUD, TELEMETRY_MODE_BINARY, false);
+    static StageProbe probe;
+    static InputCounter inputs;
+    scheduler.setProbe(&probe);
+    HAL::setInputObserver(&inputs);
+    std::vector<uint8_t> wire;
+    wire.reserve(1 << 16);
+
+    // Warm-up: lazily grown buffers settle before allocations count
+    uint64_t end = HostHAL::nowMicros() + (uint64_t)REPLAY_WARMUP_MS * 1000;
+    while (HostHAL::nowMicros() < end) {
+        trace.applyUntil(HostHAL::nowMicros());
+        loop();
+        HostHAL::takeUartOutput(wire);
+        wire.clear();
+        HostHAL::advanceMillis(step_ms);
+    }
+    probe.clear();
+    inputs.clear();
+    unsigned long baseAllocations = allocations;
+    long baseBytes = liveBytes;
+    unsigned long baseSnapshots = telemetry.getStats().snapshots;
+    unsigned long baseDropped = telemetry.getStats().dropped;
+    LatencyHistogram& loopTime = probe.stages[STAGE_LOOP];
+
+    uint64_t start_us = HostHAL::nowMicros();
+    uint64_t wallStart = wallNanos();
+    for (unsigned long day = 1; day <= days; day++) {
+        end = start_us + (uint64_t)day * REPLAY_DAY_MS * 1000;
+        while (HostHAL::nowMicros() < end) {
+            trace.applyUntil(HostHAL::nowMicros());
+            uint64_t passStart = wallNanos();
+            loop();
+            loopTime.add(wallNanos() - passStart);
+            HostHAL::takeUartOutput(wire);
+            wire.clear();
+            HostHAL::advanceMillis(step_ms);
+        }
+        double wall = (wallNanos() - wallStart) / 1e9;
+        printf("[Replay] day %3lu  %7.2f s wall  %12.0f samples/s\n", day, wall, inputs.samples / wall);
+        fflush(stdout);
+    }
+    double wall = (wallNanos() - wallStart) / 1e9;
+    double simulated = (HostHAL::nowMicros() - start_us) / 1e6;
+    unsigned long newAllocations = allocations - baseAllocations;
+    unsigned long snapshots = telemetry.getStats().snapshots - baseSnapshots;
+    unsigned long dropped = telemetry.getStats().dropped - baseDropped;
+
+    printf("[Replay] %.0f s simulated in %.2f s wall (%.0fx real time), trace looped %llu times\n",
+           simulated, wall, simulated / wall, (unsigned long long)trace.loops);
+    printf("[Replay] %llu samples (%.0f samples/s), %llu trace events applied, %llu loop() passes\n",
+           (unsigned long long)inputs.samples, inputs.samples / wall, (unsigned long long)trace.applied,
+           (unsigned long long)loopTime.total);
+    printf("[Replay] samples:");
+    for (int i = 1; i < 8; i++) {
+        printf(" %s %llu%s", INPUT_NAMES[i], (unsigned long long)inputs.byKind[i], i < 7 ? "," : "\n");
+    }
+    printf("[Replay] %lu snapshots (%lu dropped), %.0f snapshots/s\n", snapshots, dropped, snapshots / wall);
+    printf("[Replay] stage           calls       p50       p90       p99     p99.9       max\n");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        printStage(probe.stages[i], STAGE_NAMES[i], "us wall");
+    }
+    if (probe.frames > 0) {
+        // The host UART drains at exactly the baud rate, so the time from
+        // queuing a frame to its last byte leaving is bytes / rate
+        printf("[Replay] uploader: %lu frames of %zu-%zu bytes, at most %zu bytes queued ahead; "
+               "last byte on the wire %.2f us after queuing at %d baud (derived)\n",
+               probe.frames, probe.frameMin, probe.frameMax, probe.queuedAheadMax,
+               (probe.queuedAheadMax + probe.frameMax) * 10 * 1e6 / REPLAY_BAUD, REPLAY_BAUD);
+    }
+    printf("[Replay] heap: %lu allocations after warm-up, %ld bytes live (%+ld)\n",
+           newAllocations, liveBytes, liveBytes - baseBytes);
+    return newAllocations == 0 && dropped == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (strcmp(argv[1], "record") != 0 && strcmp(argv[1], "replay") != 0)) {
+        printf("Usage: %s record <trace> [hours] [loop step ms]\n", argv[0]);
+        printf("       %s replay <trace> [days] [loop step ms]\n", argv[0]);
+        return 2;
+    }
+    unsigned long step_ms = argc > 4 ? strtoul(argv[4], nullptr, 10) : REPLAY_LOOP_STEP_MS;
+    if (step_ms == 0) step_ms = 1;
+
+    // stdout allocates its buffer on first use, before any baseline
+    printf("[Replay] %s %s\n", argv[1], argv[2]);
+    if (strcmp(argv[1], "record") == 0) {
+        return record(argv[2], argc > 3 ? strtoul(argv[3], nullptr, 10) : RECORD_HOURS, step_ms);
+    }
+    return replay(argv[2], argc > 3 ? strtoul(argv[3], nullptr, 10) : REPLAY_DAYS, step_ms);
+}
+
+#endif // !ARDUINO
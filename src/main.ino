@@ -5,8 +5,6 @@
  * Current Step: All Sensors + Alert System
  */
 
-#include <Wire.h>
-#include <LiquidCrystal_I2C.h>
 #include "SoilMoistureSensor.h"
 #include "SoilTemperatureSensor.h"
 #include "SoilPHSensor.h"
@@ -15,6 +13,7 @@
 #include "DHTSensor.h"
 #include "LightSensor.h"
 #include "WindSpeedSensor.h"
+#include "WindSimulator.h"
 #include "WindDirectionSensor.h"
 #include "RainfallSensor.h"
 #include "WaterTankSensor.h"
@@ -24,9 +23,15 @@
 #include "MotionSensor.h"
 #include "WeightSensor.h"
 #include "AlertSystem.h"
+#include "TaskScheduler.h"
+#include "AdcEngine.h"
+#include "LcdDisplay.h"
+#include "CommandParser.h"
+#include "Telemetry.h"
+#include "SensorTrace.h"
 
 // 20x4 LCD Configuration (I2C address 0x27, 20 columns, 4 rows)
-LiquidCrystal_I2C lcd(0x27, 20, 4);
+LcdDisplay lcd(0x27);
 
 // Sensor Pins
 #define SOIL_MOISTURE_PIN 34  // ADC1 pin for soil moisture
@@ -66,6 +71,7 @@ LeafWetnessSensor leafWetness(LEAF_WETNESS_PIN);
 DHTSensor dhtSensor(DHT_PIN);
 LightSensor lightSensor(LDR_PIN);
 WindSpeedSensor windSpeed(WIND_SPEED_PIN);
+WindSimulator windSimulator;
 WindDirectionSensor windDirection(WIND_DIR_PIN);
 RainfallSensor rainfall(RAIN_PIN);
 WaterTankSensor waterTank(WATER_TRIG_PIN, WATER_ECHO_PIN, 100.0, 1000.0);  // 100cm height, 1000L capacity
@@ -76,83 +82,127 @@ MotionSensor motionSensor(MOTION_PIN);
 WeightSensor weightSensor(WEIGHT_DATA_PIN, WEIGHT_CLOCK_PIN);
 AlertSystem alertSystem(BUZZER_PIN);
 
-// Timing
-unsigned long lastUpdate = 0;
-const unsigned long UPDATE_INTERVAL = 2000; // Update every 2 seconds
+// Scheduling (every sensor runs at its own rate, nothing in loop() blocks)
+TaskScheduler scheduler;
+const unsigned long UPDATE_INTERVAL = 2000; // Report every 2 seconds
+const unsigned long STATS_INTERVAL = 30000; // Scheduler statistics every 30 seconds
 
 // Display mode
 int displayMode = 0;
-unsigned long lastModeSwitch = 0;
 const unsigned long MODE_SWITCH_INTERVAL = 4000; // Switch display every 4 seconds
+const unsigned long LCD_REFRESH_INTERVAL = 500;   // Redraw the current page with fresh readings
 
 // Global variables to store sensor readings
 bool dhtValid = false;
 float airTemp = 0.0;
 float humidity = 0.0;
-String airTempStatus = "";
-String humidityStatus = "";
+AirTempStatus airTempStatus;
+HumidityStatus humidityStatus;
 
 float lightPercent = 0.0;
-String lightStatus = "";
+LightStatus lightStatus;
 
 float windSpeed_ms = 0.0;
 float windSpeed_kmh = 0.0;
-String windStatus = "";
+float windGust_kmh = 0.0;
+float windMean2Min_kmh = 0.0;
+float windMean10Min_kmh = 0.0;
+WindStatus windStatus;
 
 int windDir_degrees = 0;
-String windDir_cardinal = "";
+const char* windDir_cardinal = "N";
+float windDirMean2Min = 0.0;
+float windDirStdDev2Min = 0.0;
+float windDirMean10Min = 0.0;
+float windDirStdDev10Min = 0.0;
 
 float rainfall_mm = 0.0;
 float rainRate = 0.0;
-String rainStatus = "";
+float rainfall1h_mm = 0.0;
+float rainEvent_mm = 0.0;
+RainStatus rainStatus;
 
 float waterLevel_cm = 0.0;
 float waterLevel_percent = 0.0;
 float waterVolume_liters = 0.0;
-String tankStatus = "";
+TankStatus tankStatus;
 
 float gasPPM = 0.0;
-String gasStatus = "";
+GasStatus gasStatus;
 
 float co2PPM = 0.0;
-String airQuality = "";
+AirQuality airQuality;
 
 float coPPM = 0.0;
-String coStatus = "";
+COStatus coStatus;
 
 bool motionDetected = false;
-String motionStatus = "";
+MotionStatus motionStatus;
 
 float weight_kg = 0.0;
-String weightStatus = "";
-
-// Remote control variables (values received from dashboard via Serial)
-bool remoteControlActive = false;
-float remote_soilMoisture = -1;
-float remote_soilTemp = -1;
-float remote_soilPH = -1;
-float remote_leafTemp = -1;
-float remote_leafWetness = -1;
-float remote_airTemp = -1;
-float remote_humidity = -1;
-float remote_light = -1;
-float remote_rainfall = -1;
-float remote_windSpeed = -1;
-float remote_windDirection = -1;
-float remote_gas = -1;
-float remote_co2 = -1;
-float remote_co = -1;
-float remote_waterLevel = -1;
-float remote_weight = -1;
+WeightStatus weightStatus;
+
+// Remote control (values received from dashboard via Serial)
+CommandParser commandParser;
+float remoteValues[REMOTE_CHANNEL_COUNT];
+uint16_t remoteMask = 0;  // Bit per RemoteChannel the dashboard has set
+
+// Replace a reading with the dashboard's value for a channel, if one was sent
+template <typename T> void applyRemote(RemoteChannel channel, T& reading) {
+    if (remoteMask & (1u << channel)) reading = (T)remoteValues[channel];
+}
+
+// Raw input recording for host replay (SensorTrace.h): the chunks go out as
+// telemetry trace frames, serial_bridge.py --record writes them to a file
+#ifdef SENSOR_TRACE
+#ifndef TELEMETRY_BINARY
+#error "SENSOR_TRACE sends trace frames and needs TELEMETRY_BINARY"
+#endif
+TraceRecorder traceRecorder;
+
+bool sendTraceChunk(const uint8_t* chunk, size_t length) {
+    return telemetry.sendTrace(chunk, length);
+}
+#endif
+
+// Scheduled work
+void sampleAnalogSensors();
+void sampleMotion();
+void sampleWindSpeed();
+void sampleRainfall();
+void evaluateAlerts();
+void reportReadings();
+void updateDisplay();
+void printSchedulerStats();
+
+SensorTask<SoilTemperatureSensor> soilTempTask(soilTemp);
+SensorTask<DHTSensor> dhtTask(dhtSensor);
+SensorTask<WindDirectionSensor> windDirectionTask(windDirection);
+SensorTask<WaterTankSensor> waterTankTask(waterTank);
+SensorTask<GasSensor> gasTask(gasSensor);
+SensorTask<CO2Sensor> co2Task(co2Sensor);
+SensorTask<COSensor> coTask(coSensor);
+SensorTask<WeightSensor> weightTask(weightSensor);
+CallbackTask analogTask(sampleAnalogSensors);
+CallbackTask motionTask(sampleMotion);
+CallbackTask windSpeedTask(sampleWindSpeed);
+CallbackTask rainfallTask(sampleRainfall);
+CallbackTask alertTask(evaluateAlerts);
+CallbackTask reportTask(reportReadings);
+CallbackTask displayTask(updateDisplay);
+CallbackTask statsTask(printSchedulerStats);
 
 void setup() {
-    // Initialize Serial Monitor
-    Serial.begin(115200);
-    Serial.println("\n=================================" );
-    Serial.println("Farm Monitoring System - v2.0");
-    Serial.println("Complete with All Sensors!");
-    Serial.println("Serial Protocol: JSON");
-    Serial.println("=================================\n");
+    // Initialize Serial Monitor (text report or binary telemetry, see Telemetry.h)
+    telemetry.begin(115200);
+    logPrintf("\n=================================\n");
+    logPrintf("Farm Monitoring System - v2.0\n");
+    logPrintf("Complete with All Sensors!\n");
+    logPrintf("Serial Protocol: JSON\n");
+    logPrintf("=================================\n\n");
+#ifdef SENSOR_TRACE
+    traceRecorder.begin(sendTraceChunk);
+#endif
 
     // Initialize LED indicator pins
     pinMode(LED_SOIL_PIN, OUTPUT);
@@ -166,19 +216,15 @@ void setup() {
     digitalWrite(LED_MOTION_PIN, LOW);
     digitalWrite(LED_SYSTEM_PIN, LOW);
     
-    Serial.println("LED indicators initialized");
+    logPrintf("LED indicators initialized\n");
 
-    // Initialize I2C for 20x4 LCD
-    Wire.begin();
-    
-    // Initialize 20x4 LCD
-    lcd.init();
-    lcd.backlight();
-    lcd.clear();
+    // Initialize 20x4 LCD (starts the I2C bus)
+    lcd.begin();
     lcd.setCursor(0, 0);
     lcd.print("Farm Monitor");
     lcd.setCursor(0, 1);
     lcd.print("Initializing...");
+    lcd.flush();
     
     delay(2000);
 
@@ -201,682 +247,601 @@ void setup() {
     weightSensor.begin();
     alertSystem.begin();
     
-    // Enable wind speed simulation mode for Wokwi
-    windSpeed.enableSimulation(WIND_SIM_PIN, WIND_POT_PIN);
+    // Analog drivers registered their pins in begin(); scan them via DMA
+    adcEngine.begin();
+    
+    // Alert hysteresis (raise, clear) and debounce
+    alertSystem.setThresholds(ALERT_LOW_SOIL_MOISTURE, 20.0, 25.0, 10000);
+    alertSystem.setThresholds(ALERT_LOW_WATER, 25.0, 30.0, 5000);
+    alertSystem.setDebounce(ALERT_GAS_DETECTED, 1000);
+    alertSystem.setDebounce(ALERT_OVERWEIGHT, 4000);
+    
+    // Anemometer test signal for Wokwi
+    windSimulator.begin(WIND_SIM_PIN, WIND_POT_PIN);
     
-    Serial.println("LDR Light Sensor initialized");
-    Serial.println("Wind Speed Sensor initialized with PWM simulation");
-    Serial.println("Wind Direction Sensor initialized");
-    Serial.println("Rainfall Sensor initialized");
-    Serial.println("Water Tank Level Sensor initialized");
-    Serial.println("Gas Sensor initialized");
-    Serial.println("Motion Sensor initialized");
-    Serial.println("Weight Sensor initialized");
-    Serial.println("Alert System initialized");
+    logPrintf("LDR Light Sensor initialized\n");
+    logPrintf("Wind Speed Sensor initialized with PWM simulation\n");
+    logPrintf("Wind Direction Sensor initialized\n");
+    logPrintf("Rainfall Sensor initialized\n");
+    logPrintf("Water Tank Level Sensor initialized\n");
+    logPrintf("Gas Sensor initialized\n");
+    logPrintf("Motion Sensor initialized\n");
+    logPrintf("Weight Sensor initialized\n");
+    logPrintf("Alert System initialized\n");
 
     // Display ready message
     lcd.clear();
     lcd.setCursor(0, 0);
     lcd.print("System Ready!");
+    lcd.flush();
     delay(1000);
 
-    Serial.println("\nSystem initialized successfully!");
-    Serial.println("Starting sensor readings...\n");
+    // Register periodic work: task, name, period, deadline, first-release offset (ms)
+    scheduler.addTask(&motionTask, "motion", 100);
+    scheduler.addTask(&gasTask, "gas", 500, 50);
+    scheduler.addTask(&coTask, "co", 500, 200);
+    scheduler.addTask(&co2Task, "co2", 1000, 200);
+    scheduler.addTask(&windSpeedTask, "windSpeed", WIND_SAMPLE_INTERVAL_MS);
+    scheduler.addTask(&windDirectionTask, "windDir", 1000, 50);
+    scheduler.addTask(&waterTankTask, "waterTank", 1000, 50);
+    scheduler.addTask(&analogTask, "analog", 2000, 10);
+    scheduler.addTask(&rainfallTask, "rainfall", 2000);
+    scheduler.addTask(&soilTempTask, "soilTemp", 2000, 1000);
+    scheduler.addTask(&dhtTask, "dht", 2000, 100);
+    scheduler.addTask(&weightTask, "weight", 2000, 600);
+    scheduler.addTask(&alertTask, "alerts", 500, 10, 500);
+    scheduler.addTask(&reportTask, "report", UPDATE_INTERVAL, 0, UPDATE_INTERVAL);
+    scheduler.addTask(&displayTask, "lcd", LCD_REFRESH_INTERVAL, 100, MODE_SWITCH_INTERVAL);
+    scheduler.addTask(&statsTask, "stats", STATS_INTERVAL, 0, STATS_INTERVAL);
+    scheduler.begin();
+
+    logPrintf("\nSystem initialized successfully!\n");
+    logPrintf("Starting sensor readings...\n\n");
 }
 
 void loop() {
-    unsigned long currentTime = millis();
-
     // Check for incoming Serial commands from dashboard
     checkSerialCommands();
 
     // Update wind speed simulation (read potentiometer)
-    windSpeed.updateSimulation();
-
-    // Update readings at specified interval
-    if (currentTime - lastUpdate >= UPDATE_INTERVAL) {
-        lastUpdate = currentTime;
-
-        // Read sensor data
-        float moisture = soilMoisture.readMoisture();
-        int rawMoisture = soilMoisture.getRawValue();
-        String moistureStatus = soilMoisture.getMoistureStatus();
-
-        float tempC = soilTemp.readTemperature();
-        float tempF = soilTemp.getTemperatureF();
-        String tempStatus = soilTemp.getTemperatureStatus();
-
-        float pH = soilPH.readPH();
-        float phVoltage = soilPH.getVoltage();
-        String phStatus = soilPH.getPHStatus();
-
-        float leafTempC = leafTemp.readTemperature();
-        float leafTempF = leafTemp.getObjectTempF();
-        String leafTempStatus = leafTemp.getTemperatureStatus();
-
-        float leafWet = leafWetness.readWetness();
-        String leafWetStatus = leafWetness.getWetnessStatus();
-
-        dhtValid = dhtSensor.readSensor();
-        airTemp = dhtSensor.getTemperature();
-        humidity = dhtSensor.getHumidity();
-        airTempStatus = dhtSensor.getTemperatureStatus();
-        humidityStatus = dhtSensor.getHumidityStatus();
-
-        lightPercent = lightSensor.readLight();
-        lightStatus = lightSensor.getLightStatus();
-
-        windSpeed_ms = windSpeed.calculateWindSpeed();
-        windSpeed_kmh = windSpeed.getWindSpeed_kmh();
-        windStatus = windSpeed.getWindStatus();
-
-        windDir_degrees = windDirection.readDirection();
-        
-        // Override with remote values if available
-        if (remoteControlActive) {
-            if (remote_soilMoisture >= 0) moisture = remote_soilMoisture;
-            if (remote_soilTemp >= -10) tempC = remote_soilTemp;
-            if (remote_soilPH >= 0) pH = remote_soilPH;
-            if (remote_leafTemp >= 0) leafTempC = remote_leafTemp;
-            if (remote_leafWetness >= 0) leafWet = remote_leafWetness;
-            if (remote_airTemp >= -20) airTemp = remote_airTemp;
-            if (remote_humidity >= 0) humidity = remote_humidity;
-            if (remote_light >= 0) lightPercent = remote_light;
-            if (remote_rainfall >= 0) rainfall_mm = remote_rainfall;
-            if (remote_windSpeed >= 0) windSpeed_kmh = remote_windSpeed;
-            if (remote_windDirection >= 0) windDir_degrees = (int)remote_windDirection;
-            if (remote_gas >= 0) gasPPM = remote_gas;
-            if (remote_co2 >= 0) co2PPM = remote_co2;
-            if (remote_co >= 0) coPPM = remote_co;
-            if (remote_waterLevel >= 0) waterLevel_percent = remote_waterLevel;
-            if (remote_weight >= 0) weight_kg = remote_weight;
-        }
-        windDir_cardinal = windDirection.getCardinalDirection();
+    windSimulator.update();
 
-        rainfall.update();
-        rainfall_mm = rainfall.getRainfall_mm();
-        rainRate = rainfall.getRainRate();
-        rainStatus = rainfall.getRainStatus();
+    // Fold background ADC conversions into the channel averages
+    adcEngine.service();
 
-        waterLevel_cm = waterTank.readLevel();
-        waterLevel_percent = waterTank.getLevel_percent();
-        waterVolume_liters = waterTank.getVolume_liters();
-        tankStatus = waterTank.getTankStatus();
+    // Start, poll and finish whatever sensor work is due
+    scheduler.run();
 
-        gasPPM = gasSensor.readGas();
-        gasStatus = gasSensor.getGasStatus();
+    // Advance the buzzer pattern
+    alertSystem.update();
+}
 
-        co2PPM = co2Sensor.readCO2();
-        airQuality = co2Sensor.getAirQuality();
+// Single-conversion analog sensors
+void sampleAnalogSensors() {
+    soilMoisture.readMoisture();
+    soilPH.readPH();
+    leafTemp.readTemperature();
+    leafWetness.readWetness();
+    lightSensor.readLight();
+}
 
-        coPPM = coSensor.readCO();
-        coStatus = coSensor.getCOStatus();
+// PIR is sampled fast so short pulses are not missed
+void sampleMotion() {
+    motionDetected = motionSensor.readMotion();
+}
 
-        motionDetected = motionSensor.readMotion();
-        motionStatus = motionSensor.getMotionStatus();
+void sampleWindSpeed() {
+    windSpeed.calculateWindSpeed();
+}
 
-        weight_kg = weightSensor.readWeight();
-        weightStatus = weightSensor.getWeightStatus();
+void sampleRainfall() {
+    rainfall.update();
+}
 
-        // Control LED indicators and check for alert conditions
-        // Soil moisture LED (Red)
-        if (soilMoisture.getMoisturePercent() < 20) {
-            digitalWrite(LED_SOIL_PIN, HIGH);
-            alertSystem.triggerAlert(ALERT_LOW_SOIL_MOISTURE);
-        } else {
-            digitalWrite(LED_SOIL_PIN, LOW);
-        }
-        
-        // Gas/CO/CO2 danger LED (Red)
-        if (gasSensor.isDangerous() || co2Sensor.isDangerous() || coSensor.isDangerous()) {
-            digitalWrite(LED_GAS_PIN, HIGH);
-            if (gasSensor.isDangerous()) {
-                alertSystem.triggerAlert(ALERT_GAS_DETECTED);
-            }
-            if (co2Sensor.isDangerous()) {
-                alertSystem.triggerAlert(ALERT_GAS_DETECTED);
-            }
-            if (coSensor.isDangerous()) {
-                alertSystem.triggerAlert(ALERT_GAS_DETECTED);
-            }
-        } else {
-            digitalWrite(LED_GAS_PIN, LOW);
-        }
-        
-        // Motion detection LED (Yellow)
-        if (motionDetected) {
-            digitalWrite(LED_MOTION_PIN, HIGH);
-            alertSystem.triggerAlert(ALERT_MOTION_DETECTED);
-        } else {
-            digitalWrite(LED_MOTION_PIN, LOW);
-        }
-        
-        // Water tank warning
-        if (waterTank.isLowLevel()) {
-            alertSystem.triggerAlert(ALERT_LOW_WATER);
-        }
-        
-        // Weight overload warning
-        if (weightSensor.isOverloaded()) {
-            alertSystem.triggerAlert(ALERT_OVERWEIGHT);
-        }
-        
-        // System heartbeat LED (Green) - blink every cycle
-        static bool heartbeatState = false;
-        heartbeatState = !heartbeatState;
-        digitalWrite(LED_SYSTEM_PIN, heartbeatState ? HIGH : LOW);
-
-        // Display on Serial Monitor
-        Serial.println("========== SENSOR READINGS ==========");
-        
-        Serial.println("--- SOIL MOISTURE ---");
-        Serial.print("Raw ADC Value: ");
-        Serial.println(rawMoisture);
-        Serial.print("Moisture: ");
-        Serial.print(moisture, 1);
-        Serial.println(" %");
-        Serial.print("Status: ");
-        Serial.println(moistureStatus);
-        
-        Serial.println("\n--- SOIL TEMPERATURE ---");
-        Serial.print("Temperature: ");
-        Serial.print(tempC, 1);
-        Serial.print(" °C (");
-        Serial.print(tempF, 1);
-        Serial.println(" °F)");
-        Serial.print("Status: ");
-        Serial.println(tempStatus);
-        
-        Serial.println("\n--- SOIL pH ---");
-        Serial.print("pH Value: ");
-        Serial.println(pH, 2);
-        Serial.print("Voltage: ");
-        Serial.print(phVoltage, 3);
-        Serial.println(" V");
-        Serial.print("Status: ");
-        Serial.println(phStatus);
-        
-        Serial.println("\n--- LEAF TEMPERATURE ---");
-        Serial.print("Leaf Temp: ");
-        Serial.print(leafTempC, 1);
-        Serial.print(" °C (");
-        Serial.print(leafTempF, 1);
-        Serial.println(" °F)");
-        Serial.print("Status: ");
-        Serial.println(leafTempStatus);
-        
-        Serial.println("\n--- LEAF WETNESS ---");
-        Serial.print("Wetness: ");
-        Serial.print(leafWet, 1);
-        Serial.println(" %");
+// Feed the alert engine and drive the warning LEDs
+void evaluateAlerts() {
+    // Soil moisture LED (Red)
+    alertSystem.reportValue(ALERT_LOW_SOIL_MOISTURE, soilMoisture.getMoisturePercent());
+    digitalWrite(LED_SOIL_PIN, alertSystem.isActive(ALERT_LOW_SOIL_MOISTURE) ? HIGH : LOW);
+    
+    // Gas/CO/CO2 danger LED (Red)
+    bool gasDanger = gasSensor.isDangerous() || co2Sensor.isDangerous() || coSensor.isDangerous();
+    alertSystem.reportCondition(ALERT_GAS_DETECTED, gasDanger);
+    digitalWrite(LED_GAS_PIN, gasDanger ? HIGH : LOW);
+    
+    // Motion detection LED (Yellow)
+    if (motionDetected) {
+        digitalWrite(LED_MOTION_PIN, HIGH);
+        alertSystem.triggerAlert(ALERT_MOTION_DETECTED);
+    } else {
+        digitalWrite(LED_MOTION_PIN, LOW);
+    }
+    
+    // Water tank warning
+    alertSystem.reportValue(ALERT_LOW_WATER, waterTank.getLevel_percent());
+    
+    // Weight overload warning
+    alertSystem.reportCondition(ALERT_OVERWEIGHT, weightSensor.isOverloaded());
+}
+
+// Collect the latest readings and print the report
+void reportReadings() {
+    // Latest sensor data (acquired by the sensor tasks)
+    float moisture = soilMoisture.getMoisturePercent();
+    int rawMoisture = soilMoisture.getRawValue();
+    MoistureStatus moistureStatus = soilMoisture.getMoistureStatus();
+
+    float tempC = soilTemp.getTemperatureC();
+    float tempF = soilTemp.getTemperatureF();
+    SoilTempStatus tempStatus = soilTemp.getTemperatureStatus();
+
+    float pH = soilPH.getPH();
+    float phVoltage = soilPH.getVoltage();
+    PHStatus phStatus = soilPH.getPHStatus();
+
+    float leafTempC = leafTemp.getObjectTempC();
+    float leafTempF = leafTemp.getObjectTempF();
+    LeafTempStatus leafTempStatus = leafTemp.getTemperatureStatus();
+
+    float leafWet = leafWetness.getWetnessPercent();
+    WetnessStatus leafWetStatus = leafWetness.getWetnessStatus();
+
+    dhtValid = dhtSensor.isReadingValid();
+    airTemp = dhtSensor.getTemperature();
+    humidity = dhtSensor.getHumidity();
+    airTempStatus = dhtSensor.getTemperatureStatus();
+    humidityStatus = dhtSensor.getHumidityStatus();
+
+    lightPercent = lightSensor.getLightPercent();
+    lightStatus = lightSensor.getLightStatus();
+
+    windSpeed_ms = windSpeed.getWindSpeed_ms();
+    windSpeed_kmh = windSpeed.getWindSpeed_kmh();
+    windStatus = windSpeed.getWindStatus();
+    windGust_kmh = windSpeed.getGust_ms() * 3.6;
+    windMean2Min_kmh = windSpeed.getMean2Min_ms() * 3.6;
+    windMean10Min_kmh = windSpeed.getMean10Min_ms() * 3.6;
+
+    windDir_degrees = windDirection.getDirectionDegrees();
+    windDirMean2Min = windDirection.getMeanDirection2Min();
+    windDirStdDev2Min = windDirection.getDirectionStdDev2Min();
+    windDirMean10Min = windDirection.getMeanDirection10Min();
+    windDirStdDev10Min = windDirection.getDirectionStdDev10Min();
+    
+    rainfall_mm = rainfall.getRainfall_mm();
+    rainfall1h_mm = rainfall.getRainfall1h_mm();
+    rainEvent_mm = rainfall.getEventRainfall_mm();
+    rainRate = rainfall.getRainRate();
+    rainStatus = rainfall.getRainStatus();
+
+    waterLevel_cm = waterTank.getLevel_cm();
+    waterLevel_percent = waterTank.getLevel_percent();
+    waterVolume_liters = waterTank.getVolume_liters();
+    tankStatus = waterTank.getTankStatus();
+
+    gasPPM = gasSensor.getGasPPM();
+    gasStatus = gasSensor.getGasStatus();
+
+    co2PPM = co2Sensor.getCO2PPM();
+    airQuality = co2Sensor.getAirQuality();
+
+    coPPM = coSensor.getCOPPM();
+    coStatus = coSensor.getCOStatus();
+
+    motionStatus = motionSensor.getMotionStatus();
+
+    weight_kg = weightSensor.getWeight_kg();
+    weightStatus = weightSensor.getWeightStatus();
+
+    // Override with remote values if available, after every driver read
+    applyRemote(REMOTE_SOIL_MOISTURE, moisture);
+    applyRemote(REMOTE_SOIL_TEMP, tempC);
+    applyRemote(REMOTE_SOIL_PH, pH);
+    applyRemote(REMOTE_LEAF_TEMP, leafTempC);
+    applyRemote(REMOTE_LEAF_WETNESS, leafWet);
+    applyRemote(REMOTE_AIR_TEMP, airTemp);
+    applyRemote(REMOTE_HUMIDITY, humidity);
+    applyRemote(REMOTE_LIGHT, lightPercent);
+    applyRemote(REMOTE_RAINFALL, rainfall_mm);
+    applyRemote(REMOTE_WIND_SPEED, windSpeed_kmh);
+    applyRemote(REMOTE_WIND_DIRECTION, windDir_degrees);
+    applyRemote(REMOTE_GAS, gasPPM);
+    applyRemote(REMOTE_CO2, co2PPM);
+    applyRemote(REMOTE_CO, coPPM);
+    applyRemote(REMOTE_WATER_LEVEL, waterLevel_percent);
+    applyRemote(REMOTE_WEIGHT, weight_kg);
+    windDir_cardinal = windCardinal16(windDir_degrees);
+
+    // System heartbeat LED (Green) - blink every cycle
+    static bool heartbeatState = false;
+    heartbeatState = !heartbeatState;
+    digitalWrite(LED_SYSTEM_PIN, heartbeatState ? HIGH : LOW);
+
+    // Binary mode: one snapshot frame replaces the text report
+    if (telemetry.isBinary()) {
+        TelemetrySnapshot snapshot;
+        snapshot.flags = (dhtValid ? TELEMETRY_FLAG_DHT_VALID : 0) |
+                         (motionDetected ? TELEMETRY_FLAG_MOTION : 0) |
+                         (waterTank.isLowLevel() ? TELEMETRY_FLAG_LOW_WATER : 0) |
+                         (gasSensor.isDangerous() ? TELEMETRY_FLAG_GAS_DANGER : 0) |
+                         (co2Sensor.isDangerous() ? TELEMETRY_FLAG_CO2_DANGER : 0) |
+                         (coSensor.isDangerous() ? TELEMETRY_FLAG_CO_DANGER : 0) |
+                         (weightSensor.isOverloaded() ? TELEMETRY_FLAG_OVERLOADED : 0);
+        snapshot.remoteMask = remoteMask;
+
+        float* value = snapshot.values;
+        value[TELEMETRY_SOIL_MOISTURE] = moisture;
+        value[TELEMETRY_SOIL_TEMP] = tempC;
+        value[TELEMETRY_SOIL_PH] = pH;
+        value[TELEMETRY_LEAF_TEMP] = leafTempC;
+        value[TELEMETRY_LEAF_WETNESS] = leafWet;
+        value[TELEMETRY_AIR_TEMP] = airTemp;
+        value[TELEMETRY_HUMIDITY] = humidity;
+        value[TELEMETRY_LIGHT] = lightPercent;
+        value[TELEMETRY_RAINFALL] = rainfall_mm;
+        value[TELEMETRY_WIND_SPEED] = windSpeed_kmh;
+        value[TELEMETRY_WIND_DIRECTION] = windDir_degrees;
+        value[TELEMETRY_GAS] = gasPPM;
+        value[TELEMETRY_CO2] = co2PPM;
+        value[TELEMETRY_CO] = coPPM;
+        value[TELEMETRY_WATER_LEVEL] = waterLevel_percent;
+        value[TELEMETRY_WEIGHT] = weight_kg;
+        value[TELEMETRY_RAIN_RATE] = rainRate;
+        value[TELEMETRY_RAINFALL_1H] = rainfall1h_mm;
+        value[TELEMETRY_WIND_GUST] = windGust_kmh;
+        value[TELEMETRY_WIND_MEAN_10MIN] = windMean10Min_kmh;
+        value[TELEMETRY_WIND_DIRECTION_10MIN] = windDirMean10Min;
+        value[TELEMETRY_WATER_VOLUME] = waterVolume_liters;
+
+        uint8_t* status = snapshot.status;
+        status[TELEMETRY_STATUS_MOISTURE] = moistureStatus;
+        status[TELEMETRY_STATUS_SOIL_TEMP] = tempStatus;
+        status[TELEMETRY_STATUS_PH] = phStatus;
+        status[TELEMETRY_STATUS_LEAF_TEMP] = leafTempStatus;
+        status[TELEMETRY_STATUS_WETNESS] = leafWetStatus;
+        status[TELEMETRY_STATUS_AIR_TEMP] = airTempStatus;
+        status[TELEMETRY_STATUS_HUMIDITY] = humidityStatus;
+        status[TELEMETRY_STATUS_LIGHT] = lightStatus;
+        status[TELEMETRY_STATUS_WIND] = windStatus;
+        status[TELEMETRY_STATUS_RAIN] = rainStatus;
+        status[TELEMETRY_STATUS_RAIN_INTENSITY] = rainfall.getRainIntensity();
+        status[TELEMETRY_STATUS_TANK] = tankStatus;
+        status[TELEMETRY_STATUS_GAS] = gasStatus;
+        status[TELEMETRY_STATUS_AIR_QUALITY] = airQuality;
+        status[TELEMETRY_STATUS_CO] = coStatus;
+        status[TELEMETRY_STATUS_MOTION] = motionStatus;
+        status[TELEMETRY_STATUS_WEIGHT] = weightStatus;
+
+        telemetry.sendSnapshot(snapshot);
+        return;
+    }
+
+    // Display on Serial Monitor
+    Serial.println("========== SENSOR READINGS ==========");
+    
+    Serial.println("--- SOIL MOISTURE ---");
+    Serial.print("Raw ADC Value: ");
+    Serial.println(rawMoisture);
+    Serial.print("Moisture: ");
+    Serial.print(moisture, 1);
+    Serial.println(" %");
+    Serial.print("Status: ");
+    Serial.println(statusName(moistureStatus));
+    
+    Serial.println("\n--- SOIL TEMPERATURE ---");
+    Serial.print("Temperature: ");
+    Serial.print(tempC, 1);
+    Serial.print(" °C (");
+    Serial.print(tempF, 1);
+    Serial.println(" °F)");
+    Serial.print("Status: ");
+    Serial.println(statusName(tempStatus));
+    
+    Serial.println("\n--- SOIL pH ---");
+    Serial.print("pH Value: ");
+    Serial.println(pH, 2);
+    Serial.print("Voltage: ");
+    Serial.print(phVoltage, 3);
+    Serial.println(" V");
+    Serial.print("Status: ");
+    Serial.println(statusName(phStatus));
+    
+    Serial.println("\n--- LEAF TEMPERATURE ---");
+    Serial.print("Leaf Temp: ");
+    Serial.print(leafTempC, 1);
+    Serial.print(" °C (");
+    Serial.print(leafTempF, 1);
+    Serial.println(" °F)");
+    Serial.print("Status: ");
+    Serial.println(statusName(leafTempStatus));
+    
+    Serial.println("\n--- LEAF WETNESS ---");
+    Serial.print("Wetness: ");
+    Serial.print(leafWet, 1);
+    Serial.println(" %");
+    Serial.print("Status: ");
+    Serial.println(statusName(leafWetStatus));
+    
+    Serial.println("\n--- AIR TEMPERATURE & HUMIDITY ---");
+    if (dhtValid) {
+        Serial.print("Air Temperature: ");
+        Serial.print(airTemp, 1);
+        Serial.println(" °C");
         Serial.print("Status: ");
-        Serial.println(leafWetStatus);
-        
-        Serial.println("\n--- AIR TEMPERATURE & HUMIDITY ---");
-        if (dhtValid) {
-            Serial.print("Air Temperature: ");
-            Serial.print(airTemp, 1);
-            Serial.println(" °C");
-            Serial.print("Status: ");
-            Serial.println(airTempStatus);
-            Serial.print("Humidity: ");
-            Serial.print(humidity, 1);
-            Serial.println(" %");
-            Serial.print("Status: ");
-            Serial.println(humidityStatus);
-        } else {
-            Serial.println("DHT22 reading failed!");
-        }
-        
-        Serial.println("\n--- LIGHT INTENSITY ---");
-        Serial.print("Light Level: ");
-        Serial.print(lightPercent, 1);
+        Serial.println(statusName(airTempStatus));
+        Serial.print("Humidity: ");
+        Serial.print(humidity, 1);
         Serial.println(" %");
         Serial.print("Status: ");
-        Serial.println(lightStatus);
-        
-        Serial.println("\n--- WIND SPEED ---");
-        Serial.print("Wind Speed: ");
-        Serial.print(windSpeed_kmh, 1);
-        Serial.print(" km/h (");
-        Serial.print(windSpeed_ms, 1);
-        Serial.println(" m/s)");
-        Serial.print("Status: ");
-        Serial.println(windStatus);
-        
-        Serial.println("\n--- WIND DIRECTION ---");
-        Serial.print("Direction: ");
-        Serial.print(windDir_degrees);
-        Serial.print("° (");
-        Serial.print(windDir_cardinal);
-        Serial.println(")");
-        
-        Serial.println("\n--- RAINFALL ---");
-        Serial.print("Total Rainfall: ");
-        Serial.print(rainfall_mm, 2);
-        Serial.print(" mm (");
-        Serial.print(rainfall.getRainfall_inches(), 2);
-        Serial.println(" in)");
-        Serial.print("Rain Rate: ");
-        Serial.print(rainRate, 1);
-        Serial.println(" mm/h");
-        Serial.print("Status: ");
-        Serial.println(rainStatus);
-        Serial.print("Intensity: ");
-        Serial.println(rainfall.getRainIntensity());
-        
-        Serial.println("\n--- WATER TANK LEVEL ---");
-        Serial.print("Water Level: ");
-        Serial.print(waterLevel_cm, 1);
-        Serial.print(" cm (");
-        Serial.print(waterLevel_percent, 1);
-        Serial.println(" %)");
-        Serial.print("Volume: ");
-        Serial.print(waterVolume_liters, 0);
-        Serial.println(" L");
-        Serial.print("Status: ");
-        Serial.println(tankStatus);
-        if (waterTank.isLowLevel()) {
-            Serial.println("WARNING: Low water level!");
-        }
-        
-        Serial.println("\n--- GAS SENSOR ---");
-        Serial.print("Gas Concentration: ");
-        Serial.print(gasPPM, 0);
-        Serial.println(" ppm");
-        Serial.print("Status: ");
-        Serial.println(gasStatus);
-        if (gasSensor.isDangerous()) {
-            Serial.println("DANGER: High gas level detected!");
-        }
-        
-        Serial.println("\n--- CO2 SENSOR ---");
-        Serial.print("CO2 Concentration: ");
-        Serial.print(co2PPM, 0);
-        Serial.println(" ppm");
-        Serial.print("Air Quality: ");
-        Serial.println(airQuality);
-        if (co2Sensor.isDangerous()) {
-            Serial.println("WARNING: High CO2 level - Poor ventilation!");
-        }
-        
-        Serial.println("\n--- CO SENSOR ---");
-        Serial.print("CO Concentration: ");
-        Serial.print(coPPM, 0);
-        Serial.println(" ppm");
-        Serial.print("Status: ");
-        Serial.println(coStatus);
-        if (coSensor.isDangerous()) {
-            Serial.println("DANGER: High CO level - Carbon Monoxide detected!");
-        }
-        
-        Serial.println("\n--- MOTION SENSOR ---");
-        Serial.print("Status: ");
-        Serial.println(motionStatus);
-        Serial.print("Total Motion Events: ");
-        Serial.println(motionSensor.getMotionCount());
-        
-        Serial.println("\n--- WEIGHT SENSOR ---");
-        Serial.print("Weight: ");
-        Serial.print(weight_kg, 2);
-        Serial.print(" kg (");
-        Serial.print(weightSensor.getWeight_lbs(), 2);
-        Serial.println(" lbs)");
-        Serial.print("Status: ");
-        Serial.println(weightStatus);
-        
-        Serial.println("=====================================\n");
+        Serial.println(statusName(humidityStatus));
+    } else {
+        Serial.println("DHT22 reading failed!");
+    }
+    
+    Serial.println("\n--- LIGHT INTENSITY ---");
+    Serial.print("Light Level: ");
+    Serial.print(lightPercent, 1);
+    Serial.println(" %");
+    Serial.print("Status: ");
+    Serial.println(statusName(lightStatus));
+    
+    Serial.println("\n--- WIND SPEED ---");
+    Serial.print("Wind Speed: ");
+    Serial.print(windSpeed_kmh, 1);
+    Serial.print(" km/h (");
+    Serial.print(windSpeed_ms, 1);
+    Serial.println(" m/s)");
+    Serial.print("Gust (3 s, 10 min): ");
+    Serial.print(windGust_kmh, 1);
+    Serial.println(" km/h");
+    Serial.print("Mean 2 min / 10 min: ");
+    Serial.print(windMean2Min_kmh, 1);
+    Serial.print(" / ");
+    Serial.print(windMean10Min_kmh, 1);
+    Serial.println(" km/h");
+    Serial.print("Status: ");
+    Serial.println(statusName(windStatus));
+    
+    Serial.println("\n--- WIND DIRECTION ---");
+    Serial.print("Direction: ");
+    Serial.print(windDir_degrees);
+    Serial.print("° (");
+    Serial.print(windDir_cardinal);
+    Serial.println(")");
+    Serial.print("Mean 2 min: ");
+    Serial.print(windDirMean2Min, 0);
+    Serial.print("° (");
+    Serial.print(windCardinal16(windDirMean2Min));
+    Serial.print(") ±");
+    Serial.print(windDirStdDev2Min, 0);
+    Serial.println("°");
+    Serial.print("Mean 10 min: ");
+    Serial.print(windDirMean10Min, 0);
+    Serial.print("° (");
+    Serial.print(windCardinal16(windDirMean10Min));
+    Serial.print(") ±");
+    Serial.print(windDirStdDev10Min, 0);
+    Serial.println("°");
+    
+    Serial.println("\n--- RAINFALL ---");
+    Serial.print("Last 24 h: ");
+    Serial.print(rainfall_mm, 2);
+    Serial.print(" mm (");
+    Serial.print(rainfall.getRainfall_inches(), 2);
+    Serial.println(" in)");
+    Serial.print("Last 1 h: ");
+    Serial.print(rainfall1h_mm, 2);
+    Serial.print(" mm, event: ");
+    Serial.print(rainEvent_mm, 2);
+    Serial.print(" mm (");
+    Serial.print(rainfall.getTipCount());
+    Serial.println(" tips)");
+    Serial.print("Rain Rate: ");
+    Serial.print(rainRate, 1);
+    Serial.println(" mm/h");
+    Serial.print("Status: ");
+    Serial.println(statusName(rainStatus));
+    Serial.print("Intensity: ");
+    Serial.println(statusName(rainfall.getRainIntensity()));
+    
+    Serial.println("\n--- WATER TANK LEVEL ---");
+    Serial.print("Water Level: ");
+    Serial.print(waterLevel_cm, 1);
+    Serial.print(" cm (");
+    Serial.print(waterLevel_percent, 1);
+    Serial.println(" %)");
+    Serial.print("Volume: ");
+    Serial.print(waterVolume_liters, 0);
+    Serial.println(" L");
+    Serial.print("Status: ");
+    Serial.println(statusName(tankStatus));
+    if (waterTank.isLowLevel()) {
+        Serial.println("WARNING: Low water level!");
+    }
+    
+    Serial.println("\n--- GAS SENSOR ---");
+    Serial.print("Gas Concentration: ");
+    Serial.print(gasPPM, 0);
+    Serial.println(" ppm");
+    Serial.print("Status: ");
+    Serial.println(statusName(gasStatus));
+    if (gasSensor.isDangerous()) {
+        Serial.println("DANGER: High gas level detected!");
+    }
+    
+    Serial.println("\n--- CO2 SENSOR ---");
+    Serial.print("CO2 Concentration: ");
+    Serial.print(co2PPM, 0);
+    Serial.println(" ppm");
+    Serial.print("Air Quality: ");
+    Serial.println(statusName(airQuality));
+    if (co2Sensor.isDangerous()) {
+        Serial.println("WARNING: High CO2 level - Poor ventilation!");
+    }
+    
+    Serial.println("\n--- CO SENSOR ---");
+    Serial.print("CO Concentration: ");
+    Serial.print(coPPM, 0);
+    Serial.println(" ppm");
+    Serial.print("Status: ");
+    Serial.println(statusName(coStatus));
+    if (coSensor.isDangerous()) {
+        Serial.println("DANGER: High CO level - Carbon Monoxide detected!");
+    }
+    
+    Serial.println("\n--- MOTION SENSOR ---");
+    Serial.print("Status: ");
+    Serial.println(statusName(motionStatus));
+    Serial.print("Total Motion Events: ");
+    Serial.println(motionSensor.getMotionCount());
+    
+    Serial.println("\n--- WEIGHT SENSOR ---");
+    Serial.print("Weight: ");
+    Serial.print(weight_kg, 2);
+    Serial.print(" kg (");
+    Serial.print(weightSensor.getWeight_lbs(), 2);
+    Serial.println(" lbs)");
+    Serial.print("Status: ");
+    Serial.println(statusName(weightStatus));
+    
+    Serial.println("=====================================\n");
+}
+
+// ==================== LCD PAGES ====================
+
+// One LCD row: a fixed label followed by a value printed by a function.
+// Either part may be absent.
+struct LcdRow {
+    const char* label;
+    void (*value)();
+};
+
+struct LcdPage {
+    LcdRow rows[LCD_ROWS];
+};
+
+// The screens cycled on the 20x4 LCD. Rows left empty are blank.
+static const LcdPage LCD_PAGES[] = {
+    // Soil moisture
+    {{{"SoilMoist:", [] { lcd.print(soilMoisture.getMoisturePercent(), 1); lcd.print("%"); }},
+      {nullptr, [] { lcd.print(statusName(soilMoisture.getMoistureStatus())); }}}},
+    // Soil and leaf temperature
+    {{{"SoilTemp:", [] { lcd.print(soilTemp.getTemperatureC(), 1); lcd.print("C"); }},
+      {"Status: ", [] { lcd.print(statusName(soilTemp.getTemperatureStatus())); }},
+      {"Leaf Temp: ", [] { lcd.print(leafTemp.getObjectTempC(), 1); lcd.print("C"); }},
+      {"Status: ", [] { lcd.print(statusName(leafTemp.getTemperatureStatus())); }}}},
+    // Air temperature and humidity
+    {{{"Air Temp: ", [] { if (dhtValid) { lcd.print(airTemp, 1); lcd.print("C"); } else lcd.print("Error!"); }},
+      {"Status: ", [] { lcd.print(dhtValid ? statusName(airTempStatus) : "N/A"); }},
+      {"Air Humidity: ", [] { if (dhtValid) { lcd.print(humidity, 1); lcd.print("%"); } else lcd.print("Error!"); }},
+      {"Status: ", [] { lcd.print(dhtValid ? statusName(humidityStatus) : "N/A"); }}}},
+    // Light intensity
+    {{{"Light: ", [] { lcd.print(lightPercent, 1); lcd.print(" %"); }},
+      {"Status: ", [] { lcd.print(statusName(lightStatus)); }}}},
+    // Wind speed
+    {{{"Wind Speed:", nullptr},
+      {nullptr, [] { lcd.print(windSpeed_kmh, 1); lcd.print(" km/h"); }},
+      {nullptr, [] { lcd.print(windSpeed_ms, 2); lcd.print(" m/s"); }},
+      {nullptr, [] { lcd.print(statusName(windStatus)); }}}},
+    // Wind direction
+    {{{"== WIND DIRECTION ==", nullptr},
+      {"Angle: ", [] { lcd.print(windDir_degrees); lcd.print((char)223); }},  // Degree symbol
+      {"Direction: ", [] { lcd.print(windDir_cardinal); }}}},
+    // Rainfall
+    {{{"===== RAINFALL =====", nullptr},
+      {"24h ", [] { lcd.print(rainfall_mm, 1); lcd.print(" 1h "); lcd.print(rainfall1h_mm, 1); }},
+      {"Rate: ", [] { lcd.print(rainRate, 1); lcd.print(" mm/h"); }},
+      {nullptr, [] { lcd.print(statusName(rainStatus)); }}}},
+    // Water tank level
+    {{{"=== WATER TANK ====", nullptr},
+      {"Level: ", [] { lcd.print(waterLevel_percent, 1); lcd.print(" %"); }},
+      {"Volume: ", [] { lcd.print(waterVolume_liters, 0); lcd.print(" L"); }},
+      {nullptr, [] { lcd.print(statusName(tankStatus)); if (waterTank.isLowLevel()) lcd.print(" - LOW!"); }}}},
+    // Gas sensor
+    {{{"==== GAS SENSOR ====", nullptr},
+      {"Gas: ", [] { lcd.print(gasPPM, 0); lcd.print(" ppm"); }},
+      {"Status: ", [] { lcd.print(statusName(gasStatus)); }},
+      {nullptr, [] { lcd.print(gasSensor.isDangerous() ? "DANGER!" : "Safe"); }}}},
+    // CO2 sensor
+    {{{"==== CO2 SENSOR ====", nullptr},
+      {"CO2: ", [] { lcd.print(co2PPM, 0); lcd.print(" ppm"); }},
+      {"Air Quality: ", [] { lcd.print(statusName(airQuality)); }},
+      {nullptr, [] { lcd.print(co2Sensor.isDangerous() ? "Poor Ventilation!" : "Good"); }}}},
+    // CO sensor
+    {{{"===== CO SENSOR ====", nullptr},
+      {"CO: ", [] { lcd.print(coPPM, 0); lcd.print(" ppm"); }},
+      {"Status: ", [] { lcd.print(statusName(coStatus)); }},
+      {nullptr, [] { lcd.print(coSensor.isDangerous() ? "*** DANGER ***" : "Safe"); }}}},
+    // Motion sensor
+    {{{"=== MOTION SENSOR ==", nullptr},
+      {nullptr, [] { lcd.print(statusName(motionStatus)); }},
+      {"Events: ", [] { lcd.print(motionSensor.getMotionCount()); }},
+      {nullptr, [] { lcd.print(motionDetected ? "*** ALERT ***" : "All clear"); }}}},
+    // Weight sensor
+    {{{"=== WEIGHT SENSOR ==", nullptr},
+      {"Weight: ", [] { lcd.print(weight_kg, 1); lcd.print(" kg"); }},
+      {nullptr, [] { lcd.print(weightSensor.getWeight_lbs(), 1); lcd.print(" lbs"); }},
+      {nullptr, [] { lcd.print(statusName(weightStatus)); }}}},
+    // Leaf wetness
+    {{{"=== LEAF WETNESS ===", nullptr},
+      {"Wetness: ", [] { lcd.print(leafWetness.getWetnessPercent(), 1); lcd.print("%"); }},
+      {"Status: ", [] { lcd.print(statusName(leafWetness.getWetnessStatus())); }},
+      {nullptr, [] { lcd.print(leafWetness.isWet() ? "Leaf is WET" : "Leaf is DRY"); }}}},
+};
+
+#define LCD_PAGE_COUNT (sizeof(LCD_PAGES) / sizeof(LCD_PAGES[0]))
+
+// Draw a page into the framebuffer and send what changed
+void drawPage(const LcdPage& page) {
+    lcd.clear();
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        const LcdRow& line = page.rows[row];
+        lcd.setCursor(0, row);
+        if (line.label != nullptr) lcd.print(line.label);
+        if (line.value != nullptr) line.value();
     }
+    lcd.flush();
+}
 
-    // Switch 20x4 LCD display mode (show 2 sensors at once)
-    if (currentTime - lastModeSwitch >= MODE_SWITCH_INTERVAL) {
-        lastModeSwitch = currentTime;
-        displayMode = (displayMode + 1) % 14;  // 14 screens total
-        
-        lcd.clear();
-        
-        if (displayMode == 0) {
-            // Screen 1: Soil Moisture
-            lcd.setCursor(0, 0);
-            lcd.print("SoilMoist:");
-            lcd.print(soilMoisture.getMoisturePercent(), 1);
-            lcd.print("%");
-            
-            lcd.setCursor(0, 1);
-            lcd.print(soilMoisture.getMoistureStatus());
-            
-        } else if (displayMode == 1) {
-            // Screen 2: Soil Temperature
-            lcd.setCursor(0, 0);
-            lcd.print("SoilTemp:");
-            lcd.print(soilTemp.getTemperatureC(), 1);
-            lcd.print("C");
-            
-            lcd.setCursor(0, 1);
-            lcd.print(soilTemp.getTemperatureStatus());
-            
-            lcd.setCursor(0, 1);
-            lcd.print("Status: ");
-            lcd.print(soilPH.getPHStatus());
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Leaf Temp: ");
-            lcd.print(leafTemp.getObjectTempC(), 1);
-            lcd.print("C");
-            
-            lcd.setCursor(0, 3);
-            lcd.print("Status: ");
-            lcd.print(leafTemp.getTemperatureStatus());
-        } else if (displayMode == 2) {
-            // Screen 3: Air Temperature & Humidity
-            lcd.setCursor(0, 0);
-            lcd.print("Air Temp: ");
-            if (dhtValid) {
-                lcd.print(airTemp, 1);
-                lcd.print("C");
-            } else {
-                lcd.print("Error!");
-            }
-            
-            lcd.setCursor(0, 1);
-            lcd.print("Status: ");
-            if (dhtValid) {
-                lcd.print(airTempStatus);
-            } else {
-                lcd.print("N/A");
-            }
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Air Humidity: ");
-            if (dhtValid) {
-                lcd.print(humidity, 1);
-                lcd.print("%");
-            } else {
-                lcd.print("Error!");
-            }
-            
-            lcd.setCursor(0, 3);
-            lcd.print("Status: ");
-            if (dhtValid) {
-                lcd.print(humidityStatus);
-            } else {
-                lcd.print("N/A");
-            }
-        } else if (displayMode == 3) {
-            // Screen 4: Light Intensity
-            lcd.setCursor(0, 0);
-            lcd.print("Light: ");
-            lcd.print(lightPercent, 1);
-            lcd.print(" %");
-            
-            lcd.setCursor(0, 1);
-            lcd.print("Status: ");
-            lcd.print(lightStatus);
-        } else if (displayMode == 4) {
-            // Screen 5: Wind Speed
-            lcd.setCursor(0, 0);
-            lcd.print("Wind Speed:");
-            
-            lcd.setCursor(0, 1);
-            lcd.print(windSpeed_kmh, 1);
-            lcd.print(" km/h");
-            
-            lcd.setCursor(0, 2);
-            lcd.print(windSpeed_ms, 2);
-            lcd.print(" m/s");
-            
-            lcd.setCursor(0, 3);
-            lcd.print(windStatus);
-        } else if (displayMode == 5) {
-            // Screen 6: Wind Direction
-            lcd.setCursor(0, 0);
-            lcd.print("=== WIND DIRECTION ==");
-            
-            lcd.setCursor(0, 1);
-            lcd.print("Angle: ");
-            lcd.print(windDir_degrees);
-            lcd.print((char)223);  // degree symbol
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Direction: ");
-            lcd.print(windDir_cardinal);
-            
-        } else if (displayMode == 6) {
-            // Screen 7: Rainfall
-            lcd.setCursor(0, 0);
-            lcd.print("===== RAINFALL =====");
-            
-            lcd.setCursor(0, 1);
-            lcd.print("Total: ");
-            lcd.print(rainfall_mm, 2);
-            lcd.print(" mm");
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Rate: ");
-            lcd.print(rainRate, 1);
-            lcd.print(" mm/h");
-            
-            lcd.setCursor(0, 3);
-            lcd.print(rainStatus);
-        } else if (displayMode == 7) {
-            // Screen 8: Water Tank Level
-            lcd.setCursor(0, 0);
-            lcd.print("=== WATER TANK ====");
-            
-            lcd.setCursor(0, 1);
-            lcd.print("Level: ");
-            lcd.print(waterLevel_percent, 1);
-            lcd.print(" %");
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Volume: ");
-            lcd.print(waterVolume_liters, 0);
-            lcd.print(" L");
-            
-            lcd.setCursor(0, 3);
-            lcd.print(tankStatus);
-            if (waterTank.isLowLevel()) {
-                lcd.print(" - LOW!");
-            }
-        } else if (displayMode == 8) {
-            // Screen 9: Gas Sensor
-            lcd.setCursor(0, 0);
-            lcd.print("==== GAS SENSOR ====");
-            
-            lcd.setCursor(0, 1);
-            lcd.print("Gas: ");
-            lcd.print(gasPPM, 0);
-            lcd.print(" ppm");
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Status: ");
-            lcd.print(gasStatus);
-            
-            lcd.setCursor(0, 3);
-            if (gasSensor.isDangerous()) {
-                lcd.print("DANGER!");
-            } else {
-                lcd.print("Safe");
-            }
-        } else if (displayMode == 9) {
-            // Screen 10: CO2 Sensor
-            lcd.setCursor(0, 0);
-            lcd.print("==== CO2 SENSOR ====");
-            
-            lcd.setCursor(0, 1);
-            lcd.print("CO2: ");
-            lcd.print(co2PPM, 0);
-            lcd.print(" ppm");
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Air Quality: ");
-            lcd.print(airQuality);
-            
-            lcd.setCursor(0, 3);
-            if (co2Sensor.isDangerous()) {
-                lcd.print("Poor Ventilation!");
-            } else {
-                lcd.print("Good");
-            }
-        } else if (displayMode == 10) {
-            // Screen 11: CO Sensor
-            lcd.setCursor(0, 0);
-            lcd.print("===== CO SENSOR ====");
-            
-            lcd.setCursor(0, 1);
-            lcd.print("CO: ");
-            lcd.print(coPPM, 0);
-            lcd.print(" ppm");
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Status: ");
-            lcd.print(coStatus);
-            
-            lcd.setCursor(0, 3);
-            if (coSensor.isDangerous()) {
-                lcd.print("*** DANGER ***");
-            } else {
-                lcd.print("Safe");
-            }
-        } else if (displayMode == 11) {
-            // Screen 12: Motion Sensor
-            lcd.setCursor(0, 0);
-            lcd.print("=== MOTION SENSOR ==");
-            
-            lcd.setCursor(0, 1);
-            lcd.print(motionStatus);
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Events: ");
-            lcd.print(motionSensor.getMotionCount());
-            
-            lcd.setCursor(0, 3);
-            if (motionDetected) {
-                lcd.print("*** ALERT ***");
-            } else {
-                lcd.print("All clear");
-            }
-        } else if (displayMode == 12) {
-            // Screen 13: Weight Sensor
-            lcd.setCursor(0, 0);
-            lcd.print("=== WEIGHT SENSOR ==");
-            
-            lcd.setCursor(0, 1);
-            lcd.print("Weight: ");
-            lcd.print(weight_kg, 1);
-            lcd.print(" kg");
-            
-            lcd.setCursor(0, 2);
-            lcd.print(weightSensor.getWeight_lbs(), 1);
-            lcd.print(" lbs");
-            
-            lcd.setCursor(0, 3);
-            lcd.print(weightStatus);
-        } else {
-            // Screen 14: Leaf Wetness (single sensor display)
-            lcd.setCursor(0, 0);
-            lcd.print("=== LEAF WETNESS ===");
-            
-            lcd.setCursor(0, 1);
-            lcd.print("Wetness: ");
-            lcd.print(leafWetness.getWetnessPercent(), 1);
-            lcd.print("%");
-            
-            lcd.setCursor(0, 2);
-            lcd.print("Status: ");
-            lcd.print(leafWetness.getWetnessStatus());
-            
-            lcd.setCursor(0, 3);
-            if (leafWetness.isWet()) {
-                lcd.print("Leaf is WET");
-            } else {
-                lcd.print("Leaf is DRY");
-            }
-        }
+// Redraw the current page with fresh readings; move to the next page every
+// MODE_SWITCH_INTERVAL. Only changed characters reach the bus, so the
+// in-page refresh costs a few cells rather than a whole screen.
+void updateDisplay() {
+    static unsigned long refreshes = 0;
+    if (refreshes++ % (MODE_SWITCH_INTERVAL / LCD_REFRESH_INTERVAL) == 0) {
+        displayMode = (displayMode + 1) % LCD_PAGE_COUNT;
     }
+    drawPage(LCD_PAGES[displayMode]);
 }
 
+void printSchedulerStats() {
+    scheduler.printStats();
+    adcEngine.printStats();
+    lcd.printStats();
+    commandParser.printStats();
+    telemetry.printStats();
+#ifdef SENSOR_TRACE
+    traceRecorder.printStats();
+#endif
+}
+
+
 /**
  * Check for incoming Serial commands from dashboard
- * Expected JSON format: {"sensor":"soilMoisture","value":45.5}
+ * Text frames: {"sensor":"soilMoisture","value":45.5}, or 7-byte binary
+ * frames (CommandParser.h). Bytes are parsed as they arrive; nothing waits
+ * for a whole line.
  */
 void checkSerialCommands() {
-    if (Serial.available() > 0) {
-        String jsonData = Serial.readStringUntil('\n');
-        jsonData.trim();
-        
-        if (jsonData.length() > 0) {
-            // Simple JSON parsing (looking for "sensor" and "value")
-            int sensorStart = jsonData.indexOf("\"sensor\":\"") + 10;
-            int sensorEnd = jsonData.indexOf("\"", sensorStart);
-            int valueStart = jsonData.indexOf("\"value\":") + 8;
-            int valueEnd = jsonData.indexOf("}", valueStart);
-            
-            if (sensorStart > 9 && sensorEnd > sensorStart && valueStart > 7) {
-                String sensor = jsonData.substring(sensorStart, sensorEnd);
-                String valueStr = jsonData.substring(valueStart, valueEnd);
-                float value = valueStr.toFloat();
-                
-                // Enable remote control mode
-                remoteControlActive = true;
-                
-                // Update the appropriate remote value
-                if (sensor == "soilMoisture") {
-                    remote_soilMoisture = value;
-                    Serial.print("✓ Soil Moisture set to: ");
-                } else if (sensor == "soilTemp") {
-                    remote_soilTemp = value;
-                    Serial.print("✓ Soil Temp set to: ");
-                } else if (sensor == "soilPH") {
-                    remote_soilPH = value;
-                    Serial.print("✓ Soil pH set to: ");
-                } else if (sensor == "leafTemp") {
-                    remote_leafTemp = value;
-                    Serial.print("✓ Leaf Temp set to: ");
-                } else if (sensor == "leafWetness") {
-                    remote_leafWetness = value;
-                    Serial.print("✓ Leaf Wetness set to: ");
-                } else if (sensor == "airTemp") {
-                    remote_airTemp = value;
-                    Serial.print("✓ Air Temp set to: ");
-                } else if (sensor == "humidity") {
-                    remote_humidity = value;
-                    Serial.print("✓ Humidity set to: ");
-                } else if (sensor == "light") {
-                    remote_light = value;
-                    Serial.print("✓ Light set to: ");
-                } else if (sensor == "rainfall") {
-                    remote_rainfall = value;
-                    Serial.print("✓ Rainfall set to: ");
-                } else if (sensor == "windSpeed") {
-                    remote_windSpeed = value;
-                    Serial.print("✓ Wind Speed set to: ");
-                } else if (sensor == "windDirection") {
-                    remote_windDirection = value;
-                    Serial.print("✓ Wind Direction set to: ");
-                } else if (sensor == "gas") {
-                    remote_gas = value;
-                    Serial.print("✓ Gas set to: ");
-                } else if (sensor == "co2") {
-                    remote_co2 = value;
-                    Serial.print("✓ CO2 set to: ");
-                } else if (sensor == "co") {
-                    remote_co = value;
-                    Serial.print("✓ CO set to: ");
-                } else if (sensor == "waterLevel") {
-                    remote_waterLevel = value;
-                    Serial.print("✓ Water Level set to: ");
-                } else if (sensor == "weight") {
-                    remote_weight = value;
-                    Serial.print("✓ Weight set to: ");
-                } else {
-                    Serial.print("✗ Unknown sensor: ");
-                    Serial.println(sensor);
-                    return;
-                }
-                
-                Serial.println(value);
-            }
+    while (Serial.available() > 0) {
+        CommandStatus status = commandParser.feed((uint8_t)Serial.read());
+        if (status == COMMAND_READY) {
+            const RemoteCommand& command = commandParser.getCommand();
+            remoteValues[command.channel] = command.value;
+            remoteMask |= 1u << command.channel;
+            logPrintf("✓ %s set to: %.2f\n", REMOTE_CHANNELS[command.channel].label, command.value);
+        } else if (status == COMMAND_UNKNOWN) {
+            logPrintf("✗ Unknown sensor: %s\n", commandParser.getName());
         }
     }
 }
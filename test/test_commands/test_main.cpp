@@ -0,0 +1,377 @@
+/*
+ * test_commands/test_main.cpp
+ * Remote command parsing benchmark (PlatformIO `native` environment)
+ *
+ * Builds a stream of dashboard commands: JSON as serial_bridge.py writes it,
+ * with reordered keys, extra keys and number formats mixed in, binary frames,
+ * and some damaged frames (cut lines, unknown channels, bad CRCs). The stream
+ * is pushed through:
+ * - legacy: the old checkSerialCommands(), a line read into a string, then
+ *   indexOf/substring/toFloat and an if/else chain of string compares
+ * - parser: CommandParser, byte by byte
+ * Every decoded command is checked against the one generated. Heap
+ * allocations are counted while each runs. The parser must decode every
+ * frame as generated and, once warm, make no allocations; the legacy
+ * figures are printed for comparison.
+ * Run: pio test -e native -f test_commands
+ */
+
+#ifndef ARDUINO
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "CommandParser.h"
+
+#define COMMAND_RATE 10000           // Commands per second pushed through
+#define BINARY_SHARE 4               // Every 4th command is a binary frame
+#define DAMAGE_SHARE 50              // Every 50th frame is damaged
+#define TEST_SECONDS 10.0            // Stream length at COMMAND_RATE
+
+// ==================== ALLOCATION COUNTER ====================
+static unsigned long allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* block = malloc(size ? size : 1);
+    if (block == nullptr) throw std::bad_alloc();
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+#ifdef __GLIBC__
+// Plain malloc too (strdup, C library internals)
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* block, size_t size);
+
+extern "C" void* malloc(size_t size) {
+    allocations++;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    allocations++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* block, size_t size) {
+    allocations++;
+    return __libc_realloc(block, size);
+}
+#endif
+
+// ==================== COMMAND STREAM ====================
+
+// What one frame of the stream should decode to
+struct Expected {
+    CommandStatus status;        // READY, UNKNOWN (bad name) or MALFORMED
+    uint8_t channel;
+    float value;
+    bool binary;
+};
+
+struct Stream {
+    std::vector<uint8_t> bytes;
+    std::vector<Expected> expected;
+    unsigned long commands;
+    unsigned long damaged;
+};
+
+static uint32_t randomState = 12345;
+
+static uint32_t nextRandom() {
+    randomState = randomState * 1664525u + 1013904223u;
+    return randomState >> 8;
+}
+
+static void append(Stream& stream, const char* text) {
+    stream.bytes.insert(stream.bytes.end(), text, text + strlen(text));
+}
+
+// One value as text in one of several number formats
+static void formatValue(float value, int style, char* text, size_t size) {
+    switch (style) {
+        case 0: snprintf(text, size, "%.2f", value); break;
+        case 1: snprintf(text, size, "%.0f", value); break;
+        case 2: snprintf(text, size, "%.3e", value); break;
+        default: snprintf(text, size, "%.6f", value); break;
+    }
+}
+
+static Stream buildStream(unsigned long commands) {
+    Stream stream;
+    stream.commands = commands;
+    stream.damaged = 0;
+    stream.bytes.reserve(commands * 48);
+    stream.expected.reserve(commands);
+
+    char line[128];
+    char number[32];
+    for (unsigned long i = 0; i < commands; i++) {
+        uint8_t channel = nextRandom() % REMOTE_CHANNEL_COUNT;
+        float value = (float)((int)(nextRandom() % 200000) - 50000) / 100.0f;
+        bool damage = nextRandom() % DAMAGE_SHARE == 0;
+
+        if (i % BINARY_SHARE == BINARY_SHARE - 1) {
+            uint8_t frame[COMMAND_BINARY_LENGTH];
+            encodeBinaryCommand(channel, value, frame);
+            if (damage) {
+                frame[3] ^= 0x10;                        // CRC catches it
+                stream.damaged++;
+                stream.expected.push_back({COMMAND_MALFORMED, channel, value, true});
+            } else {
+                stream.expected.push_back({COMMAND_READY, channel, value, true});
+            }
+            stream.bytes.insert(stream.bytes.end(), frame, frame + sizeof(frame));
+            continue;
+        }
+
+        int style = nextRandom() % 4;
+        formatValue(value, style, number, sizeof(number));
+        float parsed = strtof(number, nullptr);
+        const char* name = REMOTE_CHANNELS[channel].name;
+        switch (nextRandom() % 4) {
+            case 0:                                      // json.dumps in serial_bridge.py
+                snprintf(line, sizeof(line), "{\"sensor\": \"%s\", \"value\": %s}\n", name, number);
+                break;
+            case 1:
+                snprintf(line, sizeof(line), "{\"sensor\":\"%s\",\"value\":%s}\n", name, number);
+                break;
+            case 2:
+                snprintf(line, sizeof(line), "{\"value\": %s, \"sensor\": \"%s\"}\n", number, name);
+                break;
+            default:
+                snprintf(line, sizeof(line), "{\"sensor\":\"%s\",\"ts\":%lu,\"live\":true,\"value\":%s}\r\n", name,
+                         i, number);
+                break;
+        }
+
+        if (damage) {
+            stream.damaged++;
+            if (nextRandom() % 2) {
+                line[strlen(line) / 2] = '\n';           // Line cut short
+                line[strlen(line) / 2 + 1] = '\0';
+                stream.expected.push_back({COMMAND_MALFORMED, channel, parsed, false});
+                append(stream, line);
+                continue;
+            }
+            // Unknown channel: well-formed, reported by name
+            snprintf(line, sizeof(line), "{\"sensor\":\"%sX\",\"value\":%s}\n", name, number);
+            stream.expected.push_back({COMMAND_UNKNOWN, REMOTE_NO_CHANNEL, parsed, false});
+            append(stream, line);
+            continue;
+        }
+        stream.expected.push_back({COMMAND_READY, channel, parsed, false});
+        append(stream, line);
+    }
+    return stream;
+}
+
+// ==================== LEGACY ====================
+
+// The old checkSerialCommands(), one line at a time, on std::string
+static bool legacyParse(const std::string& buffer, size_t& position, Expected& result) {
+    size_t end = buffer.find('\n', position);
+    if (end == std::string::npos) end = buffer.size();
+    std::string jsonData = buffer.substr(position, end - position);      // readStringUntil('\n')
+    position = end + 1;
+
+    size_t first = jsonData.find_first_not_of(" \t\r");                // trim()
+    size_t last = jsonData.find_last_not_of(" \t\r");
+    jsonData = first == std::string::npos ? std::string() : jsonData.substr(first, last - first + 1);
+    if (jsonData.empty()) return false;
+
+    int sensorStart = (int)jsonData.find("\"sensor\":\"") + 10;
+    int sensorEnd = (int)jsonData.find("\"", sensorStart);
+    int valueStart = (int)jsonData.find("\"value\":") + 8;
+    int valueEnd = (int)jsonData.find("}", valueStart);
+    if (!(sensorStart > 9 && sensorEnd > sensorStart && valueStart > 7)) return false;
+
+    std::string sensor = jsonData.substr(sensorStart, sensorEnd - sensorStart);
+    std::string valueStr = jsonData.substr(valueStart, valueEnd - valueStart);
+    result.value = (float)atof(valueStr.c_str());
+    result.channel = REMOTE_NO_CHANNEL;
+    if (sensor == "soilMoisture") result.channel = REMOTE_SOIL_MOISTURE;
+    else if (sensor == "soilTemp") result.channel = REMOTE_SOIL_TEMP;
+    else if (sensor == "soilPH") result.channel = REMOTE_SOIL_PH;
+    else if (sensor == "leafTemp") result.channel = REMOTE_LEAF_TEMP;
+    else if (sensor == "leafWetness") result.channel = REMOTE_LEAF_WETNESS;
+    else if (sensor == "airTemp") result.channel = REMOTE_AIR_TEMP;
+    else if (sensor == "humidity") result.channel = REMOTE_HUMIDITY;
+    else if (sensor == "light") result.channel = REMOTE_LIGHT;
+    else if (sensor == "rainfall") result.channel = REMOTE_RAINFALL;
+    else if (sensor == "windSpeed") result.channel = REMOTE_WIND_SPEED;
+    else if (sensor == "windDirection") result.channel = REMOTE_WIND_DIRECTION;
+    else if (sensor == "gas") result.channel = REMOTE_GAS;
+    else if (sensor == "co2") result.channel = REMOTE_CO2;
+    else if (sensor == "co") result.channel = REMOTE_CO;
+    else if (sensor == "waterLevel") result.channel = REMOTE_WATER_LEVEL;
+    else if (sensor == "weight") result.channel = REMOTE_WEIGHT;
+    return true;
+}
+
+// ==================== RUNS ====================
+
+struct RunResult {
+    double elapsed_ns;
+    unsigned long allocations;
+    unsigned long decoded;
+    unsigned long wrong;         // Decoded command differs from the one sent
+};
+
+static bool sameValue(float a, float b) {
+    return a == b || fabsf(a - b) <= 1e-6f * fabsf(b);
+}
+
+// Text frames only: the legacy code has no binary frames
+static RunResult runLegacy(const Stream& stream) {
+    std::string text;
+    for (size_t i = 0; i < stream.bytes.size();) {
+        if (stream.bytes[i] == COMMAND_SYNC) {
+            i += COMMAND_BINARY_LENGTH;
+            continue;
+        }
+        size_t end = i;
+        while (end < stream.bytes.size() && stream.bytes[end] != '\n') end++;
+        text.append((const char*)&stream.bytes[i], end - i + 1);
+        i = end + 1;
+    }
+    std::vector<Expected> expected;
+    for (const Expected& e : stream.expected) {
+        if (!e.binary) expected.push_back(e);
+    }
+
+    RunResult result = {};
+    size_t position = 0;
+    size_t line = 0;
+    unsigned long before = allocations;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Expected decoded;
+    while (position < text.size() && line < expected.size()) {
+        const Expected& e = expected[line++];
+        bool parsed = legacyParse(text, position, decoded);
+        if (parsed) result.decoded++;
+        if (e.status == COMMAND_MALFORMED) {
+            if (parsed && decoded.channel != REMOTE_NO_CHANNEL) result.wrong++;
+        } else if (!parsed || decoded.channel != e.channel ||
+                   (e.status == COMMAND_READY && !sameValue(decoded.value, e.value))) {
+            result.wrong++;
+        }
+    }
+    result.elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    result.allocations = allocations - before;
+    return result;
+}
+
+static RunResult runParser(const Stream& stream, CommandParser& parser) {
+    RunResult result = {};
+    size_t frame = 0;
+    unsigned long before = allocations;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint8_t c : stream.bytes) {
+        CommandStatus status = parser.feed(c);
+        if (status == COMMAND_PENDING) continue;
+
+        if (status != COMMAND_MALFORMED) result.decoded++;
+        if (frame >= stream.expected.size()) {
+            result.wrong++;
+            continue;
+        }
+        const Expected& e = stream.expected[frame++];
+        if (status != e.status) {
+            result.wrong++;
+        } else if (status == COMMAND_READY) {
+            const RemoteCommand& command = parser.getCommand();
+            if (command.channel != e.channel || !sameValue(command.value, e.value)) result.wrong++;
+        }
+    }
+    result.elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    result.allocations = allocations - before;
+    result.wrong += stream.expected.size() - frame;                // Never decoded
+    return result;
+}
+
+static void printRun(const char* name, unsigned long commands, double seconds, const RunResult& result) {
+    Serial.printf("%-8s %9lu %9lu %10.1f %11.4f %12lu %11.2f %6lu\n", name, commands, result.decoded,
+                  result.elapsed_ns / commands, 100.0 * result.elapsed_ns / (seconds * 1e9), result.allocations,
+                  (double)result.allocations / commands, result.wrong);
+}
+
+// ==================== TESTS ====================
+
+static const double seconds = TEST_SECONDS;
+static const unsigned long commands = (unsigned long)(TEST_SECONDS * COMMAND_RATE);
+static Stream stream;
+static unsigned long binaryFrames;
+static CommandParser parser;
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_legacy_baseline() {
+    RunResult result = runLegacy(stream);
+    printRun("legacy", commands - binaryFrames, seconds, result);
+    TEST_ASSERT_TRUE(result.decoded > 0);
+}
+
+void test_parser_decodes_stream() {
+    RunResult result = runParser(stream, parser);
+    printRun("parser", commands, seconds, result);
+    parser.printStats();
+
+    const CommandParserStats& stats = parser.getStats();
+    TEST_ASSERT_EQUAL(0, result.wrong);
+    TEST_ASSERT_EQUAL(stream.bytes.size(), stats.bytes);
+    TEST_ASSERT_EQUAL(0, result.allocations);
+}
+
+void test_parser_second_pass() {
+    RunResult repeat = runParser(stream, parser);
+    Serial.printf("Second pass: %.1f ns/command, %lu allocations, %lu wrong\n", repeat.elapsed_ns / commands,
+                  repeat.allocations, repeat.wrong);
+    TEST_ASSERT_EQUAL(0, repeat.wrong);
+    TEST_ASSERT_EQUAL(0, repeat.allocations);
+}
+
+int main() {
+    stream = buildStream(commands);
+    unsigned long binaryBytes = 0;
+    for (size_t i = 0; i < stream.bytes.size(); i++) {
+        if (stream.bytes[i] == COMMAND_SYNC) {
+            binaryBytes += COMMAND_BINARY_LENGTH;
+            i += COMMAND_BINARY_LENGTH - 1;
+        }
+    }
+    binaryFrames = binaryBytes / COMMAND_BINARY_LENGTH;
+    double textFrameBytes = (double)(stream.bytes.size() - binaryBytes) / (commands - binaryFrames);
+
+    Serial.printf("Remote commands, %lu over %.1f s (%d/s), %lu damaged, %zu bytes\n", commands, seconds,
+                  COMMAND_RATE, stream.damaged, stream.bytes.size());
+    Serial.printf("Frame size: text %.1f bytes, binary %d bytes; 10k/s needs %.0f kbaud as text, %.0f kbaud as binary\n",
+                  textFrameBytes, COMMAND_BINARY_LENGTH, textFrameBytes * 10 * COMMAND_RATE / 1000,
+                  (double)COMMAND_BINARY_LENGTH * 10 * COMMAND_RATE / 1000);
+    Serial.printf("%-8s %9s %9s %10s %11s %12s %11s %6s\n", "decoder", "commands", "decoded", "ns/command",
+                  "CPU % @10k", "allocations", "allocs/cmd", "wrong");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_legacy_baseline);
+    RUN_TEST(test_parser_decodes_stream);
+    RUN_TEST(test_parser_second_pass);
+    return UNITY_END();
+}
+
+#endif // ARDUINO
@@ -0,0 +1,446 @@
+/*
+ * test_drivers/test_main.cpp
+ * Driver set on the host HAL (PlatformIO `native` environment)
+ *
+ * Runs the complete driver set through the same task scheduler as main.ino,
+ * against scripted input signals on the host HAL's virtual clock, printing
+ * one report per UPDATE_INTERVAL. Checks:
+ * - the readings against the scripted signals (tank echo, probes, rain tips)
+ * - the wind gust against the steady simulated wind, the Yamartino sigma
+ *   of the vane against the reported directions, the 1 h and event rain
+ *   totals against the tips
+ * - the gas alert is raised during the scripted leak and cleared after it
+ * - no task overruns or misses its deadline
+ * - the ADC engine keeps up with the scanner; its ingest cost per channel
+ *   is printed
+ * - the MQ ppm tables against libm powf, speed printed, error bounded
+ * Run: pio test -e native -f test_drivers
+ */
+
+#ifndef ARDUINO
+
+#include <Arduino.h>
+#include <unity.h>
+#include "HostHAL.h"
+#include "SoilMoistureSensor.h"
+#include "SoilTemperatureSensor.h"
+#include "SoilPHSensor.h"
+#include "LeafTemperatureSensor.h"
+#include "LeafWetnessSensor.h"
+#include "DHTSensor.h"
+#include "LightSensor.h"
+#include "WindSpeedSensor.h"
+#include "WindSimulator.h"
+#include "WindDirectionSensor.h"
+#include "RainfallSensor.h"
+#include "WaterTankSensor.h"
+#include "GasSensor.h"
+#include "CO2Sensor.h"
+#include "COSensor.h"
+#include "MotionSensor.h"
+#include "WeightSensor.h"
+#include "AlertSystem.h"
+#include "TaskScheduler.h"
+#include "AdcEngine.h"
+#include <chrono>
+#include <vector>
+
+// Same wiring as main.ino
+#define SOIL_MOISTURE_PIN 34
+#define SOIL_TEMP_PIN 15
+#define SOIL_PH_PIN 35
+#define LEAF_TEMP_PIN 37
+#define LEAF_WETNESS_PIN 32
+#define DHT_PIN 25
+#define LDR_PIN 33
+#define WIND_SPEED_PIN 27
+#define WIND_SIM_PIN 26
+#define WIND_POT_PIN 36
+#define WIND_DIR_PIN 39
+#define RAIN_PIN 14
+#define WATER_TRIG_PIN 12
+#define WATER_ECHO_PIN 13
+#define GAS_PIN 4
+#define CO2_PIN 0
+#define CO_PIN 2
+#define MOTION_PIN 19
+#define WEIGHT_DATA_PIN 5
+#define WEIGHT_CLOCK_PIN 18
+#define BUZZER_PIN 23
+
+const unsigned long UPDATE_INTERVAL = 2000;
+
+// Reports run: the gas leak (20-30 s) is over and cleared by the last one
+#define TEST_REPORTS 20
+
+// Time one pass of loop() costs outside the scheduler (serial, simulation)
+#define HOST_LOOP_OVERHEAD_US 200
+
+// Rain shower: the gauge tips every 2 * RAIN_TOGGLE_US (about 100 mm/h)
+#define RAIN_TIMER 1
+#define RAIN_TOGGLE_US 5000000
+
+// Bucket switch closes and opens on alternate timer ticks
+static void toggleRainGauge() {
+    HostHAL::setDigital(RAIN_PIN, !HostHAL::getDigital(RAIN_PIN));
+}
+
+// Slow sine around a midpoint, period in seconds
+static int wave(uint64_t now_us, int mid, int amplitude, double period_s) {
+    double t = (double)now_us / 1000000.0;
+    return mid + (int)(amplitude * sin(2.0 * M_PI * t / period_s));
+}
+
+static void scriptSignals() {
+    HostHAL::setAnalogSource(SOIL_MOISTURE_PIN, [](uint64_t now) { return wave(now, 2800, 600, 600.0); });
+    HostHAL::setAnalogSource(SOIL_PH_PIN, [](uint64_t now) { return wave(now, 1860, 120, 900.0); });
+    HostHAL::setAnalogSource(LEAF_TEMP_PIN, [](uint64_t now) { return wave(now, 1500, 400, 1200.0); });
+    HostHAL::setAnalogSource(LEAF_WETNESS_PIN, [](uint64_t now) { return wave(now, 3000, 800, 300.0); });
+    HostHAL::setAnalogSource(LDR_PIN, [](uint64_t now) { return wave(now, 2048, 2000, 86400.0); });
+    HostHAL::setAnalogSource(WIND_DIR_PIN, [](uint64_t now) { return wave(now, 2048, 300, 60.0); });
+    // MQ2 background with a gas leak (~6000 ppm) between 20 s and 30 s
+    HostHAL::setAnalogSource(GAS_PIN, [](uint64_t now) {
+        return (now >= 20000000 && now < 30000000) ? 3300 : wave(now, 400, 200, 120.0);
+    });
+    HostHAL::setAnalog(WIND_POT_PIN, 400);
+    HostHAL::setAnalog(CO2_PIN, 500);
+    HostHAL::setAnalog(CO_PIN, 100);
+
+    // Echo from 40 cm below the sensor: 40 / 0.01715 us
+    HostHAL::setPulseWidth(WATER_ECHO_PIN, 2332);
+
+    HostHAL::setTemperatureProbe(SOIL_TEMP_PIN, 1, 21.5f);
+    HostHAL::setHumidity(DHT_PIN, 24.0f, 55.0f);
+    HostHAL::setLoadCell(WEIGHT_DATA_PIN, 0);
+
+    // Wokwi wiring: PWM simulator output drives the anemometer input
+    HostHAL::connectPins(WIND_SIM_PIN, WIND_SPEED_PIN);
+    HAL::timer().start(RAIN_TIMER, RAIN_TOGGLE_US, toggleRainGauge);
+}
+
+static SoilMoistureSensor soilMoisture(SOIL_MOISTURE_PIN);
+static SoilTemperatureSensor soilTemp(SOIL_TEMP_PIN);
+static SoilPHSensor soilPH(SOIL_PH_PIN);
+static LeafTemperatureSensor leafTemp(LEAF_TEMP_PIN);
+static LeafWetnessSensor leafWetness(LEAF_WETNESS_PIN);
+static DHTSensor dhtSensor(DHT_PIN);
+static LightSensor lightSensor(LDR_PIN);
+static WindSpeedSensor windSpeed(WIND_SPEED_PIN);
+static WindSimulator windSimulator;
+static WindDirectionSensor windDirection(WIND_DIR_PIN);
+static RainfallSensor rainfall(RAIN_PIN);
+static WaterTankSensor waterTank(WATER_TRIG_PIN, WATER_ECHO_PIN, 100.0, 1000.0);
+static GasSensor gasSensor(GAS_PIN);
+static CO2Sensor co2Sensor(CO2_PIN);
+static COSensor coSensor(CO_PIN);
+static MotionSensor motionSensor(MOTION_PIN);
+static WeightSensor weightSensor(WEIGHT_DATA_PIN, WEIGHT_CLOCK_PIN);
+static AlertSystem alertSystem(BUZZER_PIN);
+
+static TaskScheduler scheduler;
+static int reports = 0;
+static bool gasAlertSeen = false;
+
+// Vane direction at every report, for the sigma check
+static float reportedDirections[TEST_REPORTS];
+
+// Samples per channel pushed through the engine by the cost benchmark
+#define ADC_BENCH_SAMPLES 200000
+
+// Conversions timed per MQ sensor and method
+#define MQ_BENCH_CONVERSIONS 2000000
+
+static void sampleAnalogSensors() {
+    soilMoisture.readMoisture();
+    soilPH.readPH();
+    leafTemp.readTemperature();
+    leafWetness.readWetness();
+    lightSensor.readLight();
+}
+
+static void sampleMotion() {
+    motionSensor.readMotion();
+}
+
+static void sampleWindSpeed() {
+    windSpeed.calculateWindSpeed();
+}
+
+static void sampleRainfall() {
+    rainfall.update();
+}
+
+static void evaluateAlerts() {
+    alertSystem.reportValue(ALERT_LOW_SOIL_MOISTURE, soilMoisture.getMoisturePercent());
+    alertSystem.reportCondition(ALERT_GAS_DETECTED,
+                                gasSensor.isDangerous() || co2Sensor.isDangerous() || coSensor.isDangerous());
+    alertSystem.reportValue(ALERT_LOW_WATER, waterTank.getLevel_percent());
+    alertSystem.reportCondition(ALERT_OVERWEIGHT, weightSensor.isOverloaded());
+}
+
+static void printReport() {
+    Serial.printf("[%8lu ms] soil %.1f%% %.1fC pH %.2f | leaf %.1fC %.1f%% | air %.1fC %.1f%% | "
+                  "light %.1f%% | wind %.1f km/h (gust %.1f, 10-min %.1f) %d deg (2-min %.0f +-%.0f) | "
+                  "rain %.1f mm/h 1h %.2f mm | tank %.1f%% | gas %.0f co2 %.0f co %.0f ppm | "
+                  "weight %.2f kg | max pass %lu us\n",
+                  HAL::clock().millis(),
+                  soilMoisture.getMoisturePercent(), soilTemp.getTemperatureC(), soilPH.getPH(),
+                  leafTemp.getObjectTempC(), leafWetness.getWetnessPercent(),
+                  dhtSensor.getTemperature(), dhtSensor.getHumidity(),
+                  lightSensor.getLightPercent(),
+                  windSpeed.getWindSpeed_kmh(), windSpeed.getGust_ms() * 3.6, windSpeed.getMean10Min_ms() * 3.6,
+                  windDirection.getDirectionDegrees(), windDirection.getMeanDirection2Min(),
+                  windDirection.getDirectionStdDev2Min(),
+                  rainfall.getRainRate(), rainfall.getRainfall1h_mm(),
+                  waterTank.getLevel_percent(),
+                  gasSensor.getGasPPM(), co2Sensor.getCO2PPM(), coSensor.getCOPPM(),
+                  weightSensor.getWeight_kg(), scheduler.getMaxPassTime_us());
+    if (alertSystem.isActive(ALERT_GAS_DETECTED)) gasAlertSeen = true;
+    if (reports < TEST_REPORTS) reportedDirections[reports] = windDirection.getDirectionDegrees();
+    reports++;
+}
+
+// Replay each scanned channel's signal through a fresh engine and time the
+// ingest path on the host CPU; every block average must be a 12-bit code
+static void benchmarkAdcEngine() {
+    Serial.println("[ADC] pin  ns/conversion  (ingest cost per scanned channel)");
+
+    uint32_t channelRate = ADC_ENGINE_SAMPLE_RATE / (adcEngine.getChannelCount() ? adcEngine.getChannelCount() : 1);
+    for (uint8_t i = 0; i < adcEngine.getChannelCount(); i++) {
+        uint8_t pin = adcEngine.getChannelPin(i);
+        static AdcEngine engine;
+        engine = AdcEngine();
+        engine.addChannel(pin);
+
+        std::vector<HalAdcSample> samples(ADC_BENCH_SAMPLES);
+        for (size_t n = 0; n < samples.size(); n++) {
+            samples[n].pin = pin;
+            samples[n].value = (uint16_t)HAL::adc().read(pin);
+            HostHAL::advanceMicros(1000000 / channelRate - HOST_ADC_CONVERSION_US);
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < samples.size(); n += ADC_ENGINE_DRAIN) {
+            size_t count = samples.size() - n < ADC_ENGINE_DRAIN ? samples.size() - n : ADC_ENGINE_DRAIN;
+            engine.ingest(&samples[n], count);
+        }
+        double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        // Keep the result alive so the loop is not optimized out
+        int average = engine.read(pin);
+        Serial.printf("[ADC] %3u %14.2f  (average %d)\n", pin, elapsed_ns / samples.size(), average);
+        TEST_ASSERT_TRUE(average >= 0 && average <= 4095);
+    }
+}
+
+// Time one ppm conversion method over a fixed pseudo-random code sequence
+template <class Convert>
+static double timeConversions(Convert convert, float& checksum) {
+    uint32_t seed = 12345;
+    float sum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < MQ_BENCH_CONVERSIONS; i++) {
+        seed = seed * 1664525 + 1013904223;
+        sum += convert((int)(seed >> 20));
+    }
+    double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    checksum = sum;
+    return elapsed_ns / MQ_BENCH_CONVERSIONS;
+}
+
+// Largest relative error a table entry may have against libm
+#define MQ_MAX_RELATIVE_ERROR 1e-5
+
+static void benchmarkCurve(const char* name, const MQCurve& curve, float (*lookup)(int)) {
+    // Worst deviation of the table from libm over every ADC code
+    double maxError = 0;
+    double maxRelative = 0;
+    for (int raw = 0; raw < MQ_ADC_CODES; raw++) {
+        double reference = mqCurvePPM(curve, raw);
+        double error = fabs(lookup(raw) - reference);
+        if (error > maxError) maxError = error;
+        if (reference > 0 && error / reference > maxRelative) maxRelative = error / reference;
+    }
+
+    float tableSum, libmSum;
+    double table_ns = timeConversions(lookup, tableSum);
+    double libm_ns = timeConversions([&curve](int raw) { return mqCurvePPM(curve, raw); }, libmSum);
+    Serial.printf("[MQ] %-6s table %6.2f ns  libm %6.2f ns  (x%.1f)  max error %.4f ppm (%.5f%%)  [%.0f/%.0f]\n",
+                  name, table_ns, libm_ns, libm_ns / table_ns, maxError, maxRelative * 100.0, tableSum, libmSum);
+    TEST_ASSERT_TRUE(maxRelative <= MQ_MAX_RELATIVE_ERROR);
+}
+
+// Same task set and rates as main.ino
+static SensorTask<SoilTemperatureSensor> soilTempTask(soilTemp);
+static SensorTask<DHTSensor> dhtTask(dhtSensor);
+static SensorTask<WindDirectionSensor> windDirectionTask(windDirection);
+static SensorTask<WaterTankSensor> waterTankTask(waterTank);
+static SensorTask<GasSensor> gasTask(gasSensor);
+static SensorTask<CO2Sensor> co2Task(co2Sensor);
+static SensorTask<COSensor> coTask(coSensor);
+static SensorTask<WeightSensor> weightTask(weightSensor);
+static CallbackTask analogTask(sampleAnalogSensors);
+static CallbackTask motionTask(sampleMotion);
+static CallbackTask windSpeedTask(sampleWindSpeed);
+static CallbackTask rainfallTask(sampleRainfall);
+static CallbackTask alertTask(evaluateAlerts);
+static CallbackTask reportTask(printReport);
+
+// Run the drivers for TEST_REPORTS reports; the tests share the one run
+static void runDrivers() {
+    static bool done = false;
+    if (done) return;
+    done = true;
+
+    HostHAL::reset();
+    scriptSignals();
+
+    soilMoisture.begin();
+    soilTemp.begin();
+    soilPH.begin();
+    leafTemp.begin();
+    leafWetness.begin();
+    dhtSensor.begin();
+    lightSensor.begin();
+    windSpeed.begin();
+    windDirection.begin();
+    rainfall.begin();
+    waterTank.begin();
+    gasSensor.begin();
+    co2Sensor.begin();
+    coSensor.begin();
+    motionSensor.begin();
+    weightSensor.begin();
+    alertSystem.begin();
+    alertSystem.setThresholds(ALERT_LOW_SOIL_MOISTURE, 20.0, 25.0, 10000);
+    alertSystem.setThresholds(ALERT_LOW_WATER, 25.0, 30.0, 5000);
+    alertSystem.setDebounce(ALERT_GAS_DETECTED, 1000);
+    alertSystem.setDebounce(ALERT_OVERWEIGHT, 4000);
+    windSimulator.begin(WIND_SIM_PIN, WIND_POT_PIN);
+    adcEngine.begin();
+
+    scheduler.addTask(&motionTask, "motion", 100);
+    scheduler.addTask(&gasTask, "gas", 500, 50);
+    scheduler.addTask(&coTask, "co", 500, 200);
+    scheduler.addTask(&co2Task, "co2", 1000, 200);
+    scheduler.addTask(&windSpeedTask, "windSpeed", WIND_SAMPLE_INTERVAL_MS);
+    scheduler.addTask(&windDirectionTask, "windDir", 1000, 50);
+    scheduler.addTask(&waterTankTask, "waterTank", 1000, 50);
+    scheduler.addTask(&analogTask, "analog", 2000, 10);
+    scheduler.addTask(&rainfallTask, "rainfall", 2000);
+    scheduler.addTask(&soilTempTask, "soilTemp", 2000, 1000);
+    scheduler.addTask(&dhtTask, "dht", 2000, 100);
+    scheduler.addTask(&weightTask, "weight", 2000, 600);
+    scheduler.addTask(&alertTask, "alerts", 500, 10, 500);
+    scheduler.addTask(&reportTask, "report", UPDATE_INTERVAL, 0, UPDATE_INTERVAL);
+    scheduler.begin();
+
+    while (reports < TEST_REPORTS) {
+        windSimulator.update();
+        adcEngine.service();
+        scheduler.run();
+        alertSystem.update();
+        HostHAL::advanceMicros(HOST_LOOP_OVERHEAD_US);
+    }
+
+    scheduler.printStats();
+    adcEngine.printStats();
+}
+
+// ==================== TESTS ====================
+
+void setUp() {
+    runDrivers();
+}
+
+void tearDown() {
+}
+
+void test_readings_follow_script() {
+    // 40 cm echo below the sensor of a 100 cm tank
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 60.0f, waterTank.getLevel_percent());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 21.5f, soilTemp.getTemperatureC());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 24.0f, dhtSensor.getTemperature());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 55.0f, dhtSensor.getHumidity());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, weightSensor.getWeight_kg());
+    TEST_ASSERT_TRUE(windSpeed.getWindSpeed_kmh() > 0);
+
+    // A tip every 2 * RAIN_TOGGLE_US
+    unsigned long elapsed_us = HAL::clock().millis() * 1000UL;
+    TEST_ASSERT_UINT32_WITHIN(1, elapsed_us / (2 * RAIN_TOGGLE_US), rainfall.getTipCount());
+}
+
+void test_wind_statistics() {
+    // The simulator blows steadily: the gust is the highest 3-s mean, so
+    // at least the 2-minute mean and close to the current speed
+    TEST_ASSERT_TRUE(windSpeed.getGust_ms() >= windSpeed.getMean2Min_ms());
+    TEST_ASSERT_FLOAT_WITHIN(0.05f * windSpeed.getWindSpeed_ms(), windSpeed.getWindSpeed_ms(), windSpeed.getGust_ms());
+
+    // The vane swings +-26 deg around 180 deg, far from north, so the
+    // Yamartino sigma matches the plain standard deviation of the
+    // directions (sampled at every report, the sensor reads at 1 Hz)
+    double sum = 0, squares = 0;
+    for (int i = 0; i < TEST_REPORTS; i++) {
+        sum += reportedDirections[i];
+        squares += (double)reportedDirections[i] * reportedDirections[i];
+    }
+    double mean = sum / TEST_REPORTS;
+    double stdDev = sqrt(squares / TEST_REPORTS - mean * mean);
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, stdDev, windDirection.getDirectionStdDev2Min());
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, mean, windDirection.getMeanDirection2Min());
+
+    // The run is shorter than both windows: they hold the same reads
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, windDirection.getDirectionStdDev2Min(), windDirection.getDirectionStdDev10Min());
+}
+
+void test_rain_totals() {
+    // Every tip is within the last hour and of the one event
+    float tipped = rainfall.getTipCount() * RAIN_MM_PER_TIP;
+    TEST_ASSERT_TRUE(rainfall.getTipCount() > 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, tipped, rainfall.getRainfall1h_mm());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, tipped, rainfall.getEventRainfall_mm());
+
+    // A tip every 2 * RAIN_TOGGLE_US
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 3600.0f * 1000000.0f / (2 * RAIN_TOGGLE_US) * RAIN_MM_PER_TIP,
+                             rainfall.getRainRate());
+}
+
+void test_gas_alert_follows_leak() {
+    TEST_ASSERT_TRUE(gasAlertSeen);
+    TEST_ASSERT_FALSE(alertSystem.isActive(ALERT_GAS_DETECTED));
+}
+
+void test_scheduler_meets_deadlines() {
+    for (int i = 0; i < scheduler.getTaskCount(); i++) {
+        const TaskStats& stats = scheduler.getStats(i);
+        TEST_ASSERT_TRUE_MESSAGE(stats.runs > 0, scheduler.getTaskName(i));
+        TEST_ASSERT_EQUAL_MESSAGE(0, stats.overruns, scheduler.getTaskName(i));
+        TEST_ASSERT_EQUAL_MESSAGE(0, stats.deadlineMisses, scheduler.getTaskName(i));
+    }
+}
+
+void test_adc_engine() {
+    TEST_ASSERT_TRUE(adcEngine.getChannelCount() > 0);
+    TEST_ASSERT_EQUAL(0, adcEngine.getStats().overruns);
+    benchmarkAdcEngine();
+}
+
+void test_mq_tables() {
+    benchmarkCurve("MQ2", GasSensor::CURVE, GasSensor::ppmFromRaw);
+    benchmarkCurve("MQ135", CO2Sensor::CURVE, CO2Sensor::ppmFromRaw);
+    benchmarkCurve("MQ7", COSensor::CURVE, COSensor::ppmFromRaw);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_readings_follow_script);
+    RUN_TEST(test_wind_statistics);
+    RUN_TEST(test_rain_totals);
+    RUN_TEST(test_gas_alert_follows_leak);
+    RUN_TEST(test_scheduler_meets_deadlines);
+    RUN_TEST(test_adc_engine);
+    RUN_TEST(test_mq_tables);
+    return UNITY_END();
+}
+
+#endif // !ARDUINO
@@ -0,0 +1,378 @@
+/*
+ * test_lcd/test_main.cpp
+ * I2C traffic of the 20x4 LCD (PlatformIO `native` environment)
+ *
+ * A mock PCF8574 backpack on the host I2C bus decodes the expander bytes
+ * like an HD44780 (4-bit mode, EN falling edge, 2-line DDRAM map). The
+ * fourteen main.ino pages, fed with slowly drifting values, are drawn by:
+ * - legacy: what LiquidCrystal_I2C does, lcd.clear() and every character
+ *   again, one expander byte per I2C transaction
+ * - framebuffer: LcdDisplay, only the changed runs, batched transactions
+ * once on the current page rotation (new page every 4 s) and once with the
+ * current page refreshed every 500 ms. Prints I2C bytes and blocking bus
+ * time per refresh. Fails if the panel differs from the page clipped to 20
+ * columns after any refresh, if a framebuffer refresh clears the panel, or
+ * if it does not send fewer bytes than the legacy driver.
+ * Run: pio test -e native -f test_lcd
+ */
+
+#ifndef ARDUINO
+
+#include <Arduino.h>
+#include <unity.h>
+#include "HostHAL.h"
+#include "LcdDisplay.h"
+
+#define LCD_ADDRESS 0x27
+#define PAGE_COUNT 14
+#define PAGE_INTERVAL_MS 4000
+#define FAST_REFRESH_MS 500
+#define TEST_CYCLES 3
+
+// ==================== MOCK EXPANDER ====================
+#define PIN_RS 0x01
+#define PIN_EN 0x04
+#define PIN_BACKLIGHT 0x08
+
+class MockPanel {
+private:
+    uint8_t ddram[128];
+    uint8_t counter;          // DDRAM address counter
+    bool fourBit;
+    bool haveHigh;
+    uint8_t high;
+    uint8_t previous;
+
+    static uint8_t nextAddress(uint8_t address) {
+        if (address == 0x27) return 0x40;
+        if (address == 0x67) return 0x00;
+        return address + 1;
+    }
+
+    void execute(uint8_t value, bool data) {
+        if (data) {
+            ddram[counter] = value;
+            counter = nextAddress(counter);
+        } else if (value & 0x80) {
+            counter = value & 0x7F;
+        } else if ((value & 0xE0) == 0x20) {
+            fourBit = (value & 0x10) == 0;
+        } else if (value == 0x01) {
+            memset(ddram, ' ', sizeof(ddram));
+            counter = 0;
+            clears++;
+        } else if ((value & 0xFE) == 0x02) {
+            counter = 0;
+        }
+    }
+
+    // Falling edge of EN: the controller takes D4-D7
+    void latch(uint8_t bits) {
+        uint8_t nibble = bits >> 4;
+        if (!fourBit) {
+            execute(nibble << 4, false);
+            return;
+        }
+        if (!haveHigh) {
+            high = nibble;
+            haveHigh = true;
+            return;
+        }
+        haveHigh = false;
+        execute((high << 4) | nibble, bits & PIN_RS);
+    }
+
+public:
+    unsigned long clears;
+
+    MockPanel() {
+        memset(ddram, 0, sizeof(ddram));
+        counter = 0;
+        fourBit = false;
+        haveHigh = false;
+        high = 0;
+        previous = 0;
+        clears = 0;
+    }
+
+    void receive(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            if ((previous & PIN_EN) && !(data[i] & PIN_EN)) latch(previous);
+            previous = data[i];
+        }
+    }
+
+    char at(uint8_t column, uint8_t row) {
+        static const uint8_t ROW_BASE[LCD_ROWS] = { 0x00, 0x40, 0x14, 0x54 };
+        return ddram[ROW_BASE[row] + column];
+    }
+};
+
+// ==================== LEGACY DRIVER ====================
+// Bus pattern of LiquidCrystal_I2C: three single-byte transactions per
+// nibble and the delays of its pulseEnable() and clear()
+class LegacyLcd {
+private:
+    void expanderWrite(uint8_t value) {
+        uint8_t bits = value | PIN_BACKLIGHT;
+        HAL::i2c().write(LCD_ADDRESS, &bits, 1);
+    }
+
+    void write4bits(uint8_t value) {
+        expanderWrite(value);
+        expanderWrite(value | PIN_EN);
+        HAL::clock().delayMicroseconds(1);
+        expanderWrite(value & ~PIN_EN);
+        HAL::clock().delayMicroseconds(50);
+    }
+
+    void send(uint8_t value, uint8_t mode) {
+        write4bits((value & 0xF0) | mode);
+        write4bits(((value << 4) & 0xF0) | mode);
+    }
+
+public:
+    void clear() {
+        send(0x01, 0);
+        HAL::clock().delayMicroseconds(2000);
+    }
+
+    void setCursor(uint8_t column, uint8_t row) {
+        static const uint8_t ROW_OFFSETS[LCD_ROWS] = { 0x00, 0x40, 0x14, 0x54 };
+        send(0x80 | (column + ROW_OFFSETS[row]), 0);
+    }
+
+    void print(const char* text) {
+        while (*text) send((uint8_t)*text++, PIN_RS);
+    }
+};
+
+// ==================== PAGES ====================
+// Row texts of main.ino's pages for the values at time t
+typedef char PageRows[LCD_ROWS][32];
+
+static float drift(double t, float mid, float amplitude, double period_s, double phase) {
+    return mid + amplitude * (float)sin(2.0 * M_PI * t / period_s + phase);
+}
+
+static void buildPage(int page, double t, PageRows rows) {
+    for (int i = 0; i < LCD_ROWS; i++) rows[i][0] = '\0';
+    switch (page) {
+        case 0:
+            snprintf(rows[0], 32, "SoilMoist:%.1f%%", drift(t, 45, 3, 600, 0));
+            snprintf(rows[1], 32, "Optimal");
+            break;
+        case 1:
+            snprintf(rows[0], 32, "SoilTemp:%.1fC", drift(t, 21.5f, 0.4f, 900, 1));
+            snprintf(rows[1], 32, "Status: Optimal");
+            snprintf(rows[2], 32, "Leaf Temp: %.1fC", drift(t, 24, 1.5f, 300, 2));
+            snprintf(rows[3], 32, "Status: Normal");
+            break;
+        case 2:
+            snprintf(rows[0], 32, "Air Temp: %.1fC", drift(t, 24, 0.6f, 400, 3));
+            snprintf(rows[1], 32, "Status: Comfortable");
+            snprintf(rows[2], 32, "Air Humidity: %.1f%%", drift(t, 55, 2, 500, 4));
+            snprintf(rows[3], 32, "Status: Normal");
+            break;
+        case 3:
+            snprintf(rows[0], 32, "Light: %.1f %%", drift(t, 62, 4, 200, 5));
+            snprintf(rows[1], 32, "Status: Bright");
+            break;
+        case 4:
+            snprintf(rows[0], 32, "Wind Speed:");
+            snprintf(rows[1], 32, "%.1f km/h", drift(t, 12, 4, 20, 6));
+            snprintf(rows[2], 32, "%.2f m/s", drift(t, 12, 4, 20, 6) / 3.6f);
+            snprintf(rows[3], 32, "Gentle breeze");
+            break;
+        case 5:
+            snprintf(rows[0], 32, "=== WIND DIRECTION ==");
+            snprintf(rows[1], 32, "Angle: %d\xDF", (int)drift(t, 180, 25, 60, 7));
+            snprintf(rows[2], 32, "Direction: S");
+            break;
+        case 6:
+            snprintf(rows[0], 32, "===== RAINFALL =====");
+            snprintf(rows[1], 32, "24h %.1f 1h %.1f", drift(t, 12, 0.5f, 3000, 8), drift(t, 2, 0.5f, 600, 9));
+            snprintf(rows[2], 32, "Rate: %.1f mm/h", drift(t, 3, 1, 120, 10));
+            snprintf(rows[3], 32, "Light rain");
+            break;
+        case 7:
+            snprintf(rows[0], 32, "=== WATER TANK ====");
+            snprintf(rows[1], 32, "Level: %.1f %%", drift(t, 60, 0.5f, 900, 11));
+            snprintf(rows[2], 32, "Volume: %.0f L", drift(t, 600, 5, 900, 11));
+            snprintf(rows[3], 32, "Normal");
+            break;
+        case 8:
+            snprintf(rows[0], 32, "==== GAS SENSOR ====");
+            snprintf(rows[1], 32, "Gas: %.0f ppm", drift(t, 300, 40, 120, 12));
+            snprintf(rows[2], 32, "Status: Safe");
+            snprintf(rows[3], 32, "Safe");
+            break;
+        case 9:
+            snprintf(rows[0], 32, "==== CO2 SENSOR ====");
+            snprintf(rows[1], 32, "CO2: %.0f ppm", drift(t, 620, 30, 300, 13));
+            snprintf(rows[2], 32, "Air Quality: Good");
+            snprintf(rows[3], 32, "Good");
+            break;
+        case 10:
+            snprintf(rows[0], 32, "===== CO SENSOR ====");
+            snprintf(rows[1], 32, "CO: %.0f ppm", drift(t, 8, 3, 200, 14));
+            snprintf(rows[2], 32, "Status: Safe");
+            snprintf(rows[3], 32, "Safe");
+            break;
+        case 11:
+            snprintf(rows[0], 32, "=== MOTION SENSOR ==");
+            snprintf(rows[1], 32, "No motion");
+            snprintf(rows[2], 32, "Events: %d", (int)(t / 90));
+            snprintf(rows[3], 32, "All clear");
+            break;
+        case 12:
+            snprintf(rows[0], 32, "=== WEIGHT SENSOR ==");
+            snprintf(rows[1], 32, "Weight: %.1f kg", drift(t, 20, 0.2f, 600, 15));
+            snprintf(rows[2], 32, "%.1f lbs", drift(t, 20, 0.2f, 600, 15) * 2.20462f);
+            snprintf(rows[3], 32, "Normal");
+            break;
+        default:
+            snprintf(rows[0], 32, "=== LEAF WETNESS ===");
+            snprintf(rows[1], 32, "Wetness: %.1f%%", drift(t, 35, 5, 300, 16));
+            snprintf(rows[2], 32, "Status: Dry");
+            snprintf(rows[3], 32, "Leaf is DRY");
+            break;
+    }
+}
+
+// ==================== RUNS ====================
+struct RunResult {
+    unsigned long refreshes;
+    uint64_t bytes;
+    uint64_t maxBytes;
+    uint64_t busy_us;
+    uint64_t maxBusy_us;
+    unsigned long mismatches;   // Refreshes after which the panel differed
+};
+
+static MockPanel panel;
+static LcdDisplay lcd(LCD_ADDRESS);
+static LegacyLcd legacy;
+
+// Cells of the panel that differ from the framebuffer
+static int compareWithFrame() {
+    int differing = 0;
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        for (uint8_t column = 0; column < LCD_COLUMNS; column++) {
+            if (panel.at(column, row) != lcd.getCell(column, row)) differing++;
+        }
+    }
+    return differing;
+}
+
+static void drawLegacy(const PageRows rows) {
+    legacy.clear();
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        if (rows[row][0] == '\0') continue;
+        legacy.setCursor(0, row);
+        legacy.print(rows[row]);
+    }
+}
+
+// Rows into the framebuffer, clipped at the row end
+static void drawFrame(const PageRows rows) {
+    lcd.clear();
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        lcd.setCursor(0, row);
+        lcd.print(rows[row]);
+    }
+}
+
+static RunResult run(bool framebuffer, unsigned long refresh_ms, int cycles) {
+    RunResult result = {};
+    lcd.begin();
+    unsigned long duration_ms = (unsigned long)cycles * PAGE_COUNT * PAGE_INTERVAL_MS;
+
+    for (unsigned long now_ms = 0; now_ms < duration_ms; now_ms += refresh_ms) {
+        PageRows rows;
+        buildPage((int)(now_ms / PAGE_INTERVAL_MS) % PAGE_COUNT, now_ms / 1000.0, rows);
+
+        uint64_t bytesBefore = HostHAL::getI2CBytesWritten(LCD_ADDRESS);
+        uint64_t start_us = HostHAL::nowMicros();
+        if (framebuffer) {
+            drawFrame(rows);
+            lcd.flush();
+        } else {
+            drawLegacy(rows);
+        }
+        uint64_t bytes = HostHAL::getI2CBytesWritten(LCD_ADDRESS) - bytesBefore;
+        uint64_t busy = HostHAL::nowMicros() - start_us;
+
+        // The legacy panel is checked against a framebuffer that is never flushed
+        if (!framebuffer) drawFrame(rows);
+        if (compareWithFrame() != 0) result.mismatches++;
+
+        result.refreshes++;
+        result.bytes += bytes;
+        result.busy_us += busy;
+        if (bytes > result.maxBytes) result.maxBytes = bytes;
+        if (busy > result.maxBusy_us) result.maxBusy_us = busy;
+        HostHAL::advanceMillis(refresh_ms);
+    }
+    return result;
+}
+
+static void printRun(const char* name, unsigned long refresh_ms, const RunResult& r) {
+    Serial.printf("%-12s %6lu ms %9lu %10.1f %9llu %10.2f %9.2f %9.2f %6lu\n", name, refresh_ms, r.refreshes,
+                  (double)r.bytes / r.refreshes, (unsigned long long)r.maxBytes,
+                  r.busy_us / 1000.0 / r.refreshes, r.maxBusy_us / 1000.0,
+                  r.busy_us / 10.0 / ((double)r.refreshes * refresh_ms), r.mismatches);
+}
+
+// Both drivers on one refresh schedule
+static void compareDrivers(unsigned long refresh_ms) {
+    RunResult legacyRun = run(false, refresh_ms, TEST_CYCLES);
+    printRun("legacy", refresh_ms, legacyRun);
+
+    LcdStats before = lcd.getStats();
+    unsigned long clearsBefore = panel.clears;
+    RunResult framebuffer = run(true, refresh_ms, TEST_CYCLES);
+    printRun("framebuffer", refresh_ms, framebuffer);
+    const LcdStats& after = lcd.getStats();
+    unsigned long flushes = after.flushes - before.flushes;
+    Serial.printf("%-12s %6lu ms   %.1f cells, %.2f cursor moves, %.2f transactions per refresh\n", "", refresh_ms,
+                  (double)(after.cellsSent - before.cellsSent) / flushes,
+                  (double)(after.cursorMoves - before.cursorMoves) / flushes,
+                  (double)(after.transactions - before.transactions) / flushes);
+
+    TEST_ASSERT_EQUAL(0, legacyRun.mismatches);
+    TEST_ASSERT_EQUAL(0, framebuffer.mismatches);
+    TEST_ASSERT_EQUAL(1, panel.clears - clearsBefore);       // Only begin() clears
+    TEST_ASSERT_TRUE(framebuffer.bytes < legacyRun.bytes);
+    TEST_ASSERT_TRUE(framebuffer.maxBusy_us < legacyRun.maxBusy_us);
+}
+
+void setUp() {
+    HostHAL::reset();
+    HostHAL::attachI2CDevice(LCD_ADDRESS, [](const uint8_t* data, size_t length) { panel.receive(data, length); });
+}
+
+void tearDown() {
+}
+
+void test_page_rotation() {
+    compareDrivers(PAGE_INTERVAL_MS);
+}
+
+void test_fast_refresh() {
+    compareDrivers(FAST_REFRESH_MS);
+}
+
+int main() {
+    Serial.printf("LCD refresh, %d cycles of %d pages, I2C at %d us/byte\n", TEST_CYCLES, PAGE_COUNT,
+                  HOST_I2C_BYTE_US);
+    Serial.printf("%-12s %9s %9s %10s %9s %10s %9s %9s %6s\n", "driver", "refresh", "refreshes",
+                  "bytes/ref", "max bytes", "bus ms/ref", "max ms", "bus %", "wrong");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_page_rotation);
+    RUN_TEST(test_fast_refresh);
+    return UNITY_END();
+}
+
+#endif // ARDUINO
@@ -0,0 +1,105 @@
+/*
+ * test_rain_gauge/test_main.cpp
+ * Tipping-bucket totals of the RainGauge behind RainfallSensor
+ * (PlatformIO `native` environment)
+ *
+ * Scripted tips on RTC seconds: the rolling hour drops a minute's tips
+ * exactly when that minute leaves the window while the 24 h total keeps
+ * them, an event ends after RAIN_EVENT_GAP_S without tips and the next
+ * tip starts a new one, the intensity follows the tip spacing, and
+ * retained state survives a restore only with a valid checksum.
+ * Run: pio test -e native -f test_rain_gauge
+ */
+
+#ifndef ARDUINO
+
+#include <unity.h>
+#include <string.h>
+#include "rain_gauge.h"
+
+#define MM_PER_TIP 0.2794f
+
+static RainGaugeState state;
+static RainGauge gauge(&state, MM_PER_TIP);
+
+void setUp() {
+    gauge.clear();
+}
+
+void tearDown() {
+}
+
+void test_hour_rollover() {
+    // Three tips in minute 10, one in minute 40
+    gauge.addTip(600);
+    gauge.addTip(620);
+    gauge.addTip(659);
+    gauge.addTip(2400);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 4 * MM_PER_TIP, gauge.lastHour(2400));
+
+    // Minute 10 is still inside the hour up to minute 69
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 4 * MM_PER_TIP, gauge.lastHour(4199));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1 * MM_PER_TIP, gauge.lastHour(4200));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 4 * MM_PER_TIP, gauge.last24h(4200));
+
+    // Long gaps empty every bucket they pass
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, gauge.lastHour(2400 + 3600));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, gauge.last24h(25 * 3600));
+    TEST_ASSERT_EQUAL_UINT32(4, gauge.totalTips());
+}
+
+void test_clock_going_back_keeps_buckets() {
+    gauge.addTip(7200);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, MM_PER_TIP, gauge.lastHour(7000));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, MM_PER_TIP, gauge.lastHour(7200));
+}
+
+void test_event_ends_after_gap() {
+    gauge.addTip(1000);
+    gauge.addTip(1000 + RAIN_EVENT_GAP_S);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2 * MM_PER_TIP, gauge.event(1000 + RAIN_EVENT_GAP_S));
+
+    uint32_t last = 1000 + RAIN_EVENT_GAP_S;
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2 * MM_PER_TIP, gauge.event(last + RAIN_EVENT_GAP_S));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, gauge.event(last + RAIN_EVENT_GAP_S + 1));
+
+    gauge.addTip(last + RAIN_EVENT_GAP_S + 1);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, MM_PER_TIP, gauge.event(last + RAIN_EVENT_GAP_S + 1));
+}
+
+void test_intensity() {
+    // A tip every 36 s is 100 tips an hour
+    for (uint32_t time = 36; time <= 360; time += 36) {
+        gauge.addTip(time);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100 * MM_PER_TIP, gauge.intensity(360));
+
+    // Once the rain stops, older tips leave the window and the span grows
+    // with the time since the last tip: 180..360 s remain, over 400 s
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5 * MM_PER_TIP * 3600.0f / 400.0f, gauge.intensity(760));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, gauge.intensity(360 + RAIN_INTENSITY_WINDOW_S + 1));
+}
+
+void test_restore_checks_state() {
+    gauge.addTip(100);
+    gauge.addTip(200);
+    TEST_ASSERT_TRUE(gauge.restore());
+    TEST_ASSERT_EQUAL_UINT32(2, gauge.totalTips());
+
+    state.eventTips++;
+    TEST_ASSERT_FALSE(gauge.restore());
+    TEST_ASSERT_EQUAL_UINT32(0, gauge.totalTips());
+    TEST_ASSERT_TRUE(gauge.restore());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_hour_rollover);
+    RUN_TEST(test_clock_going_back_keeps_buckets);
+    RUN_TEST(test_event_ends_after_gap);
+    RUN_TEST(test_intensity);
+    RUN_TEST(test_restore_checks_state);
+    return UNITY_END();
+}
+
+#endif // !ARDUINO
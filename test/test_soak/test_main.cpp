@@ -0,0 +1,137 @@
+/*
+ * test_soak/test_main.cpp
+ * Heap soak test of the full sketch (PlatformIO `native` environment)
+ *
+ * Compiles main.ino unchanged against the host HAL and runs setup() and
+ * loop() on the virtual clock for SOAK_DAYS simulated days, with scripted
+ * inputs that push every status classifier through its classes each day.
+ * Every malloc/new is tracked; once setup() is done loop() must not
+ * allocate and the live heap has to stay where it is. Prints one line per
+ * simulated day (live bytes, peak, allocations since setup()).
+ * Run: pio test -e native -f test_soak
+ * A simulated month (about 90 s): PLATFORMIO_BUILD_FLAGS=-DSOAK_DAYS=30
+ */
+
+#ifndef ARDUINO
+
+#include <Arduino.h>
+#include <unity.h>
+#include "HostHAL.h"
+#include "HostHeap.h"
+
+#ifndef SOAK_DAYS
+#define SOAK_DAYS 7
+#endif
+#define SOAK_LOOP_STEP_MS 250        // Virtual time per loop() pass (wind sample period)
+#define SOAK_DAY_MS 86400000UL
+
+// ==================== SKETCH ====================
+#include "HostSketch.h"
+#include "main.ino"
+
+// ==================== INPUT SCRIPT ====================
+
+// Triangle wave between low and high, period in seconds (cheaper than sin
+// at the scanner's 20 kHz)
+static int sweep(uint64_t now_us, int low, int high, uint64_t period_s) {
+    uint64_t period_us = period_s * 1000000ULL;
+    uint64_t phase = now_us % period_us;
+    uint64_t half = period_us / 2;
+    uint64_t ramp = phase < half ? phase : period_us - phase;
+    return low + (int)((uint64_t)(high - low) * ramp / half);
+}
+
+// Stepped day: each signal covers its whole range once or more per day
+static void scriptSignals() {
+    HostHAL::setAnalogSource(SOIL_MOISTURE_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 21600); });
+    HostHAL::setAnalogSource(SOIL_PH_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 28800); });
+    HostHAL::setAnalogSource(LEAF_TEMP_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 43200); });
+    HostHAL::setAnalogSource(LEAF_WETNESS_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 14400); });
+    HostHAL::setAnalogSource(LDR_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 86400); });
+    HostHAL::setAnalogSource(WIND_DIR_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 3600); });
+    HostHAL::setAnalogSource(WIND_POT_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 43200); });
+    HostHAL::setAnalogSource(GAS_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 86400); });
+    HostHAL::setAnalogSource(CO2_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 43200); });
+    HostHAL::setAnalogSource(CO_PIN, [](uint64_t now) { return sweep(now, 0, 4095, 28800); });
+
+    // Tank from empty to full: echo of 5 to 100 cm
+    HostHAL::setPulseSource(WATER_ECHO_PIN, [](uint64_t now) {
+        return (unsigned long)sweep(now, 290, 5830, 86400);
+    });
+
+    HostHAL::setTemperatureProbe(SOIL_TEMP_PIN, 1, 21.5f);
+    HostHAL::setHumidity(DHT_PIN, 24.0f, 55.0f);
+    HostHAL::setLoadCell(WEIGHT_DATA_PIN, 0);
+    HostHAL::connectPins(WIND_SIM_PIN, WIND_SPEED_PIN);
+}
+
+// Slow inputs without a signal source: re-scripted once per simulated hour
+static void scriptHour(unsigned long hour) {
+    float phase = (float)(hour % 24) / 24.0f;
+    HostHAL::setTemperatureProbe(SOIL_TEMP_PIN, 1, -5.0f + 45.0f * phase);
+    HostHAL::setHumidity(DHT_PIN, 45.0f - 50.0f * phase, 100.0f * phase);
+    HostHAL::setLoadCell(WEIGHT_DATA_PIN, (long)(hour % 24) * 100000L);
+    HostHAL::setDigital(RAIN_PIN, (int)(hour & 1));
+    HostHAL::setDigital(MOTION_PIN, (hour % 3) == 0 ? HIGH : LOW);
+}
+
+// ==================== TESTS ====================
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_soak() {
+    unsigned long days = SOAK_DAYS;
+    unsigned long step_ms = SOAK_LOOP_STEP_MS;
+
+    HostHAL::reset();
+    scriptSignals();
+    Serial.setEcho(false);
+
+    printf("[Soak] %lu days, %lu ms per loop() pass\n", days, step_ms);
+    setup();
+    long setupBytes = liveBytes;
+    unsigned long setupAllocations = allocations;
+    printf("[Soak] after setup(): %ld bytes live, %lu allocations\n", setupBytes, setupAllocations);
+    printf("[Soak] day   live bytes   peak bytes   allocations\n");
+
+    long firstDayBytes = 0;
+    long maxGrowth = 0;
+    unsigned long hour = 0;
+    for (unsigned long day = 1; day <= days; day++) {
+        unsigned long dayEnd = HAL::clock().millis() + SOAK_DAY_MS;
+        while ((long)(HAL::clock().millis() - dayEnd) < 0) {
+            unsigned long now = HAL::clock().millis();
+            if (now / 3600000UL != hour) {
+                hour = now / 3600000UL;
+                scriptHour(hour);
+            }
+            loop();
+            HostHAL::advanceMillis(step_ms);
+        }
+
+        if (day == 1) firstDayBytes = liveBytes;
+        if (liveBytes - firstDayBytes > maxGrowth) maxGrowth = liveBytes - firstDayBytes;
+        printf("[Soak] %3lu %12ld %12ld %13lu\n", day, liveBytes, peakBytes, allocations - setupAllocations);
+        fflush(stdout);
+    }
+
+    printf("[Soak] %lu days: heap grew %ld bytes after day 1, %lu allocations after setup()\n",
+           days, maxGrowth, allocations - setupAllocations);
+    TEST_ASSERT_EQUAL(0, allocations - setupAllocations);
+    TEST_ASSERT_EQUAL(0, maxGrowth);
+}
+
+int main() {
+    // stdout allocates its buffer on first use, before the baseline
+    printf("[Soak] main.ino heap soak\n");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_soak);
+    return UNITY_END();
+}
+
+#endif // !ARDUINO
@@ -0,0 +1,262 @@
+/*
+ * test_telemetry/test_main.cpp
+ * Serial output cost of the full sketch, text report against binary
+ * telemetry (PlatformIO `native` environment)
+ *
+ * Compiles main.ino unchanged and runs it on the virtual clock with a gas
+ * leak scripted in, so alerts are logged too. Three phases of the same
+ * length: the text report, binary snapshots with log frames, and binary
+ * snapshots alone. For each it prints the bytes on the wire per report and
+ * how long they keep the 115200 baud UART busy. The binary stream is split
+ * on 0x00 and every frame COBS-decoded and CRC-checked; the run fails on a
+ * bad frame, a dropped snapshot, a sequence gap not explained by a dropped
+ * log frame, or any text byte written around the telemetry link.
+ * Run: pio test -e native -f test_telemetry
+ * With TELEMETRY_CAPTURE=capture.bin set, the wire bytes of the binary
+ * phases are written there, for `serial_bridge.py --decode capture.bin`.
+ */
+
+#ifndef ARDUINO
+
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "HostHAL.h"
+#include "HostSketch.h"
+#include "main.ino"
+
+#define TELEMETRY_REPORTS 100
+#define TELEMETRY_BAUD 115200
+#define TELEMETRY_LOOP_STEP_US 1000
+
+// MQ2 reading during the leak, well past the danger threshold
+#define GAS_LEAK_RAW 3300
+
+static bool gasLeak = false;
+
+static void scriptSignals() {
+    HostHAL::setAnalog(SOIL_MOISTURE_PIN, 2800);
+    HostHAL::setAnalog(SOIL_PH_PIN, 1860);
+    HostHAL::setAnalog(LEAF_TEMP_PIN, 1500);
+    HostHAL::setAnalog(LEAF_WETNESS_PIN, 3000);
+    HostHAL::setAnalog(LDR_PIN, 2048);
+    HostHAL::setAnalog(WIND_DIR_PIN, 2048);
+    HostHAL::setAnalog(WIND_POT_PIN, 400);
+    HostHAL::setAnalogSource(GAS_PIN, [](uint64_t) { return gasLeak ? GAS_LEAK_RAW : 400; });
+    HostHAL::setAnalog(CO2_PIN, 500);
+    HostHAL::setAnalog(CO_PIN, 100);
+    HostHAL::setPulseWidth(WATER_ECHO_PIN, 2332);
+    HostHAL::setTemperatureProbe(SOIL_TEMP_PIN, 1, 21.5f);
+    HostHAL::setHumidity(DHT_PIN, 24.0f, 55.0f);
+    HostHAL::setLoadCell(WEIGHT_DATA_PIN, 0);
+    HostHAL::connectPins(WIND_SIM_PIN, WIND_SPEED_PIN);
+}
+
+// Run the sketch for a number of reports, with the gas leak in the middle
+// third so alerts are raised and cleared
+static void runReports(int reports) {
+    unsigned long end = HAL::clock().millis() + (unsigned long)reports * UPDATE_INTERVAL;
+    unsigned long leakStart = HAL::clock().millis() + (unsigned long)reports * UPDATE_INTERVAL / 3;
+    unsigned long leakEnd = leakStart + (unsigned long)reports * UPDATE_INTERVAL / 3;
+    while ((long)(HAL::clock().millis() - end) < 0) {
+        unsigned long now = HAL::clock().millis();
+        gasLeak = now >= leakStart && now < leakEnd;
+        loop();
+        HostHAL::advanceMicros(TELEMETRY_LOOP_STEP_US);
+    }
+    gasLeak = false;
+}
+
+// ==================== DECODING ====================
+
+struct DecodeResult {
+    unsigned long snapshots;
+    unsigned long logs;
+    unsigned long badFrames;
+    unsigned long sequenceGaps;
+    TelemetrySnapshot last;
+    std::vector<std::string> logLines;
+};
+
+static void readSnapshot(const uint8_t* payload, TelemetrySnapshot& snapshot) {
+    memcpy(&snapshot.flags, &payload[7], 2);
+    memcpy(&snapshot.remoteMask, &payload[9], 2);
+    memcpy(snapshot.values, &payload[11], sizeof(snapshot.values));
+    memcpy(snapshot.status, &payload[11 + sizeof(snapshot.values)], sizeof(snapshot.status));
+}
+
+static DecodeResult decodeStream(const std::vector<uint8_t>& wire) {
+    DecodeResult result = {};
+    std::vector<uint8_t> payload(wire.size());
+    bool haveSequence = false;
+    uint16_t expected = 0;
+
+    size_t start = 0;
+    for (size_t i = 0; i < wire.size(); i++) {
+        if (wire[i] != 0) continue;
+        size_t length = i - start;
+        const uint8_t* frame = &wire[start];
+        start = i + 1;
+        if (length == 0) continue;                   // Leading delimiter
+
+        size_t n = cobsDecode(frame, length, payload.data());
+        uint16_t crc;
+        if (n < TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE ||
+            (memcpy(&crc, &payload[n - 2], 2), crc != telemetryCrc16(payload.data(), n - 2))) {
+            result.badFrames++;
+            continue;
+        }
+        n -= TELEMETRY_CRC_SIZE;
+
+        uint16_t sequence;
+        memcpy(&sequence, &payload[1], 2);
+        if (haveSequence && sequence != expected) result.sequenceGaps++;
+        haveSequence = true;
+        expected = (uint16_t)(sequence + 1);
+
+        if (payload[0] == TELEMETRY_FRAME_SNAPSHOT && n == TELEMETRY_SNAPSHOT_SIZE) {
+            readSnapshot(payload.data(), result.last);
+            result.snapshots++;
+        } else if (payload[0] == TELEMETRY_FRAME_LOG) {
+            result.logLines.push_back(std::string((const char*)&payload[TELEMETRY_HEADER_SIZE], n - TELEMETRY_HEADER_SIZE));
+            result.logs++;
+        } else {
+            result.badFrames++;
+        }
+    }
+    return result;
+}
+
+// ==================== PHASES ====================
+
+static void printCost(const char* name, double bytes, int reports) {
+    double perReport = bytes / reports;
+    double busy_ms = perReport * 10.0 * 1000.0 / TELEMETRY_BAUD;
+    Serial.printf("[Telemetry] %-14s %8.0f bytes/report  %6.1f ms UART busy per report (%4.1f%% of %lu ms)\n",
+                  name, perReport, busy_ms, busy_ms * 100.0 / UPDATE_INTERVAL, UPDATE_INTERVAL);
+}
+
+// Binary phase: run, decode, check
+static void runBinary(const char* name, bool log, int reports, std::vector<uint8_t>& capture) {
+    telemetry.begin(TELEMETRY_BAUD, TELEMETRY_MODE_BINARY, log);
+    TelemetryStats before = telemetry.getStats();
+    unsigned long textBefore = Serial.getBytesWritten();
+    uint64_t wireBefore = HostHAL::getUartBytesWritten();
+
+    runReports(reports);
+    printSchedulerStats();                           // Goes out as log frames (or nowhere)
+
+    std::vector<uint8_t> wire;
+    HostHAL::takeUartOutput(wire);
+    capture.insert(capture.end(), wire.begin(), wire.end());
+    DecodeResult result = decodeStream(wire);
+    const TelemetryStats& stats = telemetry.getStats();
+    unsigned long textBytes = Serial.getBytesWritten() - textBefore;
+
+    Serial.setEcho(true);
+    printCost(name, (double)(HostHAL::getUartBytesWritten() - wireBefore), reports);
+    unsigned long logsDropped = stats.logsDropped - before.logsDropped;
+    Serial.printf("[Telemetry]   %lu snapshots, %lu log frames decoded; %lu bad, %lu gaps, "
+                  "%lu snapshots and %lu log frames dropped, %lu text bytes outside frames\n",
+                  result.snapshots, result.logs, result.badFrames, result.sequenceGaps,
+                  stats.dropped - before.dropped, logsDropped, textBytes);
+    for (size_t i = 0; i < result.logLines.size() && i < 3; i++) {
+        Serial.printf("[Telemetry]   log: %s", result.logLines[i].c_str());
+    }
+    if (result.snapshots > 0) {
+        Serial.printf("[Telemetry]   last snapshot: soil %.1f%%, air %.1fC, gas %.0f ppm, flags 0x%04x\n",
+                      result.last.values[TELEMETRY_SOIL_MOISTURE], result.last.values[TELEMETRY_AIR_TEMP],
+                      result.last.values[TELEMETRY_GAS], result.last.flags);
+    }
+    Serial.setEcho(false);
+
+    TEST_ASSERT_EQUAL(0, result.badFrames);
+    TEST_ASSERT_TRUE(result.sequenceGaps <= logsDropped);
+    TEST_ASSERT_EQUAL(0, textBytes);
+    TEST_ASSERT_EQUAL(before.dropped, stats.dropped);
+    TEST_ASSERT_EQUAL(stats.snapshots - before.snapshots, result.snapshots);
+    TEST_ASSERT_EQUAL(stats.logFrames - before.logFrames, result.logs);
+    TEST_ASSERT_TRUE(result.last.values[TELEMETRY_SOIL_MOISTURE] == soilMoisture.getMoisturePercent());
+    if (log) TEST_ASSERT_TRUE(result.logs > 0);
+}
+
+// ==================== TESTS ====================
+
+static std::vector<uint8_t> capture;
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// Text report, as built without TELEMETRY_BINARY
+void test_text_report() {
+    unsigned long textBefore = Serial.getBytesWritten();
+    runReports(TELEMETRY_REPORTS);
+    unsigned long textBytes = Serial.getBytesWritten() - textBefore;
+    Serial.setEcho(true);
+    printCost("text", (double)textBytes, TELEMETRY_REPORTS);
+    Serial.setEcho(false);
+    TEST_ASSERT_TRUE(textBytes > 0);
+}
+
+void test_binary_with_log() {
+    runBinary("binary + log", true, TELEMETRY_REPORTS, capture);
+}
+
+void test_binary() {
+    runBinary("binary", false, TELEMETRY_REPORTS, capture);
+}
+
+// Dashboard overrides win over every driver reading in the snapshot
+void test_remote_overrides() {
+    telemetry.begin(TELEMETRY_BAUD, TELEMETRY_MODE_BINARY, false);
+    for (uint8_t channel = 0; channel < REMOTE_CHANNEL_COUNT; channel++) {
+        remoteValues[channel] = 10.0f + channel;
+        remoteMask |= 1u << channel;
+    }
+    std::vector<uint8_t> wire;
+    HostHAL::takeUartOutput(wire);
+    wire.clear();
+    runReports(3);
+    HostHAL::takeUartOutput(wire);
+    remoteMask = 0;
+
+    DecodeResult result = decodeStream(wire);
+    TEST_ASSERT_TRUE(result.snapshots > 0);
+    TEST_ASSERT_EQUAL_HEX16((1u << REMOTE_CHANNEL_COUNT) - 1, result.last.remoteMask);
+    for (uint8_t channel = 0; channel < REMOTE_CHANNEL_COUNT; channel++) {
+        // Telemetry value indexes follow RemoteChannel (Telemetry.h)
+        float expected = channel == REMOTE_WIND_DIRECTION ? (float)(int)remoteValues[channel] : remoteValues[channel];
+        TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected, result.last.values[channel], REMOTE_CHANNELS[channel].name);
+    }
+}
+
+int main() {
+    HostHAL::reset();
+    scriptSignals();
+    Serial.setEcho(false);
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_text_report);
+    RUN_TEST(test_binary_with_log);
+    RUN_TEST(test_binary);
+    RUN_TEST(test_remote_overrides);
+    int failures = UNITY_END();
+
+    const char* capturePath = getenv("TELEMETRY_CAPTURE");
+    if (capturePath != nullptr) {
+        FILE* file = fopen(capturePath, "wb");
+        if (file == nullptr || fwrite(capture.data(), 1, capture.size(), file) != capture.size()) {
+            printf("Cannot write %s\n", capturePath);
+            return 1;
+        }
+        fclose(file);
+        printf("[Telemetry] %zu wire bytes written to %s\n", capture.size(), capturePath);
+    }
+    return failures;
+}
+
+#endif // !ARDUINO
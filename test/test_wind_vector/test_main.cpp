@@ -0,0 +1,121 @@
+/*
+ * test_wind_vector/test_main.cpp
+ * Vector-mean wind direction of the WindVectorAverage behind
+ * WindDirectionSensor (PlatformIO `native` environment)
+ *
+ * A steady direction has no spread, directions either side of north
+ * average to north rather than south, an even split of +-20 degrees has
+ * the Yamartino sigma of its standard deviation, and each window only
+ * sees its newest samples. Also the compass point lookups at their
+ * boundaries.
+ * Run: pio test -e native -f test_wind_vector
+ */
+
+#ifndef ARDUINO
+
+#include <unity.h>
+#include <math.h>
+#include "wind_vector.h"
+
+static WindVectorAverage* average;
+static int shortWindow;
+static int longWindow;
+
+// Smallest difference between two directions
+static float angleBetween(float a, float b) {
+    float delta = fmodf(fabsf(a - b), 360.0f);
+    return delta > 180.0f ? 360.0f - delta : delta;
+}
+
+void setUp() {
+    average = new WindVectorAverage();
+    shortWindow = average->addWindow(4);
+    longWindow = average->addWindow(WIND_VECTOR_HISTORY);
+}
+
+void tearDown() {
+    delete average;
+}
+
+void test_empty_window() {
+    WindVectorStats stats = average->stats(shortWindow);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.samples);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, stats.stdDev);
+    TEST_ASSERT_EQUAL_INT(-1, average->addWindow(0));
+}
+
+void test_steady_direction() {
+    for (int i = 0; i < 10; i++) {
+        average->add(135.0f);
+    }
+    WindVectorStats stats = average->stats(longWindow);
+    TEST_ASSERT_EQUAL_UINT16(10, stats.samples);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 135.0f, stats.direction);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, stats.stdDev);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, stats.steadiness);
+}
+
+void test_mean_across_north() {
+    for (int i = 0; i < 50; i++) {
+        average->add(350.0f);
+        average->add(10.0f);
+    }
+    WindVectorStats stats = average->stats(longWindow);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, angleBetween(stats.direction, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 10.0f, stats.stdDev);
+}
+
+void test_yamartino_sigma() {
+    for (int i = 0; i < 100; i++) {
+        average->add(i % 2 ? 200.0f : 160.0f);
+    }
+    // sigma = asin(e) * (1 + 0.1547 e^3) with e = sin(20 deg)
+    WindVectorStats stats = average->stats(longWindow);
+    float epsilon = sinf(20.0f * (float)M_PI / 180.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 180.0f, stats.direction);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 20.0f * (1.0f + 0.1547005f * epsilon * epsilon * epsilon), stats.stdDev);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, cosf(20.0f * (float)M_PI / 180.0f), stats.steadiness);
+}
+
+void test_windows_keep_newest_samples() {
+    for (int i = 0; i < 20; i++) {
+        average->add(90.0f);
+    }
+    for (int i = 0; i < 4; i++) {
+        average->add(270.0f);
+    }
+    WindVectorStats recent = average->stats(shortWindow);
+    TEST_ASSERT_EQUAL_UINT16(4, recent.samples);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 270.0f, recent.direction);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, recent.stdDev);
+
+    WindVectorStats all = average->stats(longWindow);
+    TEST_ASSERT_EQUAL_UINT16(24, all.samples);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 90.0f, all.direction);
+
+    average->reset();
+    TEST_ASSERT_EQUAL_UINT16(0, average->stats(longWindow).samples);
+}
+
+void test_cardinal_points() {
+    TEST_ASSERT_EQUAL_STRING("N", windCardinal16(0.0f));
+    TEST_ASSERT_EQUAL_STRING("N", windCardinal16(354.0f));
+    TEST_ASSERT_EQUAL_STRING("NNE", windCardinal16(11.25f));
+    TEST_ASSERT_EQUAL_STRING("N", windCardinal8(22.4f));
+    TEST_ASSERT_EQUAL_STRING("NE", windCardinal8(22.5f));
+    TEST_ASSERT_EQUAL_STRING("NW", windCardinal8(-30.0f));
+    TEST_ASSERT_EQUAL_STRING("S", windCardinal8(540.0f));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_window);
+    RUN_TEST(test_steady_direction);
+    RUN_TEST(test_mean_across_north);
+    RUN_TEST(test_yamartino_sigma);
+    RUN_TEST(test_windows_keep_newest_samples);
+    RUN_TEST(test_cardinal_points);
+    return UNITY_END();
+}
+
+#endif // !ARDUINO